@@ -270,7 +270,7 @@ namespace detail
 
         if (vfield1->is_float())
         {
-          auto ptr = static_cast<float*>(vfield1->fdata_pointer());
+          auto ptr = static_cast<const float*>(vfield1->get_const_values_pointer());
           if (ptr)
           {
             return makeCleaver2FieldFromLatVol(input);
@@ -295,7 +295,8 @@ namespace detail
       VMesh::dimension_type dims;
       vmesh->get_dimensions(dims);
 
-      auto ptr = static_cast<float*>(vfield->fdata_pointer());
+      // cleaver2 only reads the samples, so the values stay shared with other fields
+      auto ptr = const_cast<float*>(static_cast<const float*>(vfield->get_const_values_pointer()));
 
       auto cleaverField = boost::make_shared<cleaver2::ScalarField<float>>(ptr, dims[0], dims[1], dims[2]);
       cleaver2::BoundingBox bb(cleaver2::vec3::zero, cleaver2::vec3(dims[0], dims[1], dims[2]));
@@ -85,7 +85,8 @@ boost::shared_ptr<Cleaver::ScalarField> InterfaceWithCleaverAlgorithm::makeCleav
   VMesh::dimension_type dims;
   vmesh->get_dimensions( dims );
 
-  float* ptr = static_cast<float*>(vfield->fdata_pointer());
+  // Cleaver only reads the samples, so the values stay shared with other fields
+  float* ptr = const_cast<float*>(static_cast<const float*>(vfield->get_const_values_pointer()));
 
   auto cleaverField = boost::make_shared<Cleaver::FloatField>(dims[0], dims[1], dims[2], ptr);
   Cleaver::BoundingBox bb(Cleaver::vec3::zero, Cleaver::vec3(dims[0],dims[1],dims[2]));
@@ -176,7 +177,7 @@ FieldHandle InterfaceWithCleaverAlgorithm::run(const std::vector<FieldHandle>& i
 
       if (vfield1->is_float())
       {
-        float* ptr = static_cast<float*>(vfield1->fdata_pointer());
+        auto ptr = static_cast<const float*>(vfield1->get_const_values_pointer());
 	if (ptr)
         {
           fields.push_back(makeCleaverFieldFromLatVol(input));
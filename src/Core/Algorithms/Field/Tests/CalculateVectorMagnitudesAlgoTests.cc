@@ -88,8 +88,8 @@ TEST(CalculateVectorMagnitudesAlgoTests, CompareTriSurfVectorOnNodeToSCIRun4)
   FieldHandle SCIRun4Output = CreateTriSurfVectorOnNodeSCIRun4Output();
   VField* expected_vals = SCIRun4Output->vfield(); // what is to be expected
   VField* outputed_vals = out->vfield(); // the output
-  double* expected_mag = reinterpret_cast<double*>(expected_vals->get_values_pointer());
-  double* outputed_mag = reinterpret_cast<double*>(outputed_vals->get_values_pointer());
+  auto expected_mag = static_cast<const double*>(expected_vals->get_const_values_pointer());
+  auto outputed_mag = static_cast<const double*>(outputed_vals->get_const_values_pointer());
 
   // getting the number of things to compare
   VMesh*  imesh  = in->vmesh();
@@ -117,8 +117,8 @@ TEST(CalculateVectorMagnitudesAlgoTests, TetMeshVectorOnNodeAsInput)
   FieldHandle SCIRun4Output = CreateTetMeshVectorOnNodeSCIRun4Output();
   VField* expected_vals = SCIRun4Output->vfield(); // what is to be expected
   VField* outputed_vals = out->vfield(); // the output
-  double* expected_mag = reinterpret_cast<double*>(expected_vals->get_values_pointer());
-  double* outputed_mag = reinterpret_cast<double*>(outputed_vals->get_values_pointer());
+  auto expected_mag = static_cast<const double*>(expected_vals->get_const_values_pointer());
+  auto outputed_mag = static_cast<const double*>(outputed_vals->get_const_values_pointer());
 
   // getting the number of things to compare
   VMesh*  imesh  = in->vmesh();
@@ -29,10 +29,13 @@
 #include <Testing/Utils/SCIRunUnitTests.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/TetVolMesh.h>
+#include <Core/Basis/TetLinearLgn.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Algorithms/Legacy/FiniteElements/BuildMatrix/BuildFEMatrix.h>
+#include <Core/Algorithms/Legacy/Fields/ConvertMeshType/ConvertMeshToTetVolMesh.h>
 #include <Core/Algorithms/DataIO/ReadMatrix.h>
 #include <Testing/Utils/SCIRunUnitTests.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
@@ -40,7 +43,9 @@
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Basis;
 using namespace SCIRun::Core::Algorithms::FiniteElements;
+using namespace SCIRun::Core::Algorithms::Fields;
 using namespace SCIRun::Core::Algorithms::DataIO;
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::TestUtils;
@@ -214,3 +219,192 @@ TEST(BuildFEMatrixAlgorithmTests, DISABLED_TestMeshSize1e6)
 
   EXPECT_TRUE(compare_with_tolerance(*expectedOutput("1e6.mat"), *output));
 }
+
+namespace FEInputData
+{
+  FieldHandle generatedTetVol(size_type size)
+  {
+    FieldInformation lfi(LATVOLMESH_E, CONSTANTDATA_E, DOUBLE_E);
+    auto latVol = CreateField(lfi, CreateMesh(lfi, size, size, size, Point(-1.0, -1.0, -1.0), Point(1.0, 1.0, 1.0)));
+    latVol->vfield()->set_all_values(1.0);
+
+    ConvertMeshToTetVolMeshAlgo convert;
+    FieldHandle tetVol;
+    convert.run(latVol, tetVol);
+    return tetVol;
+  }
+
+  SparseRowMatrixHandle timedBuild(FieldHandle mesh, bool elementAssembly)
+  {
+    BuildFEMatrixAlgo algo;
+    algo.set(BuildFEMatrixAlgo::ElementAssembly, elementAssembly);
+    ScopedTimer t(elementAssembly ? "element colored assembly" : "row by row assembly");
+    auto out = algo.run(withInputData((Variables::InputField, mesh)));
+    return out.get<SparseRowMatrix>(BuildFEMatrixAlgo::Stiffness_Matrix);
+  }
+}
+
+TEST(BuildFEMatrixAlgorithmTests, ElementAssemblyMatchesRowAssemblyOnV4Meshes)
+{
+  using namespace FEInputData;
+  for (const auto& file : { "fem_1e1_elements.fld", "fem_1e3_elements.fld", "fem_1e4_elements.fld" })
+  {
+    auto mesh = loadTestMesh(file);
+    ASSERT_THAT(mesh, NotNull());
+
+    auto byRow = timedBuild(mesh, false);
+    auto byElement = timedBuild(mesh, true);
+    ASSERT_THAT(byRow, NotNull());
+    ASSERT_THAT(byElement, NotNull());
+
+    EXPECT_EQ(byRow->nonZeros(), byElement->nonZeros());
+    EXPECT_TRUE(byRow->isApprox(*byElement)) << file;
+  }
+}
+
+TEST(BuildFEMatrixAlgorithmTests, ElementAssemblyTimingOnGeneratedTetVol)
+{
+  using namespace FEInputData;
+  auto mesh = generatedTetVol(40);
+  ASSERT_THAT(mesh, NotNull());
+  std::cout << "Generated TetVol with " << mesh->vmesh()->num_elems() << " elements" << std::endl;
+
+  auto byRow = timedBuild(mesh, false);
+  auto byElement = timedBuild(mesh, true);
+  ASSERT_THAT(byRow, NotNull());
+  ASSERT_THAT(byElement, NotNull());
+
+  EXPECT_EQ(byRow->nonZeros(), byElement->nonZeros());
+  EXPECT_TRUE(byRow->isApprox(*byElement));
+}
+
+namespace FEInputData
+{
+  DenseMatrixHandle conductivityTable(double conductivity)
+  {
+    auto table = boost::make_shared<DenseMatrix>(2, 1);
+    (*table) << 0.5, conductivity;
+    return table;
+  }
+
+  SparseRowMatrixHandle build(BuildFEMatrixAlgo& algo, FieldHandle mesh, DenseMatrixHandle table)
+  {
+    auto out = algo.run(withInputData((Variables::InputField, mesh)(BuildFEMatrixAlgo::Conductivity_Table, table)));
+    return out.get<SparseRowMatrix>(BuildFEMatrixAlgo::Stiffness_Matrix);
+  }
+}
+
+TEST(BuildFEMatrixAlgorithmTests, CachedPatternReassemblyMatchesFreshBuild)
+{
+  using namespace FEInputData;
+  auto mesh = generatedTetVol(12);
+  ASSERT_THAT(mesh, NotNull());
+
+  BuildFEMatrixAlgo cached;
+  auto first = build(cached, mesh, conductivityTable(1.0));
+  ASSERT_THAT(first, NotNull());
+  const SparseRowMatrix firstCopy(*first);
+
+  auto second = build(cached, mesh, conductivityTable(3.0));
+  ASSERT_THAT(second, NotNull());
+
+  // an output that is still held downstream must not be refilled in place
+  EXPECT_NE(first, second);
+  EXPECT_TRUE(firstCopy.isApprox(*first));
+
+  BuildFEMatrixAlgo fresh;
+  fresh.set(BuildFEMatrixAlgo::CacheSparsityPattern, false);
+  auto expected = build(fresh, mesh, conductivityTable(3.0));
+  ASSERT_THAT(expected, NotNull());
+
+  EXPECT_EQ(expected->nonZeros(), second->nonZeros());
+  EXPECT_TRUE(expected->isApprox(*second));
+  EXPECT_TRUE(second->isApprox(3.0 * *first));
+
+  auto third = build(cached, mesh, conductivityTable(1.0));
+  ASSERT_THAT(third, NotNull());
+  EXPECT_TRUE(firstCopy.isApprox(*third));
+
+  // a different mesh must not pick up the cached pattern
+  auto otherMesh = generatedTetVol(10);
+  auto other = build(cached, otherMesh, conductivityTable(1.0));
+  auto otherExpected = build(fresh, otherMesh, conductivityTable(1.0));
+  ASSERT_THAT(other, NotNull());
+  EXPECT_EQ(otherExpected->nrows(), other->nrows());
+  EXPECT_TRUE(otherExpected->isApprox(*other));
+}
+
+namespace FEInputData
+{
+  // Swap the labels of two nodes in place: same geometry and counts, different connectivity
+  // swaps two nodes in place; the TetVolMesh calls keep its synchronized
+  // neighbor tables current, which the VMesh interface does not
+  void relabelNodes(FieldHandle field, index_type a, index_type b)
+  {
+    typedef TetVolMesh<TetLinearLgn<Point> > TVMesh;
+    auto mesh = boost::dynamic_pointer_cast<TVMesh>(field->mesh());
+    ASSERT_THAT(mesh, NotNull());
+
+    Point pa, pb;
+    mesh->get_point(pa, TVMesh::Node::index_type(a));
+    mesh->get_point(pb, TVMesh::Node::index_type(b));
+    mesh->set_point(pb, TVMesh::Node::index_type(a));
+    mesh->set_point(pa, TVMesh::Node::index_type(b));
+
+    TVMesh::Node::array_type nodes;
+    TVMesh::Cell::size_type numCells;
+    mesh->size(numCells);
+    for (index_type c = 0; c < numCells; ++c)
+    {
+      mesh->get_nodes(nodes, TVMesh::Cell::index_type(c));
+      for (auto& n : nodes)
+      {
+        if (n == a)
+          n = b;
+        else if (n == b)
+          n = a;
+      }
+      mesh->set_nodes(nodes, TVMesh::Cell::index_type(c));
+    }
+  }
+}
+
+TEST(BuildFEMatrixAlgorithmTests, CachedPatternIsNotReusedAfterInPlaceMeshEdit)
+{
+  using namespace FEInputData;
+  auto mesh = generatedTetVol(8);
+  ASSERT_THAT(mesh, NotNull());
+
+  BuildFEMatrixAlgo cached;
+  ASSERT_THAT(build(cached, mesh, conductivityTable(1.0)), NotNull());
+
+  relabelNodes(mesh, 0, mesh->vmesh()->num_nodes() - 1);
+
+  BuildFEMatrixAlgo fresh;
+  fresh.set(BuildFEMatrixAlgo::CacheSparsityPattern, false);
+  auto expected = build(fresh, mesh, conductivityTable(1.0));
+  auto edited = build(cached, mesh, conductivityTable(1.0));
+  ASSERT_THAT(expected, NotNull());
+  ASSERT_THAT(edited, NotNull());
+  EXPECT_TRUE(expected->isApprox(*edited));
+}
+
+TEST(BuildFEMatrixAlgorithmTests, CachedPatternTimingOnGeneratedTetVol)
+{
+  using namespace FEInputData;
+  auto mesh = generatedTetVol(40);
+  ASSERT_THAT(mesh, NotNull());
+
+  BuildFEMatrixAlgo algo;
+  SparseRowMatrixHandle output;
+  {
+    ScopedTimer t("assembly with symbolic phase");
+    output = build(algo, mesh, conductivityTable(1.0));
+  }
+  output.reset();
+  {
+    ScopedTimer t("numeric-only reassembly");
+    output = build(algo, mesh, conductivityTable(2.0));
+  }
+  ASSERT_THAT(output, NotNull());
+}
@@ -137,11 +137,12 @@ bool ErodeFieldDataNodeV(AlgoBase *algo, FieldHandle input, FieldHandle& output)
   VMesh::Node::size_type sz;
   vmesh->size(sz);
 
-  DATA* idata = reinterpret_cast<DATA*>(input->vfield()->fdata_pointer());
   DATA* odata = reinterpret_cast<DATA*>(output->vfield()->fdata_pointer());
 
   for (int p=0; p <num_iter; p++)
   {
+    // fetched per pass: copy_values below gives the buffer its own values
+    const DATA* idata = reinterpret_cast<const DATA*>(input->vfield()->get_const_values_pointer());
 
     VMesh::Node::array_type nodes;
     DATA val, nval;
@@ -196,11 +197,12 @@ bool ErodeFieldDataElemV(AlgoBase *algo, FieldHandle input, FieldHandle& output)
   VMesh::Elem::size_type sz;
   vmesh->size(sz);
 
-  DATA* idata = reinterpret_cast<DATA*>(input->vfield()->fdata_pointer());
   DATA* odata = reinterpret_cast<DATA*>(output->vfield()->fdata_pointer());
 
   for (int p=0; p <num_iter; p++)
   {
+    // fetched per pass: copy_values below gives the buffer its own values
+    const DATA* idata = reinterpret_cast<const DATA*>(input->vfield()->get_const_values_pointer());
     VMesh::Elem::array_type elems;
     DATA val, nval;
 
@@ -80,10 +80,58 @@ namespace detail
     const AlgorithmBase* algo_;
 
   protected:
+    /// Calls body(idx, elem, coords, dist) with the source element closest to
+    /// the center of every destination entity idx in [start,end). The centers
+    /// are handled a block at a time: those inside the source mesh are located
+    /// together by locate_points (dist is 0), and only the rest need a closest
+    /// element search. Entities without any closest element are skipped.
+    template <class INDEX, class BODY>
+    void for_each_closest_elem(VField::index_type start, VField::index_type end,
+                               int proc, const BODY& body) const;
+
     int nproc_;
     Barrier  barrier_;
   };
 
+  template <class INDEX, class BODY>
+  void BuildMappingMatrixPAlgoBase::for_each_closest_elem(VField::index_type start,
+                                                          VField::index_type end,
+                                                          int proc, const BODY& body) const
+  {
+    const VField::index_type blockSize = 4096;
+    std::vector<Point> points;
+    std::vector<VMesh::Elem::index_type> elems;
+    std::vector<VMesh::coords_type> coords;
+
+    for (VField::index_type first=start; first<end; first+=blockSize)
+    {
+      const VField::index_type last = std::min(end,first+blockSize);
+      points.resize(last-first);
+      for (INDEX idx=first; idx<last;idx++)
+        dmesh_->get_center(points[idx-first],idx);
+
+      smesh_->locate_points(points,elems,coords);
+
+      for (INDEX idx=first; idx<last;idx++)
+      {
+        const size_t k = idx-first;
+        if (elems[k] >= 0)
+        {
+          body(idx,elems[k],coords[k],0.0);
+        }
+        else
+        {
+          Point r;
+          double dist;
+          VMesh::Elem::index_type didx;
+          if(smesh_->find_closest_elem(dist,r,coords[k],didx,points[k]))
+            body(idx,didx,coords[k],dist);
+        }
+      }
+      if (proc == 0) algo_->update_progress_max(last,end);
+    }
+  }
+
   class BuildMappingMatrixClosestDataPAlgo : public BuildMappingMatrixPAlgoBase
   {
   public:
@@ -108,44 +156,29 @@ namespace detail
 
     if (dfield_->basis_order() == 0 && sfield_->basis_order() == 0)
     {
-      Point p, r;
-      VMesh::coords_type coords;
-      VMesh::Elem::index_type didx;
-
-      for (VMesh::Elem::index_type idx=start; idx<end;idx++)
-      {
-        dmesh_->get_center(p,idx);
-        double dist;
-        if(smesh_->find_closest_elem(dist,r,coords,didx,p))
+      for_each_closest_elem<VMesh::Elem::index_type>(start,end,proc,
+        [this](VMesh::Elem::index_type idx, VMesh::Elem::index_type didx,
+               const VMesh::coords_type&, double dist)
         {
           if (maxdist_ < 0.0 || dist < maxdist_)
           {
             cc_[idx] = didx;
           }
           else cc_[idx] = -1;
-        }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
+        });
     }
     else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 0)
     {
-      Point p, r;
-      VMesh::coords_type coords;
-      VMesh::Elem::index_type didx;
-      for (VMesh::Node::index_type idx=start; idx<end;idx++)
-      {
-        dmesh_->get_center(p,idx);
-        double dist;
-        if(smesh_->find_closest_elem(dist,r,coords,didx,p))
+      for_each_closest_elem<VMesh::Node::index_type>(start,end,proc,
+        [this](VMesh::Node::index_type idx, VMesh::Elem::index_type didx,
+               const VMesh::coords_type&, double dist)
         {
           if (maxdist_ < 0.0 || dist < maxdist_)
           {
             cc_[idx] = didx;
           }
           else cc_[idx] = -1;
-        }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
+        });
     }
     else if (dfield_->basis_order() == 0 && sfield_->basis_order() == 1)
     {
@@ -365,6 +398,44 @@ namespace detail
         void parallel(int proc);
 
         size_type e_;
+
+  private:
+    void set_constant(index_type idx, index_type didx, double dist)
+    {
+      if (maxdist_ < 0.0 || dist < maxdist_)
+      {
+        cc_[idx] = didx;
+        vv_[idx] = 1.0;
+      }
+      else
+      {
+        cc_[idx] = -1;
+        vv_[idx] = 1.0;
+      }
+    }
+
+    void set_linear(index_type idx, VMesh::Elem::index_type didx,
+                    const VMesh::coords_type& coords, double dist,
+                    VMesh::ElemInterpolate& interp)
+    {
+      if (maxdist_ < 0.0 || dist < maxdist_)
+      {
+        smesh_->get_interpolate_weights(coords,didx,interp,1);
+        for (index_type j=0;j<e_;j++)
+        {
+          cc_[idx*e_+j] = interp.node_index[j];
+          vv_[idx*e_+j] = interp.weights[j];
+        }
+      }
+      else
+      {
+        for (index_type j=0;j<e_;j++)
+        {
+          cc_[idx*e_+j] = -1;
+          vv_[idx*e_+j] = 0.0;
+        }
+      }
+    }
   };
 
   void BuildMappingMatrixInterpolatedDataPAlgo::parallel(int proc)
@@ -378,123 +449,43 @@ namespace detail
 
     barrier_.wait();
 
-    int cnt = 0;
-
     if (dfield_->basis_order() == 0 && sfield_->basis_order() == 0)
     {
-      Point p, r;
-      VMesh::Elem::index_type didx;
-
-      for (VMesh::Elem::index_type idx=start; idx<end;idx++)
-      {
-        dmesh_->get_center(p,idx);
-
-        double dist;
-        if(smesh_->find_closest_elem(dist,r,didx,p))
+      for_each_closest_elem<VMesh::Elem::index_type>(start,end,proc,
+        [this](VMesh::Elem::index_type idx, VMesh::Elem::index_type didx,
+               const VMesh::coords_type&, double dist)
         {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            cc_[idx] = didx;
-            vv_[idx] = 1.0;
-          }
-          else
-          {
-            cc_[idx] = -1;
-            vv_[idx] = 1.0;
-          }
-        }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
+          set_constant(idx,didx,dist);
+        });
     }
     else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 0)
     {
-      Point p, r;
-      VMesh::Elem::index_type didx;
-      for (VMesh::Node::index_type idx=start; idx<end;idx++)
-      {
-        dmesh_->get_center(p,idx);
-        double dist;
-        if(smesh_->find_closest_elem(dist,r,didx,p))
+      for_each_closest_elem<VMesh::Node::index_type>(start,end,proc,
+        [this](VMesh::Node::index_type idx, VMesh::Elem::index_type didx,
+               const VMesh::coords_type&, double dist)
         {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            cc_[idx] = didx;
-            vv_[idx] = 1.0;
-          }
-          else
-          {
-            cc_[idx] = -1;
-            vv_[idx] = 1.0;
-          }
-        }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
+          set_constant(idx,didx,dist);
+        });
     }
     else if (dfield_->basis_order() == 0 && sfield_->basis_order() == 1)
     {
-      Point p, r;
-      VMesh::coords_type coords;
-      VMesh::Elem::index_type didx;
       VMesh::ElemInterpolate interp;
-      for (VMesh::Elem::index_type idx=start; idx<end;idx++)
-      {
-        dmesh_->get_center(p,idx);
-        double dist;
-        if(smesh_->find_closest_elem(dist,r,coords,didx,p))
+      for_each_closest_elem<VMesh::Elem::index_type>(start,end,proc,
+        [this,&interp](VMesh::Elem::index_type idx, VMesh::Elem::index_type didx,
+                       const VMesh::coords_type& coords, double dist)
         {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            smesh_->get_interpolate_weights(coords,didx,interp,1);
-            for (index_type j=0;j<e_;j++)
-            {
-              cc_[idx*e_+j] = interp.node_index[j];
-              vv_[idx*e_+j] = interp.weights[j];
-            }
-          }
-          else
-          {
-            for (index_type j=0;j<e_;j++)
-            {
-              cc_[idx*e_+j] = -1;
-              vv_[idx*e_+j] = 0.0;
-            }
-          }
-        }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
+          set_linear(idx,didx,coords,dist,interp);
+        });
     }
     else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 1)
     {
-      Point p, r;
-      VMesh::coords_type coords;
-      VMesh::Elem::index_type didx;
       VMesh::ElemInterpolate interp;
-      for (VMesh::Node::index_type idx=start; idx<end;idx++)
-      {
-        dmesh_->get_center(p,idx);
-        double dist;
-        if(smesh_->find_closest_elem(dist,r,coords,didx,p))
+      for_each_closest_elem<VMesh::Node::index_type>(start,end,proc,
+        [this,&interp](VMesh::Node::index_type idx, VMesh::Elem::index_type didx,
+                       const VMesh::coords_type& coords, double dist)
         {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            smesh_->get_interpolate_weights(coords,didx,interp,1);
-            for (index_type j=0;j<e_;j++)
-            {
-              cc_[idx*e_+j] = interp.node_index[j];
-              vv_[idx*e_+j] = interp.weights[j];
-            }
-          }
-          else
-          {
-            for (index_type j=0;j<e_;j++)
-            {
-              cc_[idx*e_+j] = -1;
-              vv_[idx*e_+j] = 0.0;
-            }
-          }
-        }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
+          set_linear(idx,didx,coords,dist,interp);
+        });
     }
 
     barrier_.wait();
@@ -572,7 +563,7 @@ bool BuildMappingMatrixAlgo::runImpl(FieldHandle source, FieldHandle destination
     n = sfield->num_values();
     nnz = m;
 
-    if (sbasis_order == 0) smesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
+    if (sbasis_order == 0) smesh->synchronize(Mesh::ELEM_LOCATE_E|Mesh::FIND_CLOSEST_ELEM_E);
     else smesh->synchronize(Mesh::FIND_CLOSEST_NODE_E);
   }
   else if(method == "singledestination")
@@ -590,7 +581,7 @@ bool BuildMappingMatrixAlgo::runImpl(FieldHandle source, FieldHandle destination
     n = sfield->num_values();
     if (smesh->num_elems() > 0)
     {
-      smesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
+      smesh->synchronize(Mesh::ELEM_LOCATE_E|Mesh::FIND_CLOSEST_ELEM_E);
       VMesh::coords_type cs; cs[0] =0.0; cs[1] = 0.0; cs[2] = 0.0;
       VMesh::ElemInterpolate ei;
       smesh->get_interpolate_weights(cs,0,ei,sbasis_order);
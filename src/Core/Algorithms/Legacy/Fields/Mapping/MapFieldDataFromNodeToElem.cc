@@ -73,7 +73,7 @@ MapFieldDataFromNodeToElemT(const MapFieldDataFromNodeToElemAlgo* algo,
   VMesh::Elem::iterator it, eit;
   VMesh::Elem::size_type sz;
 
-  VMesh::Node::array_type nodearray;
+  VMesh::Node::fixed_array_type nodearray;
 
   mesh->begin(it);
   mesh->end(eit);
@@ -86,7 +86,7 @@ MapFieldDataFromNodeToElemT(const MapFieldDataFromNodeToElemAlgo* algo,
     while (it != eit)
     {
       Interruptible::checkForInterruption();
-      mesh->get_nodes(nodearray, *it);
+      mesh->get_elem_nodes(nodearray, *it);
       size_t nsize = nodearray.size();
       DATA val(0);
       for (size_t p = 0; p < nsize; p++)
@@ -111,7 +111,7 @@ MapFieldDataFromNodeToElemT(const MapFieldDataFromNodeToElemAlgo* algo,
     while (it != eit)
     {
       Interruptible::checkForInterruption();
-      mesh->get_nodes(nodearray, *it);
+      mesh->get_elem_nodes(nodearray, *it);
       size_t nsize = nodearray.size();
       DATA val(0);
       DATA tval(0);
@@ -140,7 +140,7 @@ MapFieldDataFromNodeToElemT(const MapFieldDataFromNodeToElemAlgo* algo,
     while (it != eit)
     {
       Interruptible::checkForInterruption();
-      mesh->get_nodes(nodearray, *it);
+      mesh->get_elem_nodes(nodearray, *it);
       size_t nsize = nodearray.size();
       DATA val(0);
       if (nsize > 0)
@@ -168,7 +168,7 @@ MapFieldDataFromNodeToElemT(const MapFieldDataFromNodeToElemAlgo* algo,
     while (it != eit)
     {
       Interruptible::checkForInterruption();
-      mesh->get_nodes(nodearray, *it);
+      mesh->get_elem_nodes(nodearray, *it);
       size_t nsize = nodearray.size();
       DATA val(0);
       for (size_t p = 0; p < nsize; p++)
@@ -192,7 +192,7 @@ MapFieldDataFromNodeToElemT(const MapFieldDataFromNodeToElemAlgo* algo,
     while (it != eit)
     {
       Interruptible::checkForInterruption();
-      mesh->get_nodes(nodearray, *it);
+      mesh->get_elem_nodes(nodearray, *it);
       size_t nsize = nodearray.size();
       valarray.resize(nsize);
       for (size_t p = 0; p < nsize; p++)
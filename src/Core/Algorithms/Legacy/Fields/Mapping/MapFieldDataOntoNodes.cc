@@ -70,6 +70,14 @@ class MapFieldDataOntoNodesPAlgo : public Interruptible
 
     void parallel(int proc);
 
+    /// Destination nodes gathered into one batched get_data call, so that
+    /// the source mesh can locate them together.
+    static const VMesh::size_type BlockSize = 4096;
+
+    template <class T>
+    void map_values(const MappingDataSource* datasource, VField::index_type start,
+                    VField::index_type end, int proc);
+
     FieldHandle sfield_;
     FieldHandle wfield_;
     FieldHandle ofield_;
@@ -116,65 +124,64 @@ MapFieldDataOntoNodesPAlgo::parallel(int proc)
   VField::index_type      end = localsize*(proc+1);
   if (proc == nproc-1) end = num_nodes;
 
-  int cnt = 0;
   if (is_flux_)
   {
     // To compute flux through a surface
-    Point p; Vector val; Vector norm;
-    for (VMesh::Node::index_type idx=start; idx<end; idx++)
+    std::vector<Point> points; std::vector<Vector> vals; Vector norm;
+    for (VField::index_type first=start; first<end; first+=BlockSize)
     {
       checkForInterruption();
-      omesh->get_center(p,idx);
-      omesh->get_normal(norm,idx);
-      datasource->get_data(val,p);
-      ofield->set_value(Dot(val,norm),idx);
-      if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
+      const VField::index_type last = std::min<VField::index_type>(end,first+BlockSize);
+      points.resize(last-first);
+      for (VMesh::Node::index_type idx=first; idx<last; idx++)
+        omesh->get_center(points[idx-first],idx);
+      datasource->get_data(vals,points);
+      for (VMesh::Node::index_type idx=first; idx<last; idx++)
+      {
+        omesh->get_normal(norm,idx);
+        ofield->set_value(Dot(vals[idx-first],norm),idx);
+      }
+      if (proc == 0) algo_->update_progress_max(last,end);
     }
   }
   else
   {
     // To map value, gradient, or gradientnorm
     if (datasource->is_scalar())
-    {
-      Point p; double val;
-      for (VMesh::Node::index_type idx=start; idx<end; idx++)
-      {
-        checkForInterruption();
-        omesh->get_center(p,idx);
-        datasource->get_data(val,p);
-        ofield->set_value(val,idx);
-        if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
-    }
+      map_values<double>(datasource.get(),start,end,proc);
     else if (datasource->is_vector())
-    {
-      Point p; Vector val;
-      for (VMesh::Node::index_type idx=start; idx<end; idx++)
-      {
-        checkForInterruption();
-        omesh->get_center(p,idx);
-        datasource->get_data(val,p);
-        ofield->set_value(val,idx);
-        if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
-    }
+      map_values<Vector>(datasource.get(),start,end,proc);
     else
-    {
-      Point p; Tensor val;
-      for (VMesh::Node::index_type idx=start; idx<end; idx++)
-      {
-        checkForInterruption();
-        omesh->get_center(p,idx);
-        datasource->get_data(val,p);
-        ofield->set_value(val,idx);
-        if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
-    }
+      map_values<Tensor>(datasource.get(),start,end,proc);
   }
   // Wait until all of the threads are done
   success_[proc] = true;
   barrier_.wait();
 }
+
+template <class T>
+void
+MapFieldDataOntoNodesPAlgo::map_values(const MappingDataSource* datasource,
+                                       VField::index_type start,
+                                       VField::index_type end, int proc)
+{
+  VMesh* omesh = ofield_->vmesh();
+  VField* ofield = ofield_->vfield();
+
+  std::vector<Point> points; std::vector<T> vals;
+  for (VField::index_type first=start; first<end; first+=BlockSize)
+  {
+    checkForInterruption();
+    const VField::index_type last = std::min<VField::index_type>(end,first+BlockSize);
+    points.resize(last-first);
+    for (VMesh::Node::index_type idx=first; idx<last; idx++)
+      omesh->get_center(points[idx-first],idx);
+    datasource->get_data(vals,points);
+    for (VMesh::Node::index_type idx=first; idx<last; idx++)
+      ofield->set_value(vals[idx-first],idx);
+    if (proc == 0) algo_->update_progress_max(last,end);
+  }
+}
 }
 
 bool
@@ -596,70 +596,17 @@ class ClosestInterpolatedDataSource : public MappingDataSource {
 
     virtual void get_data(std::vector<double>& data, const std::vector<Point>& p) const override
     {
-      data.resize(p.size());
-      for (size_t j=0; j<p.size(); j++)
-      {
-        if(!(sfield_->interpolate(data[j],p[j],def_value_)))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          if(smesh_->find_closest_elem(dist,r,coords,elem,p[j],maxdist_))
-          {
-            sfield_->interpolate(data[j],coords,elem);
-          }
-          else
-          {
-            data[j] = def_value_;
-          }
-        }
-      }
+      get_batch_data(data, p, def_value_);
     }
 
     virtual void get_data(std::vector<Vector>& data, const std::vector<Point>& p) const override
     {
-      data.resize(p.size());
-      for (size_t j=0; j<p.size(); j++)
-      {
-        if(!(sfield_->interpolate(data[j],p[j],Vector(0,0,0))))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          smesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            sfield_->interpolate(data[j],coords,elem);
-          }
-          else
-          {
-            data[j] = Vector(0.0,0.0,0.0);
-          }
-        }
-      }
+      get_batch_data(data, p, Vector(0.0,0.0,0.0));
     }
 
     virtual void get_data(std::vector<Tensor>& data, const std::vector<Point>& p) const override
     {
-      data.resize(p.size());
-      for (size_t j=0; j<p.size(); j++)
-      {
-        if(!(sfield_->interpolate(data[j],p[j],Tensor(def_value_))))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          smesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            sfield_->interpolate(data[j],coords,elem);
-          }
-          else
-          {
-            data[j] = Tensor(def_value_);
-          }
-        }
-      }
+      get_batch_data(data, p, Tensor(def_value_));
     }
 
     ClosestInterpolatedDataSource(FieldHandle sfield,double def_value,double max_dist)
@@ -676,6 +623,40 @@ class ClosestInterpolatedDataSource : public MappingDataSource {
     }
 
   private:
+    /// Locate the whole batch at once; only the points outside the mesh
+    /// fall back to a closest element search, limited to maxdist_. Points
+    /// without an element in range get the default value, as in get_data.
+    template <class T>
+    void get_batch_data(std::vector<T>& data, const std::vector<Point>& p, const T& def_value) const
+    {
+      std::vector<VMesh::Elem::index_type> elems;
+      std::vector<VMesh::coords_type> coords;
+      smesh_->locate_points(p,elems,coords);
+
+      data.resize(p.size());
+      for (size_t j=0; j<p.size(); j++)
+      {
+        if (elems[j] >= 0)
+        {
+          sfield_->interpolate(data[j],coords[j],elems[j]);
+        }
+        else
+        {
+          double dist; Point r;
+          VMesh::Elem::index_type elem;
+          VMesh::coords_type c;
+          if (smesh_->find_closest_elem(dist,r,c,elem,p[j],maxdist_) && dist < maxdist_)
+          {
+            sfield_->interpolate(data[j],c,elem);
+          }
+          else
+          {
+            data[j] = def_value;
+          }
+        }
+      }
+    }
+
     double  maxdist_;
     VField *sfield_;
     VMesh  *smesh_;
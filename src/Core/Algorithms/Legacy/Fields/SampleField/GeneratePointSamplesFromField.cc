@@ -81,26 +81,35 @@ GeneratePointSamplesFromFieldAlgoF::build_table(VMesh *vmesh,
 {
   VMesh::size_type num_elems = vmesh->num_elems();
 
+  // The importance methods sample the data at every element center: locate
+  // all of the centers in one batch.
+  std::vector<VMesh::Elem::index_type> elems;
+  std::vector<VMesh::coords_type> coords;
+  if (method == "impuni" || method == "impscat")
+  {
+    std::vector<Point> centers(num_elems);
+    for (VMesh::Elem::index_type idx=0; idx<num_elems; idx++)
+      vmesh->get_center(centers[idx], idx);
+    vmesh->locate_points(centers, elems, coords);
+  }
+
   long double sum = 0.0;
   for (VMesh::Elem::index_type idx=0; idx<num_elems; idx++)
   {
     double elemsize = 0.0;
     if (method == "impuni")
     { // Size of element * data at element.
-      Point p;
-      vmesh->get_center(p, idx);
-      if (vfield->is_vector())
+      if (elems[idx] >= 0 && vfield->is_vector())
       {
         Vector v;
-        if (vfield->interpolate(v, p))
-        {
-          elemsize = v.length() * vmesh->get_size(idx);
-        }
+        vfield->interpolate(v, coords[idx], elems[idx]);
+        elemsize = v.length() * vmesh->get_size(idx);
       }
-      if (vfield->is_scalar())
+      if (elems[idx] >= 0 && vfield->is_scalar())
       {
         double d;
-        if (vfield->interpolate(d, p) && d > 0.0)
+        vfield->interpolate(d, coords[idx], elems[idx]);
+        if (d > 0.0)
         {
           elemsize = d * vmesh->get_size(idx);
         }
@@ -108,20 +117,17 @@ GeneratePointSamplesFromFieldAlgoF::build_table(VMesh *vmesh,
     }
     else if (method == "impscat")
     { // data at element
-      Point p;
-      vmesh->get_center(p, idx);
-      if (vfield->is_vector())
+      if (elems[idx] >= 0 && vfield->is_vector())
       {
         Vector v;
-        if (vfield->interpolate(v, p))
-        {
-          elemsize = v.length();
-        }
+        vfield->interpolate(v, coords[idx], elems[idx]);
+        elemsize = v.length();
       }
-      if (vfield->is_scalar())
+      if (elems[idx] >= 0 && vfield->is_scalar())
       {
         double d;
-        if (vfield->interpolate(d, p) && d > 0.0)
+        vfield->interpolate(d, coords[idx], elems[idx]);
+        if (d > 0.0)
         {
           elemsize = d;
         }
@@ -230,8 +236,8 @@ GeneratePointSamplesFromFieldAlgo::runImpl(FieldHandle input, FieldHandle& outpu
     if (clamp)
     {
       // Find a random node in that cell.
-      VMesh::Node::array_type ra;
-      mesh->get_nodes(ra, (*loc).second);
+      VMesh::Node::fixed_array_type ra;
+      mesh->get_elem_nodes(ra, (*loc).second);
       auto index = static_cast<size_t>(rng()*ra.size());
       mesh->get_center(p, ra[index]);
     }
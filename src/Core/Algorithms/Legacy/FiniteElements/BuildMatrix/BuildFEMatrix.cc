@@ -46,6 +46,7 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <cstdint>
 #include <boost/shared_array.hpp>
 
 using namespace SCIRun;
@@ -66,14 +67,58 @@ namespace SCIRun {
         template <typename T>
         using matrix_pointer_type = boost::shared_ptr<matrix_type<T>>;
 
+/// Symbolic part of a stiffness matrix: the CSR structure and the element coloring
+/// only depend on the mesh topology, so they are kept between runs on an unchanged one.
+class FEMatrixPattern
+{
+public:
+  /// Topology counts plus a hash of the element connectivity. Meshes are not
+  /// versioned and can be edited in place, so the connectivity itself is compared
+  /// rather than the mesh object; moving nodes keeps the pattern.
+  struct Key
+  {
+    uint64_t topology_hash;
+    size_type num_nodes;
+    size_type num_elems;
+    size_type nodes_per_elem;
+    index_type dimension;
+
+    bool operator==(const Key& other) const
+    {
+      return topology_hash == other.topology_hash && num_nodes == other.num_nodes &&
+        num_elems == other.num_elems && nodes_per_elem == other.nodes_per_elem &&
+        dimension == other.dimension;
+    }
+  };
+
+  explicit FEMatrixPattern(const Key& key) : key_(key)
+  {
+  }
+
+  bool matches(const Key& key) const
+  {
+    return key == key_;
+  }
+
+  std::vector<index_type> rows_;
+  std::vector<index_type> cols_;
+  std::vector<index_type> color_offsets_;
+  std::vector<VMesh::Elem::index_type> colored_elems_;
+
+private:
+  Key key_;
+};
+
 template <typename T>
 class BuildFEMatrixAlgoImpl
 {
 public:
-  explicit BuildFEMatrixAlgoImpl(const AlgorithmBase* algo) : algo_(algo) {}
+  BuildFEMatrixAlgoImpl(const AlgorithmBase* algo, boost::shared_ptr<FEMatrixPattern>& pattern) :
+    algo_(algo), pattern_(pattern) {}
   bool run(FieldHandle input, Datatypes::DenseMatrixHandle ctable, matrix_pointer_type<T>& output) const;
 private:
   const AlgorithmBase* algo_;
+  boost::shared_ptr<FEMatrixPattern>& pattern_;
   mutable int generation_ = 0;
   mutable std::vector<std::vector<T>> basis_values_;
   mutable matrix_pointer_type<T> basis_fematrix_;
@@ -84,9 +129,12 @@ template <typename T>
 class FEMBuilder
 {
 public:
-  explicit FEMBuilder(const AlgorithmBase* algo) :
+  FEMBuilder(const AlgorithmBase* algo, boost::shared_ptr<FEMatrixPattern>& pattern) :
     algo_(algo), numprocessors_(Parallel::NumCores()),
     barrier_("FEMBuilder Barrier", numprocessors_),
+    element_assembly_(algo->get(BuildFEMatrixAlgo::ElementAssembly).toBool()),
+    cache_pattern_(algo->get(BuildFEMatrixAlgo::CacheSparsityPattern).toBool()),
+    pattern_(pattern), use_cached_pattern_(false), topology_hash_(0),
     mesh_(nullptr), field_(nullptr),
     domain_dimension(0), local_dimension_nodes(0),
     local_dimension_add_nodes(0),
@@ -107,6 +155,12 @@ private:
   const AlgorithmBase* algo_;
   int numprocessors_;
   Barrier barrier_;
+  bool element_assembly_;
+  bool cache_pattern_;
+
+  boost::shared_ptr<FEMatrixPattern>& pattern_;
+  bool use_cached_pattern_;
+  uint64_t topology_hash_;
 
   VMesh* mesh_;
   VField *field_;
@@ -119,6 +173,11 @@ private:
   boost::shared_array<index_type> allcols_;
   std::vector<index_type> colidx_;
 
+  // Elements bucketed by color for element assembly: the elements of color c are
+  // colored_elems_[color_offsets_[c]] .. colored_elems_[color_offsets_[c+1]-1]
+  std::vector<index_type> color_offsets_;
+  std::vector<VMesh::Elem::index_type> colored_elems_;
+
   index_type domain_dimension;
 
   index_type local_dimension_nodes;
@@ -137,6 +196,19 @@ private:
 
   // Entry point for the parallel version
   void parallel(int proc);
+  void parallel_element_assembly(int proc);
+  bool parallel_structure(int proc, index_type start_gd, index_type end_gd);
+  void create_matrix(const index_type* rows, const index_type* cols, index_type nnz);
+  void store_pattern();
+  uint64_t hash_topology() const;
+  FEMatrixPattern::Key pattern_key() const
+  {
+    return { topology_hash_, mesh_->num_nodes(), mesh_->num_elems(),
+      mesh_->num_nodes_per_elem(), global_dimension };
+  }
+
+  Tensor element_tensor(VMesh::Elem::index_type c_ind) const;
+  void color_elements();
 
   void add_lcl_gbl(index_type row, const std::vector<index_type> &cols, const std::vector<T> &lcl_a)
   {
@@ -144,6 +216,28 @@ private:
       fematrix_->coeffRef(row, cols[i]) += lcl_a[i];
   }
 
+  // Scatter a full local stiffness matrix into the precomputed sparsity pattern
+  void add_element_lcl_gbl(const VMesh::Node::fixed_array_type& nodes, const std::vector<T>& l_stiff)
+  {
+    const auto outer = fematrix_->outerIndexPtr();
+    const auto inner = fematrix_->innerIndexPtr();
+    auto values = fematrix_->valuePtr();
+    const size_t n = nodes.size();
+    for (size_t r = 0; r < n; r++)
+    {
+      const auto rowBegin = inner + outer[nodes[r]];
+      const auto rowEnd = inner + outer[nodes[r]+1];
+      for (size_t c = 0; c < n; c++)
+      {
+        const auto pos = std::lower_bound(rowBegin, rowEnd, static_cast<index_type>(nodes[c]));
+        if (pos == rowEnd || *pos != static_cast<index_type>(nodes[c]))
+          BOOST_THROW_EXCEPTION(AlgorithmProcessingException()
+            << ErrorMessage("BuildFEMatrix: element coupling is missing from the precomputed sparsity pattern"));
+        values[pos - inner] += l_stiff[r*n+c];
+      }
+    }
+  }
+
   void create_numerical_integration(std::vector<VMesh::coords_type>& p,
                                     std::vector<double>& w,
                                     std::vector<std::vector<double>>& d);
@@ -160,6 +254,13 @@ private:
                                   std::vector<double>& w,
                                   std::vector<std::vector<double>>& d,
                                   std::vector<std::vector<T>>& precompute);
+  bool build_local_element_matrix(VMesh::Elem::index_type c_ind,
+                                  std::vector<T>& l_stiff,
+                                  std::vector<double>& gradients,
+                                  std::vector<VMesh::coords_type>& p,
+                                  std::vector<double>& w,
+                                  std::vector<std::vector<double>>& d,
+                                  std::vector<std::vector<double>>& precompute);
   bool setup();
 
 };
@@ -267,6 +368,11 @@ FEMBuilder<T>::build_matrix(FieldHandle input,
     }
   }
 
+  if (cache_pattern_)
+    store_pattern();
+  else
+    pattern_.reset();
+
   // Make sure it is symmetric
   if (algo_->get(BuildFEMatrixAlgo::ForceSymmetry).toBool())
   {
@@ -284,6 +390,28 @@ FEMBuilder<T>::build_matrix(FieldHandle input,
   return true;
 }
 
+template <typename T>
+Tensor
+FEMBuilder<T>::element_tensor(VMesh::Elem::index_type c_ind) const
+{
+  Tensor tensor;
+
+  if (tensors_.empty())
+  {
+    // Call to virtual interface. Get the tensor value. Actually this call relies
+    // on the automatic casting feature of the virtual interface to convert scalar
+    // values into a tensor.
+    field_->get_value(tensor,c_ind);
+  }
+  else
+  {
+    int tensor_index;
+    field_->get_value(tensor_index,c_ind);
+    tensor = tensors_[tensor_index].second;
+  }
+  return tensor;
+}
+
 template <typename T>
 void
 FEMBuilder<T>::create_numerical_integration(std::vector<VMesh::coords_type> &p,
@@ -321,18 +449,7 @@ FEMBuilder<T>::build_local_matrix(VMesh::Elem::index_type c_ind,
                                std::vector<double> &w,
                                std::vector<std::vector<double>>  &d)
 {
-  Tensor tensor;
-
-  if (tensors_.empty())
-  {
-    field_->get_value(tensor,c_ind);
-  }
-  else
-  {
-    int tensor_index;
-    field_->get_value(tensor_index,c_ind);
-    tensor = tensors_[tensor_index].second;
-  }
+  auto tensor = element_tensor(c_ind);
 
   auto Ca = tensor.val(0,0);
   auto Cb = tensor.val(0,1);
@@ -434,21 +551,7 @@ FEMBuilder<T>::build_local_matrix_regular(VMesh::Elem::index_type c_ind,
                                        std::vector<std::vector<double>> &d,
                                        std::vector<std::vector<T>> &precompute)
 {
-  Tensor tensor;
-
-  if (tensors_.empty())
-  {
-    // Call to virtual interface. Get the tensor value. Actually this call relies
-    // on the automatic casting feature of the virtual interface to convert scalar
-    // values into a tensor.
-    field_->get_value(tensor,c_ind);
-  }
-  else
-  {
-    int tensor_index;
-    field_->get_value(tensor_index,c_ind);
-    tensor = tensors_[tensor_index].second;
-  }
+  auto tensor = element_tensor(c_ind);
 
   auto Ca = tensor.val(0,0);
   auto Cb = tensor.val(0,1);
@@ -606,6 +709,308 @@ FEMBuilder<T>::build_local_matrix_regular(VMesh::Elem::index_type c_ind,
   return true;
 }
 
+/// build the full local stiffness matrix (row major, local_dimension^2) of one element
+template <typename T>
+bool
+FEMBuilder<T>::build_local_element_matrix(VMesh::Elem::index_type c_ind,
+                                       std::vector<T> &l_stiff,
+                                       std::vector<double> &gradients,
+                                       std::vector<VMesh::coords_type> &p,
+                                       std::vector<double> &w,
+                                       std::vector<std::vector<double>> &d,
+                                       std::vector<std::vector<double>> &precompute)
+{
+  auto tensor = element_tensor(c_ind);
+
+  auto Ca = tensor.val(0,0);
+  auto Cb = tensor.val(0,1);
+  auto Cc = tensor.val(0,2);
+  auto Cd = tensor.val(1,1);
+  auto Ce = tensor.val(1,2);
+  auto Cf = tensor.val(2,2);
+
+  std::fill(l_stiff.begin(), l_stiff.end(), T(0.0));
+  if ( (Ca==0) && (Cb==0) && (Cc==0) && (Cd==0) && (Ce==0) && (Cf==0) )
+    return true;
+
+  auto local_dimension2=2*local_dimension;
+  // All elements of a regular mesh share their Jacobians, so these are computed
+  // for the first element only
+  const bool regular = mesh_->is_regularmesh();
+  const bool use_precompute = regular && !precompute.empty();
+  if (regular && !use_precompute)
+    precompute.resize(d.size(), std::vector<double>(10));
+
+  auto vol = mesh_->get_element_size();
+  gradients.resize(3*local_dimension);
+
+  for (size_t i = 0; i < d.size(); i++)
+  {
+    double Ji[9];
+    double detJ;
+    if (use_precompute)
+    {
+      std::copy(precompute[i].begin(), precompute[i].begin() + 9, Ji);
+      detJ = precompute[i][9];
+    }
+    else
+    {
+      detJ = mesh_->inverse_jacobian(p[i],c_ind,Ji);
+
+      // If Jacobian is negative there is a problem with the mesh
+      if (detJ <= 0.0)
+      {
+        algo_->error("Mesh has elements with negative jacobians, check the order of the nodes that define an element");
+        return false;
+      }
+
+      // Volume associated with the local Gaussian Quadrature point:
+      // weightfactor * Volume Unit element * Volume ratio (real element/unit element)
+      detJ *= w[i] * vol;
+
+      if (regular)
+      {
+        std::copy(Ji, Ji + 9, precompute[i].begin());
+        precompute[i][9] = detJ;
+      }
+    }
+
+    // Gradients of all basis functions in the real element, computed once and
+    // reused for every row of the local matrix
+    auto Nxi = &d[i][0];
+    auto Nyi = &d[i][local_dimension];
+    auto Nzi = &d[i][local_dimension2];
+    for (int j = 0; j < local_dimension; j++)
+    {
+      gradients[3*j]   = Nxi[j]*Ji[0] + Nyi[j]*Ji[1] + Nzi[j]*Ji[2];
+      gradients[3*j+1] = Nxi[j]*Ji[3] + Nyi[j]*Ji[4] + Nzi[j]*Ji[5];
+      gradients[3*j+2] = Nxi[j]*Ji[6] + Nyi[j]*Ji[7] + Nzi[j]*Ji[8];
+    }
+
+    for (int r = 0; r < local_dimension; r++)
+    {
+      const auto uxp = detJ*gradients[3*r];
+      const auto uyp = detJ*gradients[3*r+1];
+      const auto uzp = detJ*gradients[3*r+2];
+      // Matrix multiplication with conductivity tensor :
+      const auto uxyzpabc = uxp*Ca + uyp*Cb + uzp*Cc;
+      const auto uxyzpbde = uxp*Cb + uyp*Cd + uzp*Ce;
+      const auto uxyzpcef = uxp*Cc + uyp*Ce + uzp*Cf;
+
+      auto row = &l_stiff[r*local_dimension];
+      for (int j = 0; j < local_dimension; j++)
+        row[j] += gradients[3*j]*uxyzpabc + gradients[3*j+1]*uxyzpbde + gradients[3*j+2]*uxyzpcef;
+    }
+  }
+  return true;
+}
+
+/// Creates fematrix_ directly from its compressed row structure; the values are
+/// left uninitialized and zeroed by the threads that own the rows.
+template <typename T>
+void
+FEMBuilder<T>::create_matrix(const index_type* rows, const index_type* cols, index_type nnz)
+{
+  fematrix_ = boost::make_shared<matrix_type<T>>(global_dimension, global_dimension);
+  fematrix_->resizeNonZeros(nnz);
+  std::copy(rows, rows + global_dimension + 1, fematrix_->outerIndexPtr());
+  std::copy(cols, cols + nnz, fematrix_->innerIndexPtr());
+}
+
+/// FNV-1a over the node indices of every element, so a mesh edited in place with
+/// unchanged counts still gets a new pattern.
+template <typename T>
+uint64_t
+FEMBuilder<T>::hash_topology() const
+{
+  VMesh::Elem::size_type num_elems;
+  mesh_->size(num_elems);
+  VMesh::Node::fixed_array_type na;
+
+  uint64_t hash = 14695981039346656037ULL;
+  for (VMesh::Elem::index_type c = 0; c < num_elems; ++c)
+  {
+    mesh_->get_elem_nodes(na, c);
+    for (size_t k = 0; k < na.size(); ++k)
+    {
+      hash ^= static_cast<uint64_t>(na[k]);
+      hash *= 1099511628211ULL;
+    }
+  }
+  return hash;
+}
+
+template <typename T>
+void
+FEMBuilder<T>::store_pattern()
+{
+  if (!use_cached_pattern_)
+  {
+    auto pattern = boost::make_shared<FEMatrixPattern>(pattern_key());
+
+    const auto outer = fematrix_->outerIndexPtr();
+    const auto inner = fematrix_->innerIndexPtr();
+    pattern->rows_.assign(outer, outer + global_dimension + 1);
+    pattern->cols_.assign(inner, inner + fematrix_->nonZeros());
+    pattern_ = pattern;
+  }
+
+  pattern_->color_offsets_.swap(color_offsets_);
+  pattern_->colored_elems_.swap(colored_elems_);
+}
+
+/// Greedy element coloring: an element gets the lowest color not yet used by any
+/// element sharing one of its nodes. Colors are tracked as 64-bit masks per node;
+/// elements that find all 64 colors of a batch taken wait for the next batch.
+template <typename T>
+void
+FEMBuilder<T>::color_elements()
+{
+  VMesh::Elem::size_type num_elems;
+  mesh_->size(num_elems);
+
+  std::vector<int> color(num_elems, -1);
+  std::vector<uint64_t> used(global_dimension_nodes);
+  VMesh::Node::fixed_array_type na;
+
+  int num_colors = 0;
+  size_type uncolored = num_elems;
+  for (int base = 0; uncolored > 0; base += 64)
+  {
+    std::fill(used.begin(), used.end(), 0);
+    for (VMesh::Elem::index_type c = 0; c < num_elems; ++c)
+    {
+      if (color[c] >= 0)
+        continue;
+
+      mesh_->get_elem_nodes(na, c);
+      uint64_t taken = 0;
+      for (size_t k = 0; k < na.size(); k++)
+        taken |= used[na[k]];
+      if (~taken == 0)
+        continue;
+
+      int bit = 0;
+      while (taken & (uint64_t(1) << bit))
+        bit++;
+      for (size_t k = 0; k < na.size(); k++)
+        used[na[k]] |= uint64_t(1) << bit;
+
+      color[c] = base + bit;
+      num_colors = std::max(num_colors, base + bit + 1);
+      uncolored--;
+    }
+  }
+
+  // Bucket the elements by color with a counting sort
+  color_offsets_.assign(num_colors+1, 0);
+  for (size_type c = 0; c < num_elems; c++)
+    color_offsets_[color[c]+1]++;
+  for (int k = 0; k < num_colors; k++)
+    color_offsets_[k+1] += color_offsets_[k];
+
+  std::vector<index_type> fill(color_offsets_.begin(), color_offsets_.end()-1);
+  colored_elems_.resize(num_elems);
+  for (size_type c = 0; c < num_elems; c++)
+    colored_elems_[fill[color[c]]++] = c;
+
+  LOG_DEBUG("BuildFEMatrix colored {} elements with {} colors", num_elems, num_colors);
+}
+
+/// Element driven assembly: the elements of one color share no nodes, so the
+/// threads can scatter their local matrices into disjoint rows without locking.
+/// Only called after the sparsity pattern has been created and zeroed.
+template <typename T>
+void
+FEMBuilder<T>::parallel_element_assembly(int proc_num)
+{
+  if (proc_num == 0 && colored_elems_.empty())
+  {
+    try
+    {
+      color_elements();
+    }
+    catch (...)
+    {
+      algo_->error("BuildFEMatrix crashed while coloring elements");
+      success_[proc_num] = false;
+    }
+  }
+
+  barrier_.wait();
+
+  for (int q = 0; q < numprocessors_; q++)
+  {
+    if (!success_[q])
+      return;
+  }
+
+  std::vector<VMesh::coords_type> ni_points;
+  std::vector<double> ni_weights;
+  std::vector<std::vector<double>> ni_derivatives;
+  std::vector<std::vector<double>> precompute;
+  std::vector<double> gradients;
+  std::vector<T> lsm(local_dimension*local_dimension); ///< local stiffness matrix
+  VMesh::Node::fixed_array_type na;
+
+  try
+  {
+    create_numerical_integration(ni_points, ni_weights, ni_derivatives);
+  }
+  catch (...)
+  {
+    algo_->error("BuildFEMatrix could not create numerical integration scheme");
+    success_[proc_num] = false;
+  }
+
+  const int num_colors = static_cast<int>(color_offsets_.size()) - 1;
+  for (int color = 0; color < num_colors; color++)
+  {
+    if (success_[proc_num])
+    {
+      try
+      {
+        const auto color_size = color_offsets_[color+1] - color_offsets_[color];
+        const auto start = color_offsets_[color] + (color_size * proc_num)/numprocessors_;
+        const auto end = color_offsets_[color] + (color_size * (proc_num+1))/numprocessors_;
+        for (auto e = start; e < end; e++)
+        {
+          const auto c_ind = colored_elems_[e];
+          if (!build_local_element_matrix(c_ind, lsm, gradients, ni_points, ni_weights, ni_derivatives, precompute))
+          {
+            success_[proc_num] = false;
+            break;
+          }
+          mesh_->get_elem_nodes(na, c_ind);
+          add_element_lcl_gbl(na, lsm);
+        }
+      }
+      catch (const AlgorithmProcessingException& e)
+      {
+        algo_->error(e.what());
+        success_[proc_num] = false;
+      }
+      catch (...)
+      {
+        algo_->error("BuildFEMatrix crashed while filling out stiffness matrix");
+        success_[proc_num] = false;
+      }
+    }
+
+    /// no element of the next color may start before this color is scattered
+    barrier_.wait();
+
+    for (int q = 0; q < numprocessors_; q++)
+    {
+      if (!success_[q])
+        return;
+    }
+
+    if (proc_num == 0)
+      algo_->update_progress_max(num_colors + color + 1, 2*num_colors);
+  }
+}
+
 template <typename T>
 bool
 FEMBuilder<T>::setup()
@@ -650,70 +1055,61 @@ FEMBuilder<T>::setup()
     global_dimension_add_nodes = 0;
   }
 
+  // Element assembly only scatters node dofs
+  if (global_dimension_add_nodes > 0)
+    element_assembly_ = false;
+
   global_dimension_derivatives = 0;
   global_dimension = global_dimension_nodes+
   global_dimension_add_nodes+
   global_dimension_derivatives;
 
+  if (cache_pattern_)
+    topology_hash_ = hash_topology();
+  use_cached_pattern_ = cache_pattern_ && pattern_ && pattern_->matches(pattern_key());
+
+  if (use_cached_pattern_)
+  {
+    LOG_DEBUG("BuildFEMatrix reusing the sparsity pattern of topology {:x}", topology_hash_);
+    color_offsets_.swap(pattern_->color_offsets_);
+    colored_elems_.swap(pattern_->colored_elems_);
+  }
+
+  // Element assembly on a cached pattern only needs the element nodes
   if (mns > 0)
   {
-    // We only need edges for the higher order basis in case of quartic Lagrangian
-    // Hence we should only synchronize it for this case
-    if (global_dimension_add_nodes > 0)
-      mesh_->synchronize(Mesh::EDGES_E|Mesh::NODE_NEIGHBORS_E);
-    else
-      mesh_->synchronize(Mesh::NODE_NEIGHBORS_E);
+    if (!use_cached_pattern_ || !element_assembly_)
+    {
+      // We only need edges for the higher order basis in case of quartic Lagrangian
+      // Hence we should only synchronize it for this case
+      if (global_dimension_add_nodes > 0)
+        mesh_->synchronize(Mesh::EDGES_E|Mesh::NODE_NEIGHBORS_E);
+      else
+        mesh_->synchronize(Mesh::NODE_NEIGHBORS_E);
+    }
   }
   else
   {
     algo_->error("Mesh size < 0");
     success_[0] = false;
   }
-  LOG_DEBUG("Allocating buffer for nonzero row indices of size: {}", global_dimension+1);
-  rows_.reset(new index_type[global_dimension+1]);
+
+  if (!use_cached_pattern_)
+  {
+    LOG_DEBUG("Allocating buffer for nonzero row indices of size: {}", global_dimension+1);
+    rows_.reset(new index_type[global_dimension+1]);
+  }
 
   colidx_.resize(numprocessors_+1);
   return true;
 }
 
-// -- callback routine to execute in parallel
+/// Symbolic phase: gathers the nonzero columns of every row from the node
+/// neighborhoods and compresses them into the CSR structure of fematrix_.
 template <typename T>
-void
-FEMBuilder<T>::parallel(int proc_num)
+bool
+FEMBuilder<T>::parallel_structure(int proc_num, index_type start_gd, index_type end_gd)
 {
-  success_[proc_num] = true;
-
-  if (proc_num == 0)
-  {
-    try
-    {
-      success_[proc_num] = setup();
-    }
-    catch (...)
-    {
-      algo_->error("BuildFEMatrix could not setup FE Stiffness computation");
-      success_[proc_num] = false;
-    }
-  }
-
-  barrier_.wait();
-
-  // In case one of the threads fails, we should have them fail all
-  for (int q = 0; q < numprocessors_; q++)
-  {
-    if (!success_[q])
-    {
-      std::ostringstream oss;
-      oss << "FEMBuilder::setup failed in thread " << q;
-      algo_->error(oss.str());
-      return;
-    }
-  }
-
-  /// distributing dofs among processors
-  const index_type start_gd = (global_dimension * proc_num)/numprocessors_;
-  const index_type end_gd  = (global_dimension * (proc_num+1))/numprocessors_;
-
   /// creating sparse matrix structure
   std::vector<index_type> mycols;
 
@@ -813,11 +1209,10 @@ FEMBuilder<T>::parallel(int proc_num)
   {
     if (!success_[q])
     {
-      return;
+      return false;
     }
   }
 
-  std::vector<std::vector<T>> precompute;
   index_type st = 0;
 
   if (proc_num == 0)
@@ -855,7 +1250,7 @@ FEMBuilder<T>::parallel(int proc_num)
   for (int q=0; q<numprocessors_;q++)
   {
     if (! success_[q])
-      return;
+      return false;
   }
 
   try
@@ -885,7 +1280,7 @@ FEMBuilder<T>::parallel(int proc_num)
   for (auto q=0; q<numprocessors_; q++)
   {
     if (!success_[q])
-      return;
+      return false;
   }
 
   try
@@ -895,7 +1290,7 @@ FEMBuilder<T>::parallel(int proc_num)
     {
       rows_[global_dimension] = st;
       algo_->remark("Creating fematrix on main thread.");
-      fematrix_ = boost::make_shared<matrix_type<T>>(global_dimension, global_dimension, rows_.get(), allcols_.get(), st);
+      create_matrix(rows_.get(), allcols_.get(), st);
       rows_.reset();
       allcols_.reset();
     }
@@ -914,14 +1309,95 @@ FEMBuilder<T>::parallel(int proc_num)
   for (auto q=0; q<numprocessors_;q++)
   {
     if (!success_[q])
+      return false;
+  }
+
+  return true;
+}
+
+// -- callback routine to execute in parallel
+template <typename T>
+void
+FEMBuilder<T>::parallel(int proc_num)
+{
+  success_[proc_num] = true;
+
+  if (proc_num == 0)
+  {
+    try
+    {
+      success_[proc_num] = setup();
+    }
+    catch (...)
+    {
+      algo_->error("BuildFEMatrix could not setup FE Stiffness computation");
+      success_[proc_num] = false;
+    }
+  }
+
+  barrier_.wait();
+
+  // In case one of the threads fails, we should have them fail all
+  for (int q = 0; q < numprocessors_; q++)
+  {
+    if (!success_[q])
+    {
+      std::ostringstream oss;
+      oss << "FEMBuilder::setup failed in thread " << q;
+      algo_->error(oss.str());
       return;
+    }
   }
 
+  /// distributing dofs among processors
+  const index_type start_gd = (global_dimension * proc_num)/numprocessors_;
+  const index_type end_gd  = (global_dimension * (proc_num+1))/numprocessors_;
+
+  if (use_cached_pattern_)
+  {
+    try
+    {
+      /// the main thread restores the matrix from the cached pattern
+      if (proc_num == 0)
+        create_matrix(pattern_->rows_.data(), pattern_->cols_.data(), pattern_->cols_.size());
+      success_[proc_num] = true;
+    }
+    catch (...)
+    {
+      algo_->error("BuildFEMatrix crashed while restoring the cached stiffness matrix pattern");
+      success_[proc_num] = false;
+    }
+
+    /// check point
+    barrier_.wait();
+
+    // Bail out if one of the processes failed
+    for (auto q=0; q<numprocessors_;q++)
+    {
+      if (!success_[q])
+        return;
+    }
+  }
+  else if (!parallel_structure(proc_num, start_gd, end_gd))
+  {
+    return;
+  }
+
+  VMesh::Elem::array_type ca;
+  VMesh::Node::array_type na;
+  VMesh::Edge::array_type ea;
+  std::vector<index_type> neib_dofs;
+  std::vector<std::vector<T>> precompute;
+
+  int cnt = 0;
+  size_type size_gd = end_gd-start_gd;
+  auto updateFrequency = 2*size_gd / 100;
+
   try
   {
     /// zeroing in parallel
-    const auto ns = colidx_[proc_num];
-    const auto ne = colidx_[proc_num+1];
+    const auto ns = fematrix_->outerIndexPtr()[start_gd];
+    const auto ne = fematrix_->outerIndexPtr()[end_gd];
     auto a = &(fematrix_->valuePtr()[ns]), ae=&(fematrix_->valuePtr()[ne]);
     while (a<ae) *a++=0.0;
 
@@ -935,9 +1411,8 @@ FEMBuilder<T>::parallel(int proc_num)
     lsml.resize(local_dimension);
 
     /// loop over system dofs for this thread
-    cnt = 0;
-    size_gd = end_gd-start_gd;
-    for (VMesh::Node::index_type i = start_gd; i<end_gd; ++i)
+    const VMesh::Node::index_type end_row_assembly = element_assembly_ ? start_gd : end_gd;
+    for (VMesh::Node::index_type i = start_gd; i<end_row_assembly; ++i)
     {
       if (i < global_dimension_nodes)
       {
@@ -1068,10 +1543,15 @@ FEMBuilder<T>::parallel(int proc_num)
     if (!success_[q])
       return;
   }
+
+  if (element_assembly_)
+    parallel_element_assembly(proc_num);
 }
 
 const AlgorithmParameterName BuildFEMatrixAlgo::ForceSymmetry("ForceSymmetry");
 const AlgorithmParameterName BuildFEMatrixAlgo::GenerateBasis("GenerateBasis");
+const AlgorithmParameterName BuildFEMatrixAlgo::ElementAssembly("ElementAssembly");
+const AlgorithmParameterName BuildFEMatrixAlgo::CacheSparsityPattern("CacheSparsityPattern");
 
 template <typename T>
 bool
@@ -1111,7 +1591,7 @@ BuildFEMatrixAlgoImpl<T>::run(FieldHandle input, DenseMatrixHandle ctable, matri
     }
   }
 
-  FEMBuilder<T> builder(algo_);
+  FEMBuilder<T> builder(algo_, pattern_);
 
   if (algo_->get(BuildFEMatrixAlgo::GenerateBasis).toBool())
   {
@@ -1241,7 +1721,7 @@ AlgorithmOutput BuildFEMatrixAlgo::run(const AlgorithmInput& input) const
   if (field && field->vfield() && field->vfield()->is_complex_double())
 	{
 		matrix_pointer_type<complex> stiffness;
-	  BuildFEMatrixAlgoImpl<complex> impl(this);
+	  BuildFEMatrixAlgoImpl<complex> impl(this, pattern_);
 	  if (!impl.run(field, ctable, stiffness))
 	    THROW_ALGORITHM_PROCESSING_ERROR("False returned on legacy run call.--complex detected	");
 		output[Stiffness_Matrix_Complex] = stiffness;
@@ -1249,7 +1729,7 @@ AlgorithmOutput BuildFEMatrixAlgo::run(const AlgorithmInput& input) const
 	else
 	{
 		matrix_pointer_type<double> stiffness;
-	  BuildFEMatrixAlgoImpl<double> impl(this);
+	  BuildFEMatrixAlgoImpl<double> impl(this, pattern_);
 	  if (!impl.run(field, ctable, stiffness))
 	    THROW_ALGORITHM_PROCESSING_ERROR("False returned on legacy run call.");
 		output[Stiffness_Matrix] = stiffness;
@@ -38,11 +38,15 @@ namespace SCIRun {
 		namespace Algorithms {
 			namespace FiniteElements {
 
+class FEMatrixPattern;
+
 class SCISHARE BuildFEMatrixAlgo : public AlgorithmBase
 {
   public:
     static const AlgorithmParameterName ForceSymmetry;
     static const AlgorithmParameterName GenerateBasis;
+    static const AlgorithmParameterName ElementAssembly;
+    static const AlgorithmParameterName CacheSparsityPattern;
 
     static const AlgorithmInputName Conductivity_Table;
     static const AlgorithmOutputName Stiffness_Matrix;
@@ -58,9 +62,23 @@ class SCISHARE BuildFEMatrixAlgo : public AlgorithmBase
       // for instance conductivity search
       // This option only works for an indexed conductivity table
       addParameter(GenerateBasis, false);
+
+      // Assemble element by element: elements are colored so that no two
+      // elements of one color share a node, each local stiffness matrix is
+      // computed once and scattered without locks. Off uses the legacy
+      // row-by-row assembly, which recomputes it once per element node.
+      addParameter(ElementAssembly, true);
+
+      // Keep the sparsity pattern and element coloring of the last mesh, so
+      // that rerunning on the same mesh topology (e.g. with new conductivities) only
+      // recomputes the matrix values
+      addParameter(CacheSparsityPattern, true);
     }
 
     virtual AlgorithmOutput run(const AlgorithmInput &) const override;
+
+  private:
+    mutable boost::shared_ptr<FEMatrixPattern> pattern_;
 };
 
 }}}}
@@ -30,30 +30,48 @@
 // PORTED SCIRUN v4 CODE //
 ///////////////////////////
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
 #include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/AlgebraicMultigrid.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/IncompleteFactorization.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/ReverseCuthillMcKee.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/VectorKernels.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/Thread/Barrier.h>
+#include <Core/Thread/Parallel.h>
+#include <boost/scoped_ptr.hpp>
 
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Math;
 using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Thread;
 
-SolveLinearSystemAlgo::SolveLinearSystemAlgo()
+ALGORITHM_PARAMETER_DEF(Math, WarmStart);
+ALGORITHM_PARAMETER_DEF(Math, MixedPrecision);
+ALGORITHM_PARAMETER_DEF(Math, ReorderMatrix);
+
+SolveLinearSystemAlgo::SolveLinearSystemAlgo() : coldStartIterations_(-1), iterations_(0)
 {
   // For solver
   addOption(Variables::Method,"cg","jacobi|cg|bicg|minres");
-  addOption(Variables::Preconditioner,"Jacobi","None|Jacobi");
+  addOption(Variables::Preconditioner,"Jacobi","None|Jacobi|AMG|IC0|ILU0");
 
   addParameter(Variables::TargetError, 1e-5);
   addParameter(Variables::MaxIterations, 500);
 
   addParameter(Variables::BuildConvergence, true);
+  addParameter(Parameters::WarmStart, false);
+  addParameter(Parameters::MixedPrecision, false);
+  addParameter(Parameters::ReorderMatrix, false);
 
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   // for callback
@@ -73,23 +91,63 @@ SolveLinearSystemAlgo::SolveLinearSystemAlgo()
 class SolveLinearSystemParallelAlgo : public ParallelLinearAlgebraBase
 {
 public:
-  explicit SolveLinearSystemParallelAlgo(const AlgorithmBase* base);
+  SolveLinearSystemParallelAlgo(const AlgorithmBase* base, ParallelPreconditioner* preconditioner);
 
   bool run(SparseRowMatrixHandle a, DenseColumnMatrixHandle b,
             DenseColumnMatrixHandle x0, DenseColumnMatrixHandle& x,
             DenseColumnMatrixHandle& convergence) const;
+  /// Iterations taken by the last run
+  int iterations() const { return iterations_; }
 protected:
+  // z = M^-1 r, with M either the diagonal in diag or a set up preconditioner
+  void precondition(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& diag,
+                    const ParallelLinearAlgebra::ParallelVector& r, ParallelLinearAlgebra::ParallelVector& z) const;
+  // z = M^-T r
+  void precondition_trans(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& diag,
+                          const ParallelLinearAlgebra::ParallelVector& r, ParallelLinearAlgebra::ParallelVector& z) const;
+  // Records the iteration count of a successful solve
+  bool finished(ParallelLinearAlgebra& PLA, int niter) const;
+
   const AlgorithmBase* algo_;
   std::string pre_conditioner_;
+  ParallelPreconditioner* preconditioner_;
   DenseColumnMatrixHandle convergence_;
+  mutable int iterations_;
 };
 
-SolveLinearSystemParallelAlgo::SolveLinearSystemParallelAlgo(const AlgorithmBase* base) : algo_(base),
+SolveLinearSystemParallelAlgo::SolveLinearSystemParallelAlgo(const AlgorithmBase* base, ParallelPreconditioner* preconditioner) : algo_(base),
   pre_conditioner_(base->getOption(Variables::Preconditioner)),
-  convergence_(new DenseColumnMatrix(base->get(Variables::MaxIterations).toInt()))
+  preconditioner_(preconditioner),
+  convergence_(new DenseColumnMatrix(base->get(Variables::MaxIterations).toInt())),
+  iterations_(0)
 {
 }
 
+bool SolveLinearSystemParallelAlgo::finished(ParallelLinearAlgebra& PLA, int niter) const
+{
+  if (PLA.first())
+    iterations_ = niter;
+  return true;
+}
+
+void SolveLinearSystemParallelAlgo::precondition(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& diag,
+                                                 const ParallelLinearAlgebra::ParallelVector& r, ParallelLinearAlgebra::ParallelVector& z) const
+{
+  if (preconditioner_)
+    preconditioner_->apply(PLA, r, z);
+  else
+    PLA.mult(r, diag, z);
+}
+
+void SolveLinearSystemParallelAlgo::precondition_trans(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& diag,
+                                                       const ParallelLinearAlgebra::ParallelVector& r, ParallelLinearAlgebra::ParallelVector& z) const
+{
+  if (preconditioner_)
+    preconditioner_->applyTranspose(PLA, r, z);
+  else
+    PLA.mult(r, diag, z);
+}
+
 bool
 SolveLinearSystemParallelAlgo::run(SparseRowMatrixHandle a, DenseColumnMatrixHandle b,
                                    DenseColumnMatrixHandle x0, DenseColumnMatrixHandle& x,
@@ -131,7 +189,7 @@ SolveLinearSystemParallelAlgo::run(SparseRowMatrixHandle a, DenseColumnMatrixHan
 class SolveLinearSystemCGAlgo : public SolveLinearSystemParallelAlgo
 {
   public:
-    explicit SolveLinearSystemCGAlgo(const AlgorithmBase* base) : SolveLinearSystemParallelAlgo(base) {}
+    SolveLinearSystemCGAlgo(const AlgorithmBase* base, ParallelPreconditioner* preconditioner) : SolveLinearSystemParallelAlgo(base, preconditioner) {}
     virtual bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const;
 };
 
@@ -224,7 +282,7 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
     }
     PLA.wait();
 
-    return (true);
+    return finished(PLA, niter);
   }
 
   double bkden = 0.0;
@@ -253,10 +311,10 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
       }
 
       PLA.wait();
-      return true;
+      return finished(PLA, niter);
     }
 
-    PLA.mult(R,DIAG,Z);
+    precondition(PLA,DIAG,R,Z);
     double bknum = PLA.dot(Z,R);
 
     if (niter == 0)
@@ -268,16 +326,13 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
       double bk = bknum/bkden;
       PLA.scale_add(bk,P,Z,P);
     }
-    PLA.mult(A,P,Z);
+    double akden = PLA.mult_dot(A,P,Z);
     bkden = bknum;
 
-    double akden = PLA.dot(Z,P);
     double ak=bknum/akden;
 
     PLA.scale_add(ak,P,X,X);
-    PLA.scale_add(-ak,Z,R,R);
-
-    error = PLA.norm(R)/bnorm;
+    error = PLA.scale_add_norm(-ak,Z,R,R)/bnorm;
     if (error < xmin)
     {
       PLA.copy(X,XMIN);
@@ -334,7 +389,7 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
 
   PLA.wait();
 
-  return true;
+  return finished(PLA, niter);
 }
 
 
@@ -343,7 +398,7 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
 class SolveLinearSystemBICGAlgo : public SolveLinearSystemParallelAlgo
 {
   public:
-    explicit SolveLinearSystemBICGAlgo(const AlgorithmBase* base) : SolveLinearSystemParallelAlgo(base) {}
+    SolveLinearSystemBICGAlgo(const AlgorithmBase* base, ParallelPreconditioner* preconditioner) : SolveLinearSystemParallelAlgo(base, preconditioner) {}
     virtual bool parallel(ParallelLinearAlgebra& PLA,
                           SolverInputs& matrices) const;
 };
@@ -431,7 +486,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
 #endif
     }
     PLA.wait();
-    return (true);
+    return finished(PLA, niter);
   }
 
   PLA.copy(R,R1);
@@ -457,11 +512,11 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
 #endif
       }
       PLA.wait();
-      return (true);
+      return finished(PLA, niter);
     }
 
-    PLA.mult(R,DIAG,Z);
-    PLA.mult(R1,DIAG,Z1);
+    precondition(PLA,DIAG,R,Z);
+    precondition_trans(PLA,DIAG,R1,Z1);
 
     double bknum = PLA.dot(Z,R1);
 
@@ -476,7 +531,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
 #endif
       }
       PLA.wait();
-      return (true);
+      return finished(PLA, niter);
     }
 
     if (niter == 0)
@@ -549,7 +604,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   }
   PLA.wait();
 
-  return (true);
+  return finished(PLA, niter);
 }
 
 //------------------------------------------------------------------
@@ -558,7 +613,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
 class SolveLinearSystemMINRESAlgo : public SolveLinearSystemParallelAlgo
 {
 public:
-  explicit SolveLinearSystemMINRESAlgo(const AlgorithmBase* base) : SolveLinearSystemParallelAlgo(base) {}
+  SolveLinearSystemMINRESAlgo(const AlgorithmBase* base, ParallelPreconditioner* preconditioner) : SolveLinearSystemParallelAlgo(base, preconditioner) {}
   virtual bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const;
 };
 
@@ -650,13 +705,13 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
 #endif
     }
     PLA.wait();
-    return (true);
+    return finished(PLA, niter);
   }
 
   PLA.copy(R,VOLD);
   PLA.copy(R,V);
 
-  PLA.mult(DIAG,V,V);
+  precondition(PLA,DIAG,VOLD,V);
 
   double beta1   = sqrt(PLA.dot(V,VOLD));
   double snprod  = beta1;
@@ -673,7 +728,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   PLA.copy(VOLD,VOLDER);
   PLA.copy(V,VOLD);
 
-  PLA.mult(DIAG,V,V);
+  precondition(PLA,DIAG,VOLD,V);
 
   double betaold = beta1;
   double beta = sqrt(PLA.dot(VOLD,V));
@@ -720,7 +775,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
 #endif
       }
       PLA.wait();
-      return (true);
+      return finished(PLA, niter);
     }
 
     PLA.scale(1.0/beta,V,VV);
@@ -734,7 +789,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
     PLA.copy(VOLD,VOLDER);
     PLA.copy(V,VOLD);
 
-    PLA.mult(DIAG,V,V);
+    precondition(PLA,DIAG,VOLD,V);
 
     betaold = beta;
     beta = sqrt(PLA.dot(VOLD,V));
@@ -798,7 +853,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
 #endif
         }
         PLA.wait();
-        return (true);
+        return finished(PLA, niter);
       }
 
       PLA.mult(A,X,R);
@@ -821,7 +876,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
 #endif
         }
         PLA.wait();
-        return (true);
+        return finished(PLA, niter);
       }
     }
 
@@ -851,7 +906,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
 #endif
         }
         PLA.wait();
-        return (true);
+        return finished(PLA, niter);
       }
     }
 
@@ -900,7 +955,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   }
   PLA.wait();
 
-  return (true);
+  return finished(PLA, niter);
 }
 
 
@@ -910,7 +965,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
 class SolveLinearSystemJACOBIAlgo : public SolveLinearSystemParallelAlgo
 {
 public:
-  explicit SolveLinearSystemJACOBIAlgo(const AlgorithmBase* base) : SolveLinearSystemParallelAlgo(base) {}
+  explicit SolveLinearSystemJACOBIAlgo(const AlgorithmBase* base) : SolveLinearSystemParallelAlgo(base, nullptr) {}
   virtual bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const;
 };
 
@@ -986,7 +1041,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
 #endif
     }
     PLA.wait();
-    return (true);
+    return finished(PLA, niter);
   }
 
   int cnt = 0;
@@ -1009,7 +1064,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
       }
       PLA.wait();
       algo_->update_progress(1);
-      return (true);
+      return finished(PLA, niter);
     }
 
     PLA.mult(DIAG,Z,Z);
@@ -1064,7 +1119,621 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   PLA.wait();
 
   algo_->update_progress(1);
-  return (true);
+  return finished(PLA, niter);
+}
+
+//------------------------------------------------------------------
+// Batched CG solver for a block of right hand sides
+
+// Runs an independent preconditioned CG recursion for every column of B, but
+// steps all of them together. The n x k blocks are stored row-major, so one
+// sweep over A multiplies all search directions at once (SpMM) and A is
+// streamed from memory once per iteration instead of once per column. The
+// dot products are fused into the same sweeps. Columns that have converged
+// are frozen while the remaining ones keep iterating.
+
+class SolveLinearSystemBlockCGAlgo
+{
+public:
+  SolveLinearSystemBlockCGAlgo(const AlgorithmBase* base, const SparseRowMatrix& A,
+                               const DenseMatrix& B, DenseMatrix& X);
+  bool run();
+  /// Iterations of the slowest column
+  int iterations() const { return iterations_.empty() ? 0 : *std::max_element(iterations_.begin(), iterations_.end()); }
+
+private:
+  void parallel(int proc);
+  // Sums the per thread partial values of one slot, in thread order so every
+  // thread computes bitwise identical results and takes the same decisions
+  void reduce(int slot, std::vector<double>& sum) const;
+  double* partial(int proc, int slot) { return &partial_[(proc*3 + slot)*k_]; }
+
+  const AlgorithmBase* algo_;
+  const SparseRowMatrix& A_;
+  const DenseMatrix& B_;
+  DenseMatrix& X_;
+  size_t n_, k_;
+  int nproc_;
+  bool jacobi_;
+  double tolerance_;
+  int maxIterations_;
+
+  std::vector<double> R_, Z_, P_, Q_, diag_;
+  std::vector<double> partial_, diagMax_;
+  std::vector<int> iterations_;
+  std::vector<double> error_;
+  boost::scoped_ptr<Barrier> barrier_;
+};
+
+SolveLinearSystemBlockCGAlgo::SolveLinearSystemBlockCGAlgo(const AlgorithmBase* base, const SparseRowMatrix& A,
+                                                           const DenseMatrix& B, DenseMatrix& X) :
+  algo_(base), A_(A), B_(B), X_(X), n_(A.nrows()), k_(B.ncols()),
+  jacobi_(base->getOption(Variables::Preconditioner) == "Jacobi"),
+  tolerance_(base->get(Variables::TargetError).toDouble()),
+  maxIterations_(base->get(Variables::MaxIterations).toInt())
+{
+  // Require a minimum of 50 variables per processor, as the single vector solvers do
+  nproc_ = std::max(1, std::min(static_cast<int>(Parallel::NumCores()), static_cast<int>(n_ / 50)));
+}
+
+bool SolveLinearSystemBlockCGAlgo::run()
+{
+  try
+  {
+    R_.resize(n_*k_);
+    Z_.resize(n_*k_);
+    P_.resize(n_*k_);
+    Q_.resize(n_*k_);
+    diag_.resize(n_);
+    partial_.assign(nproc_*3*k_, 0.0);
+    diagMax_.assign(nproc_, 0.0);
+  }
+  catch (std::bad_alloc&)
+  {
+    algo_->error("Could not allocate enough memory for algorithm");
+    return false;
+  }
+  iterations_.assign(k_, 0);
+  error_.assign(k_, 0.0);
+  barrier_.reset(new Barrier("SolveLinearSystemBlockCG", nproc_));
+
+  Parallel::RunTasks([this](int proc) { parallel(proc); }, nproc_);
+
+  int notConverged = 0, maxIterationsUsed = 0;
+  double maxError = 0.0;
+  for (size_t j = 0; j < k_; j++)
+  {
+    if (error_[j] > tolerance_)
+      notConverged++;
+    maxIterationsUsed = std::max(maxIterationsUsed, iterations_[j]);
+    maxError = std::max(maxError, error_[j]);
+  }
+
+  std::ostringstream ostr;
+  if (notConverged == 0)
+    ostr << "Block solver converged for all " << k_ << " right hand sides after " << maxIterationsUsed << " iterations with maximum error " << maxError;
+  else
+    ostr << "Block solver stopped after " << maxIterationsUsed << " iterations. " << notConverged << " of " << k_ << " right hand sides did not converge, maximum error was " << maxError;
+  algo_->remark(ostr.str());
+  return true;
+}
+
+void SolveLinearSystemBlockCGAlgo::reduce(int slot, std::vector<double>& sum) const
+{
+  sum.assign(k_, 0.0);
+  for (int p = 0; p < nproc_; p++)
+  {
+    const double* part = &partial_[(p*3 + slot)*k_];
+    for (size_t j = 0; j < k_; j++)
+      sum[j] += part[j];
+  }
+}
+
+void SolveLinearSystemBlockCGAlgo::parallel(int proc)
+{
+  const size_t k = k_;
+  const size_t localSize = n_ / nproc_;
+  const size_t start = proc*localSize;
+  const size_t end = (proc == nproc_-1) ? n_ : start + localSize;
+
+  const double* values = A_.valuePtr();
+  const SCIRun::index_type* columns = A_.innerIndexPtr();
+  const SCIRun::index_type* rows = A_.outerIndexPtr();
+  const double* B = B_.data();
+  double* X = X_.data();
+  double* R = &R_[0];
+  double* Z = &Z_[0];
+  double* P = &P_[0];
+  double* Q = &Q_[0];
+  double* diag = &diag_[0];
+
+  // out = A*in for the rows [start, end), all k columns in one sweep over A.
+  // With dot given, the column dot products in.out are accumulated while each
+  // output row is still in cache.
+  auto spmm = [&](const double* in, double* out, double* dot)
+  {
+    for (size_t i = start; i < end; i++)
+    {
+      double* o = out + i*k;
+      std::fill(o, o+k, 0.0);
+      for (SCIRun::index_type idx = rows[i]; idx < rows[i+1]; idx++)
+      {
+        const double a = values[idx];
+        const double* v = in + columns[idx]*k;
+        for (size_t j = 0; j < k; j++)
+          o[j] += a*v[j];
+      }
+      if (dot)
+      {
+        const double* v = in + i*k;
+        for (size_t j = 0; j < k; j++)
+          dot[j] += v[j]*o[j];
+      }
+    }
+  };
+
+  // Preconditioner: inverse absolute diagonal, thresholded at 1e-18 times its maximum
+  double localMax = 0.0;
+  for (size_t i = start; i < end; i++)
+  {
+    double val = 0.0;
+    for (SCIRun::index_type idx = rows[i]; idx < rows[i+1]; idx++)
+      if (columns[idx] == static_cast<SCIRun::index_type>(i))
+        val = values[idx];
+    diag[i] = std::abs(val);
+    localMax = std::max(localMax, diag[i]);
+  }
+  diagMax_[proc] = localMax;
+  barrier_->wait();
+
+  const double max = *std::max_element(diagMax_.begin(), diagMax_.end());
+  for (size_t i = start; i < end; i++)
+    diag[i] = (jacobi_ && diag[i] > 1e-18*max) ? 1.0/diag[i] : 1.0;
+
+  // R = B - A*X, Z = M^-1 R, P = Z
+  spmm(X, R, nullptr);
+  double* rr = partial(proc, 0);
+  double* bb = partial(proc, 1);
+  double* rz = partial(proc, 2);
+  std::fill(rr, rr+k, 0.0);
+  std::fill(bb, bb+k, 0.0);
+  std::fill(rz, rz+k, 0.0);
+  for (size_t i = start; i < end; i++)
+  {
+    for (size_t j = 0; j < k; j++)
+    {
+      const size_t ij = i*k + j;
+      R[ij] = B[ij] - R[ij];
+      Z[ij] = diag[i]*R[ij];
+      P[ij] = Z[ij];
+      bb[j] += B[ij]*B[ij];
+      rr[j] += R[ij]*R[ij];
+      rz[j] += R[ij]*Z[ij];
+    }
+  }
+  barrier_->wait();
+
+  std::vector<double> bnorm, rho, sum, alpha(k), beta(k), error(k);
+  std::vector<char> active(k);
+  reduce(1, bnorm);
+  reduce(0, sum);
+  reduce(2, rho);
+
+  bool anyActive = false;
+  double maxError = 0.0;
+  for (size_t j = 0; j < k; j++)
+  {
+    bnorm[j] = std::sqrt(bnorm[j]);
+    // a zero right hand side has the zero solution, do not divide by its norm
+    error[j] = bnorm[j] > 0.0 ? std::sqrt(sum[j])/bnorm[j] : 0.0;
+    active[j] = error[j] > tolerance_;
+    anyActive = anyActive || active[j];
+    maxError = std::max(maxError, error[j]);
+  }
+  if (proc == 0)
+    error_ = error;
+
+  for (size_t j = 0; j < k; j++)
+    if (bnorm[j] == 0.0)
+      for (size_t i = start; i < end; i++)
+        X[i*k + j] = 0.0;
+
+  // the partial sums are reused by the first iteration
+  barrier_->wait();
+
+  const double logOrig = std::log(std::max(maxError, tolerance_));
+  const double logScale = logOrig - std::log(tolerance_);
+
+  int niter = 0;
+  int cnt = 0;
+  while (anyActive && niter < maxIterations_)
+  {
+    // Q = A*P fused with the P.Q dot products
+    double* pq = partial(proc, 0);
+    std::fill(pq, pq+k, 0.0);
+    spmm(P, Q, pq);
+    barrier_->wait();
+
+    reduce(0, sum);
+    for (size_t j = 0; j < k; j++)
+      alpha[j] = (active[j] && sum[j] != 0.0) ? rho[j]/sum[j] : 0.0;
+
+    // X += alpha P, R -= alpha Q, Z = M^-1 R, fused with the R.R and R.Z dot products
+    rr = partial(proc, 1);
+    rz = partial(proc, 2);
+    std::fill(rr, rr+k, 0.0);
+    std::fill(rz, rz+k, 0.0);
+    for (size_t i = start; i < end; i++)
+    {
+      for (size_t j = 0; j < k; j++)
+      {
+        const size_t ij = i*k + j;
+        X[ij] += alpha[j]*P[ij];
+        R[ij] -= alpha[j]*Q[ij];
+        Z[ij] = diag[i]*R[ij];
+        rr[j] += R[ij]*R[ij];
+        rz[j] += R[ij]*Z[ij];
+      }
+    }
+    barrier_->wait();
+
+    niter++;
+    reduce(1, sum);
+    std::vector<double> rhoNew;
+    reduce(2, rhoNew);
+    anyActive = false;
+    maxError = 0.0;
+    for (size_t j = 0; j < k; j++)
+    {
+      beta[j] = 0.0;
+      if (!active[j])
+        continue;
+      error[j] = std::sqrt(sum[j])/bnorm[j];
+      beta[j] = rhoNew[j]/rho[j];
+      rho[j] = rhoNew[j];
+      if (proc == 0)
+      {
+        error_[j] = error[j];
+        iterations_[j] = niter;
+      }
+      if (error[j] <= tolerance_)
+        active[j] = false;
+      anyActive = anyActive || active[j];
+      maxError = std::max(maxError, error[j]);
+    }
+
+    // P = Z + beta P, frozen columns get a zero search direction
+    for (size_t i = start; i < end; i++)
+    {
+      for (size_t j = 0; j < k; j++)
+      {
+        const size_t ij = i*k + j;
+        P[ij] = active[j] ? Z[ij] + beta[j]*P[ij] : 0.0;
+      }
+    }
+    // all rows of P are read by the next product
+    barrier_->wait();
+
+    cnt++;
+    if (cnt == 20 && proc == 0)
+    {
+      cnt = 0;
+      if (anyActive && logScale > 0.0)
+        algo_->update_progress((logOrig-std::log(maxError))/logScale);
+    }
+  }
+}
+
+// Mixed precision iterative refinement: the Krylov iterations run on a float
+// copy of A (values and 32 bit column indices, half the bytes of the double
+// matrix per product), the corrections are accumulated in double and every
+// refinement step recomputes the residual b - A*x with the original matrix.
+// Dot products are accumulated in double.
+class SolveLinearSystemMixedPrecisionAlgo
+{
+public:
+  SolveLinearSystemMixedPrecisionAlgo(const AlgorithmBase* base, const SparseRowMatrix& A,
+                                      const DenseColumnMatrix& b, DenseColumnMatrix& x);
+  bool run();
+  /// Single precision iterations of all refinement steps
+  int iterations() const { return iterations_; }
+  /// The refinement stopped reducing the error: A is too ill conditioned for
+  /// single precision, the double solver has to continue from x
+  bool stalled() const { return stalled_; }
+  double error() const { return error_; }
+
+  // Smallest relative residual the single precision solve is asked for
+  static const double innerToleranceLimit;
+
+private:
+  void parallel(int proc);
+  double reduce(int slot) const;
+  double& partial(int proc, int slot) { return partial_[proc*3 + slot]; }
+
+  const AlgorithmBase* algo_;
+  const SparseRowMatrix& A_;
+  const DenseColumnMatrix& b_;
+  DenseColumnMatrix& x_;
+  size_t n_;
+  int nproc_;
+  bool jacobi_;
+  double tolerance_;
+  int maxIterations_;
+
+  std::vector<float> values_;
+  std::vector<std::uint32_t> columns_;
+  std::vector<float> diag_, r_, z_, p_, q_, d_;
+  std::vector<double> residual_;
+  std::vector<double> partial_, diagMax_;
+  int iterations_;
+  int steps_;
+  double error_;
+  bool stalled_;
+  boost::scoped_ptr<Barrier> barrier_;
+};
+
+const double SolveLinearSystemMixedPrecisionAlgo::innerToleranceLimit = 1e-5;
+
+SolveLinearSystemMixedPrecisionAlgo::SolveLinearSystemMixedPrecisionAlgo(const AlgorithmBase* base, const SparseRowMatrix& A,
+                                                                         const DenseColumnMatrix& b, DenseColumnMatrix& x) :
+  algo_(base), A_(A), b_(b), x_(x), n_(A.nrows()),
+  jacobi_(base->getOption(Variables::Preconditioner) == "Jacobi"),
+  tolerance_(base->get(Variables::TargetError).toDouble()),
+  maxIterations_(base->get(Variables::MaxIterations).toInt()),
+  iterations_(0), steps_(0), error_(0.0), stalled_(false)
+{
+  // Require a minimum of 50 variables per processor, as the double precision solvers do
+  nproc_ = std::max(1, std::min(static_cast<int>(Parallel::NumCores()), static_cast<int>(n_ / 50)));
+}
+
+bool SolveLinearSystemMixedPrecisionAlgo::run()
+{
+  try
+  {
+    values_.resize(A_.nonZeros());
+    columns_.resize(A_.nonZeros());
+    diag_.resize(n_);
+    r_.resize(n_);
+    z_.resize(n_);
+    p_.resize(n_);
+    q_.resize(n_);
+    d_.resize(n_);
+    residual_.resize(n_);
+    partial_.assign(nproc_*3, 0.0);
+    diagMax_.assign(nproc_, 0.0);
+  }
+  catch (std::bad_alloc&)
+  {
+    algo_->error("Could not allocate enough memory for algorithm");
+    return false;
+  }
+  barrier_.reset(new Barrier("SolveLinearSystemMixedPrecision", nproc_));
+
+  Parallel::RunTasks([this](int proc) { parallel(proc); }, nproc_);
+
+  std::ostringstream ostr;
+  if (error_ <= tolerance_)
+    ostr << "Mixed precision refinement converged after " << iterations_ << " single precision iterations in " << steps_ << " refinement steps with error " << error_;
+  else if (stalled_)
+    ostr << "Mixed precision refinement stalled at error " << error_ << " after " << steps_ << " refinement steps, continuing in double precision";
+  else
+    ostr << "Mixed precision refinement stopped after " << iterations_ << " single precision iterations with error " << error_;
+  algo_->remark(ostr.str());
+  return true;
+}
+
+double SolveLinearSystemMixedPrecisionAlgo::reduce(int slot) const
+{
+  // thread order, so every thread computes the same value and takes the same decisions
+  double sum = 0.0;
+  for (int p = 0; p < nproc_; p++)
+    sum += partial_[p*3 + slot];
+  return sum;
+}
+
+void SolveLinearSystemMixedPrecisionAlgo::parallel(int proc)
+{
+  const size_t localSize = n_ / nproc_;
+  const size_t start = proc*localSize;
+  const size_t end = (proc == nproc_-1) ? n_ : start + localSize;
+
+  const double* values = A_.valuePtr();
+  const SCIRun::index_type* columns = A_.innerIndexPtr();
+  const SCIRun::index_type* rows = A_.outerIndexPtr();
+  const double* b = b_.data();
+  double* x = x_.data();
+  double* residual = &residual_[0];
+  float* valuesF = &values_[0];
+  std::uint32_t* columnsF = &columns_[0];
+  float* diag = &diag_[0];
+  float* r = &r_[0];
+  float* z = &z_[0];
+  float* p = &p_[0];
+  float* q = &q_[0];
+  float* d = &d_[0];
+  const auto& kernels = vectorKernels();
+
+  // Single precision copy of this thread's rows, and the Jacobi preconditioner:
+  // inverse absolute diagonal, thresholded at 1e-18 times its maximum
+  double localMax = 0.0;
+  for (size_t i = start; i < end; i++)
+  {
+    double val = 0.0;
+    for (SCIRun::index_type idx = rows[i]; idx < rows[i+1]; idx++)
+    {
+      valuesF[idx] = static_cast<float>(values[idx]);
+      columnsF[idx] = static_cast<std::uint32_t>(columns[idx]);
+      if (columns[idx] == static_cast<SCIRun::index_type>(i))
+        val = values[idx];
+    }
+    residual[i] = std::abs(val);
+    localMax = std::max(localMax, residual[i]);
+  }
+  diagMax_[proc] = localMax;
+
+  partial(proc, 0) = kernels.sumOfSquares(b + start, end - start);
+  barrier_->wait();
+
+  const double bnorm = std::sqrt(reduce(0));
+  const double max = *std::max_element(diagMax_.begin(), diagMax_.end());
+  for (size_t i = start; i < end; i++)
+    diag[i] = (jacobi_ && residual[i] > 1e-18*max) ? static_cast<float>(1.0/residual[i]) : 1.0f;
+
+  if (bnorm == 0.0)
+  {
+    for (size_t i = start; i < end; i++)
+      x[i] = 0.0;
+    return;
+  }
+
+  // q = A*p in single precision for this thread's rows, returns p.q
+  auto spmv = [&]()
+  {
+    double pq = 0.0;
+    for (size_t i = start; i < end; i++)
+    {
+      float sum = 0.0f;
+      for (SCIRun::index_type idx = rows[i]; idx < rows[i+1]; idx++)
+        sum += valuesF[idx]*p[columnsF[idx]];
+      q[i] = sum;
+      pq += static_cast<double>(p[i])*sum;
+    }
+    return pq;
+  };
+
+  double logOrig = 0.0, logScale = 0.0;
+  double previousError = 0.0;
+  int niter = 0, cnt = 0;
+  for (int step = 0; ; step++)
+  {
+    // residual = b - A*x in double precision, x is complete after the last barrier
+    barrier_->wait();
+    kernels.spmv(rows, columns, values, x, residual, start, end);
+    for (size_t i = start; i < end; i++)
+      residual[i] = b[i] - residual[i];
+    partial(proc, 0) = kernels.sumOfSquares(residual + start, end - start);
+    barrier_->wait();
+
+    const double rnorm = std::sqrt(reduce(0));
+    const double error = rnorm/bnorm;
+    if (proc == 0)
+    {
+      error_ = error;
+      steps_ = step;
+    }
+    if (step == 0)
+    {
+      logOrig = std::log(std::max(error, tolerance_));
+      logScale = logOrig - std::log(tolerance_);
+    }
+    else if (error > 0.5*previousError)
+    {
+      if (proc == 0)
+        stalled_ = error > tolerance_;
+      break;
+    }
+    if (error <= tolerance_ || niter >= maxIterations_)
+      break;
+    previousError = error;
+
+    // Solve A*d = residual/|residual| in single precision, to the relative
+    // residual that brings the double error to the target, as far as float allows
+    const double innerTolerance = std::max(innerToleranceLimit, 0.5*tolerance_/error);
+    const double scale = 1.0/rnorm;
+    double rz = 0.0;
+    for (size_t i = start; i < end; i++)
+    {
+      r[i] = static_cast<float>(scale*residual[i]);
+      z[i] = diag[i]*r[i];
+      p[i] = z[i];
+      d[i] = 0.0f;
+      rz += static_cast<double>(r[i])*z[i];
+    }
+    partial(proc, 1) = rz;
+    barrier_->wait();
+    double rho = reduce(1);
+
+    while (niter < maxIterations_)
+    {
+      partial(proc, 0) = spmv();
+      barrier_->wait();
+
+      const double pq = reduce(0);
+      if (!(pq > 0.0))
+        break;
+      const float alpha = static_cast<float>(rho/pq);
+      double rr = 0.0;
+      rz = 0.0;
+      for (size_t i = start; i < end; i++)
+      {
+        d[i] += alpha*p[i];
+        r[i] -= alpha*q[i];
+        z[i] = diag[i]*r[i];
+        rr += static_cast<double>(r[i])*r[i];
+        rz += static_cast<double>(r[i])*z[i];
+      }
+      partial(proc, 1) = rr;
+      partial(proc, 2) = rz;
+      barrier_->wait();
+
+      niter++;
+      if (proc == 0)
+        iterations_ = niter;
+      cnt++;
+      if (cnt == 20 && proc == 0)
+      {
+        cnt = 0;
+        if (logScale > 0.0)
+          algo_->update_progress((logOrig-std::log(std::max(error*std::sqrt(reduce(1)), tolerance_)))/logScale);
+      }
+
+      if (std::sqrt(reduce(1)) <= innerTolerance)
+        break;
+      const double rhoNew = reduce(2);
+      const float beta = static_cast<float>(rhoNew/rho);
+      rho = rhoNew;
+      for (size_t i = start; i < end; i++)
+        p[i] = z[i] + beta*p[i];
+      // all rows of p are read by the next product
+      barrier_->wait();
+    }
+
+    // x += |residual| * d in double precision
+    for (size_t i = start; i < end; i++)
+      x[i] += rnorm*d[i];
+  }
+}
+
+SparseRowMatrixHandle SolveLinearSystemAlgo::reordered(SparseRowMatrixHandle A) const
+{
+  if (!get(Parameters::ReorderMatrix).toBool())
+  {
+    ordering_.reset();
+    orderedSource_.reset();
+    orderedMatrix_.reset();
+    return SparseRowMatrixHandle();
+  }
+
+  // The same matrix maps to the same reordered matrix, so the AMG hierarchy or
+  // incomplete factors cached for it are reused
+  if (A == orderedSource_ && A->nonZeros() == orderedMatrix_->nonZeros())
+    return orderedMatrix_;
+
+  if (!ordering_ || !ordering_->matchesPattern(A))
+  {
+    ordering_ = boost::make_shared<ReverseCuthillMcKee>(A);
+    orderedMatrix_ = ordering_->permute(*A);
+    std::ostringstream ostr;
+    ostr << "Reordered unknowns with reverse Cuthill-McKee, bandwidth " << ReverseCuthillMcKee::bandwidth(*A)
+      << " reduced to " << ReverseCuthillMcKee::bandwidth(*orderedMatrix_);
+    remark(ostr.str());
+  }
+  else
+  {
+    orderedMatrix_ = ordering_->permute(*A);
+  }
+  orderedSource_ = A;
+  return orderedMatrix_;
 }
 
 bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
@@ -1145,24 +1814,115 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
     THROW_ALGORITHM_INPUT_ERROR("Matrix A and x0 do not have the same number of rows");
   }
 
+  // Solve P*A*P^T * P*x = P*b, with P the bandwidth reducing permutation
+  ReverseCuthillMcKee* ordering = nullptr;
+  if (auto ordered = reordered(A))
+  {
+    A = ordered;
+    ordering = ordering_.get();
+    b = ordering->permute(*b);
+    x0 = ordering->permute(*x0);
+  }
+  auto solved = [&]()
+  {
+    if (ordering)
+      x = ordering->unpermute(*x);
+    return true;
+  };
+
   std::string method = getOption(Variables::Method);
 
+  // The AMG hierarchy and the incomplete factors are expensive to set up, so
+  // they are kept for as long as the same matrix is solved again
+  std::string preconditioner = getOption(Variables::Preconditioner);
+
+  // Single precision iterations on a float copy of A, corrected with double
+  // precision residuals. A stalled refinement hands its x to the double solver.
+  int refinementIterations = 0;
+  if (get(Parameters::MixedPrecision).toBool())
+  {
+    if (method == "cg" && (preconditioner == "None" || preconditioner == "Jacobi")
+      && A->ncols() <= std::numeric_limits<std::uint32_t>::max())
+    {
+      auto refined = boost::make_shared<DenseColumnMatrix>(*x0);
+      SolveLinearSystemMixedPrecisionAlgo mixed(this, *A, *b, *refined);
+      if (!mixed.run())
+      {
+        BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Mixed precision refinement failed"));
+      }
+      iterations_ = mixed.iterations();
+      if (!mixed.stalled())
+      {
+        x = refined;
+        return solved();
+      }
+      x0 = refined;
+      refinementIterations = mixed.iterations();
+    }
+    else
+    {
+      remark("Mixed precision refinement is available for the cg method with the None or Jacobi preconditioner, solving in double precision");
+    }
+  }
+
+  ParallelPreconditioner* M = nullptr;
+  if (method != "jacobi" && (preconditioner == "AMG" || preconditioner == "IC0" || preconditioner == "ILU0"))
+  {
+    // In warm start mode, new values of a matrix with the same sparsity pattern
+    // keep the structural part of the setup: AMG aggregates, IC/ILU level schedules
+    if (preconditioner_ && preconditionerName_ == preconditioner && !preconditioner_->matches(A)
+      && get(Parameters::WarmStart).toBool() && preconditioner_->matchesPattern(A))
+    {
+      preconditioner_->update(A);
+      remark("Updated " + preconditioner + " preconditioner for the new matrix values, keeping its setup for the unchanged sparsity pattern");
+    }
+    else if (!preconditioner_ || preconditionerName_ != preconditioner || !preconditioner_->matches(A))
+    {
+      preconditioner_.reset();
+      std::ostringstream ostr;
+      if (preconditioner == "AMG")
+      {
+        auto amg = boost::make_shared<AlgebraicMultigrid>(A);
+        ostr << "Built AMG hierarchy with " << amg->numLevels() << " levels, operator complexity " << amg->operatorComplexity();
+        preconditioner_ = amg;
+      }
+      else
+      {
+        auto ilu = boost::make_shared<IncompleteFactorization>(A,
+          preconditioner == "IC0" ? IncompleteFactorizationType::IC0 : IncompleteFactorizationType::ILU0);
+        ostr << "Computed " << preconditioner << " factors with " << ilu->factors().numLevels() << " triangular solve levels";
+        if (ilu->factors().shift() > 0)
+          ostr << ", diagonal shifted by " << ilu->factors().shift();
+        preconditioner_ = ilu;
+      }
+      preconditionerName_ = preconditioner;
+      remark(ostr.str());
+    }
+    M = preconditioner_.get();
+  }
+  else
+  {
+    preconditioner_.reset();
+  }
+
   DenseColumnMatrixHandle conv;
   if (method == "cg")
   {
-    SolveLinearSystemCGAlgo algo(this);
+    SolveLinearSystemCGAlgo algo(this, M);
     if(!algo.run(A,b,x0,x,conv))
     {
       BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Conjugate Gradient method failed"));
     }
+    iterations_ = refinementIterations + algo.iterations();
   }
   else if (method == "bicg")
   {
-    SolveLinearSystemBICGAlgo algo(this);
+    SolveLinearSystemBICGAlgo algo(this, M);
     if(!(algo.run(A,b,x0,x,conv)))
     {
       BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("BiConjugate Gradient method failed"));
     }
+    iterations_ = algo.iterations();
   }
   else if (method == "jacobi")
   {
@@ -1171,14 +1931,16 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
     {
       BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Jacobi method failed"));
     }
+    iterations_ = algo.iterations();
   }
   else if (method == "minres")
   {
-    SolveLinearSystemMINRESAlgo algo(this);
+    SolveLinearSystemMINRESAlgo algo(this, M);
     if(!(algo.run(A,b,x0,x,conv)))
     {
       BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("MINRES method failed"));
     }
+    iterations_ = algo.iterations();
   }
   else
     BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Unknown solver method"));
@@ -1197,23 +1959,164 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
     }
   }
 #endif
+  return solved();
+}
+
+bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
+                           DenseMatrixHandle b,
+                           DenseMatrixHandle x0,
+                           DenseMatrixHandle& x) const
+{
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(A, "No matrix A is given");
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(b, "No matrix b is given");
+
+  if (A->nrows() != A->ncols())
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix A is not square");
+  }
+
+  if (A->nrows() != b->nrows())
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix A and b do not have the same number of rows");
+  }
+
+  if (x0 && (x0->nrows() != b->nrows() || x0->ncols() != b->ncols()))
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix x0 and b need to have the same dimensions");
+  }
+
+  x = boost::make_shared<DenseMatrix>(b->nrows(), b->ncols());
+  if (x0)
+    *x = *x0;
+  else
+    x->setZero();
+
+  const std::string method = getOption(Variables::Method);
+  const std::string preconditioner = getOption(Variables::Preconditioner);
+  const bool mixedPrecision = get(Parameters::MixedPrecision).toBool();
+  if (method == "cg" && (preconditioner == "None" || preconditioner == "Jacobi") && b->ncols() > 1 && !mixedPrecision)
+  {
+    ScopedAlgorithmStatusReporter ssr(this, "SolveLinearSystem");
+    double tolerance = get(Variables::TargetError).toDouble();
+    int maxIterations = get(Variables::MaxIterations).toInt();
+    ENSURE_POSITIVE_DOUBLE(tolerance, "Tolerance out of range!");
+    ENSURE_POSITIVE_INT(maxIterations, "Max iterations out of range!");
+
+    auto ordered = reordered(A);
+    if (ordered)
+    {
+      A = ordered;
+      b = ordering_->permute(*b);
+      x = ordering_->permute(*x);
+    }
+
+    SolveLinearSystemBlockCGAlgo algo(this, *A, *b, *x);
+    if (!algo.run())
+    {
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Block Conjugate Gradient method failed"));
+    }
+    iterations_ = algo.iterations();
+    if (ordered)
+      x = ordering_->unpermute(*x);
+    return true;
+  }
+
+  // The other methods solve one column at a time; the AMG hierarchy or the
+  // incomplete factors are still only set up once for all columns.
+  if (b->ncols() > 1 && mixedPrecision)
+    remark("Mixed precision refinement solves the right hand sides one at a time");
+  else if (b->ncols() > 1)
+    remark("The " + method + " method with " + preconditioner + " preconditioner solves the right hand sides one at a time");
+
+  int iterations = 0;
+  for (size_t j = 0; j < b->ncols(); j++)
+  {
+    auto bj = boost::make_shared<DenseColumnMatrix>(b->col(j));
+    if (bj->norm() == 0.0)
+    {
+      x->col(j).setZero();
+      continue;
+    }
+    auto x0j = boost::make_shared<DenseColumnMatrix>(x->col(j));
+    DenseColumnMatrixHandle xj;
+    if (!run(A, bj, x0j, xj))
+      return false;
+    x->col(j) = *xj;
+    iterations = std::max(iterations, iterations_);
+  }
+  iterations_ = iterations;
   return true;
 }
 
 AlgorithmOutput SolveLinearSystemAlgo::run(const AlgorithmInput& input) const
 {
   auto lhs = input.get<SparseRowMatrix>(Variables::LHS);
+
+  // a dense right hand side with several columns is solved as one block
+  auto rhsBlock = input.get<DenseMatrix>(Variables::RHS);
   auto rhs = input.get<DenseColumnMatrix>(Variables::RHS);
 
-  DenseColumnMatrixHandle solution;
+  // In warm start mode the previous solution seeds the next solve, as long as
+  // the system keeps its dimensions
+  const bool warmStart = get(Parameters::WarmStart).toBool();
+  const auto rows = rhsBlock ? rhsBlock->nrows() : (rhs ? rhs->nrows() : 0);
+  const auto columns = rhsBlock ? rhsBlock->ncols() : 1;
+  DenseMatrixHandle x0;
+  if (warmStart && previousSolution_ && previousSolution_->nrows() == rows && previousSolution_->ncols() == columns)
+    x0 = previousSolution_;
+  if (!warmStart)
+  {
+    previousSolution_.reset();
+    coldStartIterations_ = -1;
+  }
 
-  bool success = run(lhs, rhs, DenseColumnMatrixHandle(), solution);
+  DenseMatrixHandle solution;
+  bool success;
+  if (rhsBlock)
+  {
+    success = run(lhs, rhsBlock, x0, solution);
+  }
+  else
+  {
+    DenseColumnMatrixHandle x0Column, solutionColumn;
+    if (x0)
+      x0Column = boost::make_shared<DenseColumnMatrix>(x0->col(0));
+    success = run(lhs, rhs, x0Column, solutionColumn);
+    if (success)
+      solution = boost::make_shared<DenseMatrix>(solutionColumn->col(0));
+  }
   if (!success)
   {
     BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("SolveLinearSystem Algo returned false--need to improve error conditions so it throws before returning."));
   }
 
+  if (warmStart)
+  {
+    previousSolution_ = solution;
+    std::ostringstream ostr;
+    if (!x0)
+    {
+      coldStartIterations_ = iterations_;
+      ostr << "Warm start: no previous solution of matching size, started from zero and took " << iterations_ << " iterations";
+    }
+    else if (coldStartIterations_ >= 0)
+    {
+      const int saved = coldStartIterations_ - iterations_;
+      ostr << "Warm start from the previous solution took " << iterations_ << " iterations, ";
+      if (saved >= 0)
+        ostr << saved << " fewer";
+      else
+        ostr << -saved << " more";
+      ostr << " than the last solve started from zero (" << coldStartIterations_ << ")";
+    }
+    else
+    {
+      ostr << "Warm start from the previous solution took " << iterations_ << " iterations";
+    }
+    remark(ostr.str());
+  }
+
   AlgorithmOutput output;
-  output[Variables::Solution] = boost::make_shared<DenseMatrix>(solution->col(0));
+  output[Variables::Solution] = solution;
   return output;
 }
@@ -42,6 +42,13 @@ namespace Core {
 namespace Algorithms {
 namespace Math {
 
+class ParallelPreconditioner;
+class ReverseCuthillMcKee;
+
+ALGORITHM_PARAMETER_DECL(WarmStart);
+ALGORITHM_PARAMETER_DECL(MixedPrecision);
+ALGORITHM_PARAMETER_DECL(ReorderMatrix);
+
 // Solve a linear system in parallel using a standard iterative method
 // Method solves A*x = b, with x0 being the initializer for the solution
 
@@ -50,6 +57,11 @@ class SCISHARE SolveLinearSystemAlgo : public AlgorithmBase
   public:
     SolveLinearSystemAlgo();
 
+    // With MixedPrecision set, the cg method with the None or Jacobi
+    // preconditioner iterates in single precision and refines the solution
+    // with double precision residuals until TargetError is met.
+    // With ReorderMatrix set, the system is solved in the reverse Cuthill-McKee
+    // order of A, which is computed once per sparsity pattern.
     bool run(Datatypes::SparseRowMatrixHandle A,
              Datatypes::DenseColumnMatrixHandle b,
              Datatypes::DenseColumnMatrixHandle x0,
@@ -61,7 +73,37 @@ class SCISHARE SolveLinearSystemAlgo : public AlgorithmBase
              Datatypes::DenseColumnMatrixHandle x0,
              Datatypes::DenseColumnMatrixHandle& x) const;
 
+    // Solves A*X = B for all columns of B at once. With the cg method and the
+    // None or Jacobi preconditioner the columns share every sweep over A,
+    // otherwise (and in mixed precision mode) they are solved one after the other.
+    bool run(Datatypes::SparseRowMatrixHandle A,
+             Datatypes::DenseMatrixHandle b,
+             Datatypes::DenseMatrixHandle x0,
+             Datatypes::DenseMatrixHandle& x) const;
+
     AlgorithmOutput run(const AlgorithmInput& input) const;
+
+    // Iterations of the most recent solve, the slowest column for a block
+    int iterations() const { return iterations_; }
+
+  private:
+    // A in the bandwidth reducing order when ReorderMatrix is set, null otherwise
+    Datatypes::SparseRowMatrixHandle reordered(Datatypes::SparseRowMatrixHandle A) const;
+
+    // AMG hierarchy or incomplete factors of the last matrix solved, kept as
+    // long as the same matrix is solved again with the same preconditioner
+    mutable boost::shared_ptr<ParallelPreconditioner> preconditioner_;
+    mutable std::string preconditionerName_;
+    // Warm start state of run(AlgorithmInput): the last solution, and the
+    // iterations of the last solve that started from zero, to report savings
+    mutable Datatypes::DenseMatrixHandle previousSolution_;
+    mutable int coldStartIterations_;
+    mutable int iterations_;
+    // Ordering of the last sparsity pattern solved with ReorderMatrix, and the
+    // last matrix in that order, kept so cached preconditioners stay valid
+    mutable boost::shared_ptr<ReverseCuthillMcKee> ordering_;
+    mutable Datatypes::SparseRowMatrixHandle orderedSource_;
+    mutable Datatypes::SparseRowMatrixHandle orderedMatrix_;
 };
 
 
@@ -0,0 +1,450 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <cmath>
+#include <random>
+#include <Eigen/QR>
+#include <Core/Algorithms/Math/ParallelAlgebra/AlgebraicMultigrid.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Logging/Log.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Datatypes;
+
+namespace
+{
+  std::vector<double> inverseDiagonal(const SparseRowMatrix& A)
+  {
+    const index_type n = A.nrows();
+    std::vector<double> invDiag(n, 0.0);
+    for (index_type i = 0; i < n; ++i)
+    {
+      const double d = A.coeff(i, i);
+      if (d != 0.0)
+        invDiag[i] = 1.0/d;
+    }
+    return invDiag;
+  }
+
+  /// Power iteration estimate of the spectral radius of D^-1 A
+  double spectralRadius(const SparseRowMatrix& A, const std::vector<double>& invDiag)
+  {
+    const index_type n = A.nrows();
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    Eigen::VectorXd v(n);
+    for (index_type i = 0; i < n; ++i)
+      v[i] = dist(gen);
+
+    double rho = 0.0;
+    for (int k = 0; k < 15; ++k)
+    {
+      const double norm = v.norm();
+      if (norm == 0.0)
+        break;
+      v /= norm;
+      Eigen::VectorXd w = A * v;
+      for (index_type i = 0; i < n; ++i)
+        w[i] *= invDiag[i];
+      rho = w.norm();
+      v.swap(w);
+    }
+    return rho;
+  }
+
+  ParallelLinearAlgebra::ParallelMatrix parallelMatrix(SparseRowMatrix& M)
+  {
+    M.makeCompressed();
+    ParallelLinearAlgebra::ParallelMatrix pm;
+    pm.data_ = M.valuePtr();
+    pm.rows_ = M.outerIndexPtr();
+    pm.columns_ = M.innerIndexPtr();
+    pm.m_ = M.nrows();
+    pm.n_ = M.ncols();
+    pm.nnz_ = M.nonZeros();
+    return pm;
+  }
+
+  ParallelLinearAlgebra::ParallelVector parallelVector(double* data, size_t size)
+  {
+    ParallelLinearAlgebra::ParallelVector pv;
+    pv.data_ = data;
+    pv.size_ = size;
+    return pv;
+  }
+
+  /// Greedy aggregation of strongly coupled unknowns. Returns the aggregate of
+  /// every row; rows without strong couplings are left out (-1) and are only
+  /// handled by the smoother.
+  std::vector<index_type> aggregate(const SparseRowMatrix& A, double theta, index_type& numAggregates)
+  {
+    const index_type n = A.nrows();
+    const auto outer = A.outerIndexPtr();
+    const auto inner = A.innerIndexPtr();
+    const auto values = A.valuePtr();
+
+    std::vector<double> diag(n);
+    for (index_type i = 0; i < n; ++i)
+      diag[i] = std::fabs(A.coeff(i, i));
+
+    // Strong neighbors of every row, in CSR layout
+    std::vector<index_type> strongOffsets(n+1, 0);
+    std::vector<index_type> strong;
+    strong.reserve(A.nonZeros());
+    for (index_type i = 0; i < n; ++i)
+    {
+      for (auto k = outer[i]; k < outer[i+1]; ++k)
+      {
+        const auto j = inner[k];
+        if (j != i && std::fabs(values[k]) > theta*std::sqrt(diag[i]*diag[j]))
+          strong.push_back(j);
+      }
+      strongOffsets[i+1] = strong.size();
+    }
+
+    const index_type unassigned = -1, isolated = -2;
+    std::vector<index_type> agg(n, unassigned);
+    numAggregates = 0;
+
+    // Phase 1: rows whose whole strong neighborhood is free seed a new aggregate
+    for (index_type i = 0; i < n; ++i)
+    {
+      if (strongOffsets[i] == strongOffsets[i+1])
+      {
+        agg[i] = isolated;
+        continue;
+      }
+      if (agg[i] != unassigned)
+        continue;
+      bool free = true;
+      for (auto k = strongOffsets[i]; k < strongOffsets[i+1] && free; ++k)
+        free = agg[strong[k]] == unassigned;
+      if (!free)
+        continue;
+      agg[i] = numAggregates;
+      for (auto k = strongOffsets[i]; k < strongOffsets[i+1]; ++k)
+        agg[strong[k]] = numAggregates;
+      numAggregates++;
+    }
+
+    // Phase 2: attach leftover rows to a neighboring aggregate from phase 1
+    const std::vector<index_type> seeded(agg);
+    for (index_type i = 0; i < n; ++i)
+    {
+      if (agg[i] != unassigned)
+        continue;
+      for (auto k = strongOffsets[i]; k < strongOffsets[i+1]; ++k)
+      {
+        if (seeded[strong[k]] >= 0)
+        {
+          agg[i] = seeded[strong[k]];
+          break;
+        }
+      }
+    }
+
+    // Phase 3: whatever is left forms aggregates with its free neighbors
+    for (index_type i = 0; i < n; ++i)
+    {
+      if (agg[i] != unassigned)
+        continue;
+      agg[i] = numAggregates;
+      for (auto k = strongOffsets[i]; k < strongOffsets[i+1]; ++k)
+      {
+        if (agg[strong[k]] == unassigned)
+          agg[strong[k]] = numAggregates;
+      }
+      numAggregates++;
+    }
+
+    for (auto& a : agg)
+    {
+      if (a == isolated)
+        a = unassigned;
+    }
+    return agg;
+  }
+
+  /// Piecewise constant prolongator of the aggregates, with unit norm columns
+  SparseRowMatrix tentativeProlongator(const std::vector<index_type>& agg, index_type numAggregates)
+  {
+    std::vector<double> count(numAggregates, 0.0);
+    for (auto a : agg)
+    {
+      if (a >= 0)
+        count[a] += 1.0;
+    }
+
+    std::vector<SparseRowMatrix::Triplet> entries;
+    entries.reserve(agg.size());
+    for (size_t i = 0; i < agg.size(); ++i)
+    {
+      if (agg[i] >= 0)
+        entries.push_back(SparseRowMatrix::Triplet(i, agg[i], 1.0/std::sqrt(count[agg[i]])));
+    }
+    SparseRowMatrix T(static_cast<int>(agg.size()), static_cast<int>(numAggregates));
+    T.setFromTriplets(entries.begin(), entries.end());
+    return T;
+  }
+}
+
+AlgebraicMultigrid::Parameters::Parameters() :
+  strengthThreshold(0.08),
+  smoothingSweeps(1),
+  coarseSize(400),
+  maxDirectSize(2000),
+  maxLevels(10)
+{
+}
+
+AlgebraicMultigrid::AlgebraicMultigrid(SparseRowMatrixHandle A, const Parameters& parameters) :
+  fineNonZeros_(A->nonZeros()),
+  smoothingSweeps_(std::max(parameters.smoothingSweeps, 1)),
+  maxDirectSize_(parameters.maxDirectSize),
+  coarseSweeps_(0)
+{
+  Level fine;
+  fine.A = A;
+  levels_.push_back(fine);
+  build(parameters);
+}
+
+void AlgebraicMultigrid::build(const Parameters& parameters)
+{
+  double theta = parameters.strengthThreshold;
+  while (true)
+  {
+    auto& level = levels_.back();
+    auto& A = *level.A;
+    setupSmoother(level);
+
+    if (static_cast<size_type>(A.nrows()) <= parameters.coarseSize || static_cast<int>(levels_.size()) >= parameters.maxLevels)
+      break;
+
+    index_type numAggregates;
+    auto agg = aggregate(A, theta, numAggregates);
+    // Stop once aggregation no longer reduces the problem noticeably
+    if (numAggregates == 0 || numAggregates > 0.8*A.nrows())
+      break;
+
+    // Smooth the tentative prolongator with one damped Jacobi step: P = (I - w D^-1 A) T
+    auto T = tentativeProlongator(agg, numAggregates);
+    SparseRowMatrix AT = A * T;
+    for (index_type i = 0; i < AT.outerSize(); ++i)
+    {
+      const double scale = -level.omega*level.invDiag[i];
+      for (SparseRowMatrix::InnerIterator it(AT, i); it; ++it)
+        it.valueRef() *= scale;
+    }
+    level.P = boost::make_shared<SparseRowMatrix>(T + AT);
+    level.R = boost::make_shared<SparseRowMatrix>(level.P->transpose());
+    level.pP = parallelMatrix(*level.P);
+    level.pR = parallelMatrix(*level.R);
+
+    SparseRowMatrix AP = A * (*level.P);
+    Level coarse;
+    coarse.A = boost::make_shared<SparseRowMatrix>((*level.R) * AP);
+    coarse.x.resize(numAggregates);
+    coarse.b.resize(numAggregates);
+    levels_.push_back(coarse);
+
+    theta *= 0.5;
+  }
+
+  setupCoarseSolver();
+
+  std::ostringstream sizes;
+  for (size_t k = 0; k < levels_.size(); ++k)
+    sizes << (k ? " " : "") << levelSize(k);
+  LOG_DEBUG("AMG hierarchy: {} levels ({}), operator complexity {}", levels_.size(), sizes.str(), operatorComplexity());
+}
+
+void AlgebraicMultigrid::setupSmoother(Level& level)
+{
+  auto& A = *level.A;
+  level.pA = parallelMatrix(A);
+  level.invDiag = inverseDiagonal(A);
+  const double rho = spectralRadius(A, level.invDiag);
+  level.omega = rho > 0.0 ? 4.0/(3.0*rho) : 0.0;
+  level.t.resize(A.nrows());
+}
+
+void AlgebraicMultigrid::setupCoarseSolver()
+{
+  coarseInverse_.clear();
+  coarseSweeps_ = 0;
+  const auto& coarsest = *levels_.back().A;
+  const index_type n = coarsest.nrows();
+  if (n <= maxDirectSize_)
+  {
+    // The pseudo inverse also covers the singular systems of pure Neumann problems
+    Eigen::MatrixXd dense(coarsest);
+    Eigen::MatrixXd inverse = dense.completeOrthogonalDecomposition().pseudoInverse();
+    coarseInverse_.resize(n*n);
+    for (index_type i = 0; i < n; ++i)
+      for (index_type j = 0; j < n; ++j)
+        coarseInverse_[i*n+j] = inverse(i, j);
+  }
+  else
+  {
+    coarseSweeps_ = 10;
+  }
+}
+
+void AlgebraicMultigrid::update(SparseRowMatrixHandle A)
+{
+  // The prolongators built from the old values still span a good coarse space;
+  // the Galerkin operators are recomputed so the coarse correction stays exact
+  levels_[0].A = A;
+  fineNonZeros_ = A->nonZeros();
+  for (size_t l = 0; l < levels_.size(); ++l)
+  {
+    auto& level = levels_[l];
+    setupSmoother(level);
+    if (l + 1 < levels_.size())
+    {
+      SparseRowMatrix AP = (*level.A) * (*level.P);
+      levels_[l+1].A = boost::make_shared<SparseRowMatrix>((*level.R) * AP);
+    }
+  }
+  setupCoarseSolver();
+}
+
+bool AlgebraicMultigrid::matchesPattern(SparseRowMatrixHandle A) const
+{
+  return A && sameSparsityPattern(*A, *levels_[0].A);
+}
+
+bool AlgebraicMultigrid::matches(SparseRowMatrixHandle A) const
+{
+  // The hierarchy keeps the fine matrix alive, so pointer identity is meaningful
+  return A && A == levels_[0].A && A->nonZeros() == fineNonZeros_;
+}
+
+size_type AlgebraicMultigrid::levelSize(size_t level) const
+{
+  return levels_[level].A->nrows();
+}
+
+double AlgebraicMultigrid::operatorComplexity() const
+{
+  double nnz = 0.0;
+  for (const auto& level : levels_)
+    nnz += level.A->nonZeros();
+  return nnz / fineNonZeros_;
+}
+
+void AlgebraicMultigrid::vcycle(ParallelLinearAlgebra& PLA,
+  const ParallelLinearAlgebra::ParallelVector& r,
+  ParallelLinearAlgebra::ParallelVector& z)
+{
+  cycle(PLA, 0, r.data_, z.data_);
+}
+
+void AlgebraicMultigrid::smooth(ParallelLinearAlgebra& PLA, Level& level, const double* b, double* x, bool zeroGuess)
+{
+  size_t start, end;
+  PLA.range(level.A->nrows(), start, end);
+  const double* invDiag = &level.invDiag[0];
+  double* t = &level.t[0];
+  const double omega = level.omega;
+
+  // the coarsest level is smoothed instead of solved when it is too large
+  const bool coarsest = !level.P;
+  int sweeps = coarsest && coarseSweeps_ > 0 ? coarseSweeps_ : smoothingSweeps_;
+  if (zeroGuess)
+  {
+    for (size_t i = start; i < end; ++i)
+      x[i] = omega*invDiag[i]*b[i];
+    sweeps--;
+  }
+
+  auto X = parallelVector(x, level.t.size());
+  auto T = parallelVector(t, level.t.size());
+  for (int k = 0; k < sweeps; ++k)
+  {
+    PLA.mult(level.pA, X, T);
+    for (size_t i = start; i < end; ++i)
+      x[i] += omega*invDiag[i]*(b[i] - t[i]);
+  }
+}
+
+void AlgebraicMultigrid::cycle(ParallelLinearAlgebra& PLA, size_t l, const double* b, double* x)
+{
+  auto& level = levels_[l];
+  const size_t n = level.t.size();
+  size_t start, end;
+  PLA.range(n, start, end);
+
+  if (l + 1 == levels_.size())
+  {
+    if (coarseInverse_.empty())
+    {
+      smooth(PLA, level, b, x, true);
+      return;
+    }
+
+    // the right hand side was assembled by all threads
+    PLA.wait();
+    for (size_t i = start; i < end; ++i)
+    {
+      const double* row = &coarseInverse_[i*n];
+      double sum = 0.0;
+      for (size_t j = 0; j < n; ++j)
+        sum += row[j]*b[j];
+      x[i] = sum;
+    }
+    return;
+  }
+
+  auto& coarse = levels_[l+1];
+  double* t = &level.t[0];
+  auto X = parallelVector(x, n);
+  auto T = parallelVector(t, n);
+  auto XC = parallelVector(&coarse.x[0], coarse.x.size());
+  auto BC = parallelVector(&coarse.b[0], coarse.b.size());
+
+  smooth(PLA, level, b, x, true);
+
+  // restrict the residual
+  PLA.mult(level.pA, X, T);
+  for (size_t i = start; i < end; ++i)
+    t[i] = b[i] - t[i];
+  PLA.mult(level.pR, T, BC);
+
+  cycle(PLA, l+1, &coarse.b[0], &coarse.x[0]);
+
+  // coarse grid correction
+  PLA.mult(level.pP, XC, T);
+  for (size_t i = start; i < end; ++i)
+    x[i] += t[i];
+
+  smooth(PLA, level, b, x, false);
+}
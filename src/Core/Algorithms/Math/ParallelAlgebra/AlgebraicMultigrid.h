@@ -0,0 +1,113 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_MATH_PARALLELALGEBRA_ALGEBRAICMULTIGRID_H
+#define CORE_ALGORITHMS_MATH_PARALLELALGEBRA_ALGEBRAICMULTIGRID_H
+
+#include <vector>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelPreconditioner.h>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+  /// Smoothed aggregation algebraic multigrid, used as a preconditioner by the
+  /// parallel iterative solvers. The hierarchy is set up once per matrix; a
+  /// V-cycle is then applied by all threads of a ParallelLinearAlgebra run.
+  class SCISHARE AlgebraicMultigrid : public ParallelPreconditioner
+  {
+  public:
+    struct SCISHARE Parameters
+    {
+      Parameters();
+
+      double strengthThreshold;   ///< strong coupling: |a_ij| > theta*sqrt(|a_ii*a_jj|)
+      int smoothingSweeps;        ///< damped Jacobi sweeps before and after coarse correction
+      size_type coarseSize;       ///< stop coarsening below this number of unknowns
+      size_type maxDirectSize;    ///< largest coarse system solved directly
+      int maxLevels;
+    };
+
+    explicit AlgebraicMultigrid(Datatypes::SparseRowMatrixHandle A, const Parameters& parameters = Parameters());
+
+    /// Whether the hierarchy was built for this matrix
+    bool matches(Datatypes::SparseRowMatrixHandle A) const override;
+    bool matchesPattern(Datatypes::SparseRowMatrixHandle A) const override;
+    /// Keeps the aggregates and prolongators, recomputes the level operators and smoothers
+    void update(Datatypes::SparseRowMatrixHandle A) override;
+
+    size_t numLevels() const { return levels_.size(); }
+    size_type levelSize(size_t level) const;
+    /// Total number of nonzeros in all level operators relative to the fine operator
+    double operatorComplexity() const;
+
+    /// z = M^-1 r with one V-cycle. Has to be called by all threads of the
+    /// ParallelLinearAlgebra run; r and z must be different vectors.
+    void vcycle(ParallelLinearAlgebra& PLA,
+                const ParallelLinearAlgebra::ParallelVector& r,
+                ParallelLinearAlgebra::ParallelVector& z);
+
+    void apply(ParallelLinearAlgebra& PLA,
+               const ParallelLinearAlgebra::ParallelVector& r,
+               ParallelLinearAlgebra::ParallelVector& z) override
+    {
+      vcycle(PLA, r, z);
+    }
+
+  private:
+    struct Level
+    {
+      Datatypes::SparseRowMatrixHandle A;
+      Datatypes::SparseRowMatrixHandle P;  ///< prolongation to this level from the next coarser one
+      Datatypes::SparseRowMatrixHandle R;  ///< restriction, the transpose of P
+      ParallelLinearAlgebra::ParallelMatrix pA, pP, pR;
+      std::vector<double> invDiag;
+      double omega;
+      std::vector<double> x, b, t;
+    };
+
+    void build(const Parameters& parameters);
+    void setupSmoother(Level& level);
+    void setupCoarseSolver();
+    void cycle(ParallelLinearAlgebra& PLA, size_t level, const double* b, double* x);
+    void smooth(ParallelLinearAlgebra& PLA, Level& level, const double* b, double* x, bool zeroGuess);
+
+    std::vector<Level> levels_;
+    size_type fineNonZeros_;
+    int smoothingSweeps_;
+    size_type maxDirectSize_;
+    /// (pseudo) inverse of the coarsest operator, row major; empty if it is smoothed instead
+    std::vector<double> coarseInverse_;
+    int coarseSweeps_;
+  };
+
+}}}}
+
+#endif
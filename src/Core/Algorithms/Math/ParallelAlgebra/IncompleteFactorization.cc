@@ -0,0 +1,472 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <algorithm>
+#include <cmath>
+#include <Core/Algorithms/Math/ParallelAlgebra/IncompleteFactorization.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Thread/Parallel.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  /// Levels with fewer rows are not worth a barrier; runs of them are solved by one thread
+  const size_t minimumParallelLevelSize = 512;
+  const size_t grainSize = 256;
+
+  /// Diagonal shifts tried when a factorization breaks down
+  const double initialShift = 1e-3;
+  const int maximumShifts = 12;
+  const double pivotTolerance = 1e-12;
+
+  bool stablePivot(double pivot, double diagonal, bool positive)
+  {
+    if (!std::isfinite(pivot))
+      return false;
+    return positive ? pivot > pivotTolerance*std::fabs(diagonal) : std::fabs(pivot) > pivotTolerance*std::fabs(diagonal);
+  }
+
+  bool stablePivot(const complex& pivot, const complex& diagonal, bool)
+  {
+    if (!std::isfinite(pivot.real()) || !std::isfinite(pivot.imag()))
+      return false;
+    return std::abs(pivot) > pivotTolerance*std::abs(diagonal);
+  }
+
+  /// Transpose of a strictly triangular CSR matrix
+  template <typename T>
+  void transpose(size_type n, const std::vector<index_type>& outer, const std::vector<index_type>& inner, const std::vector<T>& values,
+    std::vector<index_type>& outerT, std::vector<index_type>& innerT, std::vector<T>& valuesT)
+  {
+    outerT.assign(n + 1, 0);
+    for (auto j : inner)
+      outerT[j + 1]++;
+    for (size_type i = 0; i < n; ++i)
+      outerT[i + 1] += outerT[i];
+
+    innerT.resize(inner.size());
+    valuesT.resize(values.size());
+    std::vector<index_type> next(outerT.begin(), outerT.end() - 1);
+    for (size_type i = 0; i < n; ++i)
+    {
+      for (auto k = outer[i]; k < outer[i + 1]; ++k)
+      {
+        const auto pos = next[inner[k]]++;
+        innerT[pos] = i;
+        valuesT[pos] = values[k];
+      }
+    }
+  }
+
+  /// Builds the level schedule of a triangle, or only replaces its values
+  template <typename T>
+  void setTriangle(LevelScheduledTriangle<T>& triangle, size_type n,
+    const std::vector<index_type>& outer, const std::vector<index_type>& inner,
+    const std::vector<T>& values, const std::vector<T>& diagonal, bool lower, bool reuseSchedule)
+  {
+    if (reuseSchedule)
+      triangle.setValues(outer, values, diagonal);
+    else
+      triangle = LevelScheduledTriangle<T>(n, outer, inner, values, diagonal, lower);
+  }
+}
+
+template <typename T>
+LevelScheduledTriangle<T>::LevelScheduledTriangle(size_type n, const std::vector<index_type>& outer, const std::vector<index_type>& inner,
+  const std::vector<T>& values, const std::vector<T>& diagonal, bool lower) : numLevels_(0)
+{
+  // level of a row is one more than the deepest row it depends on
+  std::vector<index_type> level(n, 0);
+  for (size_type r = 0; r < n; ++r)
+  {
+    const auto i = lower ? r : n - 1 - r;
+    index_type l = 0;
+    for (auto k = outer[i]; k < outer[i + 1]; ++k)
+      l = std::max(l, level[inner[k]] + 1);
+    level[i] = l;
+    numLevels_ = std::max(numLevels_, static_cast<size_t>(l + 1));
+  }
+
+  std::vector<size_t> levelOffsets(numLevels_ + 1, 0);
+  for (auto l : level)
+    levelOffsets[l + 1]++;
+  for (size_t l = 0; l < numLevels_; ++l)
+    levelOffsets[l + 1] += levelOffsets[l];
+
+  rows_.resize(n);
+  std::vector<size_t> next(levelOffsets.begin(), levelOffsets.end() - 1);
+  for (size_type i = 0; i < n; ++i)
+    rows_[next[level[i]]++] = i;
+
+  // store the rows in level order so a level is read contiguously
+  outer_.resize(n + 1);
+  outer_[0] = 0;
+  inner_.reserve(inner.size());
+  values_.reserve(values.size());
+  invDiagonal_.resize(n);
+  for (size_type p = 0; p < n; ++p)
+  {
+    const auto i = rows_[p];
+    inner_.insert(inner_.end(), inner.begin() + outer[i], inner.begin() + outer[i + 1]);
+    values_.insert(values_.end(), values.begin() + outer[i], values.begin() + outer[i + 1]);
+    outer_[p + 1] = inner_.size();
+    invDiagonal_[p] = T(1) / diagonal[i];
+  }
+
+  for (size_t l = 0; l < numLevels_; ++l)
+  {
+    const size_t begin = levelOffsets[l], end = levelOffsets[l + 1];
+    const bool parallel = end - begin >= minimumParallelLevelSize;
+    if (!parallel && !stages_.empty() && !stages_.back().parallel)
+      stages_.back().end = end;
+    else
+      stages_.push_back({ begin, end, parallel });
+  }
+}
+
+template <typename T>
+void LevelScheduledTriangle<T>::setValues(const std::vector<index_type>& outer, const std::vector<T>& values, const std::vector<T>& diagonal)
+{
+  for (size_t p = 0; p < rows_.size(); ++p)
+  {
+    const auto i = rows_[p];
+    std::copy(values.begin() + outer[i], values.begin() + outer[i + 1], values_.begin() + outer_[p]);
+    invDiagonal_[p] = T(1) / diagonal[i];
+  }
+}
+
+template <typename T>
+void LevelScheduledTriangle<T>::solveRows(size_t begin, size_t end, const T* r, T* z) const
+{
+  for (size_t p = begin; p < end; ++p)
+  {
+    T sum = r[rows_[p]];
+    for (auto k = outer_[p]; k < outer_[p + 1]; ++k)
+      sum -= values_[k] * z[inner_[k]];
+    z[rows_[p]] = sum * invDiagonal_[p];
+  }
+}
+
+template <typename T>
+void LevelScheduledTriangle<T>::solve(const T* r, T* z) const
+{
+  for (const auto& stage : stages_)
+  {
+    if (stage.parallel)
+      Parallel::For(stage.begin, stage.end, [this, r, z](size_t b, size_t e) { solveRows(b, e, r, z); }, grainSize);
+    else
+      solveRows(stage.begin, stage.end, r, z);
+  }
+}
+
+template <typename T>
+void LevelScheduledTriangle<T>::solve(ParallelLinearAlgebra& PLA, const T* r, T* z) const
+{
+  for (const auto& stage : stages_)
+  {
+    if (stage.parallel)
+    {
+      size_t start, end;
+      PLA.range(stage.end - stage.begin, start, end);
+      solveRows(stage.begin + start, stage.begin + end, r, z);
+    }
+    else if (PLA.first())
+    {
+      solveRows(stage.begin, stage.end, r, z);
+    }
+    PLA.wait();
+  }
+}
+
+template <typename T>
+IncompleteFactorizationGeneric<T>::IncompleteFactorizationGeneric(const SparseRowMatrixGeneric<T>& A, IncompleteFactorizationType type) :
+  type_(type), shift_(0)
+{
+  if (A.nrows() != A.ncols())
+    BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Incomplete factorization needs a square matrix"));
+
+  factorizeShifted(A, false);
+}
+
+template <typename T>
+void IncompleteFactorizationGeneric<T>::refactorize(const SparseRowMatrixGeneric<T>& A)
+{
+  if (static_cast<size_t>(A.nrows()) != lower_.size())
+    BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Refactorization needs a matrix with the original sparsity pattern"));
+
+  shift_ = 0;
+  factorizeShifted(A, true);
+}
+
+template <typename T>
+void IncompleteFactorizationGeneric<T>::factorizeShifted(const SparseRowMatrixGeneric<T>& A, bool reuseSchedule)
+{
+  if (factorize(A, 0.0, reuseSchedule))
+    return;
+  for (int k = 0; k < maximumShifts; ++k)
+  {
+    shift_ = initialShift * std::pow(2.0, k);
+    if (factorize(A, shift_, reuseSchedule))
+      return;
+  }
+  BOOST_THROW_EXCEPTION(AlgorithmProcessingException()
+    << ErrorMessage(type_ == IncompleteFactorizationType::IC0 ?
+      "Incomplete Cholesky factorization broke down, the matrix is not positive definite" :
+      "Incomplete LU factorization broke down, the matrix has zero pivots"));
+}
+
+template <typename T>
+bool IncompleteFactorizationGeneric<T>::factorize(const SparseRowMatrixGeneric<T>& A, double shift, bool reuseSchedule)
+{
+  const size_type n = A.nrows();
+  const auto Aouter = A.outerIndexPtr();
+  const auto Ainner = A.innerIndexPtr();
+  const auto Avalues = A.valuePtr();
+  const auto Anonzeros = A.innerNonZeroPtr();
+  auto rowEnd = [&](index_type i) { return Anonzeros ? Aouter[i] + Anonzeros[i] : Aouter[i + 1]; };
+
+  // Split A into strictly lower, diagonal and strictly upper parts
+  std::vector<index_type> lowerOuter(n + 1, 0), upperOuter(n + 1, 0);
+  std::vector<index_type> lowerInner, upperInner;
+  std::vector<T> lowerValues, upperValues, diagonal(n, T(0)), original(n, T(0));
+  for (size_type i = 0; i < n; ++i)
+  {
+    for (auto k = Aouter[i]; k < rowEnd(i); ++k)
+    {
+      const auto j = Ainner[k];
+      if (j < i)
+      {
+        lowerInner.push_back(j);
+        lowerValues.push_back(Avalues[k]);
+      }
+      else if (j > i)
+      {
+        upperInner.push_back(j);
+        upperValues.push_back(Avalues[k]);
+      }
+      else
+        original[i] = Avalues[k];
+    }
+    diagonal[i] = original[i] * (1.0 + shift);
+    lowerOuter[i + 1] = lowerInner.size();
+    upperOuter[i + 1] = upperInner.size();
+  }
+
+  // dense scatter of the current row, indexed by column
+  std::vector<T> row(n, T(0));
+
+  if (type_ == IncompleteFactorizationType::IC0)
+  {
+    // Row by row: l_ik = (a_ik - sum_{m<k} l_im*l_km) / l_kk, l_ii = sqrt(a_ii - sum l_im^2)
+    for (size_type i = 0; i < n; ++i)
+    {
+      for (auto k = lowerOuter[i]; k < lowerOuter[i + 1]; ++k)
+        row[lowerInner[k]] = lowerValues[k];
+
+      T pivot = diagonal[i];
+      for (auto k = lowerOuter[i]; k < lowerOuter[i + 1]; ++k)
+      {
+        const auto col = lowerInner[k];
+        T sum = row[col];
+        for (auto m = lowerOuter[col]; m < lowerOuter[col + 1]; ++m)
+          sum -= lowerValues[m] * row[lowerInner[m]];
+        const T l = sum / diagonal[col];
+        row[col] = l;
+        lowerValues[k] = l;
+        pivot -= l * l;
+      }
+
+      for (auto k = lowerOuter[i]; k < lowerOuter[i + 1]; ++k)
+        row[lowerInner[k]] = T(0);
+
+      if (!stablePivot(pivot, original[i], true))
+        return false;
+      diagonal[i] = std::sqrt(pivot);
+    }
+
+    setTriangle(lower_, n, lowerOuter, lowerInner, lowerValues, diagonal, true, reuseSchedule);
+    std::vector<index_type> outerT, innerT;
+    std::vector<T> valuesT;
+    transpose(n, lowerOuter, lowerInner, lowerValues, outerT, innerT, valuesT);
+    setTriangle(upper_, n, outerT, innerT, valuesT, diagonal, false, reuseSchedule);
+  }
+  else
+  {
+    // IKJ variant: eliminate the lower entries of row i with the finished rows above it,
+    // dropping every update outside the pattern of A
+    std::vector<char> inRow(n, 0);
+    for (size_type i = 0; i < n; ++i)
+    {
+      for (auto k = lowerOuter[i]; k < lowerOuter[i + 1]; ++k)
+      {
+        row[lowerInner[k]] = lowerValues[k];
+        inRow[lowerInner[k]] = 1;
+      }
+      for (auto k = upperOuter[i]; k < upperOuter[i + 1]; ++k)
+      {
+        row[upperInner[k]] = upperValues[k];
+        inRow[upperInner[k]] = 1;
+      }
+
+      T pivot = diagonal[i];
+      for (auto k = lowerOuter[i]; k < lowerOuter[i + 1]; ++k)
+      {
+        const auto col = lowerInner[k];
+        const T l = row[col] / diagonal[col];
+        lowerValues[k] = l;
+        for (auto m = upperOuter[col]; m < upperOuter[col + 1]; ++m)
+        {
+          const auto j = upperInner[m];
+          if (j == i)
+            pivot -= l * upperValues[m];
+          else if (inRow[j])
+            row[j] -= l * upperValues[m];
+        }
+      }
+
+      for (auto k = lowerOuter[i]; k < lowerOuter[i + 1]; ++k)
+      {
+        row[lowerInner[k]] = T(0);
+        inRow[lowerInner[k]] = 0;
+      }
+      for (auto k = upperOuter[i]; k < upperOuter[i + 1]; ++k)
+      {
+        upperValues[k] = row[upperInner[k]];
+        row[upperInner[k]] = T(0);
+        inRow[upperInner[k]] = 0;
+      }
+
+      if (!stablePivot(pivot, original[i], false))
+        return false;
+      diagonal[i] = pivot;
+    }
+
+    const std::vector<T> unit(n, T(1));
+    setTriangle(lower_, n, lowerOuter, lowerInner, lowerValues, unit, true, reuseSchedule);
+    setTriangle(upper_, n, upperOuter, upperInner, upperValues, diagonal, false, reuseSchedule);
+
+    std::vector<index_type> outerT, innerT;
+    std::vector<T> valuesT;
+    transpose(n, upperOuter, upperInner, upperValues, outerT, innerT, valuesT);
+    setTriangle(lowerTransposed_, n, outerT, innerT, valuesT, diagonal, true, reuseSchedule);
+    transpose(n, lowerOuter, lowerInner, lowerValues, outerT, innerT, valuesT);
+    setTriangle(upperTransposed_, n, outerT, innerT, valuesT, unit, false, reuseSchedule);
+  }
+  return true;
+}
+
+template <typename T>
+void IncompleteFactorizationGeneric<T>::solve(const T* r, T* z) const
+{
+  std::vector<T> y(lower_.size());
+  lower_.solve(r, &y[0]);
+  upper_.solve(&y[0], z);
+}
+
+template <typename T>
+void IncompleteFactorizationGeneric<T>::solveTranspose(const T* r, T* z) const
+{
+  if (type_ == IncompleteFactorizationType::IC0)
+    return solve(r, z);
+  std::vector<T> y(lower_.size());
+  lowerTransposed_.solve(r, &y[0]);
+  upperTransposed_.solve(&y[0], z);
+}
+
+template <typename T>
+void IncompleteFactorizationGeneric<T>::solve(ParallelLinearAlgebra& PLA, const T* r, T* work, T* z) const
+{
+  // r is only complete once every thread has finished writing its part
+  PLA.wait();
+  lower_.solve(PLA, r, work);
+  upper_.solve(PLA, work, z);
+}
+
+template <typename T>
+void IncompleteFactorizationGeneric<T>::solveTranspose(ParallelLinearAlgebra& PLA, const T* r, T* work, T* z) const
+{
+  if (type_ == IncompleteFactorizationType::IC0)
+    return solve(PLA, r, work, z);
+  PLA.wait();
+  lowerTransposed_.solve(PLA, r, work);
+  upperTransposed_.solve(PLA, work, z);
+}
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+  template class SCISHARE LevelScheduledTriangle<double>;
+  template class SCISHARE LevelScheduledTriangle<complex>;
+  template class SCISHARE IncompleteFactorizationGeneric<double>;
+  template class SCISHARE IncompleteFactorizationGeneric<complex>;
+}}}}
+
+IncompleteFactorization::IncompleteFactorization(SparseRowMatrixHandle A, IncompleteFactorizationType type) :
+  A_(A), nonZeros_(A->nonZeros()), factors_(*A, type), work_(A->nrows())
+{
+}
+
+bool IncompleteFactorization::matches(SparseRowMatrixHandle A) const
+{
+  // the factors keep the matrix alive, so pointer identity is meaningful
+  return A && A == A_ && A->nonZeros() == nonZeros_;
+}
+
+bool IncompleteFactorization::matchesPattern(SparseRowMatrixHandle A) const
+{
+  return A && sameSparsityPattern(*A, *A_);
+}
+
+void IncompleteFactorization::update(SparseRowMatrixHandle A)
+{
+  factors_.refactorize(*A);
+  A_ = A;
+  nonZeros_ = A->nonZeros();
+}
+
+void IncompleteFactorization::apply(ParallelLinearAlgebra& PLA,
+  const ParallelLinearAlgebra::ParallelVector& r,
+  ParallelLinearAlgebra::ParallelVector& z)
+{
+  factors_.solve(PLA, r.data_, &work_[0], z.data_);
+}
+
+void IncompleteFactorization::applyTranspose(ParallelLinearAlgebra& PLA,
+  const ParallelLinearAlgebra::ParallelVector& r,
+  ParallelLinearAlgebra::ParallelVector& z)
+{
+  factors_.solveTranspose(PLA, r.data_, &work_[0], z.data_);
+}
@@ -0,0 +1,157 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_MATH_PARALLELALGEBRA_INCOMPLETEFACTORIZATION_H
+#define CORE_ALGORITHMS_MATH_PARALLELALGEBRA_INCOMPLETEFACTORIZATION_H
+
+#include <vector>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelPreconditioner.h>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+  /// Sparse triangular factor with its rows grouped into levels: a row only
+  /// depends on rows of earlier levels, so all rows of a level can be solved
+  /// concurrently. Rows are stored in level order.
+  template <typename T>
+  class LevelScheduledTriangle
+  {
+  public:
+    LevelScheduledTriangle() : numLevels_(0) {}
+    /// Strictly lower or upper triangular part in CSR layout, plus the diagonal
+    LevelScheduledTriangle(size_type n, const std::vector<index_type>& outer, const std::vector<index_type>& inner,
+      const std::vector<T>& values, const std::vector<T>& diagonal, bool lower);
+
+    size_t numLevels() const { return numLevels_; }
+    size_t size() const { return rows_.size(); }
+
+    /// New values for the same sparsity pattern, keeping the level schedule
+    void setValues(const std::vector<index_type>& outer, const std::vector<T>& values, const std::vector<T>& diagonal);
+
+    /// z = T^-1 r on the Parallel thread pool; r and z must be different vectors
+    void solve(const T* r, T* z) const;
+    /// Same within a ParallelLinearAlgebra run, with a barrier after every level
+    void solve(ParallelLinearAlgebra& PLA, const T* r, T* z) const;
+
+  private:
+    /// Consecutive levels that are either wide enough to be split over the
+    /// threads, or are solved in one go by a single thread
+    struct Stage
+    {
+      size_t begin, end;
+      bool parallel;
+    };
+
+    void solveRows(size_t begin, size_t end, const T* r, T* z) const;
+
+    std::vector<index_type> rows_;
+    std::vector<index_type> outer_;
+    std::vector<index_type> inner_;
+    std::vector<T> values_;
+    std::vector<T> invDiagonal_;
+    std::vector<Stage> stages_;
+    size_t numLevels_;
+  };
+
+  enum class IncompleteFactorizationType
+  {
+    IC0,    ///< incomplete Cholesky A ~ L*L^T, for symmetric matrices
+    ILU0    ///< incomplete LU A ~ L*U
+  };
+
+  /// Incomplete factorization without fill-in: the factors keep the sparsity
+  /// pattern of A. If a pivot breaks down, the factorization is repeated with
+  /// an increasingly shifted diagonal.
+  template <typename T>
+  class IncompleteFactorizationGeneric
+  {
+  public:
+    IncompleteFactorizationGeneric(const Datatypes::SparseRowMatrixGeneric<T>& A, IncompleteFactorizationType type);
+
+    /// Factorizes new values of a matrix with the sparsity pattern of the original
+    /// one, reusing the level schedules of the triangular solves
+    void refactorize(const Datatypes::SparseRowMatrixGeneric<T>& A);
+
+    IncompleteFactorizationType type() const { return type_; }
+    /// Relative diagonal shift that was needed for a stable factorization
+    double shift() const { return shift_; }
+    /// Number of levels of the forward and backward substitution
+    size_t numLevels() const { return lower_.numLevels() + upper_.numLevels(); }
+
+    /// z = M^-1 r on the Parallel thread pool
+    void solve(const T* r, T* z) const;
+    /// z = M^-T r
+    void solveTranspose(const T* r, T* z) const;
+
+    /// Same within a ParallelLinearAlgebra run; work has to be shared by all threads
+    void solve(ParallelLinearAlgebra& PLA, const T* r, T* work, T* z) const;
+    void solveTranspose(ParallelLinearAlgebra& PLA, const T* r, T* work, T* z) const;
+
+  private:
+    void factorizeShifted(const Datatypes::SparseRowMatrixGeneric<T>& A, bool reuseSchedule);
+    bool factorize(const Datatypes::SparseRowMatrixGeneric<T>& A, double shift, bool reuseSchedule);
+
+    IncompleteFactorizationType type_;
+    double shift_;
+    LevelScheduledTriangle<T> lower_, upper_;
+    /// Factors of M^T = U^T*L^T, only needed for ILU(0) as IC(0) is symmetric
+    LevelScheduledTriangle<T> lowerTransposed_, upperTransposed_;
+  };
+
+  /// IC(0)/ILU(0) preconditioner of the parallel iterative solvers
+  class SCISHARE IncompleteFactorization : public ParallelPreconditioner
+  {
+  public:
+    IncompleteFactorization(Datatypes::SparseRowMatrixHandle A, IncompleteFactorizationType type);
+
+    bool matches(Datatypes::SparseRowMatrixHandle A) const override;
+    bool matchesPattern(Datatypes::SparseRowMatrixHandle A) const override;
+    /// Refactorizes with the level schedules of the triangular solves kept
+    void update(Datatypes::SparseRowMatrixHandle A) override;
+    const IncompleteFactorizationGeneric<double>& factors() const { return factors_; }
+
+    void apply(ParallelLinearAlgebra& PLA,
+               const ParallelLinearAlgebra::ParallelVector& r,
+               ParallelLinearAlgebra::ParallelVector& z) override;
+    void applyTranspose(ParallelLinearAlgebra& PLA,
+                        const ParallelLinearAlgebra::ParallelVector& r,
+                        ParallelLinearAlgebra::ParallelVector& z) override;
+
+  private:
+    Datatypes::SparseRowMatrixHandle A_;
+    size_type nonZeros_;
+    IncompleteFactorizationGeneric<double> factors_;
+    std::vector<double> work_;
+  };
+
+}}}}
+
+#endif
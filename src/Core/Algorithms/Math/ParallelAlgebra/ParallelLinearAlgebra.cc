@@ -40,6 +40,7 @@
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
 #include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/VectorKernels.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Thread/Parallel.h>
 
@@ -57,7 +58,8 @@ ParallelLinearAlgebraBase::~ParallelLinearAlgebraBase()
 ParallelLinearAlgebra::ParallelLinearAlgebra(ParallelLinearAlgebraSharedData& data, int proc)
   : data_(data),
   proc_(proc),
-  nproc_(data.numProcs())
+  nproc_(data.numProcs()),
+  kernels_(vectorKernels())
 {
   // Compute local size
   size_ = data.getSize();
@@ -83,6 +85,13 @@ void ParallelLinearAlgebra::wait()
   data_.wait();
 }
 
+void ParallelLinearAlgebra::range(size_t size, size_t& start, size_t& end) const
+{
+  const size_t local_size = size/nproc_;
+  start = proc_*local_size;
+  end = (proc_ == nproc_-1) ? size : start + local_size;
+}
+
 bool ParallelLinearAlgebra::add_vector(DenseColumnMatrixHandle mat, ParallelVector& V)
 {
   // Basic checks
@@ -147,38 +156,7 @@ bool ParallelLinearAlgebra::add_matrix(SparseRowMatrixHandle mat, ParallelMatrix
 
 void ParallelLinearAlgebra::mult(const ParallelVector& a, const ParallelVector& b, ParallelVector& r)
 {
-  double* a_ptr = a.data_+start_;
-  double* b_ptr = b.data_+start_;
-  double* r_ptr = r.data_+start_;
-
-  size_t j = 0;
-  for (; j<local_size16_; j+=16)
-  {
-    *r_ptr = (*a_ptr)*(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = (*a_ptr)*(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = (*a_ptr)*(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = (*a_ptr)*(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-
-    *r_ptr = (*a_ptr)*(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = (*a_ptr)*(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = (*a_ptr)*(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = (*a_ptr)*(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-
-    *r_ptr = (*a_ptr)*(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = (*a_ptr)*(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = (*a_ptr)*(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = (*a_ptr)*(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-
-    *r_ptr = (*a_ptr)*(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = (*a_ptr)*(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = (*a_ptr)*(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = (*a_ptr)*(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-  }
-
-  for (; j<local_size_; j++)
-  {
-    *r_ptr = (*a_ptr)*(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-  }
+  kernels_.mult(a.data_+start_, b.data_+start_, r.data_+start_, local_size_);
 }
 
 void ParallelLinearAlgebra::add(const ParallelVector& a, const ParallelVector& b, ParallelVector& r)
@@ -386,75 +364,18 @@ void ParallelLinearAlgebra::absthreshold_invert(const ParallelVector& a, Paralle
 
 void ParallelLinearAlgebra::scale_add(double s, const ParallelVector& a, const ParallelVector& b, ParallelVector& r)
 {
-  double* a_ptr = a.data_+start_;
-  double* b_ptr = b.data_+start_;
-  double* r_ptr = r.data_+start_;
-
-  size_t j=0;
-  for (; j<local_size16_; j+=16)
-  {
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-  }
+  kernels_.scaleAdd(s, a.data_+start_, b.data_+start_, r.data_+start_, local_size_);
+}
 
-  for (; j<local_size_; j++)
-  {
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-  }
+double ParallelLinearAlgebra::scale_add_norm(double s, const ParallelVector& a, const ParallelVector& b, ParallelVector& r)
+{
+  double val = kernels_.scaleAddSumOfSquares(s, a.data_+start_, b.data_+start_, r.data_+start_, local_size_);
+  return(sqrt(reduce_sum(val)));
 }
 
 double ParallelLinearAlgebra::dot(const ParallelVector& a, const ParallelVector& b)
 {
-  double* a_ptr = a.data_+start_;
-  double* b_ptr = b.data_+start_;
-
-  double val = 0.0;
-  size_t j=0;
-  for (; j<local_size16_; j+=16)
-  {
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-  }
-
-  for (; j<local_size_; j++)
-  {
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-  }
-
+  double val = kernels_.dot(a.data_+start_, b.data_+start_, local_size_);
   return(reduce_sum(val));
 }
 
@@ -530,39 +451,7 @@ void ParallelLinearAlgebra::ones(ParallelVector& a)
 
 double ParallelLinearAlgebra::norm(const ParallelVector& a)
 {
-  double* a_ptr = a.data_+start_;
-
-  double val = 0.0;
-  size_t j=0;
-
-  for (; j<local_size16_; j+=16)
-  {
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-  }
-
-  for (; j<local_size_; j++)
-  {
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-  }
-
+  double val = kernels_.sumOfSquares(a.data_+start_, local_size_);
   return(sqrt(reduce_sum(val)));
 }
 
@@ -629,24 +518,22 @@ void ParallelLinearAlgebra::mult(const ParallelMatrix& a, const ParallelVector&
 {
   wait();
 
-  double* idata = b.data_;
-  double* odata = r.data_;
+  // Non-square operators (e.g. multigrid transfers) split their own rows
+  size_t start, end;
+  range(a.m_, start, end);
 
-  double* data = a.data_;
-  auto rows = a.rows_;
-  auto columns = a.columns_;
+  kernels_.spmv(a.rows_, a.columns_, a.data_, b.data_, r.data_, start, end);
+}
 
-  for(size_t i=start_;i<end_;i++)
-  {
-    double sum = 0.0;
-    index_type row_idx = rows[i];
-    index_type next_idx = rows[i+1];
-    for(index_type j=row_idx;j<next_idx;j++)
-    {
-	    sum+=data[j]*idata[columns[j]];
-    }
-    odata[i]=sum;
-  }
+double ParallelLinearAlgebra::mult_dot(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r)
+{
+  wait();
+
+  size_t start, end;
+  range(a.m_, start, end);
+
+  double val = kernels_.spmvDot(a.rows_, a.columns_, a.data_, b.data_, r.data_, start, end);
+  return(reduce_sum(val));
 }
 
 void ParallelLinearAlgebra::mult_trans(ParallelMatrix& a, ParallelVector& b, ParallelVector& r)
@@ -683,7 +570,11 @@ void ParallelLinearAlgebra::diag(ParallelMatrix& a, ParallelVector& r)
   auto rows = a.rows_;
   auto columns = a.columns_;
 
-  for(size_t i=start_;i<end_;i++)
+  // Non-square operators (e.g. multigrid transfers) split their own rows
+  size_t start, end;
+  range(a.m_, start, end);
+
+  for(size_t i=start;i<end;i++)
   {
     double val = 0.0;
     size_t row_idx=rows[i];
@@ -705,7 +596,11 @@ void ParallelLinearAlgebra::absdiag(const ParallelMatrix& a, ParallelVector& r)
   auto rows = a.rows_;
   auto columns = a.columns_;
 
-  for(size_t i=start_;i<end_;i++)
+  // Non-square operators (e.g. multigrid transfers) split their own rows
+  size_t start, end;
+  range(a.m_, start, end);
+
+  for(size_t i=start;i<end;i++)
   {
     double val = 0.0;
     size_t row_idx=rows[i];
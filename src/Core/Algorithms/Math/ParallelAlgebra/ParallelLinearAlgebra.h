@@ -47,6 +47,7 @@ namespace Algorithms {
 namespace Math {
 
   class ParallelLinearAlgebra;
+  struct VectorKernels;
 
   struct SCISHARE SolverInputs
   {
@@ -160,6 +161,8 @@ public:
 
   // r = s*a + b;
   void scale_add(double s, const ParallelVector& a, const ParallelVector& b, ParallelVector& r);
+  // r = s*a + b; returns |r| without a second pass over r
+  double scale_add_norm(double s, const ParallelVector& a, const ParallelVector& b, ParallelVector& r);
 
   void add(const ParallelVector& a, const ParallelVector& b, ParallelVector& r);
 
@@ -184,6 +187,8 @@ public:
   double max(const ParallelVector& a);
 
   void mult(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r);
+  // r = a*b; returns dot(b, r) accumulated while the rows are computed
+  double mult_dot(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r);
 
   void absdiag(const ParallelMatrix& a, ParallelVector& r);
 
@@ -192,6 +197,10 @@ public:
   int  proc() { return proc_; }
   int  nproc() { return nproc_; }
 
+  // Range of rows of a vector of length size handled by this thread, using the
+  // same split as the system vectors
+  void range(size_t size, size_t& start, size_t& end) const;
+
   bool first() { return proc_ == 0; }
   void wait();
 
@@ -205,6 +214,8 @@ private:
   int proc_;  // process number
   int nproc_; // number of processes
 
+  const VectorKernels& kernels_;
+
   size_t size_;
   size_t local_size_;
   size_t local_size16_;
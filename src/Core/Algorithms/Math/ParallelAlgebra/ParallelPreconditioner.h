@@ -0,0 +1,78 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_MATH_PARALLELALGEBRA_PARALLELPRECONDITIONER_H
+#define CORE_ALGORITHMS_MATH_PARALLELALGEBRA_PARALLELPRECONDITIONER_H
+
+#include <boost/noncopyable.hpp>
+#include <Core/Datatypes/MatrixFwd.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+  /// Preconditioner of the parallel iterative solvers that is set up once for a
+  /// matrix and then applied by all threads of a ParallelLinearAlgebra run.
+  class SCISHARE ParallelPreconditioner : boost::noncopyable
+  {
+  public:
+    virtual ~ParallelPreconditioner() {}
+
+    /// Whether the preconditioner was set up for this matrix
+    virtual bool matches(Datatypes::SparseRowMatrixHandle A) const = 0;
+
+    /// Whether A has the sparsity pattern the preconditioner was set up for
+    virtual bool matchesPattern(Datatypes::SparseRowMatrixHandle A) const = 0;
+
+    /// Sets the preconditioner up for A, which has to match the pattern, reusing
+    /// the part of the setup that only depends on the sparsity pattern
+    virtual void update(Datatypes::SparseRowMatrixHandle A) = 0;
+
+    /// z = M^-1 r. Has to be called by all threads; r and z must be different vectors.
+    virtual void apply(ParallelLinearAlgebra& PLA,
+                       const ParallelLinearAlgebra::ParallelVector& r,
+                       ParallelLinearAlgebra::ParallelVector& z) = 0;
+
+    /// z = M^-T r, needed for the shadow residual of BiCG
+    virtual void applyTranspose(ParallelLinearAlgebra& PLA,
+                                const ParallelLinearAlgebra::ParallelVector& r,
+                                ParallelLinearAlgebra::ParallelVector& z)
+    {
+      apply(PLA, r, z);
+    }
+  };
+
+  /// Whether both matrices have the same size and store the same entries
+  SCISHARE bool sameSparsityPattern(const Datatypes::SparseRowMatrix& a, const Datatypes::SparseRowMatrix& b);
+
+}}}}
+
+#endif
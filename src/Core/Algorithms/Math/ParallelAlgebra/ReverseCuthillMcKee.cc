@@ -0,0 +1,262 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <algorithm>
+#include <Core/Algorithms/Math/ParallelAlgebra/ReverseCuthillMcKee.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelPreconditioner.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Datatypes;
+
+namespace
+{
+  /// Off diagonal pattern of A + A^T in CSR layout
+  struct Graph
+  {
+    explicit Graph(const SparseRowMatrix& A) : outer(A.nrows() + 1, 0)
+    {
+      const index_type n = A.nrows();
+      const index_type* rows = A.outerIndexPtr();
+      const index_type* columns = A.innerIndexPtr();
+      for (index_type i = 0; i < n; ++i)
+        for (index_type k = rows[i]; k < rows[i+1]; ++k)
+          if (columns[k] != i)
+          {
+            outer[i+1]++;
+            outer[columns[k]+1]++;
+          }
+      for (index_type i = 0; i < n; ++i)
+        outer[i+1] += outer[i];
+
+      std::vector<index_type> fill(outer.begin(), outer.end() - 1);
+      inner.resize(outer[n]);
+      for (index_type i = 0; i < n; ++i)
+        for (index_type k = rows[i]; k < rows[i+1]; ++k)
+          if (columns[k] != i)
+          {
+            inner[fill[i]++] = columns[k];
+            inner[fill[columns[k]]++] = i;
+          }
+
+      // symmetric patterns list every edge twice
+      index_type end = 0;
+      for (index_type i = 0; i < n; ++i)
+      {
+        auto first = inner.begin() + outer[i];
+        auto last = inner.begin() + outer[i+1];
+        std::sort(first, last);
+        last = std::unique(first, last);
+        const index_type begin = end;
+        for (auto it = first; it != last; ++it)
+          inner[end++] = *it;
+        outer[i] = begin;
+      }
+      outer[n] = end;
+      inner.resize(end);
+    }
+
+    index_type degree(index_type i) const { return outer[i+1] - outer[i]; }
+
+    std::vector<index_type> outer, inner;
+  };
+
+  /// Breadth first search over the unnumbered nodes, neighbours in order of
+  /// increasing degree. Appends the visited nodes to order and their distance
+  /// from root to distance, and returns the number of levels.
+  index_type breadthFirst(const Graph& g, index_type root, const std::vector<char>& numbered,
+    std::vector<index_type>& level, std::vector<index_type>& order, std::vector<index_type>& distance)
+  {
+    const size_t begin = order.size();
+    order.push_back(root);
+    level[root] = 0;
+    std::vector<index_type> neighbours;
+    for (size_t head = begin; head < order.size(); ++head)
+    {
+      const index_type i = order[head];
+      neighbours.clear();
+      for (index_type k = g.outer[i]; k < g.outer[i+1]; ++k)
+      {
+        const index_type j = g.inner[k];
+        if (!numbered[j] && level[j] < 0)
+        {
+          level[j] = level[i] + 1;
+          neighbours.push_back(j);
+        }
+      }
+      std::stable_sort(neighbours.begin(), neighbours.end(),
+        [&g](index_type a, index_type b) { return g.degree(a) < g.degree(b); });
+      order.insert(order.end(), neighbours.begin(), neighbours.end());
+    }
+    // level[] is only scratch space, leave it cleared for the next search
+    for (size_t k = begin; k < order.size(); ++k)
+    {
+      distance.push_back(level[order[k]]);
+      level[order[k]] = -1;
+    }
+    return distance.back() + 1;
+  }
+
+  /// George-Liu: a node of near maximal eccentricity in the component of start,
+  /// so the level structure rooted there is long and narrow
+  index_type pseudoPeripheralNode(const Graph& g, index_type start, const std::vector<char>& numbered,
+    std::vector<index_type>& level)
+  {
+    std::vector<index_type> order, distance;
+    index_type root = start;
+    index_type depth = breadthFirst(g, root, numbered, level, order, distance);
+    for (;;)
+    {
+      // the last level ends the search order, take its node of smallest degree
+      index_type candidate = order.back();
+      for (size_t k = order.size(); k-- > 0 && distance[k] == depth - 1; )
+        if (g.degree(order[k]) < g.degree(candidate))
+          candidate = order[k];
+
+      order.clear();
+      distance.clear();
+      const index_type candidateDepth = breadthFirst(g, candidate, numbered, level, order, distance);
+      if (candidateDepth <= depth)
+        return root;
+      root = candidate;
+      depth = candidateDepth;
+    }
+  }
+}
+
+ReverseCuthillMcKee::ReverseCuthillMcKee(SparseRowMatrixHandle A) : A_(A)
+{
+  const index_type n = A->nrows();
+  Graph g(*A);
+
+  std::vector<char> numbered(n, 0);
+  std::vector<index_type> level(n, -1);
+  std::vector<index_type> order;
+  order.reserve(n);
+  for (index_type i = 0; i < n; ++i)
+  {
+    if (numbered[i])
+      continue;
+    const index_type root = pseudoPeripheralNode(g, i, numbered, level);
+    const size_t begin = order.size();
+    std::vector<index_type> distance;
+    breadthFirst(g, root, numbered, level, order, distance);
+    for (size_t k = begin; k < order.size(); ++k)
+      numbered[order[k]] = 1;
+  }
+  permutation_.assign(order.rbegin(), order.rend());
+
+  std::vector<index_type> inverse(n);
+  for (index_type i = 0; i < n; ++i)
+    inverse[permutation_[i]] = i;
+
+  const index_type* rows = A->outerIndexPtr();
+  const index_type* columns = A->innerIndexPtr();
+  outer_.assign(1, 0);
+  outer_.reserve(n + 1);
+  inner_.reserve(A->nonZeros());
+  source_.reserve(A->nonZeros());
+  std::vector<std::pair<index_type, index_type>> row;
+  for (index_type i = 0; i < n; ++i)
+  {
+    const index_type old = permutation_[i];
+    row.clear();
+    for (index_type k = rows[old]; k < rows[old+1]; ++k)
+      row.push_back(std::make_pair(inverse[columns[k]], k));
+    std::sort(row.begin(), row.end());
+    for (const auto& entry : row)
+    {
+      inner_.push_back(entry.first);
+      source_.push_back(entry.second);
+    }
+    outer_.push_back(static_cast<index_type>(inner_.size()));
+  }
+}
+
+bool ReverseCuthillMcKee::matchesPattern(SparseRowMatrixHandle A) const
+{
+  return A && sameSparsityPattern(*A, *A_);
+}
+
+SparseRowMatrixHandle ReverseCuthillMcKee::permute(const SparseRowMatrix& A) const
+{
+  const int n = static_cast<int>(permutation_.size());
+  auto B = boost::make_shared<SparseRowMatrix>(n, n);
+  B->resizeNonZeros(inner_.size());
+  std::copy(outer_.begin(), outer_.end(), B->outerIndexPtr());
+  std::copy(inner_.begin(), inner_.end(), B->innerIndexPtr());
+  const double* values = A.valuePtr();
+  double* permuted = B->valuePtr();
+  for (size_t k = 0; k < source_.size(); ++k)
+    permuted[k] = values[source_[k]];
+  return B;
+}
+
+DenseColumnMatrixHandle ReverseCuthillMcKee::permute(const DenseColumnMatrix& x) const
+{
+  auto y = boost::make_shared<DenseColumnMatrix>(x.nrows());
+  for (size_t i = 0; i < permutation_.size(); ++i)
+    (*y)[i] = x[permutation_[i]];
+  return y;
+}
+
+DenseMatrixHandle ReverseCuthillMcKee::permute(const DenseMatrix& x) const
+{
+  auto y = boost::make_shared<DenseMatrix>(x.nrows(), x.ncols());
+  for (size_t i = 0; i < permutation_.size(); ++i)
+    y->row(i) = x.row(permutation_[i]);
+  return y;
+}
+
+DenseColumnMatrixHandle ReverseCuthillMcKee::unpermute(const DenseColumnMatrix& x) const
+{
+  auto y = boost::make_shared<DenseColumnMatrix>(x.nrows());
+  for (size_t i = 0; i < permutation_.size(); ++i)
+    (*y)[permutation_[i]] = x[i];
+  return y;
+}
+
+DenseMatrixHandle ReverseCuthillMcKee::unpermute(const DenseMatrix& x) const
+{
+  auto y = boost::make_shared<DenseMatrix>(x.nrows(), x.ncols());
+  for (size_t i = 0; i < permutation_.size(); ++i)
+    y->row(permutation_[i]) = x.row(i);
+  return y;
+}
+
+size_type ReverseCuthillMcKee::bandwidth(const SparseRowMatrix& A)
+{
+  size_type band = 0;
+  for (index_type i = 0; i < A.outerSize(); ++i)
+    for (index_type k = A.outerIndexPtr()[i]; k < A.outerIndexPtr()[i+1]; ++k)
+      band = std::max(band, static_cast<size_type>(std::abs(A.innerIndexPtr()[k] - i)));
+  return band;
+}
@@ -0,0 +1,80 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_MATH_PARALLELALGEBRA_REVERSECUTHILLMCKEE_H
+#define CORE_ALGORITHMS_MATH_PARALLELALGEBRA_REVERSECUTHILLMCKEE_H
+
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <Core/Datatypes/MatrixFwd.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+  /// Bandwidth reducing symmetric reordering of a sparse matrix. Meshes from
+  /// Cleaver or TetGen number their nodes in an essentially random order; after
+  /// the reordering the entries gathered by a row of a matrix-vector product are
+  /// close together in memory. The ordering only depends on the sparsity
+  /// pattern, nonsymmetric patterns are symmetrized.
+  class SCISHARE ReverseCuthillMcKee : boost::noncopyable
+  {
+  public:
+    explicit ReverseCuthillMcKee(Datatypes::SparseRowMatrixHandle A);
+
+    /// Whether A has the sparsity pattern the ordering was computed for
+    bool matchesPattern(Datatypes::SparseRowMatrixHandle A) const;
+
+    /// Old index of every new index
+    const std::vector<index_type>& permutation() const { return permutation_; }
+
+    /// P*A*P^T for a matrix with the pattern of the ordering
+    Datatypes::SparseRowMatrixHandle permute(const Datatypes::SparseRowMatrix& A) const;
+    /// P*x, the rows of x in the new order
+    Datatypes::DenseColumnMatrixHandle permute(const Datatypes::DenseColumnMatrix& x) const;
+    Datatypes::DenseMatrixHandle permute(const Datatypes::DenseMatrix& x) const;
+    /// P^T*x, back to the original order
+    Datatypes::DenseColumnMatrixHandle unpermute(const Datatypes::DenseColumnMatrix& x) const;
+    Datatypes::DenseMatrixHandle unpermute(const Datatypes::DenseMatrix& x) const;
+
+    /// Largest |i-j| of the stored entries
+    static size_type bandwidth(const Datatypes::SparseRowMatrix& A);
+
+  private:
+    Datatypes::SparseRowMatrixHandle A_;
+    std::vector<index_type> permutation_;
+    // pattern of P*A*P^T, and the index into the values of A of every entry
+    std::vector<index_type> outer_, inner_, source_;
+  };
+
+}}}}
+
+#endif
@@ -0,0 +1,438 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <atomic>
+#include <Core/Algorithms/Math/ParallelAlgebra/VectorKernels.h>
+
+// The vector kernels are compiled per function for their instruction set, so the
+// library still runs on CPUs without them; other compilers get the scalar kernels.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SCIRUN_X86_VECTOR_KERNELS
+#include <immintrin.h>
+#endif
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Math;
+
+namespace
+{
+  // Scalar kernels. The independent partial sums keep several multiply-adds in
+  // flight and let the compiler vectorize for the baseline instruction set.
+
+  double dotScalar(const double* a, const double* b, size_t n)
+  {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+      s0 += a[i]*b[i];
+      s1 += a[i+1]*b[i+1];
+      s2 += a[i+2]*b[i+2];
+      s3 += a[i+3]*b[i+3];
+    }
+    for (; i < n; i++)
+      s0 += a[i]*b[i];
+    return (s0 + s1) + (s2 + s3);
+  }
+
+  double sumOfSquaresScalar(const double* a, size_t n)
+  {
+    return dotScalar(a, a, n);
+  }
+
+  void multScalar(const double* a, const double* b, double* r, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+      r[i] = a[i]*b[i];
+  }
+
+  void scaleAddScalar(double s, const double* a, const double* b, double* r, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+      r[i] = s*a[i] + b[i];
+  }
+
+  double scaleAddSumOfSquaresScalar(double s, const double* a, const double* b, double* r, size_t n)
+  {
+    double s0 = 0.0, s1 = 0.0;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+      const double r0 = s*a[i] + b[i];
+      const double r1 = s*a[i+1] + b[i+1];
+      r[i] = r0;
+      r[i+1] = r1;
+      s0 += r0*r0;
+      s1 += r1*r1;
+    }
+    for (; i < n; i++)
+    {
+      r[i] = s*a[i] + b[i];
+      s0 += r[i]*r[i];
+    }
+    return s0 + s1;
+  }
+
+  inline double rowScalar(const index_type* columns, const double* values, const double* x, index_type k, index_type end)
+  {
+    double sum = 0.0;
+    for (; k < end; k++)
+      sum += values[k]*x[columns[k]];
+    return sum;
+  }
+
+  void spmvScalar(const index_type* rows, const index_type* columns, const double* values,
+                  const double* x, double* r, size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; i++)
+      r[i] = rowScalar(columns, values, x, rows[i], rows[i+1]);
+  }
+
+  double spmvDotScalar(const index_type* rows, const index_type* columns, const double* values,
+                       const double* x, double* r, size_t begin, size_t end)
+  {
+    double dot = 0.0;
+    for (size_t i = begin; i < end; i++)
+    {
+      r[i] = rowScalar(columns, values, x, rows[i], rows[i+1]);
+      dot += x[i]*r[i];
+    }
+    return dot;
+  }
+
+  const VectorKernels scalarKernels =
+  {
+    VectorInstructionSet::Scalar, "scalar",
+    dotScalar, sumOfSquaresScalar, multScalar, scaleAddScalar, scaleAddSumOfSquaresScalar,
+    spmvScalar, spmvDotScalar
+  };
+
+#ifdef SCIRUN_X86_VECTOR_KERNELS
+
+  // AVX2: 4 doubles per register, the CSR rows gather x with 64 bit column indices
+
+#define SCIRUN_AVX2 __attribute__((target("avx2,fma")))
+
+  SCIRUN_AVX2 inline double sumAVX2(__m256d v)
+  {
+    __m128d lo = _mm256_castpd256_pd128(v);
+    __m128d hi = _mm256_extractf128_pd(v, 1);
+    lo = _mm_add_pd(lo, hi);
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+  }
+
+  SCIRUN_AVX2 double dotAVX2(const double* a, const double* b, size_t n)
+  {
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+      s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a+i), _mm256_loadu_pd(b+i), s0);
+      s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a+i+4), _mm256_loadu_pd(b+i+4), s1);
+      s2 = _mm256_fmadd_pd(_mm256_loadu_pd(a+i+8), _mm256_loadu_pd(b+i+8), s2);
+      s3 = _mm256_fmadd_pd(_mm256_loadu_pd(a+i+12), _mm256_loadu_pd(b+i+12), s3);
+    }
+    for (; i + 4 <= n; i += 4)
+      s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a+i), _mm256_loadu_pd(b+i), s0);
+    double sum = sumAVX2(_mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+    for (; i < n; i++)
+      sum += a[i]*b[i];
+    return sum;
+  }
+
+  SCIRUN_AVX2 double sumOfSquaresAVX2(const double* a, size_t n)
+  {
+    return dotAVX2(a, a, n);
+  }
+
+  SCIRUN_AVX2 void multAVX2(const double* a, const double* b, double* r, size_t n)
+  {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+      _mm256_storeu_pd(r+i, _mm256_mul_pd(_mm256_loadu_pd(a+i), _mm256_loadu_pd(b+i)));
+    for (; i < n; i++)
+      r[i] = a[i]*b[i];
+  }
+
+  SCIRUN_AVX2 void scaleAddAVX2(double s, const double* a, const double* b, double* r, size_t n)
+  {
+    const __m256d vs = _mm256_set1_pd(s);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+      _mm256_storeu_pd(r+i, _mm256_fmadd_pd(vs, _mm256_loadu_pd(a+i), _mm256_loadu_pd(b+i)));
+    for (; i < n; i++)
+      r[i] = s*a[i] + b[i];
+  }
+
+  SCIRUN_AVX2 double scaleAddSumOfSquaresAVX2(double s, const double* a, const double* b, double* r, size_t n)
+  {
+    const __m256d vs = _mm256_set1_pd(s);
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+      const __m256d r0 = _mm256_fmadd_pd(vs, _mm256_loadu_pd(a+i), _mm256_loadu_pd(b+i));
+      const __m256d r1 = _mm256_fmadd_pd(vs, _mm256_loadu_pd(a+i+4), _mm256_loadu_pd(b+i+4));
+      _mm256_storeu_pd(r+i, r0);
+      _mm256_storeu_pd(r+i+4, r1);
+      s0 = _mm256_fmadd_pd(r0, r0, s0);
+      s1 = _mm256_fmadd_pd(r1, r1, s1);
+    }
+    double sum = sumAVX2(_mm256_add_pd(s0, s1));
+    for (; i < n; i++)
+    {
+      r[i] = s*a[i] + b[i];
+      sum += r[i]*r[i];
+    }
+    return sum;
+  }
+
+  SCIRUN_AVX2 inline double rowAVX2(const index_type* columns, const double* values, const double* x, index_type k, index_type end)
+  {
+    static_assert(sizeof(index_type) == 8, "the gather assumes 64 bit column indices");
+    __m256d acc = _mm256_setzero_pd();
+    for (; k + 4 <= end; k += 4)
+    {
+      const __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns + k));
+      acc = _mm256_fmadd_pd(_mm256_loadu_pd(values + k), _mm256_i64gather_pd(x, idx, 8), acc);
+    }
+    double sum = sumAVX2(acc);
+    for (; k < end; k++)
+      sum += values[k]*x[columns[k]];
+    return sum;
+  }
+
+  SCIRUN_AVX2 void spmvAVX2(const index_type* rows, const index_type* columns, const double* values,
+                            const double* x, double* r, size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; i++)
+      r[i] = rowAVX2(columns, values, x, rows[i], rows[i+1]);
+  }
+
+  SCIRUN_AVX2 double spmvDotAVX2(const index_type* rows, const index_type* columns, const double* values,
+                                 const double* x, double* r, size_t begin, size_t end)
+  {
+    double dot = 0.0;
+    for (size_t i = begin; i < end; i++)
+    {
+      r[i] = rowAVX2(columns, values, x, rows[i], rows[i+1]);
+      dot += x[i]*r[i];
+    }
+    return dot;
+  }
+
+#undef SCIRUN_AVX2
+
+  const VectorKernels avx2Kernels =
+  {
+    VectorInstructionSet::AVX2, "AVX2",
+    dotAVX2, sumOfSquaresAVX2, multAVX2, scaleAddAVX2, scaleAddSumOfSquaresAVX2,
+    spmvAVX2, spmvDotAVX2
+  };
+
+  // AVX-512: 8 doubles per register, remainders are handled with masked loads
+
+#define SCIRUN_AVX512 __attribute__((target("avx512f")))
+
+  SCIRUN_AVX512 inline __mmask8 tailMask(size_t remaining)
+  {
+    return static_cast<__mmask8>((1u << remaining) - 1);
+  }
+
+  SCIRUN_AVX512 double dotAVX512(const double* a, const double* b, size_t n)
+  {
+    __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd(), s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+      s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a+i), _mm512_loadu_pd(b+i), s0);
+      s1 = _mm512_fmadd_pd(_mm512_loadu_pd(a+i+8), _mm512_loadu_pd(b+i+8), s1);
+      s2 = _mm512_fmadd_pd(_mm512_loadu_pd(a+i+16), _mm512_loadu_pd(b+i+16), s2);
+      s3 = _mm512_fmadd_pd(_mm512_loadu_pd(a+i+24), _mm512_loadu_pd(b+i+24), s3);
+    }
+    for (; i + 8 <= n; i += 8)
+      s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a+i), _mm512_loadu_pd(b+i), s0);
+    if (i < n)
+    {
+      const __mmask8 m = tailMask(n - i);
+      s1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m, a+i), _mm512_maskz_loadu_pd(m, b+i), s1);
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+  }
+
+  SCIRUN_AVX512 double sumOfSquaresAVX512(const double* a, size_t n)
+  {
+    return dotAVX512(a, a, n);
+  }
+
+  SCIRUN_AVX512 void multAVX512(const double* a, const double* b, double* r, size_t n)
+  {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+      _mm512_storeu_pd(r+i, _mm512_mul_pd(_mm512_loadu_pd(a+i), _mm512_loadu_pd(b+i)));
+    if (i < n)
+    {
+      const __mmask8 m = tailMask(n - i);
+      _mm512_mask_storeu_pd(r+i, m, _mm512_mul_pd(_mm512_maskz_loadu_pd(m, a+i), _mm512_maskz_loadu_pd(m, b+i)));
+    }
+  }
+
+  SCIRUN_AVX512 void scaleAddAVX512(double s, const double* a, const double* b, double* r, size_t n)
+  {
+    const __m512d vs = _mm512_set1_pd(s);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+      _mm512_storeu_pd(r+i, _mm512_fmadd_pd(vs, _mm512_loadu_pd(a+i), _mm512_loadu_pd(b+i)));
+    if (i < n)
+    {
+      const __mmask8 m = tailMask(n - i);
+      _mm512_mask_storeu_pd(r+i, m, _mm512_fmadd_pd(vs, _mm512_maskz_loadu_pd(m, a+i), _mm512_maskz_loadu_pd(m, b+i)));
+    }
+  }
+
+  SCIRUN_AVX512 double scaleAddSumOfSquaresAVX512(double s, const double* a, const double* b, double* r, size_t n)
+  {
+    const __m512d vs = _mm512_set1_pd(s);
+    __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+      const __m512d r0 = _mm512_fmadd_pd(vs, _mm512_loadu_pd(a+i), _mm512_loadu_pd(b+i));
+      const __m512d r1 = _mm512_fmadd_pd(vs, _mm512_loadu_pd(a+i+8), _mm512_loadu_pd(b+i+8));
+      _mm512_storeu_pd(r+i, r0);
+      _mm512_storeu_pd(r+i+8, r1);
+      s0 = _mm512_fmadd_pd(r0, r0, s0);
+      s1 = _mm512_fmadd_pd(r1, r1, s1);
+    }
+    for (; i < n; i += 8)
+    {
+      const __mmask8 m = n - i >= 8 ? static_cast<__mmask8>(0xff) : tailMask(n - i);
+      const __m512d r0 = _mm512_fmadd_pd(vs, _mm512_maskz_loadu_pd(m, a+i), _mm512_maskz_loadu_pd(m, b+i));
+      _mm512_mask_storeu_pd(r+i, m, r0);
+      s0 = _mm512_fmadd_pd(r0, r0, s0);
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(s0, s1));
+  }
+
+  SCIRUN_AVX512 inline double rowAVX512(const index_type* columns, const double* values, const double* x, index_type k, index_type end)
+  {
+    __m512d acc = _mm512_setzero_pd();
+    for (; k + 8 <= end; k += 8)
+    {
+      const __m512i idx = _mm512_loadu_si512(columns + k);
+      acc = _mm512_fmadd_pd(_mm512_loadu_pd(values + k), _mm512_i64gather_pd(idx, x, 8), acc);
+    }
+    if (k < end)
+    {
+      const __mmask8 m = tailMask(static_cast<size_t>(end - k));
+      const __m512i idx = _mm512_maskz_loadu_epi64(m, columns + k);
+      const __m512d xv = _mm512_mask_i64gather_pd(_mm512_setzero_pd(), m, idx, x, 8);
+      acc = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m, values + k), xv, acc);
+    }
+    return _mm512_reduce_add_pd(acc);
+  }
+
+  SCIRUN_AVX512 void spmvAVX512(const index_type* rows, const index_type* columns, const double* values,
+                                const double* x, double* r, size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; i++)
+      r[i] = rowAVX512(columns, values, x, rows[i], rows[i+1]);
+  }
+
+  SCIRUN_AVX512 double spmvDotAVX512(const index_type* rows, const index_type* columns, const double* values,
+                                     const double* x, double* r, size_t begin, size_t end)
+  {
+    double dot = 0.0;
+    for (size_t i = begin; i < end; i++)
+    {
+      r[i] = rowAVX512(columns, values, x, rows[i], rows[i+1]);
+      dot += x[i]*r[i];
+    }
+    return dot;
+  }
+
+#undef SCIRUN_AVX512
+
+  const VectorKernels avx512Kernels =
+  {
+    VectorInstructionSet::AVX512, "AVX-512",
+    dotAVX512, sumOfSquaresAVX512, multAVX512, scaleAddAVX512, scaleAddSumOfSquaresAVX512,
+    spmvAVX512, spmvDotAVX512
+  };
+
+#endif
+
+  const VectorKernels* detectKernels()
+  {
+    if (auto k = vectorKernels(VectorInstructionSet::AVX512))
+      return k;
+    if (auto k = vectorKernels(VectorInstructionSet::AVX2))
+      return k;
+    return &scalarKernels;
+  }
+
+  std::atomic<const VectorKernels*> currentKernels(nullptr);
+}
+
+const VectorKernels* SCIRun::Core::Algorithms::Math::vectorKernels(VectorInstructionSet set)
+{
+  switch (set)
+  {
+#ifdef SCIRUN_X86_VECTOR_KERNELS
+  case VectorInstructionSet::AVX512:
+    return __builtin_cpu_supports("avx512f") ? &avx512Kernels : nullptr;
+  case VectorInstructionSet::AVX2:
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ? &avx2Kernels : nullptr;
+#endif
+  case VectorInstructionSet::Scalar:
+    return &scalarKernels;
+  default:
+    return nullptr;
+  }
+}
+
+const VectorKernels& SCIRun::Core::Algorithms::Math::vectorKernels()
+{
+  auto kernels = currentKernels.load(std::memory_order_acquire);
+  if (!kernels)
+  {
+    // concurrent first calls detect the same kernels, so the race is benign
+    kernels = detectKernels();
+    currentKernels.store(kernels, std::memory_order_release);
+  }
+  return *kernels;
+}
+
+bool SCIRun::Core::Algorithms::Math::selectVectorKernels(VectorInstructionSet set)
+{
+  auto kernels = vectorKernels(set);
+  if (!kernels)
+    return false;
+  currentKernels.store(kernels, std::memory_order_release);
+  return true;
+}
@@ -0,0 +1,84 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_MATH_PARALLELALGEBRA_VECTORKERNELS_H
+#define CORE_ALGORITHMS_MATH_PARALLELALGEBRA_VECTORKERNELS_H
+
+#include <cstddef>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+  enum class VectorInstructionSet
+  {
+    Scalar,
+    AVX2,     ///< x86 AVX2 with FMA
+    AVX512    ///< x86 AVX-512F
+  };
+
+  /// Inner loops of the parallel solvers over a part of a vector, or over a
+  /// range of rows of a CSR matrix. Every instruction set provides one table;
+  /// the widest one the CPU supports is picked on first use.
+  struct SCISHARE VectorKernels
+  {
+    VectorInstructionSet instructionSet;
+    const char* name;
+
+    double (*dot)(const double* a, const double* b, size_t n);
+    double (*sumOfSquares)(const double* a, size_t n);
+    /// r = a.*b
+    void (*mult)(const double* a, const double* b, double* r, size_t n);
+    /// r = s*a + b
+    void (*scaleAdd)(double s, const double* a, const double* b, double* r, size_t n);
+    /// r = s*a + b, returns the sum of squares of r
+    double (*scaleAddSumOfSquares)(double s, const double* a, const double* b, double* r, size_t n);
+    /// r_i = sum_j A_ij x_j for the rows begin..end-1
+    void (*spmv)(const index_type* rows, const index_type* columns, const double* values,
+                 const double* x, double* r, size_t begin, size_t end);
+    /// Same as spmv for a square matrix, returns sum_i x_i r_i over the rows
+    double (*spmvDot)(const index_type* rows, const index_type* columns, const double* values,
+                      const double* x, double* r, size_t begin, size_t end);
+  };
+
+  /// Kernels currently used by ParallelLinearAlgebra
+  SCISHARE const VectorKernels& vectorKernels();
+
+  /// Kernels of one instruction set, or null if the CPU or the compiler does not support it
+  SCISHARE const VectorKernels* vectorKernels(VectorInstructionSet set);
+
+  /// Overrides the automatic choice, e.g. to compare instruction sets.
+  /// Returns false and keeps the current kernels if the set is not supported.
+  SCISHARE bool selectVectorKernels(VectorInstructionSet set);
+
+}}}}
+
+#endif
@@ -28,6 +28,8 @@
 
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Math/SolveLinearSystemWithEigen.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/IncompleteFactorization.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
@@ -44,6 +46,78 @@ namespace
 {
   using EigenComputationInfo = boost::error_info<struct tag_eigen_computation, Eigen::ComputationInfo>;
 
+  template <typename Scalar, typename Derived>
+  SparseRowMatrixGeneric<Scalar> toRowMajor(const Eigen::SparseMatrixBase<Derived>& mat)
+  {
+    return SparseRowMatrixGeneric<Scalar>(mat);
+  }
+
+  template <typename Scalar, typename Derived>
+  SparseRowMatrixGeneric<Scalar> toRowMajor(const Eigen::MatrixBase<Derived>& mat)
+  {
+    return SparseRowMatrixGeneric<Scalar>(mat.sparseView());
+  }
+
+  /// Eigen preconditioner running the level scheduled IC(0)/ILU(0) triangular solves
+  /// on the Parallel thread pool, in place of Eigen's serial incomplete factorizations
+  template <typename Scalar, IncompleteFactorizationType Type>
+  class LevelScheduledPreconditioner
+  {
+  public:
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+    LevelScheduledPreconditioner() : info_(Eigen::Success) {}
+
+    template <typename MatType>
+    explicit LevelScheduledPreconditioner(const MatType& mat) : info_(Eigen::Success)
+    {
+      compute(mat);
+    }
+
+    template <typename MatType>
+    LevelScheduledPreconditioner& analyzePattern(const MatType&)
+    {
+      return *this;
+    }
+
+    template <typename MatType>
+    LevelScheduledPreconditioner& factorize(const MatType& mat)
+    {
+      try
+      {
+        factors_ = boost::make_shared<IncompleteFactorizationGeneric<Scalar>>(toRowMajor<Scalar>(mat), Type);
+        info_ = Eigen::Success;
+      }
+      catch (AlgorithmProcessingException&)
+      {
+        factors_.reset();
+        info_ = Eigen::NumericalIssue;
+      }
+      return *this;
+    }
+
+    template <typename MatType>
+    LevelScheduledPreconditioner& compute(const MatType& mat)
+    {
+      return factorize(mat);
+    }
+
+    template <typename Rhs>
+    Vector solve(const Eigen::MatrixBase<Rhs>& b) const
+    {
+      const Vector r = b;
+      Vector z(r.size());
+      factors_->solve(r.data(), z.data());
+      return z;
+    }
+
+    Eigen::ComputationInfo info() const { return info_; }
+
+  private:
+    boost::shared_ptr<IncompleteFactorizationGeneric<Scalar>> factors_;
+    Eigen::ComputationInfo info_;
+  };
+
   template <class ColumnMatrixType, template <typename> class SolverType>
   class SolveLinearSystemAlgorithmEigenCGImpl
   {
@@ -79,6 +153,11 @@ namespace
   };
 }
 
+SolveLinearSystemAlgorithm::SolveLinearSystemAlgorithm()
+{
+  addOption(Variables::Preconditioner, "Jacobi", "None|Jacobi|IC0|ILU0");
+}
+
 SolveLinearSystemAlgorithm::Outputs SolveLinearSystemAlgorithm::run(const Inputs& input, const Parameters& params) const
 {
   return runImpl<Inputs, Outputs>(input, params);
@@ -97,6 +176,19 @@ using CG = Eigen::ConjugateGradient<T>;
 template <typename T>
 using BiCG = Eigen::BiCGSTAB<T>;
 
+template <typename T>
+using CGNone = Eigen::ConjugateGradient<T, Eigen::Lower, Eigen::IdentityPreconditioner>;
+template <typename T>
+using CGIC0 = Eigen::ConjugateGradient<T, Eigen::Lower, LevelScheduledPreconditioner<typename T::Scalar, IncompleteFactorizationType::IC0>>;
+template <typename T>
+using CGILU0 = Eigen::ConjugateGradient<T, Eigen::Lower, LevelScheduledPreconditioner<typename T::Scalar, IncompleteFactorizationType::ILU0>>;
+template <typename T>
+using BiCGNone = Eigen::BiCGSTAB<T, Eigen::IdentityPreconditioner>;
+template <typename T>
+using BiCGIC0 = Eigen::BiCGSTAB<T, LevelScheduledPreconditioner<typename T::Scalar, IncompleteFactorizationType::IC0>>;
+template <typename T>
+using BiCGILU0 = Eigen::BiCGSTAB<T, LevelScheduledPreconditioner<typename T::Scalar, IncompleteFactorizationType::ILU0>>;
+
 template <typename In, typename Out>
 Out SolveLinearSystemAlgorithm::runImpl(const In& input, const Parameters& params) const
 {
@@ -113,21 +205,41 @@ Out SolveLinearSystemAlgorithm::runImpl(const In& input, const Parameters& param
   ENSURE_POSITIVE_INT(maxIterations, "Max iterations out of range!");
 
   auto method = std::get<2>(params);
-
-  using SolutionType = DenseColumnMatrixGeneric<typename std::tuple_element<0, In>::type::element_type::value_type>;
-  using AlgoTypeCG = SolveLinearSystemAlgorithmEigenCGImpl<SolutionType, CG>;
-  using AlgoTypeBiCG = SolveLinearSystemAlgorithmEigenCGImpl<SolutionType, BiCG>;
+  auto preconditioner = getOption(Variables::Preconditioner);
 
   if ("cg" == method)
-    return solve<AlgoTypeCG, In, Out>(input, params);
+  {
+    if ("None" == preconditioner)
+      return solveWithPreconditioner<In, Out, CGNone>(input, params);
+    else if ("IC0" == preconditioner)
+      return solveWithPreconditioner<In, Out, CGIC0>(input, params);
+    else if ("ILU0" == preconditioner)
+      return solveWithPreconditioner<In, Out, CGILU0>(input, params);
+    return solveWithPreconditioner<In, Out, CG>(input, params);
+  }
   else if ("bicg" == method)
-    return solve<AlgoTypeBiCG, In, Out>(input, params);
+  {
+    if ("None" == preconditioner)
+      return solveWithPreconditioner<In, Out, BiCGNone>(input, params);
+    else if ("IC0" == preconditioner)
+      return solveWithPreconditioner<In, Out, BiCGIC0>(input, params);
+    else if ("ILU0" == preconditioner)
+      return solveWithPreconditioner<In, Out, BiCGILU0>(input, params);
+    return solveWithPreconditioner<In, Out, BiCG>(input, params);
+  }
   else
   {
     BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Need to upgrade Eigen for LSCG."));
   }
 }
 
+template <typename In, typename Out, template <typename> class Solver>
+Out SolveLinearSystemAlgorithm::solveWithPreconditioner(const In& input, const Parameters& params) const
+{
+  using SolutionType = DenseColumnMatrixGeneric<typename std::tuple_element<0, In>::type::element_type::value_type>;
+  return solve<SolveLinearSystemAlgorithmEigenCGImpl<SolutionType, Solver>, In, Out>(input, params);
+}
+
 template <typename SolverType, typename In, typename Out>
 Out SolveLinearSystemAlgorithm::solve(const In& input, const Parameters& params) const
 {
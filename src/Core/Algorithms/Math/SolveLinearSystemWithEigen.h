@@ -47,6 +47,8 @@ namespace Math {
     typedef std::tuple<SCIRun::Core::Datatypes::DenseColumnMatrixHandle, double, int> Outputs;
     typedef std::tuple<SCIRun::Core::Datatypes::ComplexDenseColumnMatrixHandle, double, int> ComplexOutputs;
 
+    SolveLinearSystemAlgorithm();
+
     Outputs run(const Inputs& input, const Parameters& params) const;
     ComplexOutputs run(const ComplexInputs& input, const Parameters& params) const;
 
@@ -54,6 +56,8 @@ namespace Math {
   private:
     template <typename In, typename Out>
     Out runImpl(const In& input, const Parameters& params) const;
+    template <typename In, typename Out, template <typename> class Solver>
+    Out solveWithPreconditioner(const In& input, const Parameters& params) const;
     template <typename SolverType, typename In, typename Out>
     Out solve(const In& input, const Parameters& params) const;
   };
@@ -0,0 +1,185 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <Core/Algorithms/Math/ParallelAlgebra/AlgebraicMultigrid.h>
+#include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Testing/Utils/MatrixTestUtilities.h>
+
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::TestUtils;
+using namespace SCIRun;
+using namespace ::testing;
+
+namespace
+{
+  /// 7-point finite difference Laplacian on an n^3 grid. With dirichlet set the
+  /// boundary is eliminated, otherwise it is the singular pure Neumann operator.
+  SparseRowMatrixHandle poisson3D(int n, bool dirichlet)
+  {
+    const int size = n*n*n;
+    std::vector<SparseRowMatrix::Triplet> entries;
+    auto index = [n](int i, int j, int k) { return (k*n + j)*n + i; };
+    for (int k = 0; k < n; ++k)
+      for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+        {
+          const int row = index(i, j, k);
+          double diag = dirichlet ? 6.0 : 0.0;
+          const int nb[6][3] = { {i-1,j,k}, {i+1,j,k}, {i,j-1,k}, {i,j+1,k}, {i,j,k-1}, {i,j,k+1} };
+          for (const auto& c : nb)
+          {
+            if (c[0] < 0 || c[0] >= n || c[1] < 0 || c[1] >= n || c[2] < 0 || c[2] >= n)
+              continue;
+            entries.push_back(SparseRowMatrix::Triplet(row, index(c[0], c[1], c[2]), -1.0));
+            if (!dirichlet)
+              diag += 1.0;
+          }
+          entries.push_back(SparseRowMatrix::Triplet(row, row, diag));
+        }
+    auto A = boost::make_shared<SparseRowMatrix>(size, size);
+    A->setFromTriplets(entries.begin(), entries.end());
+    A->makeCompressed();
+    return A;
+  }
+
+  DenseColumnMatrixHandle rhs(SparseRowMatrixHandle A)
+  {
+    // right hand side of a known smooth solution, consistent for singular operators too
+    DenseColumnMatrix x(A->nrows());
+    for (size_t i = 0; i < x.nrows(); ++i)
+      x[i] = std::sin(0.01*i);
+    return boost::make_shared<DenseColumnMatrix>(*A * x);
+  }
+
+  double relativeResidual(SparseRowMatrixHandle A, DenseColumnMatrixHandle b, DenseColumnMatrixHandle x)
+  {
+    DenseColumnMatrix r = *b - *A * *x;
+    return r.norm() / b->norm();
+  }
+
+  DenseColumnMatrixHandle solve(SparseRowMatrixHandle A, DenseColumnMatrixHandle b,
+    const std::string& method, const std::string& preconditioner, int maxIterations)
+  {
+    SolveLinearSystemAlgo algo;
+    algo.set(Variables::MaxIterations, maxIterations);
+    algo.set(Variables::TargetError, 1e-8);
+    algo.setOption(Variables::Method, method);
+    algo.setOption(Variables::Preconditioner, preconditioner);
+    algo.setUpdaterFunc([](double) {});
+
+    DenseColumnMatrixHandle x;
+    ScopedTimer t(method + " with " + preconditioner + " preconditioner");
+    EXPECT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), x));
+    return x;
+  }
+}
+
+TEST(AlgebraicMultigridTests, CoarsensPoissonMatrix)
+{
+  auto A = poisson3D(24, true);
+  AlgebraicMultigrid amg(A);
+
+  EXPECT_GE(amg.numLevels(), 2u);
+  EXPECT_EQ(A->nrows(), amg.levelSize(0));
+  for (size_t l = 1; l < amg.numLevels(); ++l)
+    EXPECT_LT(amg.levelSize(l), amg.levelSize(l-1) / 4);
+  EXPECT_LT(amg.operatorComplexity(), 2.0);
+
+  EXPECT_TRUE(amg.matches(A));
+  EXPECT_FALSE(amg.matches(poisson3D(24, true)));
+}
+
+TEST(AlgebraicMultigridTests, SingleLevelForSmallMatrix)
+{
+  auto A = poisson3D(5, true);
+  AlgebraicMultigrid amg(A);
+  EXPECT_EQ(1u, amg.numLevels());
+
+  auto b = rhs(A);
+  auto x = solve(A, b, "cg", "AMG", 3);
+  EXPECT_LT(relativeResidual(A, b, x), 1e-8);
+}
+
+TEST(AlgebraicMultigridTests, PreconditionedCGConvergesWhereJacobiDoesNot)
+{
+  auto A = poisson3D(30, true);
+  auto b = rhs(A);
+
+  auto amg = solve(A, b, "cg", "AMG", 40);
+  auto jacobi = solve(A, b, "cg", "Jacobi", 40);
+
+  EXPECT_LT(relativeResidual(A, b, amg), 1e-7);
+  EXPECT_GT(relativeResidual(A, b, jacobi), 1e-7);
+}
+
+TEST(AlgebraicMultigridTests, HandlesSingularNeumannOperator)
+{
+  auto A = poisson3D(20, false);
+  auto b = rhs(A);
+
+  auto x = solve(A, b, "cg", "AMG", 60);
+  EXPECT_LT(relativeResidual(A, b, x), 1e-7);
+}
+
+TEST(AlgebraicMultigridTests, PreconditionsBiCGAndMinres)
+{
+  auto A = poisson3D(20, true);
+  auto b = rhs(A);
+
+  EXPECT_LT(relativeResidual(A, b, solve(A, b, "bicg", "AMG", 60)), 1e-7);
+  EXPECT_LT(relativeResidual(A, b, solve(A, b, "minres", "AMG", 60)), 1e-7);
+}
+
+TEST(AlgebraicMultigridTests, UpdateKeepsHierarchyForNewValues)
+{
+  auto A = poisson3D(24, true);
+  AlgebraicMultigrid amg(A);
+  const auto levels = amg.numLevels();
+  const auto coarseSize = amg.levelSize(levels - 1);
+
+  // a varying coefficient on the same grid
+  auto B = boost::make_shared<SparseRowMatrix>(*A);
+  for (int i = 0; i < B->outerSize(); ++i)
+    for (SparseRowMatrix::InnerIterator it(*B, i); it; ++it)
+      it.valueRef() *= 1.0 + 0.5*std::sin(0.01*(i + it.col()));
+
+  EXPECT_TRUE(amg.matchesPattern(B));
+  EXPECT_FALSE(amg.matches(B));
+  amg.update(B);
+  EXPECT_TRUE(amg.matches(B));
+  EXPECT_EQ(levels, amg.numLevels());
+  EXPECT_EQ(coarseSize, amg.levelSize(levels - 1));
+}
@@ -0,0 +1,470 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <Core/Algorithms/Math/ParallelAlgebra/IncompleteFactorization.h>
+#include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
+#include <Core/Algorithms/Math/SolveLinearSystemWithEigen.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/Algorithms/DataIO/ReadMatrix.h>
+#include <Testing/Utils/SCIRunUnitTests.h>
+#include <Testing/Utils/MatrixTestUtilities.h>
+#include <chrono>
+
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::DataIO;
+using namespace SCIRun::TestUtils;
+using namespace SCIRun;
+using namespace ::testing;
+
+namespace
+{
+  /// 7-point finite difference operator on an n^3 grid with Dirichlet boundary;
+  /// a nonzero convection adds an upwinded first derivative, making it nonsymmetric
+  SparseRowMatrixHandle convectionDiffusion3D(int n, double convection)
+  {
+    const int size = n*n*n;
+    std::vector<SparseRowMatrix::Triplet> entries;
+    auto index = [n](int i, int j, int k) { return (k*n + j)*n + i; };
+    for (int k = 0; k < n; ++k)
+      for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+        {
+          const int row = index(i, j, k);
+          entries.push_back(SparseRowMatrix::Triplet(row, row, 6.0 + convection));
+          const int nb[6][3] = { {i-1,j,k}, {i+1,j,k}, {i,j-1,k}, {i,j+1,k}, {i,j,k-1}, {i,j,k+1} };
+          for (int c = 0; c < 6; ++c)
+          {
+            const int* p = nb[c];
+            if (p[0] < 0 || p[0] >= n || p[1] < 0 || p[1] >= n || p[2] < 0 || p[2] >= n)
+              continue;
+            entries.push_back(SparseRowMatrix::Triplet(row, index(p[0], p[1], p[2]), c == 0 ? -1.0 - convection : -1.0));
+          }
+        }
+    auto A = boost::make_shared<SparseRowMatrix>(size, size);
+    A->setFromTriplets(entries.begin(), entries.end());
+    A->makeCompressed();
+    return A;
+  }
+
+  SparseRowMatrixHandle tridiagonal(int n)
+  {
+    std::vector<SparseRowMatrix::Triplet> entries;
+    for (int i = 0; i < n; ++i)
+    {
+      entries.push_back(SparseRowMatrix::Triplet(i, i, 2.5));
+      if (i > 0)
+        entries.push_back(SparseRowMatrix::Triplet(i, i-1, -1.0));
+      if (i < n-1)
+        entries.push_back(SparseRowMatrix::Triplet(i, i+1, -1.0));
+    }
+    auto A = boost::make_shared<SparseRowMatrix>(n, n);
+    A->setFromTriplets(entries.begin(), entries.end());
+    A->makeCompressed();
+    return A;
+  }
+
+  DenseColumnMatrix smoothVector(int n)
+  {
+    DenseColumnMatrix x(n);
+    for (int i = 0; i < n; ++i)
+      x[i] = std::sin(0.01*i) + 1.0;
+    return x;
+  }
+
+  DenseColumnMatrixHandle rhs(SparseRowMatrixHandle A)
+  {
+    return boost::make_shared<DenseColumnMatrix>(*A * smoothVector(A->nrows()));
+  }
+
+  double relativeResidual(SparseRowMatrixHandle A, DenseColumnMatrixHandle b, DenseColumnMatrixHandle x)
+  {
+    DenseColumnMatrix r = *b - *A * *x;
+    return r.norm() / b->norm();
+  }
+
+  DenseColumnMatrixHandle solve(SparseRowMatrixHandle A, DenseColumnMatrixHandle b,
+    const std::string& method, const std::string& preconditioner, int maxIterations)
+  {
+    SolveLinearSystemAlgo algo;
+    algo.set(Variables::MaxIterations, maxIterations);
+    algo.set(Variables::TargetError, 1e-8);
+    algo.setOption(Variables::Method, method);
+    algo.setOption(Variables::Preconditioner, preconditioner);
+    algo.setUpdaterFunc([](double) {});
+
+    DenseColumnMatrixHandle x;
+    ScopedTimer t(method + " with " + preconditioner + " preconditioner");
+    EXPECT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), x));
+    return x;
+  }
+
+  /// Applies a preconditioner to b on nproc threads
+  class ApplyPreconditioner : public ParallelLinearAlgebraBase
+  {
+  public:
+    ApplyPreconditioner(ParallelPreconditioner& M, bool transpose) : M_(M), transpose_(transpose) {}
+
+    bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const override
+    {
+      ParallelLinearAlgebra::ParallelVector R, Z;
+      if (!PLA.add_vector(matrices.b, R) || !PLA.add_vector(matrices.x, Z))
+        return false;
+      if (transpose_)
+        M_.applyTranspose(PLA, R, Z);
+      else
+        M_.apply(PLA, R, Z);
+      return true;
+    }
+
+  private:
+    ParallelPreconditioner& M_;
+    bool transpose_;
+  };
+
+  int eigenIterations(SparseRowMatrixHandle A, DenseColumnMatrixHandle b, const std::string& method, const std::string& preconditioner)
+  {
+    SolveLinearSystemAlgorithm algo;
+    algo.setOption(Variables::Preconditioner, preconditioner);
+    ScopedTimer t("Eigen " + method + " with " + preconditioner + " preconditioner");
+    auto x = algo.run(std::make_tuple(A, b), std::make_tuple(1e-8, 1000, method));
+    EXPECT_LT(relativeResidual(A, b, std::get<0>(x)), 1e-6);
+    return std::get<2>(x);
+  }
+}
+
+TEST(IncompleteFactorizationTests, ExactForTridiagonalMatrix)
+{
+  // no fill-in occurs, so IC(0) and ILU(0) are the complete factorizations
+  const int n = 50;
+  auto A = tridiagonal(n);
+  auto x = smoothVector(n);
+  DenseColumnMatrix b = *A * x;
+
+  for (auto type : { IncompleteFactorizationType::IC0, IncompleteFactorizationType::ILU0 })
+  {
+    IncompleteFactorizationGeneric<double> factors(*A, type);
+    EXPECT_EQ(0.0, factors.shift());
+    // every row depends on its predecessor, so there is no parallelism
+    EXPECT_EQ(2u*n, factors.numLevels());
+
+    DenseColumnMatrix z(n);
+    factors.solve(b.data(), z.data());
+    EXPECT_COLUMN_MATRIX_EQ_BY_TWO_NORM(x, z, 1e-12);
+  }
+}
+
+TEST(IncompleteFactorizationTests, DiagonalMatrixHasOneLevelPerSolve)
+{
+  SparseRowMatrix D(100, 100);
+  for (int i = 0; i < 100; ++i)
+    D.insert(i, i) = i + 1.0;
+  D.makeCompressed();
+
+  IncompleteFactorizationGeneric<double> factors(D, IncompleteFactorizationType::IC0);
+  EXPECT_EQ(2u, factors.numLevels());
+
+  DenseColumnMatrix r(100), z(100);
+  r.setOnes();
+  factors.solve(r.data(), z.data());
+  for (int i = 0; i < 100; ++i)
+    EXPECT_DOUBLE_EQ(1.0/(i + 1.0), z[i]);
+}
+
+TEST(IncompleteFactorizationTests, LevelsOfGridMatrixFollowWavefronts)
+{
+  // row (i,j,k) depends on its lower neighbors, so its level is i+j+k
+  const int n = 12;
+  auto A = convectionDiffusion3D(n, 0.0);
+  IncompleteFactorizationGeneric<double> factors(*A, IncompleteFactorizationType::IC0);
+  EXPECT_EQ(2u*(3*(n-1) + 1), factors.numLevels());
+}
+
+TEST(IncompleteFactorizationTests, TransposedSolveIsAdjoint)
+{
+  auto A = convectionDiffusion3D(8, 2.0);
+  const int n = A->nrows();
+  IncompleteFactorizationGeneric<double> factors(*A, IncompleteFactorizationType::ILU0);
+
+  DenseColumnMatrix x = smoothVector(n), y(n), Mx(n), MTy(n);
+  for (int i = 0; i < n; ++i)
+    y[i] = std::cos(0.3*i);
+  factors.solve(x.data(), Mx.data());
+  factors.solveTranspose(y.data(), MTy.data());
+
+  EXPECT_NEAR(Mx.dot(y), x.dot(MTy), 1e-10*std::fabs(Mx.dot(y)));
+}
+
+TEST(IncompleteFactorizationTests, ThreadedSolveMatchesPoolSolve)
+{
+  auto A = convectionDiffusion3D(50, 1.0);
+  const int n = A->nrows();
+  auto b = boost::make_shared<DenseColumnMatrix>(smoothVector(n));
+
+  for (auto type : { IncompleteFactorizationType::IC0, IncompleteFactorizationType::ILU0 })
+  {
+    IncompleteFactorization M(A, type);
+    for (bool transpose : { false, true })
+    {
+      DenseColumnMatrix expected(n);
+      if (transpose)
+        M.factors().solveTranspose(b->data(), expected.data());
+      else
+        M.factors().solve(b->data(), expected.data());
+
+      SolverInputs matrices;
+      matrices.A = A;
+      matrices.b = b;
+      matrices.x0 = b;
+      matrices.x = boost::make_shared<DenseColumnMatrix>(n);
+      ApplyPreconditioner apply(M, transpose);
+      ASSERT_TRUE(apply.start_parallel(matrices, 4));
+      EXPECT_COLUMN_MATRIX_EQ_BY_TWO_NORM(expected, *matrices.x, 1e-12);
+    }
+  }
+}
+
+TEST(IncompleteFactorizationTests, RefactorizationMatchesNewFactorization)
+{
+  auto A = convectionDiffusion3D(20, 1.0);
+  const int n = A->nrows();
+  auto b = smoothVector(n);
+
+  // same pattern, new values
+  auto B = boost::make_shared<SparseRowMatrix>(*A);
+  for (int k = 0; k < B->nonZeros(); ++k)
+    B->valuePtr()[k] *= 1.0 + 0.1*std::sin(double(k));
+
+  for (auto type : { IncompleteFactorizationType::IC0, IncompleteFactorizationType::ILU0 })
+  {
+    IncompleteFactorization M(A, type);
+    EXPECT_TRUE(M.matchesPattern(B));
+    EXPECT_FALSE(M.matches(B));
+    M.update(B);
+    EXPECT_TRUE(M.matches(B));
+
+    IncompleteFactorizationGeneric<double> expected(*B, type);
+    for (bool transpose : { false, true })
+    {
+      DenseColumnMatrix x(n), y(n);
+      if (transpose)
+      {
+        M.factors().solveTranspose(b.data(), x.data());
+        expected.solveTranspose(b.data(), y.data());
+      }
+      else
+      {
+        M.factors().solve(b.data(), x.data());
+        expected.solve(b.data(), y.data());
+      }
+      EXPECT_COLUMN_MATRIX_EQ_BY_TWO_NORM(y, x, 1e-12);
+    }
+  }
+}
+
+TEST(IncompleteFactorizationTests, DifferentPatternDoesNotMatch)
+{
+  IncompleteFactorization M(tridiagonal(100), IncompleteFactorizationType::IC0);
+  EXPECT_TRUE(M.matchesPattern(tridiagonal(100)));
+  EXPECT_FALSE(M.matchesPattern(tridiagonal(101)));
+
+  auto other = boost::make_shared<SparseRowMatrix>(100, 100);
+  other->setIdentity();
+  other->makeCompressed();
+  EXPECT_FALSE(M.matchesPattern(other));
+}
+
+TEST(IncompleteFactorizationTests, ShiftsDiagonalWhenCholeskyBreaksDown)
+{
+  // Kershaw's matrix is positive definite, but its IC(0) has a negative pivot
+  DenseMatrix K(4, 4);
+  K << 3, -2, 0, 2,
+      -2, 3, -2, 0,
+       0, -2, 3, -2,
+       2, 0, -2, 3;
+  SparseRowMatrix A(4, 4);
+  copyDenseToSparse(K, A);
+
+  IncompleteFactorizationGeneric<double> factors(A, IncompleteFactorizationType::IC0);
+  EXPECT_GT(factors.shift(), 0.0);
+}
+
+TEST(IncompleteFactorizationTests, ThrowsOnIndefiniteMatrixForCholesky)
+{
+  auto A = tridiagonal(10);
+  A->coeffRef(5, 5) = -2.5;
+  EXPECT_THROW(IncompleteFactorizationGeneric<double>(*A, IncompleteFactorizationType::IC0), AlgorithmProcessingException);
+  EXPECT_NO_THROW(IncompleteFactorizationGeneric<double>(*A, IncompleteFactorizationType::ILU0));
+}
+
+TEST(IncompleteFactorizationTests, IC0ConjugateGradientConvergesWhereJacobiDoesNot)
+{
+  auto A = convectionDiffusion3D(30, 0.0);
+  auto b = rhs(A);
+
+  auto ic = solve(A, b, "cg", "IC0", 40);
+  auto jacobi = solve(A, b, "cg", "Jacobi", 40);
+
+  EXPECT_LT(relativeResidual(A, b, ic), 1e-7);
+  EXPECT_GT(relativeResidual(A, b, jacobi), 1e-7);
+}
+
+TEST(IncompleteFactorizationTests, ILU0BiConjugateGradientConvergesWhereJacobiDoesNot)
+{
+  auto A = convectionDiffusion3D(30, 2.0);
+  auto b = rhs(A);
+
+  auto ilu = solve(A, b, "bicg", "ILU0", 50);
+  auto jacobi = solve(A, b, "bicg", "Jacobi", 50);
+
+  EXPECT_LT(relativeResidual(A, b, ilu), 1e-7);
+  EXPECT_GT(relativeResidual(A, b, jacobi), 1e-7);
+}
+
+TEST(IncompleteFactorizationTests, PreconditionsMinres)
+{
+  auto A = convectionDiffusion3D(20, 0.0);
+  auto b = rhs(A);
+
+  EXPECT_LT(relativeResidual(A, b, solve(A, b, "minres", "IC0", 80)), 1e-7);
+}
+
+TEST(IncompleteFactorizationTests, EigenSolversNeedFewerIterations)
+{
+  auto A = convectionDiffusion3D(30, 0.0);
+  auto b = rhs(A);
+  const int jacobi = eigenIterations(A, b, "cg", "Jacobi");
+  const int ic = eigenIterations(A, b, "cg", "IC0");
+  EXPECT_LT(ic, jacobi / 2);
+
+  auto N = convectionDiffusion3D(30, 2.0);
+  auto c = rhs(N);
+  const int bicgJacobi = eigenIterations(N, c, "bicg", "Jacobi");
+  const int bicgIlu = eigenIterations(N, c, "bicg", "ILU0");
+  EXPECT_LT(bicgIlu, bicgJacobi / 2);
+}
+
+TEST(IncompleteFactorizationTests, EigenSolverHandlesComplexSystems)
+{
+  auto A = convectionDiffusion3D(12, 2.0);
+  ComplexSparseRowMatrixHandle C(new ComplexSparseRowMatrix(A->cast<complex>() * complex(1.0, 0.5)));
+  ComplexDenseColumnMatrix x(C->nrows());
+  for (size_t i = 0; i < x.nrows(); ++i)
+    x[i] = complex(std::sin(0.1*i), 1.0);
+  ComplexDenseColumnMatrixHandle b(new ComplexDenseColumnMatrix(*C * x));
+
+  SolveLinearSystemAlgorithm algo;
+  algo.setOption(Variables::Preconditioner, "ILU0");
+  auto solution = algo.run(std::make_tuple(C, b), std::make_tuple(1e-10, 200, std::string("bicg")));
+
+  ComplexDenseColumnMatrix r = *b - *C * *std::get<0>(solution);
+  EXPECT_LT(r.norm() / b->norm(), 1e-8);
+}
+
+namespace
+{
+  struct SolveCost
+  {
+    int iterations;
+    double seconds;
+  };
+
+  /// Iterations and wall time, factorization included, to reach the target error
+  SolveCost solveCost(SparseRowMatrixHandle A, DenseColumnMatrixHandle b,
+    const std::string& method, const std::string& preconditioner)
+  {
+    SolveLinearSystemAlgo algo;
+    algo.set(Variables::MaxIterations, 5000);
+    algo.set(Variables::TargetError, 1e-6);
+    algo.setOption(Variables::Method, method);
+    algo.setOption(Variables::Preconditioner, preconditioner);
+    algo.setUpdaterFunc([](double) {});
+
+    DenseColumnMatrixHandle x;
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), x));
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << method << " with " << preconditioner << ": " << algo.iterations()
+      << " iterations, " << elapsed.count() << " s" << std::endl;
+    EXPECT_LT(relativeResidual(A, b, x), 1e-5);
+    return { algo.iterations(), elapsed.count() };
+  }
+}
+
+class IncompleteFactorizationOnTestMatrices : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    auto Afile = TestResources::rootDir() / "Matrices" / "moritz_A.mat";
+    auto rhsFile = TestResources::rootDir() / "Matrices" / "moritz_b.mat";
+    if (!boost::filesystem::exists(Afile) || !boost::filesystem::exists(rhsFile))
+    {
+      FAIL() << "TODO: Issue #142 will standardize these file locations other than being on Dan's hard drive." << std::endl
+        << "Once that issue is done however, this will be a user setup error." << std::endl;
+      return;
+    }
+    ReadMatrixAlgorithm reader;
+    A = castMatrix::toSparse(reader.run(Afile.string()));
+    b = convertMatrix::toColumn(reader.run(rhsFile.string()));
+    ASSERT_TRUE(A != nullptr);
+    ASSERT_TRUE(b != nullptr);
+  }
+
+  SparseRowMatrixHandle A;
+  DenseColumnMatrixHandle b;
+};
+
+// Regression bounds: the incomplete factors must save at least a third of the
+// Jacobi iterations, and the whole solve may not take longer than Jacobi's.
+TEST_F(IncompleteFactorizationOnTestMatrices, IC0ConjugateGradientBeatsJacobi)
+{
+  auto jacobi = solveCost(A, b, "cg", "Jacobi");
+  auto ic = solveCost(A, b, "cg", "IC0");
+
+  EXPECT_LT(3 * ic.iterations, 2 * jacobi.iterations);
+  EXPECT_LT(ic.seconds, jacobi.seconds);
+}
+
+TEST_F(IncompleteFactorizationOnTestMatrices, ILU0BiConjugateGradientBeatsJacobi)
+{
+  auto jacobi = solveCost(A, b, "bicg", "Jacobi");
+  auto ilu = solveCost(A, b, "bicg", "ILU0");
+
+  EXPECT_LT(3 * ilu.iterations, 2 * jacobi.iterations);
+  EXPECT_LT(ilu.seconds, jacobi.seconds);
+}
@@ -976,3 +976,53 @@ TEST(ParallelArithmeticTests, CanComputeDotProductMulti)
   EXPECT_EQ(-9 , v23);
   EXPECT_EQ(9 , v13);
 }
+
+TEST(ParallelArithmeticTests, CanMultiplyMatrixByVectorAndDotInOnePass)
+{
+  ParallelLinearAlgebraSharedData data(getDummySystem(),1);
+  ParallelLinearAlgebra pla(data,0);
+
+  ParallelLinearAlgebra::ParallelVector v1;
+  auto vec1 = vector1();
+  pla.add_vector(vec1, v1);
+
+  ParallelLinearAlgebra::ParallelVector v2;
+  auto vec2 = vector2();
+  pla.add_vector(vec2, v2);
+
+  ParallelLinearAlgebra::ParallelMatrix m1;
+  auto mat1 = matrix1();
+  pla.add_matrix(mat1, m1);
+
+  EXPECT_EQ(-5, pla.mult_dot(m1,v1,v2));
+
+  EXPECT_EQ(1,v2.data_[0]);
+  EXPECT_EQ(-4,v2.data_[1]);
+  EXPECT_EQ(0,v2.data_[300]);
+  EXPECT_EQ(-2,v2.data_[size-1]);
+}
+
+TEST(ParallelArithmeticTests, CanScaleAddAndComputeNormInOnePass)
+{
+  ParallelLinearAlgebraSharedData data(getDummySystem(),1);
+  ParallelLinearAlgebra pla(data,0);
+
+  ParallelLinearAlgebra::ParallelVector v1;
+  auto vec1 = vector1();
+  pla.add_vector(vec1, v1);
+
+  ParallelLinearAlgebra::ParallelVector v3;
+  auto vec3 = vector3();
+  pla.add_vector(vec3, v3);
+
+  ParallelLinearAlgebra::ParallelVector r;
+  pla.new_vector(r);
+
+  EXPECT_DOUBLE_EQ(sqrt(174.0), pla.scale_add_norm(2, v1, v3, r));
+
+  EXPECT_EQ(2, r.data_[0]);
+  EXPECT_EQ(5, r.data_[1]);
+  EXPECT_EQ(8, r.data_[2]);
+  EXPECT_EQ(-9, r.data_[size-1]);
+  EXPECT_DOUBLE_EQ(pla.norm(r), sqrt(174.0));
+}
@@ -0,0 +1,191 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <random>
+#include <Core/Algorithms/Math/ParallelAlgebra/ReverseCuthillMcKee.h>
+#include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun;
+
+namespace
+{
+  /// 7-point Laplacian on an n^3 grid with the nodes numbered in random order,
+  /// like the meshes TetGen or Cleaver produce
+  SparseRowMatrixHandle shuffledPoisson3D(int n, unsigned seed)
+  {
+    const int size = n*n*n;
+    std::vector<int> number(size);
+    std::iota(number.begin(), number.end(), 0);
+    std::mt19937 gen(seed);
+    std::shuffle(number.begin(), number.end(), gen);
+
+    std::vector<SparseRowMatrix::Triplet> entries;
+    auto index = [n, &number](int i, int j, int k) { return number[(k*n + j)*n + i]; };
+    for (int k = 0; k < n; ++k)
+      for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+        {
+          const int row = index(i, j, k);
+          entries.push_back(SparseRowMatrix::Triplet(row, row, 6.0));
+          const int nb[6][3] = { {i-1,j,k}, {i+1,j,k}, {i,j-1,k}, {i,j+1,k}, {i,j,k-1}, {i,j,k+1} };
+          for (const auto& c : nb)
+            if (c[0] >= 0 && c[0] < n && c[1] >= 0 && c[1] < n && c[2] >= 0 && c[2] < n)
+              entries.push_back(SparseRowMatrix::Triplet(row, index(c[0], c[1], c[2]), -1.0));
+        }
+    auto A = boost::make_shared<SparseRowMatrix>(size, size);
+    A->setFromTriplets(entries.begin(), entries.end());
+    A->makeCompressed();
+    return A;
+  }
+
+  void expectPermutation(const std::vector<index_type>& p, size_t n)
+  {
+    ASSERT_EQ(n, p.size());
+    std::vector<index_type> sorted(p);
+    std::sort(sorted.begin(), sorted.end());
+    for (size_t i = 0; i < n; ++i)
+      ASSERT_EQ(static_cast<index_type>(i), sorted[i]);
+  }
+}
+
+TEST(ReverseCuthillMcKeeTests, ReducesBandwidthOfRandomlyNumberedGrid)
+{
+  auto A = shuffledPoisson3D(12, 3);
+  ReverseCuthillMcKee rcm(A);
+  expectPermutation(rcm.permutation(), A->nrows());
+
+  auto B = rcm.permute(*A);
+  EXPECT_EQ(A->nonZeros(), B->nonZeros());
+  EXPECT_GT(ReverseCuthillMcKee::bandwidth(*A), 1000);
+  // the best possible ordering of a 12^3 grid has a bandwidth of about 12^2
+  EXPECT_LT(ReverseCuthillMcKee::bandwidth(*B), 250);
+}
+
+TEST(ReverseCuthillMcKeeTests, PermutedSystemHasPermutedSolution)
+{
+  auto A = shuffledPoisson3D(5, 7);
+  ReverseCuthillMcKee rcm(A);
+  auto B = rcm.permute(*A);
+  const auto& p = rcm.permutation();
+
+  for (size_t i = 0; i < A->nrows(); ++i)
+    for (size_t j = 0; j < A->ncols(); ++j)
+      ASSERT_EQ(A->coeff(p[i], p[j]), B->coeff(i, j)) << i << "," << j;
+
+  DenseColumnMatrix x(A->nrows());
+  for (size_t i = 0; i < x.nrows(); ++i)
+    x[i] = i;
+  auto px = rcm.permute(x);
+  DenseColumnMatrix Ax = *A * x;
+  DenseColumnMatrix Bpx = *B * *px;
+  auto back = rcm.unpermute(Bpx);
+  for (size_t i = 0; i < x.nrows(); ++i)
+    EXPECT_EQ(Ax[i], (*back)[i]);
+
+  DenseMatrix X(A->nrows(), 2);
+  X.col(0) = x;
+  X.col(1) = Ax;
+  auto roundTrip = rcm.unpermute(*rcm.permute(X));
+  EXPECT_EQ(0.0, (*roundTrip - X).norm());
+}
+
+TEST(ReverseCuthillMcKeeTests, HandlesNonsymmetricPatternAndSeveralComponents)
+{
+  // two decoupled chains, one of them only coupled one way, and an isolated node
+  std::vector<SparseRowMatrix::Triplet> entries;
+  const int n = 9;
+  for (int i = 0; i < n; ++i)
+    entries.push_back(SparseRowMatrix::Triplet(i, i, 1.0));
+  for (int i = 0; i + 2 < 6; i += 2)
+    entries.push_back(SparseRowMatrix::Triplet(i, i + 2, -1.0));
+  entries.push_back(SparseRowMatrix::Triplet(5, 1, -1.0));
+  entries.push_back(SparseRowMatrix::Triplet(3, 5, -1.0));
+  auto A = boost::make_shared<SparseRowMatrix>(n, n);
+  A->setFromTriplets(entries.begin(), entries.end());
+  A->makeCompressed();
+
+  ReverseCuthillMcKee rcm(A);
+  expectPermutation(rcm.permutation(), n);
+  auto B = rcm.permute(*A);
+  EXPECT_EQ(A->nonZeros(), B->nonZeros());
+  EXPECT_LE(ReverseCuthillMcKee::bandwidth(*B), 1);
+}
+
+TEST(ReverseCuthillMcKeeTests, PatternIsMatchedForNewValues)
+{
+  auto A = shuffledPoisson3D(6, 1);
+  ReverseCuthillMcKee rcm(A);
+  auto scaled = boost::make_shared<SparseRowMatrix>(*A * 2.0);
+  EXPECT_TRUE(rcm.matchesPattern(scaled));
+  EXPECT_EQ(2.0 * rcm.permute(*A)->norm(), rcm.permute(*scaled)->norm());
+  EXPECT_FALSE(rcm.matchesPattern(shuffledPoisson3D(6, 2)));
+}
+
+TEST(ReverseCuthillMcKeeTests, SolverGivesSameSolutionWithReordering)
+{
+  auto A = shuffledPoisson3D(14, 5);
+  auto b = boost::make_shared<DenseColumnMatrix>(A->nrows());
+  for (size_t i = 0; i < b->nrows(); ++i)
+    (*b)[i] = std::sin(0.1 * i);
+
+  for (const auto& preconditioner : { "Jacobi", "IC0" })
+  {
+    SolveLinearSystemAlgo algo;
+    algo.set(Variables::TargetError, 1e-10);
+    algo.setOption(Variables::Method, "cg");
+    algo.setOption(Variables::Preconditioner, preconditioner);
+    algo.setUpdaterFunc([](double) {});
+
+    DenseColumnMatrixHandle x;
+    ASSERT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), x));
+    algo.set(Parameters::ReorderMatrix, true);
+    DenseColumnMatrixHandle reordered;
+    ASSERT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), reordered));
+    EXPECT_LE((*x - *reordered).norm(), 1e-8 * x->norm()) << preconditioner;
+    DenseColumnMatrix r = *b - *A * *reordered;
+    EXPECT_LE(r.norm(), 1e-10 * b->norm()) << preconditioner;
+
+    // block right hand sides are reordered as well
+    DenseMatrix B(b->nrows(), 2);
+    B.col(0) = *b;
+    B.col(1) = 2.0 * *b;
+    DenseMatrixHandle X;
+    ASSERT_TRUE(algo.run(A, boost::make_shared<DenseMatrix>(B), DenseMatrixHandle(), X));
+    EXPECT_LE((X->col(1) - 2.0 * *reordered).norm(), 1e-8 * X->col(1).norm()) << preconditioner;
+  }
+}
@@ -40,6 +40,7 @@
 #include <Core/Datatypes/MatrixTypeConversions.h>
 #include <Core/Datatypes/MatrixIO.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
 
 using namespace SCIRun::Core::Datatypes;
@@ -147,3 +148,308 @@ TEST(SolveLinearSystemTests, DISABLED_CanSolveDarrell_MINRES)
   double solutionError = 2.4;
   CanSolveDarrellWithMethod("minres", solutionError);
 }
+
+namespace
+{
+  /// 7-point finite difference Laplacian on an n^3 grid with dirichlet boundary
+  SparseRowMatrixHandle poisson3D(int n)
+  {
+    const int size = n*n*n;
+    std::vector<SparseRowMatrix::Triplet> entries;
+    auto index = [n](int i, int j, int k) { return (k*n + j)*n + i; };
+    for (int k = 0; k < n; ++k)
+      for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+        {
+          const int row = index(i, j, k);
+          const int nb[6][3] = { {i-1,j,k}, {i+1,j,k}, {i,j-1,k}, {i,j+1,k}, {i,j,k-1}, {i,j,k+1} };
+          for (const auto& c : nb)
+          {
+            if (c[0] < 0 || c[0] >= n || c[1] < 0 || c[1] >= n || c[2] < 0 || c[2] >= n)
+              continue;
+            entries.push_back(SparseRowMatrix::Triplet(row, index(c[0], c[1], c[2]), -1.0));
+          }
+          entries.push_back(SparseRowMatrix::Triplet(row, row, 6.0));
+        }
+    auto A = boost::make_shared<SparseRowMatrix>(size, size);
+    A->setFromTriplets(entries.begin(), entries.end());
+    A->makeCompressed();
+    return A;
+  }
+
+  /// One column per "electrode": a dipole-like source pair, the last column is left zero
+  DenseMatrixHandle electrodeRhs(SparseRowMatrixHandle A, int columns)
+  {
+    auto b = boost::make_shared<DenseMatrix>(A->nrows(), columns);
+    b->setZero();
+    for (int j = 0; j < columns - 1; ++j)
+    {
+      (*b)((j*7919) % A->nrows(), j) = 1.0;
+      (*b)((j*104729 + 13) % A->nrows(), j) = -1.0;
+    }
+    return b;
+  }
+
+  SolveLinearSystemAlgo& configure(SolveLinearSystemAlgo& algo, const std::string& method, const std::string& preconditioner)
+  {
+    algo.set(Variables::MaxIterations, 500);
+    algo.set(Variables::TargetError, 1e-9);
+    algo.setOption(Variables::Method, method);
+    algo.setOption(Variables::Preconditioner, preconditioner);
+    algo.setUpdaterFunc([](double) {});
+    return algo;
+  }
+
+  void expectSolvesEachColumn(SparseRowMatrixHandle A, DenseMatrixHandle b, DenseMatrixHandle x, double tolerance)
+  {
+    ASSERT_TRUE(x != nullptr);
+    ASSERT_EQ(b->nrows(), x->nrows());
+    ASSERT_EQ(b->ncols(), x->ncols());
+    DenseMatrix r = *b - *A * *x;
+    for (size_t j = 0; j < b->ncols(); ++j)
+    {
+      const double bnorm = b->col(j).norm();
+      if (bnorm == 0)
+        EXPECT_EQ(0.0, x->col(j).norm());
+      else
+        EXPECT_LE(r.col(j).norm() / bnorm, tolerance) << "column " << j;
+    }
+  }
+}
+
+TEST(SolveLinearSystemTests, BlockCGMatchesColumnByColumnSolves)
+{
+  auto A = poisson3D(24);
+  auto b = electrodeRhs(A, 32);
+
+  for (const auto& preconditioner : { "None", "Jacobi" })
+  {
+    SolveLinearSystemAlgo algo;
+    configure(algo, "cg", preconditioner);
+
+    DenseMatrixHandle block;
+    {
+      ScopedTimer t(std::string("block CG with ") + preconditioner + " preconditioner, 32 right hand sides");
+      ASSERT_TRUE(algo.run(A, b, DenseMatrixHandle(), block));
+    }
+    expectSolvesEachColumn(A, b, block, 1e-9);
+
+    DenseMatrix columns(b->nrows(), b->ncols());
+    {
+      ScopedTimer t(std::string("column CG with ") + preconditioner + " preconditioner, 32 right hand sides");
+      for (size_t j = 0; j < b->ncols(); ++j)
+      {
+        DenseColumnMatrixHandle x;
+        ASSERT_TRUE(algo.run(A, boost::make_shared<DenseColumnMatrix>(b->col(j)), DenseColumnMatrixHandle(), x));
+        columns.col(j) = *x;
+      }
+    }
+    EXPECT_LE((*block - columns).norm(), 1e-6 * columns.norm());
+  }
+}
+
+TEST(SolveLinearSystemTests, BlockCGUsesInitialGuess)
+{
+  auto A = poisson3D(12);
+  auto b = electrodeRhs(A, 4);
+  SolveLinearSystemAlgo algo;
+  configure(algo, "cg", "Jacobi");
+
+  DenseMatrixHandle x;
+  ASSERT_TRUE(algo.run(A, b, DenseMatrixHandle(), x));
+
+  // starting from the solution leaves nothing to do
+  DenseMatrixHandle again;
+  ASSERT_TRUE(algo.run(A, b, x, again));
+  expectSolvesEachColumn(A, b, again, 1e-9);
+  EXPECT_LE((*again - *x).norm(), 1e-12 * x->norm());
+}
+
+TEST(SolveLinearSystemTests, OtherMethodsSolveBlockColumnByColumn)
+{
+  auto A = poisson3D(12);
+  auto b = electrodeRhs(A, 3);
+  for (const auto& setup : { std::make_pair("bicg", "Jacobi"), std::make_pair("cg", "IC0") })
+  {
+    SolveLinearSystemAlgo algo;
+    configure(algo, setup.first, setup.second);
+    DenseMatrixHandle x;
+    ASSERT_TRUE(algo.run(A, b, DenseMatrixHandle(), x));
+    expectSolvesEachColumn(A, b, x, 1e-8);
+  }
+}
+
+TEST(SolveLinearSystemTests, AlgorithmInputAcceptsDenseRightHandSide)
+{
+  auto A = poisson3D(10);
+  auto b = electrodeRhs(A, 5);
+  SolveLinearSystemAlgo algo;
+  configure(algo, "cg", "Jacobi");
+
+  AlgorithmInput input;
+  input[Variables::LHS] = A;
+  input[Variables::RHS] = b;
+  auto output = algo.run(input);
+  auto x = output.get<DenseMatrix>(Variables::Solution);
+  expectSolvesEachColumn(A, b, x, 1e-9);
+}
+
+TEST(SolveLinearSystemTests, BlockSolveRejectsMismatchedSizes)
+{
+  auto A = poisson3D(5);
+  auto b = boost::make_shared<DenseMatrix>(A->nrows() + 1, 2);
+  b->setZero();
+  SolveLinearSystemAlgo algo;
+  DenseMatrixHandle x;
+  EXPECT_THROW(algo.run(A, b, DenseMatrixHandle(), x), AlgorithmInputException);
+}
+
+namespace
+{
+  DenseMatrixHandle solveThroughInput(SolveLinearSystemAlgo& algo, SparseRowMatrixHandle A, MatrixHandle b)
+  {
+    AlgorithmInput input;
+    input[Variables::LHS] = A;
+    input[Variables::RHS] = b;
+    return algo.run(input).get<DenseMatrix>(Variables::Solution);
+  }
+
+  DenseColumnMatrixHandle perturbedColumn(SparseRowMatrixHandle A, double perturbation)
+  {
+    DenseColumnMatrix x(A->nrows());
+    for (size_t i = 0; i < x.nrows(); ++i)
+      x[i] = std::sin(0.01*i) + perturbation*std::cos(0.07*i);
+    return boost::make_shared<DenseColumnMatrix>(*A * x);
+  }
+}
+
+TEST(SolveLinearSystemTests, WarmStartSavesIterationsForSimilarRightHandSide)
+{
+  auto A = poisson3D(20);
+  for (bool warmStart : { false, true })
+  {
+    SolveLinearSystemAlgo algo;
+    configure(algo, "cg", "Jacobi");
+    algo.set(Parameters::WarmStart, warmStart);
+
+    solveThroughInput(algo, A, perturbedColumn(A, 0.0));
+    const int cold = algo.iterations();
+    auto b = perturbedColumn(A, 1e-4);
+    auto x = solveThroughInput(algo, A, b);
+    expectSolvesEachColumn(A, convertMatrix::toDense(b), x, 1e-9);
+    if (warmStart)
+      EXPECT_LT(algo.iterations(), cold / 2);
+    else
+      EXPECT_EQ(cold, algo.iterations());
+  }
+}
+
+TEST(SolveLinearSystemTests, WarmStartWorksForBlockRightHandSide)
+{
+  auto A = poisson3D(12);
+  auto b = electrodeRhs(A, 4);
+  SolveLinearSystemAlgo algo;
+  configure(algo, "cg", "Jacobi");
+  algo.set(Parameters::WarmStart, true);
+
+  solveThroughInput(algo, A, b);
+  EXPECT_GT(algo.iterations(), 0);
+  auto x = solveThroughInput(algo, A, b);
+  EXPECT_EQ(0, algo.iterations());
+  expectSolvesEachColumn(A, b, x, 1e-9);
+
+  // a different number of columns starts from zero again
+  auto fewer = electrodeRhs(A, 3);
+  solveThroughInput(algo, A, fewer);
+  EXPECT_GT(algo.iterations(), 0);
+}
+
+TEST(SolveLinearSystemTests, WarmStartUpdatesPreconditionerForNewValues)
+{
+  auto A = poisson3D(16);
+  auto B = boost::make_shared<SparseRowMatrix>(*A);
+  for (int k = 0; k < B->nonZeros(); ++k)
+    B->valuePtr()[k] *= 1.01;
+
+  for (const auto& preconditioner : { "AMG", "IC0" })
+  {
+    SolveLinearSystemAlgo algo;
+    configure(algo, "cg", preconditioner);
+    algo.set(Parameters::WarmStart, true);
+
+    auto b = perturbedColumn(A, 0.0);
+    solveThroughInput(algo, A, b);
+    const int cold = algo.iterations();
+    auto x = solveThroughInput(algo, B, b);
+    expectSolvesEachColumn(B, convertMatrix::toDense(b), x, 1e-9);
+    EXPECT_LT(algo.iterations(), cold) << preconditioner;
+  }
+}
+
+TEST(SolveLinearSystemTests, MixedPrecisionMeetsDoubleTolerance)
+{
+  auto A = poisson3D(20);
+  auto b = perturbedColumn(A, 0.0);
+
+  for (const auto& preconditioner : { "None", "Jacobi" })
+  {
+    SolveLinearSystemAlgo algo;
+    configure(algo, "cg", preconditioner);
+
+    DenseColumnMatrixHandle xDouble;
+    {
+      ScopedTimer t(std::string("double precision CG with ") + preconditioner + " preconditioner");
+      ASSERT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), xDouble));
+    }
+    const int doubleIterations = algo.iterations();
+
+    algo.set(Parameters::MixedPrecision, true);
+    DenseColumnMatrixHandle xMixed;
+    {
+      ScopedTimer t(std::string("mixed precision CG with ") + preconditioner + " preconditioner");
+      ASSERT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), xMixed));
+    }
+
+    expectSolvesEachColumn(A, convertMatrix::toDense(b), convertMatrix::toDense(xMixed), 1e-9);
+    EXPECT_LE((*xMixed - *xDouble).norm(), 1e-7 * xDouble->norm()) << preconditioner;
+    EXPECT_LT(algo.iterations(), 2 * doubleIterations) << preconditioner;
+  }
+}
+
+TEST(SolveLinearSystemTests, MixedPrecisionRefinesFromInitialGuess)
+{
+  auto A = poisson3D(12);
+  auto b = perturbedColumn(A, 0.0);
+  SolveLinearSystemAlgo algo;
+  configure(algo, "cg", "Jacobi");
+  algo.set(Parameters::MixedPrecision, true);
+
+  DenseColumnMatrixHandle x;
+  ASSERT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), x));
+  DenseColumnMatrixHandle again;
+  ASSERT_TRUE(algo.run(A, b, x, again));
+  EXPECT_EQ(0, algo.iterations());
+  expectSolvesEachColumn(A, convertMatrix::toDense(b), convertMatrix::toDense(again), 1e-9);
+
+  auto zero = boost::make_shared<DenseColumnMatrix>(b->nrows());
+  zero->setZero();
+  ASSERT_TRUE(algo.run(A, zero, x, again));
+  EXPECT_EQ(0.0, again->norm());
+}
+
+TEST(SolveLinearSystemTests, MixedPrecisionSolvesBlockAndOtherPreconditioners)
+{
+  auto A = poisson3D(12);
+  auto b = electrodeRhs(A, 3);
+
+  const std::pair<std::string, std::string> setups[] = { { "cg", "Jacobi" }, { "cg", "AMG" }, { "bicg", "Jacobi" } };
+  for (const auto& setup : setups)
+  {
+    SolveLinearSystemAlgo algo;
+    configure(algo, setup.first, setup.second);
+    algo.set(Parameters::MixedPrecision, true);
+    DenseMatrixHandle x;
+    ASSERT_TRUE(algo.run(A, b, DenseMatrixHandle(), x));
+    expectSolvesEachColumn(A, b, x, 1e-9);
+  }
+}
@@ -154,7 +154,7 @@ INSTANTIATE_TEST_CASE_P(
 		"jacobi",
 		"minres"
 		),
-		Values("jacobi","none"),
+		Values("jacobi","none","IC0","ILU0"),
 	Values(1e-1,1e-3,1e-4,1e-5))
 	);
 #else
@@ -0,0 +1,161 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <Core/Algorithms/Math/ParallelAlgebra/VectorKernels.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Math;
+
+namespace
+{
+  std::vector<const VectorKernels*> supportedKernels()
+  {
+    std::vector<const VectorKernels*> kernels;
+    for (auto set : { VectorInstructionSet::Scalar, VectorInstructionSet::AVX2, VectorInstructionSet::AVX512 })
+      if (auto k = vectorKernels(set))
+        kernels.push_back(k);
+    return kernels;
+  }
+
+  std::vector<double> randomVector(size_t n, std::mt19937& gen)
+  {
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<double> v(n);
+    for (auto& x : v)
+      x = dist(gen);
+    return v;
+  }
+
+  // row lengths 0..20 so every kernel sees empty rows, full registers and remainders
+  struct RandomCSR
+  {
+    RandomCSR(size_t n, std::mt19937& gen) : rows(n + 1, 0)
+    {
+      std::uniform_int_distribution<index_type> length(0, 20), column(0, n - 1);
+      for (size_t i = 0; i < n; ++i)
+      {
+        auto len = length(gen);
+        for (index_type k = 0; k < len; ++k)
+          columns.push_back(column(gen));
+        rows[i + 1] = static_cast<index_type>(columns.size());
+      }
+      values = randomVector(columns.size(), gen);
+    }
+    std::vector<index_type> rows, columns;
+    std::vector<double> values;
+  };
+
+  const size_t sizes[] = { 0, 1, 3, 7, 8, 15, 16, 31, 33, 1001 };
+  const double tolerance = 1e-12;
+}
+
+TEST(VectorKernelsTests, DefaultSelectionIsSupported)
+{
+  auto& current = vectorKernels();
+  EXPECT_EQ(&current, vectorKernels(current.instructionSet));
+  EXPECT_TRUE(vectorKernels(VectorInstructionSet::Scalar) != nullptr);
+}
+
+TEST(VectorKernelsTests, CanSelectScalarKernels)
+{
+  auto previous = vectorKernels().instructionSet;
+  EXPECT_TRUE(selectVectorKernels(VectorInstructionSet::Scalar));
+  EXPECT_EQ(VectorInstructionSet::Scalar, vectorKernels().instructionSet);
+  EXPECT_TRUE(selectVectorKernels(previous));
+}
+
+TEST(VectorKernelsTests, VectorOperationsMatchScalarKernels)
+{
+  std::mt19937 gen(5);
+  auto scalar = vectorKernels(VectorInstructionSet::Scalar);
+  for (auto n : sizes)
+  {
+    auto a = randomVector(n, gen);
+    auto b = randomVector(n, gen);
+    std::vector<double> expected(n), expectedFused(n);
+    scalar->mult(a.data(), b.data(), expected.data(), n);
+    auto expectedNorm = scalar->scaleAddSumOfSquares(0.5, a.data(), b.data(), expectedFused.data(), n);
+
+    for (auto k : supportedKernels())
+    {
+      SCOPED_TRACE(std::string(k->name) + " n=" + std::to_string(n));
+      EXPECT_NEAR(scalar->dot(a.data(), b.data(), n), k->dot(a.data(), b.data(), n), tolerance);
+      EXPECT_NEAR(scalar->sumOfSquares(a.data(), n), k->sumOfSquares(a.data(), n), tolerance);
+
+      std::vector<double> r(n + 1, 42.0);
+      k->mult(a.data(), b.data(), r.data(), n);
+      for (size_t i = 0; i < n; ++i)
+        EXPECT_DOUBLE_EQ(expected[i], r[i]);
+      EXPECT_EQ(42.0, r[n]);
+
+      k->scaleAdd(0.5, a.data(), b.data(), r.data(), n);
+      for (size_t i = 0; i < n; ++i)
+        EXPECT_NEAR(expectedFused[i], r[i], tolerance);
+      EXPECT_EQ(42.0, r[n]);
+
+      std::fill(r.begin(), r.end(), 42.0);
+      EXPECT_NEAR(expectedNorm, k->scaleAddSumOfSquares(0.5, a.data(), b.data(), r.data(), n), tolerance);
+      for (size_t i = 0; i < n; ++i)
+        EXPECT_NEAR(expectedFused[i], r[i], tolerance);
+      EXPECT_EQ(42.0, r[n]);
+    }
+  }
+}
+
+TEST(VectorKernelsTests, SparseMatrixVectorProductMatchesScalarKernels)
+{
+  std::mt19937 gen(11);
+  auto scalar = vectorKernels(VectorInstructionSet::Scalar);
+  const size_t n = 517;
+  RandomCSR A(n, gen);
+  auto x = randomVector(n, gen);
+
+  std::vector<double> expected(n);
+  scalar->spmv(A.rows.data(), A.columns.data(), A.values.data(), x.data(), expected.data(), 0, n);
+
+  for (auto k : supportedKernels())
+  {
+    SCOPED_TRACE(k->name);
+    std::vector<double> r(n, 42.0);
+    // a sub range, as one thread of the parallel solver would compute it
+    k->spmv(A.rows.data(), A.columns.data(), A.values.data(), x.data(), r.data(), 100, 300);
+    for (size_t i = 0; i < n; ++i)
+      EXPECT_NEAR(i >= 100 && i < 300 ? expected[i] : 42.0, r[i], tolerance);
+
+    double expectedDot = 0;
+    for (size_t i = 0; i < n; ++i)
+      expectedDot += x[i] * expected[i];
+    std::fill(r.begin(), r.end(), 0.0);
+    EXPECT_NEAR(expectedDot, k->spmvDot(A.rows.data(), A.columns.data(), A.values.data(), x.data(), r.data(), 0, n), 1e-10);
+    for (size_t i = 0; i < n; ++i)
+      EXPECT_NEAR(expected[i], r[i], tolerance);
+  }
+}
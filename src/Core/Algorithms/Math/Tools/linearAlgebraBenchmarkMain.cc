@@ -0,0 +1,161 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+/// @file linearAlgebraBenchmarkMain.cc
+/// Reports the memory bandwidth reached by the solver vector kernels for every
+/// instruction set the CPU supports.
+///
+/// usage: linear_algebra_benchmark [grid size] [repetitions]
+/// The matrix is the 7 point Laplacian on a grid^3 mesh, the vectors have one
+/// entry per node. The product is also timed with the nodes numbered in random
+/// order, as meshes from TetGen or Cleaver are, and after reverse Cuthill-McKee
+/// reordering of that matrix.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <vector>
+#include <Core/Algorithms/Math/ParallelAlgebra/VectorKernels.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/ReverseCuthillMcKee.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Datatypes;
+
+namespace
+{
+  struct Laplacian
+  {
+    explicit Laplacian(index_type n) : rows(1, 0)
+    {
+      auto id = [n](index_type i, index_type j, index_type k) { return (k*n + j)*n + i; };
+      for (index_type k = 0; k < n; ++k)
+        for (index_type j = 0; j < n; ++j)
+          for (index_type i = 0; i < n; ++i)
+          {
+            auto add = [this](index_type c, double v) { columns.push_back(c); values.push_back(v); };
+            if (k > 0) add(id(i, j, k-1), -1.0);
+            if (j > 0) add(id(i, j-1, k), -1.0);
+            if (i > 0) add(id(i-1, j, k), -1.0);
+            add(id(i, j, k), 6.0);
+            if (i < n-1) add(id(i+1, j, k), -1.0);
+            if (j < n-1) add(id(i, j+1, k), -1.0);
+            if (k < n-1) add(id(i, j, k+1), -1.0);
+            rows.push_back(static_cast<index_type>(columns.size()));
+          }
+    }
+    size_t size() const { return rows.size() - 1; }
+    std::vector<index_type> rows, columns;
+    std::vector<double> values;
+  };
+
+  double volatile sink;
+
+  // best of several runs, reported as bytes moved per second
+  double bandwidth(double bytes, int repetitions, const std::function<double()>& kernel)
+  {
+    double best = 1e30;
+    for (int run = 0; run < 5; ++run)
+    {
+      auto start = std::chrono::steady_clock::now();
+      double s = 0.0;
+      for (int r = 0; r < repetitions; ++r)
+        s += kernel();
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      sink = s;
+      best = std::min(best, elapsed.count() / repetitions);
+    }
+    return bytes / best * 1e-9;
+  }
+}
+
+int main(int argc, const char* argv[])
+{
+  const index_type grid = argc > 1 ? std::atoi(argv[1]) : 64;
+  const int repetitions = argc > 2 ? std::atoi(argv[2]) : 20;
+
+  Laplacian A(grid);
+  const size_t n = A.size();
+  const size_t nnz = A.values.size();
+  std::vector<double> x(n, 1.0), y(n, 0.5), r(n, 0.0);
+
+  const double vec = sizeof(double) * static_cast<double>(n);
+  const double csr = (sizeof(double) + sizeof(index_type)) * static_cast<double>(nnz) + sizeof(index_type) * static_cast<double>(n + 1);
+
+  std::printf("%lu unknowns, %lu nonzeros, bandwidth in GB/s\n", static_cast<unsigned long>(n), static_cast<unsigned long>(nnz));
+  std::printf("%-10s %10s %10s %10s %10s %10s %10s\n", "kernels", "dot", "norm", "axpy", "axpy+norm", "spmv", "spmv+dot");
+
+  for (auto set : { VectorInstructionSet::Scalar, VectorInstructionSet::AVX2, VectorInstructionSet::AVX512 })
+  {
+    auto k = vectorKernels(set);
+    if (!k)
+      continue;
+    auto dot = bandwidth(2*vec, repetitions, [&]() { return k->dot(x.data(), y.data(), n); });
+    auto norm = bandwidth(vec, repetitions, [&]() { return k->sumOfSquares(x.data(), n); });
+    auto axpy = bandwidth(3*vec, repetitions, [&]() { k->scaleAdd(1e-3, x.data(), y.data(), r.data(), n); return r[0]; });
+    auto axpyNorm = bandwidth(3*vec, repetitions, [&]() { return k->scaleAddSumOfSquares(1e-3, x.data(), y.data(), r.data(), n); });
+    auto spmv = bandwidth(csr + 2*vec, repetitions, [&]()
+      { k->spmv(A.rows.data(), A.columns.data(), A.values.data(), x.data(), r.data(), 0, n); return r[0]; });
+    auto spmvDot = bandwidth(csr + 2*vec, repetitions, [&]()
+      { return k->spmvDot(A.rows.data(), A.columns.data(), A.values.data(), x.data(), r.data(), 0, n); });
+    std::printf("%-10s %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", k->name, dot, norm, axpy, axpyNorm, spmv, spmvDot);
+  }
+  std::printf("solver default: %s\n", vectorKernels().name);
+
+  // same matrix, nodes numbered randomly
+  std::vector<index_type> number(n);
+  std::iota(number.begin(), number.end(), 0);
+  std::mt19937 gen(1);
+  std::shuffle(number.begin(), number.end(), gen);
+  std::vector<SparseRowMatrix::Triplet> entries;
+  entries.reserve(nnz);
+  for (size_t i = 0; i < n; ++i)
+    for (index_type k = A.rows[i]; k < A.rows[i+1]; ++k)
+      entries.push_back(SparseRowMatrix::Triplet(number[i], number[A.columns[k]], A.values[k]));
+  auto shuffled = boost::make_shared<SparseRowMatrix>(static_cast<int>(n), static_cast<int>(n));
+  shuffled->setFromTriplets(entries.begin(), entries.end());
+  shuffled->makeCompressed();
+  ReverseCuthillMcKee rcm(shuffled);
+  auto reordered = rcm.permute(*shuffled);
+
+  const auto& k = vectorKernels();
+  auto spmv = [&](const SparseRowMatrix& M)
+  {
+    return bandwidth(csr + 2*vec, repetitions, [&]()
+      { k.spmv(M.outerIndexPtr(), M.innerIndexPtr(), M.valuePtr(), x.data(), r.data(), 0, n); return r[0]; });
+  };
+  std::printf("%-24s %10s %10s\n", "node numbering", "bandwidth", "spmv GB/s");
+  std::printf("%-24s %10ld %10.2f\n", "grid", static_cast<long>(grid*grid), spmv(SparseRowMatrix(n, n, A.rows.data(), A.columns.data(), A.values.data(), nnz)));
+  std::printf("%-24s %10ld %10.2f\n", "random", static_cast<long>(ReverseCuthillMcKee::bandwidth(*shuffled)), spmv(*shuffled));
+  std::printf("%-24s %10ld %10.2f\n", "reverse Cuthill-McKee", static_cast<long>(ReverseCuthillMcKee::bandwidth(*reordered)), spmv(*reordered));
+  return 0;
+}
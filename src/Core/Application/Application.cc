@@ -35,10 +35,15 @@
 #include <Core/Algorithms/Factory/HardCodedAlgorithmFactory.h>
 #include <Dataflow/State/SimpleMapModuleState.h>
 #include <Dataflow/Network/ModuleReexecutionStrategies.h>
+#include <Dataflow/Network/ModuleCostHistory.h>
+#include <Dataflow/Network/ModuleOutputMemoCache.h>
+#include <Dataflow/Network/PortDataCache.h>
 #include <Dataflow/Engine/Scheduler/DesktopExecutionStrategyFactory.h>
+#include <Dataflow/Engine/Scheduler/ModuleExecutionPool.h>
 #include <Core/Command/GlobalCommandBuilderFromCommandLine.h>
 #include <Core/Logging/Log.h>
 #include <Core/Logging/ApplicationHelper.h>
+#include <Core/Logging/ExecutionProfiler.h>
 #include <Core/IEPlugin/IEPluginInit.h>
 #include <Core/Utils/Exception.h>
 #include <Core/Application/Session/Session.h>
@@ -87,10 +92,14 @@ Application::Application() :
   LogSettings::Instance().setLogDirectory(configDir);
   SessionManager::Instance().initialize(configDir);
   SessionManager::Instance().session()->beginSession();
+  ModuleCostHistory::Instance().setStorageFile(configDir / "scirun_module_costs");
+  // created before any port, so it outlives the network's sources and sinks
+  PortDataCache::Instance();
 }
 
 Application::~Application()
 {
+  ModuleCostHistory::Instance().save();
   SessionManager::Instance().session()->endSession();
 }
 
@@ -159,6 +168,42 @@ void Application::readCommandLine(int argc, const char* argv[])
     auto maxCoresOption = private_->parameters_->developerParameters()->maxCores();
     if (maxCoresOption)
       Thread::Parallel::SetMaximumCores(*maxCoresOption);
+    auto maxModulesOption = private_->parameters_->developerParameters()->maxModules();
+    if (maxModulesOption)
+      ModuleExecutionPool::SetConcurrencyLimit(*maxModulesOption);
+    auto memoizeOption = private_->parameters_->developerParameters()->memoizeOutputsMegabytes();
+    if (memoizeOption)
+    {
+      auto spillDirectory = private_->parameters_->developerParameters()->memoizeSpillDirectory();
+      if (spillDirectory)
+        ModuleOutputMemoCache::Instance().setSpillDirectory(*spillDirectory);
+      ModuleOutputMemoCache::Instance().setMemoryBudget(static_cast<size_t>(*memoizeOption) << 20);
+    }
+    auto portCacheOption = private_->parameters_->developerParameters()->portCacheMegabytes();
+    if (portCacheOption)
+    {
+      auto spillDirectory = private_->parameters_->developerParameters()->portSpillDirectory();
+      if (spillDirectory)
+        PortDataCache::Instance().setSpillDirectory(*spillDirectory);
+      PortDataCache::Instance().setMemoryBudget(static_cast<size_t>(*portCacheOption) << 20);
+    }
+    auto profileOption = private_->parameters_->developerParameters()->profileTraceFile();
+    if (profileOption)
+    {
+      ExecutionProfiler::Instance().setEnabled(true);
+      boost::filesystem::path traceFile(*profileOption);
+      auto executionStart = boost::make_shared<ExecutionProfiler::Clock::time_point>();
+      ExecutionContext::connectNetworkExecutionStarts([executionStart]() { *executionStart = ExecutionProfiler::Clock::now(); });
+      // rewritten after every execution, so the trace covers the whole session
+      ExecutionContext::connectNetworkExecutionFinished([traceFile, executionStart](int)
+      {
+        auto& profiler = ExecutionProfiler::Instance();
+        profiler.recordSpan("Network execution", "network", *executionStart, ExecutionProfiler::Clock::now());
+        if (!profiler.writeChromeTrace(traceFile))
+          logError("Could not write execution trace to {}", traceFile.string());
+        logInfo("Execution profile summary:\n{}", profiler.summaryTable());
+      });
+    }
 
     LogSettings::Instance().setVerbose(parameters()->verboseMode());
   }
@@ -70,6 +70,15 @@ using namespace SCIRun::Core::Algorithms;
       return q;
     }
 
+    if (params->batchParameterFile())
+    {
+      if (params->dataDirectory())
+        q->enqueue(cmdFactory_->create(GlobalCommands::SetupDataDirectory));
+      q->enqueue(cmdFactory_->create(GlobalCommands::RunParameterSweep));
+      q->enqueue(cmdFactory_->create(GlobalCommands::QuitCommand));
+      return q;
+    }
+
     if (!params->disableSplash() && !params->disableGui())
       q->enqueue(cmdFactory_->create(GlobalCommands::ShowSplashScreen));
 
@@ -63,6 +63,8 @@ public:
       ("script,s", po::value<std::string>(), "Python script--interpret and drop into embedded console")
       ("Script,S", po::value<std::string>(), "Python script--interpret and quit after one SCIRun execution pass")
       ("import", po::value<std::string>(), "Import a network from SCIRun 4.7")
+      ("batch", po::value<std::string>(), "Execute the network once per parameter set in file arg, then quit")
+      ("batch-instances", po::value<unsigned int>(), "Number of network instances executing batch parameter sets at once")
       ("no_splash,0", "Turn off splash screen")
       ("verbose", "Turn on debug log information")
       //("threadMode", po::value<std::string>(), "network execution threading mode--DEVELOPER USE ONLY")
@@ -70,6 +72,12 @@ public:
       //("frameInitLimit", po::value<int>(), "ViewScene frame init limit--increase if renderer fails")
       ("guiExpandFactor", po::value<double>(), "Expansion factor for high resolution displays")
       ("max-cores", po::value<unsigned int>(), "Limit the number of cores used by multithreaded algorithms")
+      ("max-modules", po::value<unsigned int>(), "Limit the number of modules executing at once")
+      ("memoize-outputs", po::value<unsigned int>(), "Reuse module outputs, caching up to arg megabytes")
+      ("memoize-spill-dir", po::value<std::string>(), "Directory for memoized outputs evicted from memory")
+      ("port-cache", po::value<unsigned int>(), "Limit cached port data to arg megabytes")
+      ("port-spill-dir", po::value<std::string>(), "Directory for port data evicted from memory")
+      ("profile", po::value<std::string>(), "Profile network executions into Chrome trace file arg")
       ("list-modules", "print list of available modules")
       ;
 
@@ -119,9 +127,17 @@ public:
     const boost::optional<int>& frameInitLimit,
     const boost::optional<int>& regressionTimeout,
     const boost::optional<unsigned int>& maxCores,
+    const boost::optional<unsigned int>& maxModules,
+    const boost::optional<unsigned int>& memoizeOutputsMegabytes,
+    const boost::optional<std::string>& memoizeSpillDirectory,
+    const boost::optional<unsigned int>& portCacheMegabytes,
+    const boost::optional<std::string>& portSpillDirectory,
+    const boost::optional<std::string>& profileTraceFile,
     const boost::optional<double>& guiExpandFactor
-    ) : threadMode_(threadMode), reexecuteMode_(reexecuteMode), frameInitLimit_(frameInitLimit),
-    regressionTimeout_(regressionTimeout), maxCores_(maxCores), guiExpandFactor_(guiExpandFactor)
+    ) : threadMode_(threadMode), reexecuteMode_(reexecuteMode), memoizeSpillDirectory_(memoizeSpillDirectory),
+    portSpillDirectory_(portSpillDirectory), profileTraceFile_(profileTraceFile), frameInitLimit_(frameInitLimit), regressionTimeout_(regressionTimeout),
+    maxCores_(maxCores), maxModules_(maxModules), memoizeOutputsMegabytes_(memoizeOutputsMegabytes),
+    portCacheMegabytes_(portCacheMegabytes), guiExpandFactor_(guiExpandFactor)
   {}
   boost::optional<int> regressionTimeoutSeconds() const override
   {
@@ -143,14 +159,38 @@ public:
   {
     return maxCores_;
   }
+  boost::optional<unsigned int> maxModules() const override
+  {
+    return maxModules_;
+  }
+  boost::optional<unsigned int> memoizeOutputsMegabytes() const override
+  {
+    return memoizeOutputsMegabytes_;
+  }
+  boost::optional<std::string> memoizeSpillDirectory() const override
+  {
+    return memoizeSpillDirectory_;
+  }
+  boost::optional<unsigned int> portCacheMegabytes() const override
+  {
+    return portCacheMegabytes_;
+  }
+  boost::optional<std::string> portSpillDirectory() const override
+  {
+    return portSpillDirectory_;
+  }
+  boost::optional<std::string> profileTraceFile() const override
+  {
+    return profileTraceFile_;
+  }
   boost::optional<double> guiExpandFactor() const override
   {
     return guiExpandFactor_;
   }
 private:
-  boost::optional<std::string> threadMode_, reexecuteMode_;
+  boost::optional<std::string> threadMode_, reexecuteMode_, memoizeSpillDirectory_, portSpillDirectory_, profileTraceFile_;
   boost::optional<int> frameInitLimit_, regressionTimeout_;
-  boost::optional<unsigned int> maxCores_;
+  boost::optional<unsigned int> maxCores_, maxModules_, memoizeOutputsMegabytes_, portCacheMegabytes_;
   boost::optional<double> guiExpandFactor_;
 };
 
@@ -192,11 +232,13 @@ public:
     const boost::optional<boost::filesystem::path>& pythonScriptFile,
     const boost::optional<boost::filesystem::path>& dataDirectory,
     const boost::optional<std::string>& networkToImport,
+    const boost::optional<boost::filesystem::path>& batchParameterFile,
+    const boost::optional<unsigned int>& batchInstances,
     DeveloperParametersPtr devParams,
     const Flags& flags
    ) : entireCommandLine_(entireCommandLine),
     inputFiles_(inputFiles), pythonScriptFile_(pythonScriptFile), dataDirectory_(dataDirectory),
-    networkToImport_(networkToImport),
+    networkToImport_(networkToImport), batchParameterFile_(batchParameterFile), batchInstances_(batchInstances),
     devParams_(devParams),
     flags_(flags)
   {}
@@ -221,6 +263,16 @@ public:
     return networkToImport_;
   }
 
+  boost::optional<boost::filesystem::path> batchParameterFile() const override
+  {
+    return batchParameterFile_;
+  }
+
+  boost::optional<unsigned int> batchInstances() const override
+  {
+    return batchInstances_;
+  }
+
   bool help() const override
   {
     return flags_.help_;
@@ -302,6 +354,8 @@ private:
   boost::optional<boost::filesystem::path> pythonScriptFile_;
   boost::optional<boost::filesystem::path> dataDirectory_;
   boost::optional<std::string> networkToImport_;
+  boost::optional<boost::filesystem::path> batchParameterFile_;
+  boost::optional<unsigned int> batchInstances_;
   DeveloperParametersPtr devParams_;
   Flags flags_;
 };
@@ -352,6 +406,11 @@ ApplicationParametersHandle CommandLineParser::parse(int argc, const char* argv[
     {
       importNetworkFile = parsed["import"].as<std::string>();
     }
+    auto batchParameterFile = boost::optional<boost::filesystem::path>();
+    if (parsed.count("batch") != 0 && !parsed["batch"].empty() && !parsed["batch"].defaulted())
+    {
+      batchParameterFile = boost::filesystem::path(parsed["batch"].as<std::string>());
+    }
 
     return boost::make_shared<ApplicationParametersImpl>
       (boost::algorithm::join(cmdline, " "),
@@ -359,12 +418,20 @@ ApplicationParametersHandle CommandLineParser::parse(int argc, const char* argv[
       pythonScriptFile,
       dataDirectory,
       importNetworkFile,
+      batchParameterFile,
+      parseOptionalArg<unsigned int>(parsed, "batch-instances"),
       boost::make_shared<DeveloperParametersImpl>(
         parseOptionalArg<std::string>(parsed, "threadMode"),
         parseOptionalArg<std::string>(parsed, "reexecuteMode"),
         parseOptionalArg<int>(parsed, "frameInitLimit"),
         parseOptionalArg<int>(parsed, "regression"),
         parseOptionalArg<unsigned int>(parsed, "max-cores"),
+        parseOptionalArg<unsigned int>(parsed, "max-modules"),
+        parseOptionalArg<unsigned int>(parsed, "memoize-outputs"),
+        parseOptionalArg<std::string>(parsed, "memoize-spill-dir"),
+        parseOptionalArg<unsigned int>(parsed, "port-cache"),
+        parseOptionalArg<std::string>(parsed, "port-spill-dir"),
+        parseOptionalArg<std::string>(parsed, "profile"),
         parseOptionalArg<double>(parsed, "guiExpandFactor")
       ),
       ApplicationParametersImpl::Flags(
@@ -51,6 +51,8 @@ namespace SCIRun {
         virtual boost::optional<boost::filesystem::path> pythonScriptFile() const = 0;
         virtual boost::optional<boost::filesystem::path> dataDirectory() const = 0;
         virtual boost::optional<std::string> importNetworkFile() const = 0;
+        virtual boost::optional<boost::filesystem::path> batchParameterFile() const = 0;
+        virtual boost::optional<unsigned int> batchInstances() const = 0;
         virtual bool help() const = 0;
         virtual bool version() const = 0;
         virtual bool executeNetwork() const = 0;
@@ -77,6 +79,12 @@ namespace SCIRun {
         virtual boost::optional<std::string> reexecuteMode() const = 0;
         virtual boost::optional<int> frameInitLimit() const = 0;
         virtual boost::optional<unsigned int> maxCores() const = 0;
+        virtual boost::optional<unsigned int> maxModules() const = 0;
+        virtual boost::optional<unsigned int> memoizeOutputsMegabytes() const = 0;
+        virtual boost::optional<std::string> memoizeSpillDirectory() const = 0;
+        virtual boost::optional<unsigned int> portCacheMegabytes() const = 0;
+        virtual boost::optional<std::string> portSpillDirectory() const = 0;
+        virtual boost::optional<std::string> profileTraceFile() const = 0;
         virtual boost::optional<double> guiExpandFactor() const = 0;
       };
 
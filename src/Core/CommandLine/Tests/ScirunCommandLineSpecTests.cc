@@ -54,11 +54,21 @@ TEST(ScirunCommandLineSpecTest, CanReadBasicOptions)
     "  -S [ --Script ] arg     Python script--interpret and quit after one SCIRun \n"
     "                          execution pass\n"
     "  --import arg            Import a network from SCIRun 4.7\n"
+    "  --batch arg             Execute the network once per parameter set in file \n"
+    "                          arg, then quit\n"
+    "  --batch-instances arg   Number of network instances executing batch parameter\n"
+    "                          sets at once\n"
     "  -0 [ --no_splash ]      Turn off splash screen\n"
     "  --verbose               Turn on debug log information\n"
     "  --guiExpandFactor arg   Expansion factor for high resolution displays\n"
     "  --max-cores arg         Limit the number of cores used by multithreaded \n"
     "                          algorithms\n"
+    "  --max-modules arg       Limit the number of modules executing at once\n"
+    "  --memoize-outputs arg   Reuse module outputs, caching up to arg megabytes\n"
+    "  --memoize-spill-dir arg Directory for memoized outputs evicted from memory\n"
+    "  --port-cache arg        Limit cached port data to arg megabytes\n"
+    "  --port-spill-dir arg    Directory for port data evicted from memory\n"
+    "  --profile arg           Profile network executions into Chrome trace file arg\n"
     "  --list-modules          print list of available modules\n";
 
   EXPECT_EQ(expectedHelp, parser.describe());
@@ -160,6 +170,52 @@ TEST(ScirunCommandLineSpecTest, CanReadBasicOptions)
   //   EXPECT_EQ("serial", *aph->developerParameters()->threadMode());
   // }
 
+  {
+    const char* argv[] = { "scirun.exe", "--max-modules", "3" };
+    int argc = sizeof(argv) / sizeof(char*);
+
+    auto aph = parser.parse(argc, argv);
+
+    ASSERT_TRUE(!!aph->developerParameters()->maxModules());
+    EXPECT_EQ(3, *aph->developerParameters()->maxModules());
+    EXPECT_FALSE(aph->developerParameters()->maxCores());
+  }
+
+  {
+    const char* argv[] = { "scirun.exe", "--memoize-outputs", "256", "--memoize-spill-dir", "/tmp/memo" };
+    int argc = sizeof(argv) / sizeof(char*);
+
+    auto aph = parser.parse(argc, argv);
+
+    ASSERT_TRUE(!!aph->developerParameters()->memoizeOutputsMegabytes());
+    EXPECT_EQ(256, *aph->developerParameters()->memoizeOutputsMegabytes());
+    ASSERT_TRUE(!!aph->developerParameters()->memoizeSpillDirectory());
+    EXPECT_EQ("/tmp/memo", *aph->developerParameters()->memoizeSpillDirectory());
+  }
+
+  {
+    const char* argv[] = { "scirun.exe", "--port-cache", "2048", "--port-spill-dir", "/tmp/ports" };
+    int argc = sizeof(argv) / sizeof(char*);
+
+    auto aph = parser.parse(argc, argv);
+
+    ASSERT_TRUE(!!aph->developerParameters()->portCacheMegabytes());
+    EXPECT_EQ(2048, *aph->developerParameters()->portCacheMegabytes());
+    ASSERT_TRUE(!!aph->developerParameters()->portSpillDirectory());
+    EXPECT_EQ("/tmp/ports", *aph->developerParameters()->portSpillDirectory());
+    EXPECT_FALSE(aph->developerParameters()->profileTraceFile());
+  }
+
+  {
+    const char* argv[] = { "scirun.exe", "--profile", "/tmp/trace.json" };
+    int argc = sizeof(argv) / sizeof(char*);
+
+    auto aph = parser.parse(argc, argv);
+
+    ASSERT_TRUE(!!aph->developerParameters()->profileTraceFile());
+    EXPECT_EQ("/tmp/trace.json", *aph->developerParameters()->profileTraceFile());
+  }
+
   {
     const char* argv[] = { "scirun.exe", "-1" };
     int argc = sizeof(argv) / sizeof(char*);
@@ -198,5 +254,19 @@ TEST(ScirunCommandLineSpecTest, CanReadBasicOptions)
 
     EXPECT_TRUE(!!aph->importNetworkFile());
     EXPECT_EQ("oldnetwork.srn", *aph->importNetworkFile());
+    EXPECT_FALSE(aph->batchParameterFile());
+  }
+
+  {
+    const char* argv[] = { "scirun.exe", "-x", "--batch", "sweep.txt", "--batch-instances", "4", "net.srn5" };
+    int argc = sizeof(argv) / sizeof(char*);
+
+    auto aph = parser.parse(argc, argv);
+
+    ASSERT_TRUE(!!aph->batchParameterFile());
+    EXPECT_EQ("sweep.txt", aph->batchParameterFile()->string());
+    ASSERT_TRUE(!!aph->batchInstances());
+    EXPECT_EQ(4, *aph->batchInstances());
+    EXPECT_EQ("net.srn5", aph->inputFiles()[0]);
   }
 }
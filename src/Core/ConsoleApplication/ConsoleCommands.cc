@@ -29,6 +29,7 @@
 #include <Core/ConsoleApplication/ConsoleCommands.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Dataflow/Engine/Controller/NetworkEditorController.h>
+#include <Dataflow/Engine/Controller/ParameterSweep.h>
 #include <Core/Application/Application.h>
 #include <Dataflow/Serialization/Network/XMLSerializer.h>
 #include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
@@ -121,6 +122,63 @@ bool ExecuteCurrentNetworkCommandConsole::execute()
   return interactive.execute();
 }
 
+bool RunParameterSweepCommandConsole::execute()
+{
+  quietModulesIfNotVerbose();
+
+  auto& app = Application::Instance();
+  auto inputFiles = app.parameters()->inputFiles();
+  auto sweepFile = app.parameters()->batchParameterFile();
+  if (inputFiles.empty() || !sweepFile)
+  {
+    LOG_CONSOLE("Batch mode needs a network file and a parameter sweep file");
+    exit(1);
+  }
+
+  try
+  {
+    auto sweep = Dataflow::Engine::ParameterSweep::load(*sweepFile);
+    auto openedFile = XMLSerializer::load_xml<NetworkFile>(inputFiles[0]);
+    if (!openedFile)
+    {
+      LOG_CONSOLE("File load failed: " << inputFiles[0]);
+      exit(1);
+    }
+
+    // the xml is parsed once; every instance beyond the first is built from the same description
+    auto instanceCount = std::max(1u, app.parameters()->batchInstances().get_value_or(1));
+    instanceCount = std::min(instanceCount, static_cast<unsigned int>(std::max<size_t>(1, sweep.runs().size())));
+    app.controller()->clear();
+    app.controller()->loadNetwork(openedFile);
+    std::vector<boost::shared_ptr<Dataflow::Engine::NetworkEditorController>> copies;
+    std::vector<NetworkHandle> instances { app.controller()->getNetwork() };
+    for (unsigned int i = 1; i < instanceCount; ++i)
+    {
+      copies.push_back(app.controller()->createNetworkInstance(openedFile));
+      instances.push_back(copies.back()->getNetwork());
+    }
+    LOG_CONSOLE("Running " << sweep.runs().size() << " parameter sets on " << instanceCount << " network instance(s)");
+
+    Dataflow::Engine::ParameterSweepRunner runner(instances);
+    auto results = runner.run(sweep, [](const Dataflow::Engine::SweepRunResult& r)
+    {
+      LOG_CONSOLE("Run " << r.run << (r.succeeded ? " finished" : " FAILED") << " on instance " << r.instance << " in " << r.seconds << " s");
+    });
+
+    auto failed = std::count_if(results.begin(), results.end(), [](const Dataflow::Engine::SweepRunResult& r) { return !r.succeeded; });
+    LOG_CONSOLE("Batch done: " << results.size() - failed << " of " << results.size() << " runs succeeded");
+    if (0 == failed)
+      return true;
+  }
+  catch (std::exception& e)
+  {
+    LOG_CONSOLE("Batch run failed: " << e.what());
+  }
+  LOG_CONSOLE("Goodbye! Exit code: 1");
+  exit(1);
+  return false;
+}
+
 QuitAfterExecuteCommandConsole::QuitAfterExecuteCommandConsole()
 {
   addParameter(Name("RunningPython"), false);
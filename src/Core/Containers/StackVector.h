@@ -43,6 +43,8 @@
 #define SCI_Containers_StackVector_h 1
 
 #include <boost/array.hpp>
+#include <cassert>
+#include <stdexcept>
 
 namespace SCIRun {
 
@@ -60,11 +62,23 @@ public:
   }
   void resize(size_t size, const value_type& val = value_type())
   {
+    assert(size <= CAPACITY);
+    if (size > CAPACITY)
+      throw std::length_error("StackVector capacity exceeded");
     size_ = size;
     //not sure what to do here. semantics is different, but SCIRun 4 probably overruns buffers all the time anyway...
   }
-  void clear() {}
+  void clear() { size_ = 0; }
+  void reserve(size_t) {}
+  void push_back(const value_type& v)
+  {
+    assert(size_ < CAPACITY);
+    if (size_ >= CAPACITY)
+      throw std::length_error("StackVector capacity exceeded");
+    (*this)[size_++] = v;
+  }
   size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
 private:
   size_t size_;
 };
@@ -0,0 +1,871 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#ifndef CORE_DATATYPES_BOUNDINGVOLUMEHIERARCHY_H
+#define CORE_DATATYPES_BOUNDINGVOLUMEHIERARCHY_H 1
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <boost/unordered_set.hpp>
+#include <Core/GeometryPrimitives/BBox.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/Transform.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Thread/Parallel.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SCIRUN_BVH_SSE 1
+#endif
+
+namespace SCIRun {
+
+/// Bounding volume hierarchy over element bounding boxes, an alternative to a
+/// uniform SearchGridT for locating elements in strongly graded meshes. The
+/// tree is built top down with a binned surface area heuristic, splitting all
+/// nodes of one level in parallel, and is then collapsed into a 4-wide tree
+/// whose child boxes are tested four at a time. Boxes are stored in single
+/// precision rounded outward, so a box never loses a point its double
+/// precision box contains.
+///
+/// Primitives inserted after the build are kept in a list that is scanned
+/// linearly, and removed ones are skipped; rebuild after large edits.
+///
+/// Only TetVolMesh builds one, on synchronize(ELEM_LOCATE_BVH_E). The other
+/// unstructured meshes ignore that flag and always locate through their
+/// SearchGridT.
+class BoundingVolumeHierarchy
+{
+public:
+  BoundingVolumeHierarchy() : slack_(0.0f) {}
+
+  /// box(i, b) extends the empty box b by the bounding box of primitive i, for
+  /// i in [0, numPrims); primitives whose box stays invalid are left out.
+  /// Every box is padded by padding on each side.
+  template <class BoxFunction>
+  void build(size_type numPrims, const BoxFunction& box, double padding);
+
+  void clear();
+  bool empty() const { return nodes_.empty() && extra_.empty(); }
+  size_t num_nodes() const { return nodes_.size(); }
+
+  /// Calls visit(i) for the primitives whose box contains p until one returns
+  /// true; returns whether one did.
+  template <class Visitor>
+  bool locate(const Core::Geometry::Point& p, const Visitor& visit) const;
+
+  /// Calls visit(i) for every primitive whose box overlaps b.
+  template <class Visitor>
+  void overlap(const Core::Geometry::BBox& b, const Visitor& visit) const;
+
+  /// Calls visit(i, dmin2) for the primitives whose box lies within
+  /// sqrt(dmin2) of p, nearest boxes first. visit lowers dmin2 (a squared
+  /// distance) when it finds something closer, which prunes the rest of the
+  /// search; returning true stops it.
+  template <class Visitor>
+  void closest(const Core::Geometry::Point& p, double& dmin2, const Visitor& visit) const;
+
+  void insert(index_type prim, const Core::Geometry::BBox& box);
+  void remove(index_type prim);
+  /// Replaces every box by the bounding box of its eight transformed corners.
+  void transform(const Core::Geometry::Transform& t);
+
+private:
+  struct Box
+  {
+    float lo[3];
+    float hi[3];
+  };
+
+  /// Four child boxes in structure of arrays layout. A lane with count 0 is an
+  /// inner node, one with count > 0 the primitives prims_[child, child + count).
+  struct Node
+  {
+    float lo[3][4];
+    float hi[3][4];
+    uint32_t child[4];
+    uint32_t count[4];
+  };
+
+  /// Node of the binary tree built before collapsing; left is 0 for a leaf,
+  /// otherwise the children are left and left + 1.
+  struct BuildNode
+  {
+    Box bounds;
+    uint32_t begin;
+    uint32_t end;
+    uint32_t left;
+    int depth;
+  };
+
+  struct Split
+  {
+    bool split;
+    uint32_t mid;
+    Box left;
+    Box right;
+  };
+
+  static const int NumBins = 16;
+  static const uint32_t MaxLeafSize = 8;
+  static const int MaxSAHDepth = 48;
+  static const int MaxStackSize = 256;
+  static const uint32_t EmptyLane = 0xffffffff;
+
+  static float round_down(double v)
+  {
+    const float f = static_cast<float>(v);
+    return (f > v) ? std::nextafter(f, -FLT_MAX) : f;
+  }
+
+  static float round_up(double v)
+  {
+    const float f = static_cast<float>(v);
+    return (f < v) ? std::nextafter(f, FLT_MAX) : f;
+  }
+
+  static Box empty_box()
+  {
+    Box b;
+    for (int d = 0; d < 3; ++d) { b.lo[d] = FLT_MAX; b.hi[d] = -FLT_MAX; }
+    return b;
+  }
+
+  static void grow(Box& b, const Box& o)
+  {
+    for (int d = 0; d < 3; ++d)
+    {
+      b.lo[d] = std::min(b.lo[d], o.lo[d]);
+      b.hi[d] = std::max(b.hi[d], o.hi[d]);
+    }
+  }
+
+  static double half_area(const Box& b)
+  {
+    if (b.lo[0] > b.hi[0]) return 0.0;
+    const double dx = b.hi[0] - b.lo[0], dy = b.hi[1] - b.lo[1], dz = b.hi[2] - b.lo[2];
+    return dx * dy + dy * dz + dz * dx;
+  }
+
+  static bool contains(const Box& b, const float* q)
+  {
+    return b.lo[0] <= q[0] && q[0] <= b.hi[0] && b.lo[1] <= q[1] && q[1] <= b.hi[1] &&
+      b.lo[2] <= q[2] && q[2] <= b.hi[2];
+  }
+
+  static bool overlaps(const Box& b, const Box& q)
+  {
+    return b.lo[0] <= q.hi[0] && q.lo[0] <= b.hi[0] && b.lo[1] <= q.hi[1] && q.lo[1] <= b.hi[1] &&
+      b.lo[2] <= q.hi[2] && q.lo[2] <= b.hi[2];
+  }
+
+  static double distance(const Box& b, const float* q)
+  {
+    double d2 = 0.0;
+    for (int d = 0; d < 3; ++d)
+    {
+      const double v = std::max(std::max<double>(b.lo[d] - q[d], q[d] - b.hi[d]), 0.0);
+      d2 += v * v;
+    }
+    return std::sqrt(d2);
+  }
+
+  static Box to_box(const Core::Geometry::BBox& b)
+  {
+    Box r;
+    const Core::Geometry::Point& lo = b.get_min();
+    const Core::Geometry::Point& hi = b.get_max();
+    for (int d = 0; d < 3; ++d) { r.lo[d] = round_down(lo[d]); r.hi[d] = round_up(hi[d]); }
+    return r;
+  }
+
+  static Box transformed(const Box& b, const Core::Geometry::Transform& t)
+  {
+    Box r = empty_box();
+    for (int c = 0; c < 8; ++c)
+    {
+      const Core::Geometry::Point p = t.project(Core::Geometry::Point(
+        (c & 1) ? b.hi[0] : b.lo[0], (c & 2) ? b.hi[1] : b.lo[1], (c & 4) ? b.hi[2] : b.lo[2]));
+      for (int d = 0; d < 3; ++d)
+      {
+        r.lo[d] = std::min(r.lo[d], round_down(p[d]));
+        r.hi[d] = std::max(r.hi[d], round_up(p[d]));
+      }
+    }
+    return r;
+  }
+
+  /// Bit k is set when lane k of n contains q.
+  static int contains_mask(const Node& n, const float* q)
+  {
+#ifdef SCIRUN_BVH_SSE
+    __m128 in = _mm_set1_ps(0.0f);
+    in = _mm_cmpeq_ps(in, in);
+    for (int d = 0; d < 3; ++d)
+    {
+      const __m128 x = _mm_set1_ps(q[d]);
+      in = _mm_and_ps(in, _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(n.lo[d]), x),
+        _mm_cmple_ps(x, _mm_loadu_ps(n.hi[d]))));
+    }
+    return _mm_movemask_ps(in);
+#else
+    int mask = 0;
+    for (int k = 0; k < 4; ++k)
+      if (n.lo[0][k] <= q[0] && q[0] <= n.hi[0][k] && n.lo[1][k] <= q[1] && q[1] <= n.hi[1][k] &&
+          n.lo[2][k] <= q[2] && q[2] <= n.hi[2][k])
+        mask |= 1 << k;
+    return mask;
+#endif
+  }
+
+  /// Bit k is set when lane k of n overlaps q.
+  static int overlap_mask(const Node& n, const Box& q)
+  {
+#ifdef SCIRUN_BVH_SSE
+    __m128 in = _mm_set1_ps(0.0f);
+    in = _mm_cmpeq_ps(in, in);
+    for (int d = 0; d < 3; ++d)
+    {
+      in = _mm_and_ps(in, _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(n.lo[d]), _mm_set1_ps(q.hi[d])),
+        _mm_cmple_ps(_mm_set1_ps(q.lo[d]), _mm_loadu_ps(n.hi[d]))));
+    }
+    return _mm_movemask_ps(in);
+#else
+    int mask = 0;
+    for (int k = 0; k < 4; ++k)
+      if (n.lo[0][k] <= q.hi[0] && q.lo[0] <= n.hi[0][k] && n.lo[1][k] <= q.hi[1] &&
+          q.lo[1] <= n.hi[1][k] && n.lo[2][k] <= q.hi[2] && q.lo[2] <= n.hi[2][k])
+        mask |= 1 << k;
+    return mask;
+#endif
+  }
+
+  /// Distance from q to each lane box of n.
+  static void distances(const Node& n, const float* q, float* dist)
+  {
+#ifdef SCIRUN_BVH_SSE
+    const __m128 zero = _mm_setzero_ps();
+    __m128 d2 = zero;
+    for (int d = 0; d < 3; ++d)
+    {
+      const __m128 x = _mm_set1_ps(q[d]);
+      const __m128 v = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(n.lo[d]), x),
+        _mm_sub_ps(x, _mm_loadu_ps(n.hi[d]))), zero);
+      d2 = _mm_add_ps(d2, _mm_mul_ps(v, v));
+    }
+    _mm_storeu_ps(dist, _mm_sqrt_ps(d2));
+#else
+    for (int k = 0; k < 4; ++k)
+    {
+      float d2 = 0.0f;
+      for (int d = 0; d < 3; ++d)
+      {
+        const float v = std::max(std::max(n.lo[d][k] - q[d], q[d] - n.hi[d][k]), 0.0f);
+        d2 += v * v;
+      }
+      dist[k] = std::sqrt(d2);
+    }
+#endif
+  }
+
+  bool skip(index_type prim) const
+  {
+    return !removed_.empty() && removed_.count(prim) > 0;
+  }
+
+  /// Runs task over chunks [0, numChunks), in parallel when there are several.
+  template <class Task>
+  static void for_chunks(size_t numChunks, const Task& task)
+  {
+    if (numChunks == 1)
+      task(0, 1);
+    else
+      Core::Thread::Parallel::For(0, numChunks, task, 1);
+  }
+
+  void split(BuildNode& node, Split& result);
+  void median_split(BuildNode& node, Split& result);
+  void set_lane(Node& n, int k, const Box& b, uint32_t child, uint32_t count);
+
+  std::vector<Node> nodes_;
+  std::vector<index_type> prims_;
+  /// Box of each primitive, in the order of prims_.
+  std::vector<Box> boxes_;
+  /// Primitives inserted after the build.
+  std::vector<std::pair<index_type, Box> > extra_;
+  /// Primitives in the tree that have been removed.
+  boost::unordered_set<index_type> removed_;
+  /// Error bound of the single precision box distances.
+  float slack_;
+};
+
+
+template <class BoxFunction>
+void
+BoundingVolumeHierarchy::build(size_type numPrims, const BoxFunction& box, double padding)
+{
+  clear();
+
+  std::vector<Box> boxes(numPrims);
+  std::vector<char> valid(numPrims);
+  Core::Thread::Parallel::For(0, numPrims, [&](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      Core::Geometry::BBox b;
+      box(static_cast<index_type>(i), b);
+      valid[i] = b.valid();
+      if (valid[i])
+      {
+        b.extend(padding);
+        boxes[i] = to_box(b);
+      }
+    }
+  });
+
+  // The boxes move along with prims_ while splitting, so nodes scan them in order
+  Box bounds = empty_box();
+  prims_.reserve(numPrims);
+  boxes_.reserve(numPrims);
+  for (index_type i = 0; i < numPrims; ++i)
+  {
+    if (!valid[i]) continue;
+    prims_.push_back(i);
+    boxes_.push_back(boxes[i]);
+    grow(bounds, boxes[i]);
+  }
+  std::vector<Box>().swap(boxes);
+  if (prims_.empty()) return;
+
+  float extent = 0.0f;
+  for (int d = 0; d < 3; ++d)
+    extent = std::max(extent, std::max(std::fabs(bounds.lo[d]), std::fabs(bounds.hi[d])));
+  slack_ = 8.0f * FLT_EPSILON * extent;
+
+  // Binary tree, one level at a time; the nodes of a level own disjoint ranges
+  // of prims_, so they are split in parallel.
+  std::vector<BuildNode> tree(1);
+  tree[0].bounds = bounds;
+  tree[0].begin = 0;
+  tree[0].end = static_cast<uint32_t>(prims_.size());
+  tree[0].left = 0;
+  tree[0].depth = 0;
+
+  std::vector<uint32_t> level(1, 0);
+  std::vector<Split> splits;
+  while (!level.empty())
+  {
+    splits.resize(level.size());
+    Core::Thread::Parallel::For(0, level.size(), [&](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+        split(tree[level[i]], splits[i]);
+    }, 1);
+
+    std::vector<uint32_t> next;
+    for (size_t i = 0; i < level.size(); ++i)
+    {
+      if (!splits[i].split) continue;
+      const uint32_t left = static_cast<uint32_t>(tree.size());
+      BuildNode l, r;
+      l.bounds = splits[i].left;
+      l.begin = tree[level[i]].begin;
+      l.end = splits[i].mid;
+      r.bounds = splits[i].right;
+      r.begin = splits[i].mid;
+      r.end = tree[level[i]].end;
+      l.left = r.left = 0;
+      l.depth = r.depth = tree[level[i]].depth + 1;
+      tree[level[i]].left = left;
+      tree.push_back(l);
+      tree.push_back(r);
+      next.push_back(left);
+      next.push_back(left + 1);
+    }
+    level.swap(next);
+  }
+
+  // Collapse into the 4-wide tree: every node takes the children of its
+  // largest inner children until it has four.
+  nodes_.resize(1);
+  std::vector<std::pair<uint32_t, uint32_t> > stack(1, std::make_pair(0u, 0u));
+  while (!stack.empty())
+  {
+    const uint32_t b = stack.back().first;
+    const uint32_t ni = stack.back().second;
+    stack.pop_back();
+
+    uint32_t lanes[4];
+    int numLanes = 0;
+    if (tree[b].left == 0)
+      lanes[numLanes++] = b;
+    else
+    {
+      lanes[numLanes++] = tree[b].left;
+      lanes[numLanes++] = tree[b].left + 1;
+    }
+    while (numLanes < 4)
+    {
+      int widest = -1;
+      double widestArea = -1.0;
+      for (int k = 0; k < numLanes; ++k)
+      {
+        if (tree[lanes[k]].left == 0) continue;
+        const double area = half_area(tree[lanes[k]].bounds);
+        if (area > widestArea) { widest = k; widestArea = area; }
+      }
+      if (widest < 0) break;
+      const uint32_t left = tree[lanes[widest]].left;
+      lanes[widest] = left;
+      lanes[numLanes++] = left + 1;
+    }
+
+    for (int k = 0; k < 4; ++k)
+    {
+      if (k >= numLanes)
+      {
+        set_lane(nodes_[ni], k, empty_box(), EmptyLane, 0);
+      }
+      else if (tree[lanes[k]].left == 0)
+      {
+        const BuildNode& leaf = tree[lanes[k]];
+        set_lane(nodes_[ni], k, leaf.bounds, leaf.begin, leaf.end - leaf.begin);
+      }
+      else
+      {
+        const uint32_t child = static_cast<uint32_t>(nodes_.size());
+        nodes_.push_back(Node());
+        set_lane(nodes_[ni], k, tree[lanes[k]].bounds, child, 0);
+        stack.push_back(std::make_pair(lanes[k], child));
+      }
+    }
+  }
+}
+
+inline void
+BoundingVolumeHierarchy::split(BuildNode& node, Split& result)
+{
+  result.split = false;
+  const uint32_t count = node.end - node.begin;
+  if (count <= 1) return;
+  if (node.depth >= MaxSAHDepth)
+  {
+    if (count > MaxLeafSize) median_split(node, result);
+    return;
+  }
+
+  // Bounds of the box centers, and the box centers binned along each axis;
+  // large nodes are binned in parallel chunks.
+  struct Bins
+  {
+    Box bounds[3][NumBins];
+    uint32_t counts[3][NumBins];
+  };
+
+  const size_t grain = 1 << 14;
+  const size_t numChunks = (count + grain - 1) / grain;
+  auto chunkRange = [&](size_t c, uint32_t& begin, uint32_t& end)
+  {
+    begin = node.begin + static_cast<uint32_t>(c * grain);
+    end = std::min(node.end, static_cast<uint32_t>(begin + grain));
+  };
+
+  Box oneCenterBounds;
+  std::vector<Box> manyCenterBounds(numChunks > 1 ? numChunks : 0);
+  Box* centerBounds = (numChunks > 1) ? &manyCenterBounds[0] : &oneCenterBounds;
+  for_chunks(numChunks, [&](size_t cb, size_t ce)
+  {
+    for (size_t c = cb; c < ce; ++c)
+    {
+      centerBounds[c] = empty_box();
+      uint32_t begin, end;
+      chunkRange(c, begin, end);
+      for (uint32_t i = begin; i < end; ++i)
+      {
+        const Box& b = boxes_[i];
+        for (int d = 0; d < 3; ++d)
+        {
+          const float center = 0.5f * (b.lo[d] + b.hi[d]);
+          centerBounds[c].lo[d] = std::min(centerBounds[c].lo[d], center);
+          centerBounds[c].hi[d] = std::max(centerBounds[c].hi[d], center);
+        }
+      }
+    }
+  });
+  Box centers = empty_box();
+  for (size_t c = 0; c < numChunks; ++c)
+    grow(centers, centerBounds[c]);
+
+  // Small nodes get fewer bins, clearing and sweeping them dominates otherwise
+  const int numBins = static_cast<int>(std::min<uint32_t>(NumBins, std::max<uint32_t>(4, count)));
+  float scale[3];
+  bool flat = true;
+  for (int d = 0; d < 3; ++d)
+  {
+    const float extent = centers.hi[d] - centers.lo[d];
+    scale[d] = (extent > 0.0f) ? numBins / extent : 0.0f;
+    if (extent > 0.0f) flat = false;
+  }
+  if (flat)
+  {
+    // All centers coincide, no plane separates them
+    if (count > MaxLeafSize) median_split(node, result);
+    return;
+  }
+
+  auto binOf = [&](const Box& b, int d)
+  {
+    const float center = 0.5f * (b.lo[d] + b.hi[d]);
+    return std::min(numBins - 1, static_cast<int>((center - centers.lo[d]) * scale[d]));
+  };
+
+  Bins oneBins;
+  std::vector<Bins> manyBins(numChunks > 1 ? numChunks : 0);
+  Bins* chunkBins = (numChunks > 1) ? &manyBins[0] : &oneBins;
+  for_chunks(numChunks, [&](size_t cb, size_t ce)
+  {
+    for (size_t c = cb; c < ce; ++c)
+    {
+      Bins& bins = chunkBins[c];
+      for (int d = 0; d < 3; ++d)
+        for (int k = 0; k < numBins; ++k)
+        {
+          bins.bounds[d][k] = empty_box();
+          bins.counts[d][k] = 0;
+        }
+      uint32_t begin, end;
+      chunkRange(c, begin, end);
+      for (uint32_t i = begin; i < end; ++i)
+      {
+        const Box& b = boxes_[i];
+        for (int d = 0; d < 3; ++d)
+        {
+          if (scale[d] == 0.0f) continue;
+          const int k = binOf(b, d);
+          grow(bins.bounds[d][k], b);
+          ++bins.counts[d][k];
+        }
+      }
+    }
+  });
+  Bins& bins = chunkBins[0];
+  for (size_t c = 1; c < numChunks; ++c)
+    for (int d = 0; d < 3; ++d)
+      for (int k = 0; k < numBins; ++k)
+      {
+        grow(bins.bounds[d][k], chunkBins[c].bounds[d][k]);
+        bins.counts[d][k] += chunkBins[c].counts[d][k];
+      }
+
+  // Sweep the planes between bins; the cost of a split is the expected number
+  // of primitive tests relative to the node, plus one for the node itself.
+  int bestAxis = -1, bestPlane = 0;
+  double bestCost = static_cast<double>(count);
+  Box bestLeft = empty_box(), bestRight = empty_box();
+  const double area = half_area(node.bounds);
+  for (int d = 0; d < 3; ++d)
+  {
+    if (scale[d] == 0.0f) continue;
+    Box rightBounds[NumBins];
+    uint32_t rightCounts[NumBins];
+    Box acc = empty_box();
+    uint32_t n = 0;
+    for (int k = numBins - 1; k > 0; --k)
+    {
+      grow(acc, bins.bounds[d][k]);
+      n += bins.counts[d][k];
+      rightBounds[k] = acc;
+      rightCounts[k] = n;
+    }
+    acc = empty_box();
+    n = 0;
+    for (int k = 1; k < numBins; ++k)
+    {
+      grow(acc, bins.bounds[d][k - 1]);
+      n += bins.counts[d][k - 1];
+      if (n == 0 || rightCounts[k] == 0) continue;
+      const double cost = 1.0 + (area > 0.0 ?
+        (half_area(acc) * n + half_area(rightBounds[k]) * rightCounts[k]) / area : 0.5 * count);
+      if (cost < bestCost)
+      {
+        bestCost = cost;
+        bestAxis = d;
+        bestPlane = k;
+        bestLeft = acc;
+        bestRight = rightBounds[k];
+      }
+    }
+  }
+
+  if (bestAxis < 0)
+  {
+    if (count > MaxLeafSize) median_split(node, result);
+    return;
+  }
+
+  uint32_t mid = node.begin;
+  for (uint32_t i = node.begin; i < node.end; ++i)
+  {
+    if (binOf(boxes_[i], bestAxis) < bestPlane)
+    {
+      std::swap(prims_[i], prims_[mid]);
+      std::swap(boxes_[i], boxes_[mid]);
+      ++mid;
+    }
+  }
+  result.split = true;
+  result.mid = mid;
+  result.left = bestLeft;
+  result.right = bestRight;
+}
+
+inline void
+BoundingVolumeHierarchy::median_split(BuildNode& node, Split& result)
+{
+  int axis = 0;
+  for (int d = 1; d < 3; ++d)
+    if (node.bounds.hi[d] - node.bounds.lo[d] > node.bounds.hi[axis] - node.bounds.lo[axis])
+      axis = d;
+
+  const uint32_t count = node.end - node.begin;
+  std::vector<uint32_t> order(count);
+  for (uint32_t i = 0; i < count; ++i) order[i] = node.begin + i;
+  const uint32_t half = count / 2;
+  std::nth_element(order.begin(), order.begin() + half, order.end(), [&](uint32_t a, uint32_t b)
+  {
+    return boxes_[a].lo[axis] + boxes_[a].hi[axis] < boxes_[b].lo[axis] + boxes_[b].hi[axis];
+  });
+
+  std::vector<index_type> prims(count);
+  std::vector<Box> boxes(count);
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    prims[i] = prims_[order[i]];
+    boxes[i] = boxes_[order[i]];
+  }
+  std::copy(prims.begin(), prims.end(), prims_.begin() + node.begin);
+  std::copy(boxes.begin(), boxes.end(), boxes_.begin() + node.begin);
+
+  result.split = true;
+  result.mid = node.begin + half;
+  result.left = empty_box();
+  result.right = empty_box();
+  for (uint32_t i = node.begin; i < result.mid; ++i) grow(result.left, boxes_[i]);
+  for (uint32_t i = result.mid; i < node.end; ++i) grow(result.right, boxes_[i]);
+}
+
+inline void
+BoundingVolumeHierarchy::set_lane(Node& n, int k, const Box& b, uint32_t child, uint32_t count)
+{
+  for (int d = 0; d < 3; ++d)
+  {
+    n.lo[d][k] = b.lo[d];
+    n.hi[d][k] = b.hi[d];
+  }
+  n.child[k] = child;
+  n.count[k] = count;
+}
+
+inline void
+BoundingVolumeHierarchy::clear()
+{
+  nodes_.clear();
+  prims_.clear();
+  boxes_.clear();
+  extra_.clear();
+  removed_.clear();
+  slack_ = 0.0f;
+}
+
+template <class Visitor>
+bool
+BoundingVolumeHierarchy::locate(const Core::Geometry::Point& p, const Visitor& visit) const
+{
+  const float q[3] = { static_cast<float>(p.x()), static_cast<float>(p.y()), static_cast<float>(p.z()) };
+  if (!nodes_.empty())
+  {
+    uint32_t stack[MaxStackSize];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+      const Node& n = nodes_[stack[--top]];
+      const int mask = contains_mask(n, q);
+      for (int k = 0; k < 4; ++k)
+      {
+        if (!(mask & (1 << k))) continue;
+        if (n.count[k] == 0)
+        {
+          stack[top++] = n.child[k];
+          continue;
+        }
+        for (uint32_t i = n.child[k]; i < n.child[k] + n.count[k]; ++i)
+          if (contains(boxes_[i], q) && !skip(prims_[i]) && visit(prims_[i])) return (true);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < extra_.size(); ++i)
+    if (contains(extra_[i].second, q) && visit(extra_[i].first)) return (true);
+  return (false);
+}
+
+template <class Visitor>
+void
+BoundingVolumeHierarchy::overlap(const Core::Geometry::BBox& b, const Visitor& visit) const
+{
+  if (!b.valid()) return;
+  const Box q = to_box(b);
+  if (!nodes_.empty())
+  {
+    uint32_t stack[MaxStackSize];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+      const Node& n = nodes_[stack[--top]];
+      const int mask = overlap_mask(n, q);
+      for (int k = 0; k < 4; ++k)
+      {
+        if (!(mask & (1 << k))) continue;
+        if (n.count[k] == 0)
+        {
+          stack[top++] = n.child[k];
+          continue;
+        }
+        for (uint32_t i = n.child[k]; i < n.child[k] + n.count[k]; ++i)
+          if (overlaps(boxes_[i], q) && !skip(prims_[i])) visit(prims_[i]);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < extra_.size(); ++i)
+    if (overlaps(extra_[i].second, q)) visit(extra_[i].first);
+}
+
+template <class Visitor>
+void
+BoundingVolumeHierarchy::closest(const Core::Geometry::Point& p, double& dmin2, const Visitor& visit) const
+{
+  const float q[3] = { static_cast<float>(p.x()), static_cast<float>(p.y()), static_cast<float>(p.z()) };
+  if (!nodes_.empty())
+  {
+    std::pair<float, uint32_t> stack[MaxStackSize];
+    int top = 0;
+    stack[top++] = std::make_pair(0.0f, 0u);
+    while (top > 0)
+    {
+      const std::pair<float, uint32_t> entry = stack[--top];
+      if (entry.first - slack_ > std::sqrt(dmin2)) continue;
+
+      const Node& n = nodes_[entry.second];
+      float dist[4];
+      distances(n, q, dist);
+      int order[4] = { 0, 1, 2, 3 };
+      std::sort(order, order + 4, [&dist](int a, int b) { return dist[a] < dist[b]; });
+
+      // Scan the leaves nearest first, then push the inner nodes farthest
+      // first so the nearest is searched next.
+      for (int j = 0; j < 4; ++j)
+      {
+        const int k = order[j];
+        if (n.count[k] == 0 || dist[k] - slack_ > std::sqrt(dmin2)) continue;
+        for (uint32_t i = n.child[k]; i < n.child[k] + n.count[k]; ++i)
+          if (distance(boxes_[i], q) - slack_ <= std::sqrt(dmin2) && !skip(prims_[i]) &&
+              visit(prims_[i], dmin2))
+            return;
+      }
+      for (int j = 3; j >= 0; --j)
+      {
+        const int k = order[j];
+        if (n.count[k] != 0 || n.child[k] == EmptyLane || dist[k] - slack_ > std::sqrt(dmin2)) continue;
+        stack[top++] = std::make_pair(dist[k], n.child[k]);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < extra_.size(); ++i)
+    if (distance(extra_[i].second, q) - slack_ <= std::sqrt(dmin2) && visit(extra_[i].first, dmin2))
+      return;
+}
+
+inline void
+BoundingVolumeHierarchy::insert(index_type prim, const Core::Geometry::BBox& box)
+{
+  if (box.valid())
+    extra_.push_back(std::make_pair(prim, to_box(box)));
+}
+
+inline void
+BoundingVolumeHierarchy::remove(index_type prim)
+{
+  for (size_t i = 0; i < extra_.size(); ++i)
+  {
+    if (extra_[i].first == prim)
+    {
+      extra_.erase(extra_.begin() + i);
+      break;
+    }
+  }
+  removed_.insert(prim);
+}
+
+inline void
+BoundingVolumeHierarchy::transform(const Core::Geometry::Transform& t)
+{
+  float extent = 0.0f;
+  for (size_t i = 0; i < nodes_.size(); ++i)
+  {
+    Node& n = nodes_[i];
+    for (int k = 0; k < 4; ++k)
+    {
+      if (n.child[k] == EmptyLane) continue;
+      Box b;
+      for (int d = 0; d < 3; ++d) { b.lo[d] = n.lo[d][k]; b.hi[d] = n.hi[d][k]; }
+      b = transformed(b, t);
+      set_lane(n, k, b, n.child[k], n.count[k]);
+      for (int d = 0; d < 3; ++d)
+        extent = std::max(extent, std::max(std::fabs(b.lo[d]), std::fabs(b.hi[d])));
+    }
+  }
+  for (size_t i = 0; i < boxes_.size(); ++i)
+    boxes_[i] = transformed(boxes_[i], t);
+  for (size_t i = 0; i < extra_.size(); ++i)
+    extra_[i].second = transformed(extra_[i].second, t);
+  slack_ = std::max(slack_, 8.0f * FLT_EPSILON * extent);
+}
+
+} // end namespace SCIRun
+
+#endif
@@ -90,6 +90,13 @@ public:
   virtual void get_delems(VMesh::DElem::array_type& delems,
                           VMesh::Elem::index_type i) const;
 
+  virtual void get_elem_nodes(VMesh::Node::fixed_array_type& nodes,
+                              VMesh::Elem::index_type i) const;
+  virtual void get_elem_edges(VMesh::Edge::fixed_array_type& edges,
+                              VMesh::Elem::index_type i) const;
+  virtual void get_elem_delems(VMesh::DElem::fixed_array_type& delems,
+                               VMesh::Elem::index_type i) const;
+
   virtual void set_nodes(VMesh::Node::array_type&,
                          VMesh::Elem::index_type);
 
@@ -254,6 +261,30 @@ VCurveMesh<MESH>::get_delems(VMesh::DElem::array_type& delems,
   this->mesh_->get_nodes_from_edge(delems,i);
 }
 
+template <class MESH>
+void
+VCurveMesh<MESH>::get_elem_nodes(VMesh::Node::fixed_array_type& nodes,
+                                 VMesh::Elem::index_type i) const
+{
+  this->mesh_->get_nodes_from_edge(nodes,i);
+}
+
+template <class MESH>
+void
+VCurveMesh<MESH>::get_elem_edges(VMesh::Edge::fixed_array_type& edges,
+                                 VMesh::Elem::index_type i) const
+{
+  edges.resize(1); edges[0] = static_cast<VMesh::Edge::index_type>(i);
+}
+
+template <class MESH>
+void
+VCurveMesh<MESH>::get_elem_delems(VMesh::DElem::fixed_array_type& delems,
+                                  VMesh::Elem::index_type i) const
+{
+  this->mesh_->get_nodes_from_edge(delems,i);
+}
+
 template <class MESH>
 void
 VCurveMesh<MESH>::get_delems(VMesh::DElem::array_type& delems,
@@ -52,6 +52,7 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/NodeAdjacency.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 
 #include <Core/Datatypes/Legacy/Field/share.h>
@@ -347,6 +348,14 @@ public:
   void get_elems(typename Elem::array_type &array,
                  typename Node::index_type idx) const
   { get_edges_from_node(array,idx); }
+  /// The edges around node idx without copying them; valid until the mesh
+  /// or its NODE_NEIGHBORS_E synchronization changes.
+  NodeAdjacency::Span get_elems_span(typename Node::index_type idx) const
+  {
+    ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
+      "CurveMesh: Must call synchronize NODE_NEIGHBORS_E on CurveMesh first");
+    return node_neighbors_.elems(idx);
+  }
   void get_elems(typename Elem::array_type &array,
                  typename Edge::index_type idx) const
   { array.resize(1); array[0]= idx; }
@@ -1188,10 +1197,11 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
       "CurveMesh: Must call synchronize NODE_NEIGHBORS_E on CurveMesh first");
 
-    array.resize(node_neighbors_[idx].size());
-    for (typename NodeNeighborMap::size_type i = 0; i < node_neighbors_[idx].size(); ++i)
+    const NodeAdjacency::Span edges = node_neighbors_.elems(idx);
+    array.resize(edges.size());
+    for (size_t i = 0; i < edges.size(); ++i)
       array[i] =
-        static_cast<typename ARRAY::value_type>(node_neighbors_[idx][i]);
+        static_cast<typename ARRAY::value_type>(edges[i]);
   }
 
   template<class ARRAY, class INDEX>
@@ -1221,11 +1231,12 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
                   "Must call synchronize NODE_NEIGHBORS_E on CurveMesh first");
 
-    if (node_neighbors_[node].size() > 1)
+    const NodeAdjacency::Span edges = node_neighbors_.elems(node);
+    if (edges.size() > 1)
     {
-      if (node_neighbors_[node][0] == edge)
-        neighbor = static_cast<INDEX1>(node_neighbors_[node][1]);
-      else neighbor = static_cast<INDEX1>(node_neighbors_[node][0]);
+      if (edges[0] == edge)
+        neighbor = static_cast<INDEX1>(edges[1]);
+      else neighbor = static_cast<INDEX1>(edges[0]);
       return (true);
     }
     return (false);
@@ -1238,13 +1249,14 @@ protected:
   {
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
                   "Must call synchronize NODE_NEIGHBORS_E on CurveMesh first");
-    array.resize(node_neighbors_[idx].size());
-    for (typename NodeNeighborMap::size_type p=0;p<node_neighbors_[idx].size();p++)
+    const NodeAdjacency::Span edges = node_neighbors_.elems(idx);
+    array.resize(edges.size());
+    for (size_t p=0;p<edges.size();p++)
     {
-      if (edges_[2*(node_neighbors_[idx][p])] == idx)
-        array[p] = static_cast<typename ARRAY::value_type>(edges_[2*(node_neighbors_[idx][p])+1]);
+      if (edges_[2*(edges[p])] == idx)
+        array[p] = static_cast<typename ARRAY::value_type>(edges_[2*(edges[p])+1]);
       else
-        array[p] = static_cast<typename ARRAY::value_type>(edges_[2*(node_neighbors_[idx][p])]);
+        array[p] = static_cast<typename ARRAY::value_type>(edges_[2*(edges[p])]);
     }
   }
 
@@ -1256,15 +1268,16 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
                   "Must call synchronize NODE_NEIGHBORS_E on CurveMesh first");
 
-    typename NodeNeighborMap::size_type sz = node_neighbors_[idx].size();
+    const NodeAdjacency::Span edges = node_neighbors_.elems(idx);
+    size_t sz = edges.size();
     if (sz < 1) return (false);
 
     array.clear();
     array.reserve(sz-1);
-    for (typename NodeNeighborMap::size_type i=0; i<sz;i++)
+    for (size_t i=0; i<sz;i++)
     {
-      if (node_neighbors_[idx][i] != static_cast<typename ARRAY::value_type>(idx))
-          array.push_back(typename ARRAY::value_type(node_neighbors_[idx][i]));
+      if (edges[i] != static_cast<typename ARRAY::value_type>(idx))
+          array.push_back(typename ARRAY::value_type(edges[i]));
     }
     return (true);
   }
@@ -1279,20 +1292,20 @@ protected:
     typename Node::index_type n1 = edges_[2*idx];
     typename Node::index_type n2 = edges_[2*idx+1];
 
-    typename NodeNeighborMap::size_type s1 = node_neighbors_[n1].size();
-    typename NodeNeighborMap::size_type s2 = node_neighbors_[n2].size();
+    const NodeAdjacency::Span e1 = node_neighbors_.elems(n1);
+    const NodeAdjacency::Span e2 = node_neighbors_.elems(n2);
 
     array.clear();
-    array.reserve(s1+s2-2);
-    for (typename NodeNeighborMap::size_type i=0; i<s1;i++)
+    array.reserve(e1.size()+e2.size()-2);
+    for (size_t i=0; i<e1.size();i++)
     {
-      if (node_neighbors_[n1][i] != idx)
-        array.push_back(typename ARRAY::value_type(node_neighbors_[n1][i]));
+      if (e1[i] != idx)
+        array.push_back(typename ARRAY::value_type(e1[i]));
     }
-    for (typename NodeNeighborMap::size_type i=0; i<s2;i++)
+    for (size_t i=0; i<e2.size();i++)
     {
-      if (node_neighbors_[n2][i] != idx)
-        array.push_back(typename ARRAY::value_type(node_neighbors_[n2][i]));
+      if (e2[i] != idx)
+        array.push_back(typename ARRAY::value_type(e2[i]));
     }
   }
 
@@ -1320,8 +1333,7 @@ protected:
   /// Vector indicating which edges are conected to which
   /// node. This is the reverse of the connectivity data
   /// stored in the edges_ array.
-  typedef std::vector<std::vector<typename Edge::index_type> > NodeNeighborMap;
-  NodeNeighborMap         node_neighbors_;
+  NodeAdjacency           node_neighbors_;
   Core::Geometry::BBox                    bbox_;
   double                  epsilon_;
   double                  epsilon2_;
@@ -1715,15 +1727,9 @@ template <class Basis>
 void
 CurveMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  index_type i;
-  size_type  num_elems = (edges_.size()>>1);
-  for (i = 0; i < num_elems; i++)
-  {
-    node_neighbors_[edges_[2*i]].push_back(i);
-    node_neighbors_[edges_[2*i+1]].push_back(i);
-  }
+  node_neighbors_.build(points_.size(), edges_.size(),
+    [this](index_type i) { return static_cast<index_type>(edges_[i]); },
+    [](index_type i) { return i >> 1; });
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
 }
 
@@ -46,6 +46,8 @@
 #include <Core/Datatypes/Legacy/Field/CastFData.h>
 #include <Core/Containers/StackVector.h>
 
+#include <boost/thread/mutex.hpp>
+
 #include <Core/Datatypes/Legacy/Field/share.h>
 
 namespace SCIRun {
@@ -75,9 +77,11 @@ public:
 
   /// Clone the field data, but not the mesh.
   /// Use mesh_detach() first to clone the complete field
+  /// The data is shared copy-on-write: it is only copied once the clone or
+  /// this field writes to it through its VField.
   virtual GenericField<Mesh, Basis, FData> *clone() const;
 
-  /// Clone everything, field data and mesh.
+  /// Clone everything, field data and mesh. Field data is shared copy-on-write as in clone().
   virtual GenericField<Mesh, Basis, FData> *deep_clone() const;
 
   /// Obtain a Handle to the Mesh
@@ -127,12 +131,16 @@ public:
   static FieldHandle field_maker();
   static FieldHandle field_maker_mesh(MeshHandle mesh);
 
+  /// Take a private copy of the data container if a clone still shares it.
+  void unshare_values();
+
 protected:
 
   /// A (generic) mesh.
   mesh_handle_type             mesh_;
-  /// Data container.
-  fdata_type                   fdata_;
+  /// Data container, shared with clones until one side writes.
+  boost::shared_ptr<fdata_type> fdata_;
+  boost::mutex                 unshare_lock_;
   Basis                        basis_;
 
   VField*                      vfield_;
@@ -183,6 +191,24 @@ class VGenericField : public VField {
       if (vfdata_) delete vfdata_;
     }
 
+    /// Point at a private data container (null keeps the current one, which is no
+    /// longer shared). A field is not read while it is being written, so the old
+    /// interface is released right away along with this field's share of the values.
+    void rebind_values(VFData* vfdata)
+    {
+      if (vfdata)
+      {
+        delete vfdata_;
+        vfdata_ = vfdata;
+      }
+      shared_values_.store(false, std::memory_order_release);
+    }
+
+  protected:
+    virtual void unshare_values() const
+    {
+      static_cast<FIELD*>(field_)->unshare_values();
+    }
 };
 
 // PIO
@@ -251,7 +277,9 @@ void GenericField<Mesh, Basis, FData>::io(Piostream& stream)
     basis_.io(stream);
   }
 
-  Pio(stream, fdata_);
+  if (stream.reading())
+    unshare_values();
+  Pio(stream, *fdata_);
 
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   freeze();
@@ -274,7 +302,7 @@ template <class Mesh, class Basis, class FData>
 GenericField<Mesh, Basis, FData>::GenericField() :
   Field(),
   mesh_(mesh_handle_type(new mesh_type())),
-  fdata_(0),
+  fdata_(boost::make_shared<fdata_type>(0)),
   vfield_(0),
   basis_order_(0),
   mesh_dimensionality_(-1)
@@ -284,7 +312,7 @@ GenericField<Mesh, Basis, FData>::GenericField() :
   basis_order_ = basis_order();
   if (mesh_) mesh_dimensionality_ = mesh_->dimensionality();
 
-  VFData* vfdata = CreateVFData(fdata_,get_basis().get_nodes(),get_basis().get_derivs());
+  VFData* vfdata = CreateVFData(*fdata_,get_basis().get_nodes(),get_basis().get_derivs());
   vfield_ = new VGenericField<GenericField<Mesh,Basis,FData> >(this, vfdata);
   vfield_->resize_values();
 
@@ -302,10 +330,13 @@ GenericField<Mesh, Basis, FData>::GenericField(const GenericField& copy) :
 {
   DEBUG_CONSTRUCTOR("GenericField")
 
-  VFData* vfdata = CreateVFData(fdata_,get_basis().get_nodes(),get_basis().get_derivs());
+  VFData* vfdata = CreateVFData(*fdata_,get_basis().get_nodes(),get_basis().get_derivs());
   if (vfdata)
   {
     vfield_ = new VGenericField<GenericField<Mesh,Basis,FData> >(this, vfdata);
+    vfield_->mark_values_shared();
+    if (copy.vfield_)
+      copy.vfield_->mark_values_shared();
   }
 }
 
@@ -314,7 +345,7 @@ template <class Mesh, class Basis, class FData>
 GenericField<Mesh, Basis, FData>::GenericField(mesh_handle_type mesh) :
   Field(),
   mesh_(mesh),
-  fdata_(0),
+  fdata_(boost::make_shared<fdata_type>(0)),
   vfield_(0),
   basis_order_(0),
   mesh_dimensionality_(-1)
@@ -324,7 +355,7 @@ GenericField<Mesh, Basis, FData>::GenericField(mesh_handle_type mesh) :
   basis_order_ = basis_order();
   if (mesh_) mesh_dimensionality_ = mesh_->dimensionality();
 
-  VFData* vfdata = CreateVFData(fdata_,get_basis().get_nodes(),get_basis().get_derivs());
+  VFData* vfdata = CreateVFData(*fdata_,get_basis().get_nodes(),get_basis().get_derivs());
   vfield_ = new VGenericField<GenericField<Mesh,Basis,FData> >(this, vfdata);
   vfield_->resize_values();
 }
@@ -354,6 +385,25 @@ GenericField<Mesh, Basis, FData> *
   return copy;
 }
 
+template <class Mesh, class Basis, class FData>
+void
+GenericField<Mesh, Basis, FData>::unshare_values()
+{
+  boost::lock_guard<boost::mutex> lock(unshare_lock_);
+  typedef VGenericField<GenericField<Mesh, Basis, FData> > vfield_type;
+  auto vfield = static_cast<vfield_type*>(vfield_);
+  if (!vfield->values_shared())
+    return;
+
+  if (fdata_.use_count() > 1)
+  {
+    fdata_ = boost::make_shared<fdata_type>(*fdata_);
+    vfield->rebind_values(CreateVFData(*fdata_,get_basis().get_nodes(),get_basis().get_derivs()));
+  }
+  else
+    vfield->rebind_values(nullptr);
+}
+
 template <class Mesh, class Basis, class FData>
 MeshHandle
 GenericField<Mesh, Basis, FData>::mesh() const
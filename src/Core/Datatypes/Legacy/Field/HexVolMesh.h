@@ -51,6 +51,8 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshTopologySort.h>
+#include <Core/Datatypes/Legacy/Field/NodeAdjacency.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Mesh/VirtualMeshFacade.h>
 
@@ -564,6 +566,14 @@ public:
   void get_elems(typename Elem::array_type &array,
                  typename Node::index_type idx) const
   { get_cells_from_node(array,idx); }
+  /// The cells around node idx without copying them; valid until the mesh
+  /// or its NODE_NEIGHBORS_E synchronization changes.
+  NodeAdjacency::Span get_elems_span(typename Node::index_type idx) const
+  {
+    ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
+            "HexVolMesh: Must call synchronize NODE_NEIGHBORS_E first.");
+    return node_neighbors_.elems(idx);
+  }
   void get_elems(typename Elem::array_type &array,
                  typename Edge::index_type idx) const
   { get_cells_from_edge(array,idx); }
@@ -1793,10 +1803,10 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
             "HexVolMesh: Must call synchronize NODE_NEIGHBORS_E first.");
 
-    array.resize(node_neighbors_[idx].size());
-    for (size_t i = 0; i < node_neighbors_[idx].size(); ++i)
-      array[i] = static_cast<typename ARRAY::value_type>(
-                                                  (node_neighbors_[idx][i])>>3);
+    const NodeAdjacency::Span cells = node_neighbors_.elems(idx);
+    array.resize(cells.size());
+    for (size_t i = 0; i < cells.size(); ++i)
+      array[i] = static_cast<typename ARRAY::value_type>(cells[i]);
   }
 
   template<class ARRAY, class INDEX>
@@ -1808,7 +1818,7 @@ protected:
       "HexVolMesh: Must call synchronize EDGES_E first");
 
     // Get all the nodes that share an edge with this node
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const NodeAdjacency::Span neighbors = node_neighbors_.entries(idx);
 
     array.clear();
     array.reserve(neighbors.size());
@@ -1890,7 +1900,7 @@ protected:
       "HexVolMesh: Must call synchronize FACES_E first");
 
     array.clear();
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const NodeAdjacency::Span neighbors = node_neighbors_.entries(idx);
 
     // Iterate through all those edges
     for (size_t n = 0; n < neighbors.size(); n++)
@@ -2090,12 +2100,12 @@ protected:
   {
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
               "Must call synchronize NODE_NEIGHBORS_E on HexVolMesh first.");
-    size_t sz = node_neighbors_[node].size();
+    const NodeAdjacency::Span neighbors = node_neighbors_.entries(node);
 
     std::set<index_type> inserted;
-    for (size_t i = 0; i < sz; i++)
+    for (size_t i = 0; i < neighbors.size(); i++)
     {
-      const index_type base = ((node_neighbors_[node][i])&(~0x7));
+      const index_type base = ((neighbors[i])&(~0x7));
       for (index_type c = base; c < base+8; ++c)
       {
         if (cells_[c] != node) inserted.insert(cells_[c]);
@@ -2756,9 +2766,7 @@ protected:
     }
   };
 
-  using face_ht = boost::unordered_map<PFace, typename Face::index_type, FaceHash>;
   using face_nt = boost::unordered_map<PFaceNode, typename Face::index_type, FaceHash>;
-  using edge_ht = boost::unordered_map<PEdge, typename Edge::index_type, EdgeHash>;
   using edge_nt = boost::unordered_map<PEdgeNode, typename Edge::index_type, EdgeHash>;
 
   typedef std::vector<PFaceCell> face_ct;
@@ -2774,14 +2782,18 @@ protected:
   edge_ct edges_;
   edge_nt edge_table_;
 
-  inline
-  void hash_edge(typename Node::index_type n1, typename Node::index_type n2,
-                 index_type combind_index, edge_ht &table) const;
-
-  inline
-  void hash_face(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Node::index_type n3, typename Node::index_type n4,
-                 index_type combined_index, face_ht &table) const;
+  /// Faces ordered by order_face_nodes compare equal in either orientation;
+  /// putting the smaller of the two middle nodes second gives one key for both,
+  /// the same normalization PFaceNode::operator< applies.
+  template <class KEY>
+  static void canonical_face_key(KEY& key)
+  {
+    if (key[2] == key[3])
+    {
+      if (key[1] > key[2]) { std::swap(key[1], key[2]); key[3] = key[2]; }
+    }
+    else if (key[1] > key[3]) std::swap(key[1], key[3]);
+  }
 
   template <class INDEX>
   bool order_face_nodes(INDEX& n1, INDEX& n2, INDEX& n3, INDEX& n4) const
@@ -2852,7 +2864,7 @@ protected:
     typename Node::array_type   nodes_;
   };
 
-  std::vector<std::vector<typename Cell::index_type> > node_neighbors_;
+  NodeAdjacency node_neighbors_;
   std::vector<unsigned char> boundary_faces_;
 
   /// This grid is used as an acceleration structure to expedite calls
@@ -3212,107 +3224,55 @@ HexVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 
 template <class Basis>
 void
-HexVolMesh<Basis>::hash_face(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             typename Node::index_type n3,
-                             typename Node::index_type n4,
-                             index_type combined_index,
-                             face_ht &table) const
+HexVolMesh<Basis>::compute_faces()
 {
-  // Reorder nodes while maintaining CCW or CW orientation
-  // Check for degenerate faces, if faces has degeneracy it
-  // will be ignored (e.g. nodes on opposite corners are equal,
-  // or more then two nodes are equal)
-
-  if (!(order_face_nodes(n1,n2,n3,n4))) return;
-  PFace f(n1, n2, n3, n4);
-
+  // 6 faces -- each is entered CCW from outside looking in
+  static const int face_nodes[6][4] =
+    { {0, 1, 2, 3}, {7, 6, 5, 4}, {0, 4, 5, 1}, {2, 6, 7, 3}, {3, 7, 4, 0}, {1, 5, 6, 2} };
 
-  typename face_ht::iterator iter = table.find(f);
-
-  if (iter == table.end())
+  SortedTopology<4> topology;
+  topology.compute(static_cast<size_type>(cells_.size() >> 3), 6, static_cast<size_type>(points_.size()),
+    [this](index_type cell, typename SortedTopology<4>::key_type* keys, index_type* combined)
   {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
-  {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "HexVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index>>3)
-           << " are illegally adjacent." << std::endl;*/
-    }
-    else if ((f.cells_[0]>>3) == (combined_index>>3))
+    const under_type* n = &cells_[cell << 3];
+    for (int i = 0; i < 6; ++i)
     {
-      //TODO: inject new logger
-      /*
-      std::cerr << "HexVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index>>3)
-           << " are the same." << std::endl;
-           */
+      typename SortedTopology<4>::key_type& key = keys[i];
+      key = {{ n[face_nodes[i][0]], n[face_nodes[i][1]], n[face_nodes[i][2]], n[face_nodes[i][3]] }};
+      // degenerate faces are ignored
+      if (!order_face_nodes(key[0], key[1], key[2], key[3])) key[0] = -1;
+      else canonical_face_key(key);
+      combined[i] = (cell << 3) + i;
     }
-    else
-    {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
-    }
-  }
-}
-
-template <class Basis>
-void
-HexVolMesh<Basis>::compute_faces()
-{
-  face_table_.clear();
-
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(8);
-
-  face_ht table;
-
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    // 6 faces -- each is entered CCW from outside looking in
-    index_type cell_index = (*ci)<<3;
-    hash_face(arr[0], arr[1], arr[2], arr[3], cell_index, table);
-    hash_face(arr[7], arr[6], arr[5], arr[4], cell_index + 1, table);
-    hash_face(arr[0], arr[4], arr[5], arr[1], cell_index + 2, table);
-    hash_face(arr[2], arr[6], arr[7], arr[3], cell_index + 3, table);
-    hash_face(arr[3], arr[7], arr[4], arr[0], cell_index + 4, table);
-    hash_face(arr[1], arr[5], arr[6], arr[2], cell_index + 5, table);
-
-    ++ci;
-  }
+  });
 
-  faces_.resize(table.size());
-  boundary_faces_.resize(cells_.size()>>3);
-
-  typename face_ht::iterator ht_iter = table.begin();
-  typename face_ht::iterator ht_iter_end = table.end();
-
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
+  faces_.clear();
+  faces_.resize(topology.size());
+  Core::Thread::Parallel::For(0, topology.size(), [this, &topology](size_t begin, size_t end)
   {
-    const PFace& pface = (*ht_iter).first;
-    faces_[uidx].cells_[0] = pface.cells_[0];
-    faces_[uidx].cells_[1] = pface.cells_[1];
-    face_table_[PFaceNode(pface.nodes_[0],pface.nodes_[1],pface.nodes_[2],pface.nodes_[3])] = uidx;
-
-    if (pface.cells_[1] == -1)
+    for (size_t f = begin; f < end; ++f)
     {
-      index_type cell = (pface.cells_[0]) >> 3;
-      index_type face = (pface.cells_[0]) & 0x7;
-      boundary_faces_[cell] |= 1 << face;
+      faces_[f].cells_[0] = topology.occurrence(f, 0);
+      faces_[f].cells_[1] = topology.neighbor(f, 3);
     }
+  });
 
-    ++ht_iter; uidx++;
+  // the table is keyed by the ordered nodes of the face in its first cell
+  face_table_.clear();
+  face_table_.reserve(topology.size());
+  boundary_faces_.assign(cells_.size() >> 3, 0);
+  for (size_t f = 0; f < topology.size(); ++f)
+  {
+    index_type cell = (faces_[f].cells_[0]) >> 3;
+    index_type face = (faces_[f].cells_[0]) & 0x7;
+    const under_type* n = &cells_[cell << 3];
+    index_type n1 = n[face_nodes[face][0]], n2 = n[face_nodes[face][1]];
+    index_type n3 = n[face_nodes[face][2]], n4 = n[face_nodes[face][3]];
+    order_face_nodes(n1, n2, n3, n4);
+    face_table_.emplace(PFaceNode(n1, n2, n3, n4), static_cast<typename Face::index_type>(f));
+
+    if (faces_[f].cells_[1] == MESH_NO_NEIGHBOR)
+      boundary_faces_[cell] |= 1 << face;
   }
 
   synchronize_lock_.lock();
@@ -3320,74 +3280,44 @@ HexVolMesh<Basis>::compute_faces()
   synchronize_lock_.unlock();
 }
 
-template <class Basis>
-void
-HexVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             index_type combined_index,
-                             edge_ht &table) const
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-  if (iter == table.end())
-  {
-    e.cells_.push_back(combined_index); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(combined_index); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 HexVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  edge_ht table;
-  typename Node::array_type arr;
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    index_type cell_index = (*ci)<<4;
-    hash_edge(arr[0], arr[1], cell_index  , table);
-    hash_edge(arr[1], arr[2], cell_index+1, table);
-    hash_edge(arr[2], arr[3], cell_index+2, table);
-    hash_edge(arr[3], arr[0], cell_index+3, table);
-
-    hash_edge(arr[4], arr[5], cell_index+4, table);
-    hash_edge(arr[5], arr[6], cell_index+5, table);
-    hash_edge(arr[6], arr[7], cell_index+6, table);
-    hash_edge(arr[7], arr[4], cell_index+7, table);
-
-    hash_edge(arr[0], arr[4], cell_index+8, table);
-    hash_edge(arr[5], arr[1], cell_index+9, table);
-    hash_edge(arr[2], arr[6], cell_index+10,table);
-    hash_edge(arr[7], arr[3], cell_index+11,table);
-    ++ci;
-  }
-
-  // dump edges into the edges_ container.
+  static const int edge_nodes[12][2] =
+    { {0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6}, {6, 7}, {7, 4}, {0, 4}, {5, 1}, {2, 6}, {7, 3} };
 
-  edges_.resize(table.size());
-
-  typename edge_ht::iterator ht_iter = table.begin();
-  typename edge_ht::iterator ht_iter_end = table.end();
+  SortedTopology<2> topology;
+  topology.compute(static_cast<size_type>(cells_.size() >> 3), 12, static_cast<size_type>(points_.size()),
+    [this](index_type cell, typename SortedTopology<2>::key_type* keys, index_type* combined)
+  {
+    const under_type* n = &cells_[cell << 3];
+    for (int i = 0; i < 12; ++i)
+    {
+      keys[i] = {{ n[edge_nodes[i][0]], n[edge_nodes[i][1]] }};
+      SortedTopology<2>::sortNodes(keys[i]);
+      if (keys[i][0] == keys[i][1]) keys[i][0] = -1;
+      combined[i] = (cell << 4) + i;
+    }
+  });
 
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
+  // dump edges into the edges_ container.
+  edges_.clear();
+  edges_.resize(topology.size());
+  Core::Thread::Parallel::For(0, topology.size(), [this, &topology](size_t begin, size_t end)
   {
-    const PEdge& pedge = (*ht_iter).first;
-    edges_[uidx].cells_ = pedge.cells_;
-    edge_table_[PEdgeNode(pedge.nodes_[0],pedge.nodes_[1])] = uidx;
-    ++ht_iter; uidx++;
-  }
+    for (size_t e = begin; e < end; ++e)
+    {
+      edges_[e].cells_.resize(topology.count(e));
+      for (size_t j = 0; j < topology.count(e); ++j)
+        edges_[e].cells_[j] = topology.occurrence(e, j);
+    }
+  });
+
+  edge_table_.clear();
+  edge_table_.reserve(topology.size());
+  for (size_t e = 0; e < topology.size(); ++e)
+    edge_table_.emplace(PEdgeNode(topology.key(e)[0], topology.key(e)[1]), static_cast<typename Edge::index_type>(e));
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::EDGES_E;
@@ -3677,13 +3607,10 @@ template <class Basis>
 void
 HexVolMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  index_type i, num_cells = cells_.size();
-  for (i = 0; i < num_cells; i++)
-  {
-    node_neighbors_[cells_[i]].push_back(i);
-  }
+  // entry i of cells_ is node i%8 of cell i/8
+  node_neighbors_.build(points_.size(), cells_.size(),
+    [this](index_type i) { return static_cast<index_type>(cells_[i]); },
+    [](index_type i) { return i; }, 3);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
@@ -126,6 +126,15 @@ class VImageMesh : public VMeshShared<MESH> {
     virtual void get_delems(VMesh::DElem::array_type& delems,
                             VMesh::Elem::index_type i) const override;
 
+    virtual void get_elem_nodes(VMesh::Node::fixed_array_type& nodes,
+                                VMesh::Elem::index_type i) const override;
+    virtual void get_elem_edges(VMesh::Edge::fixed_array_type& edges,
+                                VMesh::Elem::index_type i) const override;
+    virtual void get_elem_faces(VMesh::Face::fixed_array_type& faces,
+                                VMesh::Elem::index_type i) const override;
+    virtual void get_elem_delems(VMesh::DElem::fixed_array_type& delems,
+                                 VMesh::Elem::index_type i) const override;
+
     /// Get the center of a certain mesh element
     virtual void get_center(Point &point, VMesh::Node::index_type i) const override;
     virtual void get_center(Point &point, VMesh::ENode::index_type i) const override;
@@ -821,6 +830,38 @@ get_delems(VMesh::DElem::array_type &array, VMesh::Elem::index_type idx) const
   get_edges_from_face(array,idx);
 }
 
+template <class MESH>
+void
+VImageMesh<MESH>::
+get_elem_nodes(VMesh::Node::fixed_array_type &array, VMesh::Elem::index_type idx) const
+{
+  get_nodes_from_face(array,idx);
+}
+
+template <class MESH>
+void
+VImageMesh<MESH>::
+get_elem_edges(VMesh::Edge::fixed_array_type &array, VMesh::Elem::index_type idx) const
+{
+  get_edges_from_face(array,idx);
+}
+
+template <class MESH>
+void
+VImageMesh<MESH>::
+get_elem_faces(VMesh::Face::fixed_array_type &array, VMesh::Elem::index_type idx) const
+{
+  array.resize(1); array[0] = static_cast<VMesh::Face::index_type>(idx);
+}
+
+template <class MESH>
+void
+VImageMesh<MESH>::
+get_elem_delems(VMesh::DElem::fixed_array_type &array, VMesh::Elem::index_type idx) const
+{
+  get_edges_from_face(array,idx);
+}
+
 template <class MESH>
 void
 VImageMesh<MESH>::
@@ -145,6 +145,15 @@ public:
   virtual void get_delems(VMesh::DElem::array_type& delems,
                           VMesh::Elem::index_type i) const;
 
+  virtual void get_elem_nodes(VMesh::Node::fixed_array_type& nodes,
+                              VMesh::Elem::index_type i) const;
+  virtual void get_elem_edges(VMesh::Edge::fixed_array_type& edges,
+                              VMesh::Elem::index_type i) const;
+  virtual void get_elem_faces(VMesh::Face::fixed_array_type& faces,
+                              VMesh::Elem::index_type i) const;
+  virtual void get_elem_delems(VMesh::DElem::fixed_array_type& delems,
+                               VMesh::Elem::index_type i) const;
+
   virtual bool get_elem(VMesh::Elem::index_type& elem,
                         VMesh::Node::array_type& nodes) const;
   virtual bool get_delem(VMesh::DElem::index_type& delem,
@@ -1325,7 +1334,7 @@ void
 VLatVolMesh<MESH>::get_edges(VMesh::Edge::array_type &array,
                              VMesh::Elem::index_type idx) const
 {
-  get_edges_from_face(array,idx);
+  get_edges_from_cell(array,idx);
 }
 
 template <class MESH>
@@ -1449,6 +1458,38 @@ VLatVolMesh<MESH>::get_delems(VMesh::DElem::array_type &array,
   get_faces_from_cell(array,idx);
 }
 
+template <class MESH>
+void
+VLatVolMesh<MESH>::get_elem_nodes(VMesh::Node::fixed_array_type &array,
+                                  VMesh::Elem::index_type idx) const
+{
+  get_nodes_from_cell(array,idx);
+}
+
+template <class MESH>
+void
+VLatVolMesh<MESH>::get_elem_edges(VMesh::Edge::fixed_array_type &array,
+                                  VMesh::Elem::index_type idx) const
+{
+  get_edges_from_cell(array,idx);
+}
+
+template <class MESH>
+void
+VLatVolMesh<MESH>::get_elem_faces(VMesh::Face::fixed_array_type &array,
+                                  VMesh::Elem::index_type idx) const
+{
+  get_faces_from_cell(array,idx);
+}
+
+template <class MESH>
+void
+VLatVolMesh<MESH>::get_elem_delems(VMesh::DElem::fixed_array_type &array,
+                                   VMesh::Elem::index_type idx) const
+{
+  get_faces_from_cell(array,idx);
+}
+
 template <class MESH>
 void
 VLatVolMesh<MESH>::get_delems(VMesh::DElem::array_type &array,
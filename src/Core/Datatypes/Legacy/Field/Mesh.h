@@ -81,7 +81,11 @@ public:
     BOUNDING_BOX_E = 1 << 12,
     FIND_CLOSEST_NODE_E		= 1 << 13,
     FIND_CLOSEST_ELEM_E		= 1 << 14,
-    FIND_CLOSEST_E = FIND_CLOSEST_NODE_E | FIND_CLOSEST_ELEM_E
+    FIND_CLOSEST_E = FIND_CLOSEST_NODE_E | FIND_CLOSEST_ELEM_E,
+    /// Build ELEM_LOCATE_E as a bounding volume hierarchy instead of a uniform
+    /// search grid. Only TetVolMesh implements it; other meshes ignore it and
+    /// keep their search grid.
+    ELEM_LOCATE_BVH_E = 1 << 15
   };
 
   virtual bool synchronize(mask_type) { return false; }
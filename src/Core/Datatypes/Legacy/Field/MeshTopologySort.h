@@ -0,0 +1,276 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_DATATYPES_MESHTOPOLOGYSORT_H
+#define CORE_DATATYPES_MESHTOPOLOGYSORT_H 1
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/Utils/Legacy/Assert.h>
+
+namespace SCIRun {
+
+/// The distinct faces or edges of an unstructured mesh, found by radix sorting
+/// one packed (node tuple, element) key per element face or edge rather than
+/// hashing them one by one. Entities come out in ascending order of their node
+/// tuples; the elements sharing an entity come out in ascending order of their
+/// combined (element, local index) value.
+template <size_t N>
+class SortedTopology
+{
+public:
+  typedef std::array<index_type, N> key_type;
+
+  /// gen(elem, keys, combined) fills perElem entries for element elem: the nodes
+  /// of each face or edge, and the value stored for that occurrence. The nodes must
+  /// be in a canonical order, so that the same entity seen from two elements
+  /// gives the same key (sortNodes gives one).
+  /// Node values run from 0 to numNodes; numNodes fills unused key slots (e.g. a
+  /// triangle in a 4 node key). An entry whose first node is negative is skipped.
+  /// Combined values must not decrease with elem.
+  template <class Generator>
+  void compute(size_type numElems, int perElem, size_type numNodes, const Generator& gen);
+
+  size_t size() const { return keys_.size(); }
+  /// Nodes of entity i in the generator's canonical order.
+  const key_type& key(size_t i) const { return keys_[i]; }
+  size_t count(size_t i) const { return static_cast<size_t>(offsets_[i + 1] - offsets_[i]); }
+  /// The j-th combined value of the elements that contain entity i.
+  index_type occurrence(size_t i, size_t j) const { return occurrences_[offsets_[i] + j]; }
+  /// Only one element contains entity i.
+  bool boundary(size_t i) const { return count(i) == 1; }
+
+  /// For a face: the first occurrence after the first that lies in another
+  /// element, comparing combined values shifted right by localBits; -1 if none.
+  /// A face found in more than two elements keeps its first two, as the hash
+  /// table construction did.
+  index_type neighbor(size_t i, int localBits) const
+  {
+    const index_type first = occurrences_[offsets_[i]] >> localBits;
+    for (index_type j = offsets_[i] + 1; j < offsets_[i + 1]; ++j)
+      if ((occurrences_[j] >> localBits) != first)
+        return occurrences_[j];
+    return -1;
+  }
+
+  /// Ascending order, the canonical order of simplex faces and of edges.
+  static void sortNodes(key_type& key)
+  {
+    for (size_t i = 1; i < N; ++i)
+      for (size_t j = i; j > 0 && key[j] < key[j - 1]; --j)
+        std::swap(key[j], key[j - 1]);
+  }
+
+private:
+  struct Record
+  {
+    uint64_t lo, hi;
+    index_type combined;
+  };
+
+  static int bitsFor(uint64_t value)
+  {
+    int bits = 1;
+    while (bits < 64 && (value >> bits) != 0) ++bits;
+    return bits;
+  }
+
+  static void putBits(Record& r, uint64_t value, int shift)
+  {
+    if (shift >= 64)
+      r.hi |= value << (shift - 64);
+    else
+    {
+      r.lo |= value << shift;
+      if (shift > 0) r.hi |= value >> (64 - shift);
+    }
+  }
+
+  static uint64_t getBits(const Record& r, int shift, int width)
+  {
+    uint64_t value;
+    if (shift >= 64) value = r.hi >> (shift - 64);
+    else if (shift == 0) value = r.lo;
+    else value = (r.lo >> shift) | (r.hi << (64 - shift));
+    return width >= 64 ? value : value & ((uint64_t(1) << width) - 1);
+  }
+
+  static bool sameKey(const Record& a, const Record& b) { return a.lo == b.lo && a.hi == b.hi; }
+
+  std::vector<key_type> keys_;
+  std::vector<index_type> offsets_;
+  std::vector<index_type> occurrences_;
+};
+
+template <size_t N>
+template <class Generator>
+void
+SortedTopology<N>::compute(size_type numElems, int perElem, size_type numNodes, const Generator& gen)
+{
+  using Core::Thread::Parallel;
+
+  // numNodes + 1 marks skipped entries, so they sort behind every real key
+  const uint64_t skipped = static_cast<uint64_t>(numNodes) + 1;
+  const int bits = bitsFor(skipped);
+  if (bits * static_cast<int>(N) > 128)
+    ASSERTFAIL("SortedTopology: too many nodes to pack a key into 128 bits");
+
+  const size_t n = static_cast<size_t>(numElems) * perElem;
+  std::vector<Record> records(n), sorted(n);
+
+  // Pack the keys, one element per iteration
+  Parallel::For(0, static_cast<size_t>(numElems), [&](size_t begin, size_t end)
+  {
+    std::vector<key_type> keys(perElem);
+    std::vector<index_type> combined(perElem);
+    for (size_t elem = begin; elem < end; ++elem)
+    {
+      gen(static_cast<index_type>(elem), &keys[0], &combined[0]);
+      for (int k = 0; k < perElem; ++k)
+      {
+        Record& r = records[elem * perElem + k];
+        r.lo = r.hi = 0;
+        r.combined = combined[k];
+        key_type& key = keys[k];
+        if (key[0] < 0)
+          key.fill(static_cast<index_type>(skipped));
+        for (size_t j = 0; j < N; ++j)
+          putBits(r, static_cast<uint64_t>(key[j]), static_cast<int>(N - 1 - j) * bits);
+      }
+    }
+  });
+
+  // Stable LSD radix sort on 8 bit digits. Records start in combined order, so
+  // that order survives inside each key.
+  const size_t numChunks = std::max<size_t>(1, std::min<size_t>(4 * Parallel::NumCores(), n / 16384));
+  const size_t chunkSize = (n + numChunks - 1) / numChunks;
+  std::vector<std::array<size_t, 256> > counts(numChunks);
+  const int numDigits = (bits * static_cast<int>(N) + 7) / 8;
+
+  for (int digit = 0; digit < numDigits; ++digit)
+  {
+    const int shift = 8 * digit;
+    Parallel::For(0, numChunks, [&](size_t begin, size_t end)
+    {
+      for (size_t c = begin; c < end; ++c)
+      {
+        counts[c].fill(0);
+        const size_t last = std::min(n, (c + 1) * chunkSize);
+        for (size_t i = c * chunkSize; i < last; ++i)
+          ++counts[c][getBits(records[i], shift, 8)];
+      }
+    }, 1);
+
+    // turn the counts into scatter offsets, bucket major then chunk
+    size_t offset = 0;
+    bool uniform = false;
+    for (size_t bucket = 0; bucket < 256; ++bucket)
+    {
+      size_t total = 0;
+      for (size_t c = 0; c < numChunks; ++c)
+      {
+        size_t count = counts[c][bucket];
+        counts[c][bucket] = offset;
+        offset += count;
+        total += count;
+      }
+      if (total == n) uniform = true;
+    }
+    if (uniform)
+      continue;
+
+    Parallel::For(0, numChunks, [&](size_t begin, size_t end)
+    {
+      for (size_t c = begin; c < end; ++c)
+      {
+        const size_t last = std::min(n, (c + 1) * chunkSize);
+        for (size_t i = c * chunkSize; i < last; ++i)
+          sorted[counts[c][getBits(records[i], shift, 8)]++] = records[i];
+      }
+    }, 1);
+    records.swap(sorted);
+  }
+  std::vector<Record>().swap(sorted);
+
+  // drop the skipped entries at the back
+  Record last;
+  last.lo = last.hi = 0;
+  for (size_t j = 0; j < N; ++j)
+    putBits(last, skipped, static_cast<int>(N - 1 - j) * bits);
+  size_t valid = n;
+  while (valid > 0 && sameKey(records[valid - 1], last))
+    --valid;
+
+  // each chunk counts where a new key starts, then writes its entities at
+  // the prefix sum of the counts before it
+  std::vector<size_t> heads(numChunks + 1, 0);
+  const size_t validChunk = (valid + numChunks - 1) / numChunks;
+  Parallel::For(0, numChunks, [&](size_t begin, size_t end)
+  {
+    for (size_t c = begin; c < end; ++c)
+    {
+      const size_t stop = std::min(valid, (c + 1) * validChunk);
+      for (size_t i = c * validChunk; i < stop; ++i)
+        if (i == 0 || !sameKey(records[i], records[i - 1])) ++heads[c + 1];
+    }
+  }, 1);
+  for (size_t c = 0; c < numChunks; ++c)
+    heads[c + 1] += heads[c];
+
+  keys_.resize(heads[numChunks]);
+  offsets_.resize(heads[numChunks] + 1);
+  occurrences_.resize(valid);
+  offsets_.back() = static_cast<index_type>(valid);
+  Parallel::For(0, numChunks, [&](size_t begin, size_t end)
+  {
+    for (size_t c = begin; c < end; ++c)
+    {
+      size_t h = heads[c];
+      const size_t stop = std::min(valid, (c + 1) * validChunk);
+      for (size_t i = c * validChunk; i < stop; ++i)
+      {
+        occurrences_[i] = records[i].combined;
+        if (i == 0 || !sameKey(records[i], records[i - 1]))
+        {
+          for (size_t j = 0; j < N; ++j)
+            keys_[h][j] = static_cast<index_type>(getBits(records[i], static_cast<int>(N - 1 - j) * bits, bits));
+          offsets_[h++] = static_cast<index_type>(i);
+        }
+      }
+    }
+  }, 1);
+}
+
+}
+
+#endif
@@ -0,0 +1,241 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_DATATYPES_NODEADJACENCY_H
+#define CORE_DATATYPES_NODEADJACENCY_H 1
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <vector>
+#include <boost/unordered_map.hpp>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Thread/Parallel.h>
+
+namespace SCIRun {
+
+/// Per node list of the entries (element occurrences, or neighboring nodes)
+/// that touch it, stored as one offsets array and one entries array instead of
+/// a vector per node. It is built in parallel by a counting sort; within a node
+/// the entries keep the order in which the mesh enumerates them.
+///
+/// Meshes that edit their connectivity after synchronizing (TetVolMesh) can
+/// insert and erase single entries. An edited node gets its own vector, so an
+/// edit costs what it did with a vector per node; the next build folds the
+/// edits back into the flat arrays.
+class NodeAdjacency
+{
+public:
+  /// A view of the entries of one node, valid until the adjacency is edited
+  /// or rebuilt. Values come out shifted right by the shift given to build,
+  /// which turns combined (element, local index) entries into elements.
+  class Span
+  {
+  public:
+    class const_iterator
+    {
+    public:
+      typedef std::random_access_iterator_tag iterator_category;
+      typedef index_type value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef const index_type* pointer;
+      typedef index_type reference;
+
+      const_iterator(const index_type* p, int shift) : p_(p), shift_(shift) {}
+      index_type operator*() const { return *p_ >> shift_; }
+      index_type operator[](difference_type i) const { return p_[i] >> shift_; }
+      const_iterator& operator++() { ++p_; return *this; }
+      const_iterator operator++(int) { const_iterator it(*this); ++p_; return it; }
+      const_iterator& operator--() { --p_; return *this; }
+      const_iterator& operator+=(difference_type i) { p_ += i; return *this; }
+      const_iterator operator+(difference_type i) const { return const_iterator(p_ + i, shift_); }
+      difference_type operator-(const const_iterator& it) const { return p_ - it.p_; }
+      bool operator==(const const_iterator& it) const { return p_ == it.p_; }
+      bool operator!=(const const_iterator& it) const { return p_ != it.p_; }
+      bool operator<(const const_iterator& it) const { return p_ < it.p_; }
+    private:
+      const index_type* p_;
+      int shift_;
+    };
+
+    Span() : begin_(nullptr), end_(nullptr), shift_(0) {}
+    Span(const index_type* begin, const index_type* end, int shift) :
+      begin_(begin), end_(end), shift_(shift) {}
+
+    size_t size() const { return static_cast<size_t>(end_ - begin_); }
+    bool empty() const { return begin_ == end_; }
+    index_type operator[](size_t i) const { return begin_[i] >> shift_; }
+    const_iterator begin() const { return const_iterator(begin_, shift_); }
+    const_iterator end() const { return const_iterator(end_, shift_); }
+
+  private:
+    const index_type* begin_;
+    const index_type* end_;
+    int shift_;
+  };
+
+  NodeAdjacency() : shift_(0) {}
+
+  /// Entry e of numEntries belongs to node nodeOf(e) and stores value(e).
+  /// Entries with a negative node are left out.
+  template <class NodeOf, class ValueOf>
+  void build(size_type numNodes, size_type numEntries,
+             const NodeOf& nodeOf, const ValueOf& value, int shift = 0);
+
+  void clear()
+  {
+    std::vector<index_type>().swap(offsets_);
+    std::vector<index_type>().swap(entries_);
+    edited_.clear();
+  }
+
+  size_type num_nodes() const
+  {
+    return offsets_.empty() ? 0 : static_cast<size_type>(offsets_.size() - 1);
+  }
+
+  /// The stored entries of node n, unshifted.
+  Span entries(index_type n) const { return span(n, 0); }
+  /// The entries of node n shifted by the build shift.
+  Span elems(index_type n) const { return span(n, shift_); }
+
+  size_t size(index_type n) const { return entries(n).size(); }
+
+  /// Append a node without entries, for points added after the build.
+  void add_node()
+  {
+    if (offsets_.empty()) offsets_.push_back(0);
+    offsets_.push_back(offsets_.back());
+  }
+
+  void insert(index_type n, index_type entry) { edit(n).push_back(entry); }
+
+  /// Remove the first occurrence of entry from node n; false if it is not there.
+  bool erase(index_type n, index_type entry)
+  {
+    std::vector<index_type>& list = edit(n);
+    std::vector<index_type>::iterator it = std::find(list.begin(), list.end(), entry);
+    if (it == list.end()) return false;
+    list.erase(it);
+    return true;
+  }
+
+private:
+  typedef boost::unordered_map<index_type, std::vector<index_type> > edit_map;
+
+  Span span(index_type n, int shift) const
+  {
+    if (!edited_.empty())
+    {
+      edit_map::const_iterator it = edited_.find(n);
+      if (it != edited_.end())
+        return it->second.empty() ? Span() :
+          Span(&it->second[0], &it->second[0] + it->second.size(), shift);
+    }
+    const index_type* base = entries_.empty() ? nullptr : &entries_[0];
+    return Span(base + offsets_[n], base + offsets_[n + 1], shift);
+  }
+
+  std::vector<index_type>& edit(index_type n)
+  {
+    edit_map::iterator it = edited_.find(n);
+    if (it == edited_.end())
+      it = edited_.insert(std::make_pair(n, std::vector<index_type>(
+        entries_.begin() + offsets_[n], entries_.begin() + offsets_[n + 1]))).first;
+    return it->second;
+  }
+
+  std::vector<index_type> offsets_;
+  std::vector<index_type> entries_;
+  edit_map edited_;
+  int shift_;
+};
+
+template <class NodeOf, class ValueOf>
+void
+NodeAdjacency::build(size_type numNodes, size_type numEntries,
+                     const NodeOf& nodeOf, const ValueOf& value, int shift)
+{
+  using Core::Thread::Parallel;
+
+  shift_ = shift;
+  edited_.clear();
+  const size_t nodes = static_cast<size_t>(numNodes);
+  const size_t n = static_cast<size_t>(numEntries);
+
+  // count the entries of each node
+  std::vector<std::atomic<index_type> > fill(nodes);
+  Parallel::For(0, n, [&](size_t begin, size_t end)
+  {
+    for (size_t e = begin; e < end; ++e)
+    {
+      const index_type node = nodeOf(static_cast<index_type>(e));
+      if (node >= 0) fill[node].fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+
+  offsets_.resize(nodes + 1);
+  offsets_[0] = 0;
+  for (size_t i = 0; i < nodes; ++i)
+  {
+    offsets_[i + 1] = offsets_[i] + fill[i].load(std::memory_order_relaxed);
+    fill[i].store(offsets_[i], std::memory_order_relaxed);
+  }
+
+  // scatter the entry numbers, then put each node back in enumeration order
+  // and swap in the stored values
+  entries_.resize(offsets_[nodes]);
+  if (entries_.empty())
+    return;
+  Parallel::For(0, n, [&](size_t begin, size_t end)
+  {
+    for (size_t e = begin; e < end; ++e)
+    {
+      const index_type node = nodeOf(static_cast<index_type>(e));
+      if (node >= 0)
+        entries_[fill[node].fetch_add(1, std::memory_order_relaxed)] = static_cast<index_type>(e);
+    }
+  });
+
+  Parallel::For(0, nodes, [&](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      index_type* first = &entries_[0] + offsets_[i];
+      index_type* last = &entries_[0] + offsets_[i + 1];
+      std::sort(first, last);
+      for (index_type* p = first; p != last; ++p)
+        *p = value(*p);
+    }
+  });
+}
+
+}
+
+#endif
@@ -63,6 +63,9 @@ public:
 
   virtual void get_nodes(VMesh::Node::array_type& nodes,
                          VMesh::Elem::index_type i) const;
+
+  virtual void get_elem_nodes(VMesh::Node::fixed_array_type& nodes,
+                              VMesh::Elem::index_type i) const;
   virtual void get_elems(VMesh::Elem::array_type& elems,
                          VMesh::Node::index_type i) const;
 
@@ -237,6 +240,14 @@ VPointCloudMesh<MESH>::get_nodes(VMesh::Node::array_type& nodes,
   nodes.resize(1); nodes[0] = static_cast<VMesh::Node::index_type>(i);
 }
 
+template <class MESH>
+void
+VPointCloudMesh<MESH>::get_elem_nodes(VMesh::Node::fixed_array_type& nodes,
+                                      VMesh::Elem::index_type i) const
+{
+  nodes.resize(1); nodes[0] = static_cast<VMesh::Node::index_type>(i);
+}
+
 template <class MESH>
 void
 VPointCloudMesh<MESH>::get_elems(VMesh::Elem::array_type& elems,
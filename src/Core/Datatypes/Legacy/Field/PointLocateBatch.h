@@ -0,0 +1,241 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_DATATYPES_POINTLOCATEBATCH_H
+#define CORE_DATATYPES_POINTLOCATEBATCH_H 1
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/Thread/Parallel.h>
+
+namespace SCIRun {
+
+/// The order in which to visit a batch of points so that consecutive points
+/// lie close together: ascending Morton (Z curve) code of each point, with the
+/// coordinates quantized to 10 bits per axis over the bounding box of the batch.
+/// Points with the same code keep their input order.
+class MortonOrder
+{
+public:
+  void compute(const std::vector<Core::Geometry::Point>& points);
+
+  size_t size() const { return order_.size(); }
+  /// Input position of the i-th point in Morton order.
+  size_t operator[](size_t i) const { return static_cast<size_t>(order_[i] & IndexMask); }
+
+  /// Interleaves the bits of three 10 bit values, x in the lowest position.
+  static uint32_t code(uint32_t x, uint32_t y, uint32_t z)
+  {
+    return spread(x) | (spread(y) << 1) | (spread(z) << 2);
+  }
+
+private:
+  /// Records hold the code above the input position.
+  static const int IndexBits = 34;
+  static const uint64_t IndexMask = (uint64_t(1) << IndexBits) - 1;
+
+  static uint32_t spread(uint32_t v)
+  {
+    v &= 0x3ff;
+    v = (v | (v << 16)) & 0x030000ff;
+    v = (v | (v << 8)) & 0x0300f00f;
+    v = (v | (v << 4)) & 0x030c30c3;
+    v = (v | (v << 2)) & 0x09249249;
+    return v;
+  }
+
+  std::vector<uint64_t> order_;
+};
+
+inline void
+MortonOrder::compute(const std::vector<Core::Geometry::Point>& points)
+{
+  using namespace Core::Thread;
+
+  const size_t n = points.size();
+  order_.resize(n);
+  if (n == 0) return;
+
+  // Too many points to pack: keep the input order.
+  if (n > IndexMask)
+  {
+    for (size_t i = 0; i < n; ++i) order_[i] = i;
+    return;
+  }
+
+  const size_t numChunks = std::max<size_t>(1, std::min<size_t>(4 * Parallel::NumCores(), n / 16384));
+  const size_t chunkSize = (n + numChunks - 1) / numChunks;
+
+  std::vector<std::array<double, 6> > bounds(numChunks);
+  Parallel::For(0, numChunks, [&](size_t begin, size_t end)
+  {
+    for (size_t c = begin; c < end; ++c)
+    {
+      std::array<double, 6>& b = bounds[c];
+      b = {{ DBL_MAX, DBL_MAX, DBL_MAX, -DBL_MAX, -DBL_MAX, -DBL_MAX }};
+      const size_t last = std::min(n, (c + 1) * chunkSize);
+      for (size_t i = c * chunkSize; i < last; ++i)
+      {
+        for (int k = 0; k < 3; ++k)
+        {
+          b[k] = std::min(b[k], points[i][k]);
+          b[k + 3] = std::max(b[k + 3], points[i][k]);
+        }
+      }
+    }
+  }, 1);
+
+  double lo[3], scale[3];
+  for (int k = 0; k < 3; ++k)
+  {
+    double hi = -DBL_MAX;
+    lo[k] = DBL_MAX;
+    for (size_t c = 0; c < numChunks; ++c)
+    {
+      lo[k] = std::min(lo[k], bounds[c][k]);
+      hi = std::max(hi, bounds[c][k + 3]);
+    }
+    scale[k] = hi > lo[k] ? 1023.0 / (hi - lo[k]) : 0.0;
+  }
+
+  std::vector<uint64_t> sorted(n);
+  Parallel::For(0, n, [&](size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      uint32_t q[3];
+      for (int k = 0; k < 3; ++k)
+      {
+        // written so that NaN coordinates end up in cell 0
+        const double t = (points[i][k] - lo[k]) * scale[k];
+        q[k] = t > 0.0 ? static_cast<uint32_t>(std::min(t, 1023.0)) : 0;
+      }
+      order_[i] = (static_cast<uint64_t>(code(q[0], q[1], q[2])) << IndexBits) | i;
+    }
+  }, 16384);
+
+  // Stable LSD radix sort on the 30 code bits, 8 bits at a time.
+  std::vector<std::array<size_t, 256> > counts(numChunks);
+  for (int shift = IndexBits; shift < 64; shift += 8)
+  {
+    Parallel::For(0, numChunks, [&](size_t begin, size_t end)
+    {
+      for (size_t c = begin; c < end; ++c)
+      {
+        counts[c].fill(0);
+        const size_t last = std::min(n, (c + 1) * chunkSize);
+        for (size_t i = c * chunkSize; i < last; ++i)
+          ++counts[c][(order_[i] >> shift) & 0xff];
+      }
+    }, 1);
+
+    size_t offset = 0;
+    bool uniform = false;
+    for (size_t bucket = 0; bucket < 256; ++bucket)
+    {
+      size_t total = 0;
+      for (size_t c = 0; c < numChunks; ++c)
+      {
+        size_t count = counts[c][bucket];
+        counts[c][bucket] = offset;
+        offset += count;
+        total += count;
+      }
+      if (total == n) uniform = true;
+    }
+    if (uniform)
+      continue;
+
+    Parallel::For(0, numChunks, [&](size_t begin, size_t end)
+    {
+      for (size_t c = begin; c < end; ++c)
+      {
+        const size_t last = std::min(n, (c + 1) * chunkSize);
+        for (size_t i = c * chunkSize; i < last; ++i)
+          sorted[counts[c][(order_[i] >> shift) & 0xff]++] = order_[i];
+      }
+    }, 1);
+    order_.swap(sorted);
+  }
+}
+
+/// Locates a batch of points with locate(elem, coords, point), which follows
+/// the locate_elem contract: elem holds an estimate on entry, which is tested
+/// before the search structure is consulted, and the containing element on a
+/// successful return. The points are visited in MortonOrder and each search
+/// starts from the element of the previous hit, so a query next to the last
+/// one usually costs a single inside test, and the misses walk the search
+/// structure through neighboring bins or subtrees. Chunks of the ordered batch
+/// run in parallel.
+///
+/// elems[i] and (*coords)[i] belong to points[i]. Points that lie in no element
+/// get element -1 and unspecified coordinates. coords may be null.
+template <class INDEX, class ARRAY, class LOCATE>
+void
+locate_point_batch(const std::vector<Core::Geometry::Point>& points,
+                   std::vector<INDEX>& elems,
+                   std::vector<ARRAY>* coords,
+                   const LOCATE& locate)
+{
+  const size_t n = points.size();
+  elems.resize(n);
+  if (coords) coords->resize(n);
+  if (n == 0) return;
+
+  MortonOrder order;
+  order.compute(points);
+
+  Core::Thread::Parallel::For(0, n, [&](size_t begin, size_t end)
+  {
+    INDEX previous(-1);
+    ARRAY c;
+    for (size_t i = begin; i < end; ++i)
+    {
+      const size_t k = order[i];
+      INDEX elem(previous);
+      if (locate(elem, c, points[k]))
+      {
+        previous = elem;
+        elems[k] = elem;
+        if (coords) (*coords)[k] = c;
+      }
+      else
+      {
+        elems[k] = INDEX(-1);
+      }
+    }
+  }, 1024);
+}
+
+}
+
+#endif
@@ -51,6 +51,8 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshTopologySort.h>
+#include <Core/Datatypes/Legacy/Field/NodeAdjacency.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 
 #include <Core/Utils/Legacy/CheckSum.h>
@@ -1833,11 +1835,11 @@ protected:
   {
     ASSERTMSG(synchronized_ & NODE_NEIGHBORS_E,
               "Must call synchronize NODE_NEIGHBORS_E on PrismVolMesh first.");
-    size_t sz = node_neighbors_[node].size();
-    array.resize(sz);
-    for (size_t i=0; i< sz; i++)
+    const NodeAdjacency::Span neighbors = node_neighbors_.entries(node);
+    array.resize(neighbors.size());
+    for (size_t i=0; i< neighbors.size(); i++)
     {
-      array[i] = static_cast<typename ARRAY::value_type>(node_neighbors_[node][i]);
+      array[i] = static_cast<typename ARRAY::value_type>(neighbors[i]);
     }
   }
 
@@ -2497,14 +2499,17 @@ protected:
   std::vector<PEdge>            edges_;
   edge_ht                  edge_table_;
 
-  inline
-  void hash_edge(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Cell::index_type ci, edge_ht &table) const;
-
-  inline
-  void hash_face(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Node::index_type n3, typename Node::index_type n4,
-                 index_type combined_index, face_ht &table) const;
+  /// Faces ordered by order_face_nodes compare equal in either orientation;
+  /// putting the smaller of the two middle nodes second gives one key for both.
+  template <class KEY>
+  static void canonical_face_key(KEY& key)
+  {
+    if (key[2] == key[3])
+    {
+      if (key[1] > key[2]) { std::swap(key[1], key[2]); key[3] = key[2]; }
+    }
+    else if (key[1] > key[3]) std::swap(key[1], key[3]);
+  }
 
   template <class INDEX>
   bool order_face_nodes(INDEX& n1, INDEX& n2, INDEX& n3, INDEX& n4) const
@@ -2558,31 +2563,12 @@ protected:
     return (true);
   }
 
-  /// useful functors
-  struct FillNodeNeighbors {
-    FillNodeNeighbors(std::vector<std::vector<typename Node::index_type> > &n,
-                      const PrismVolMesh &m) :
-      nbor_vec_(n),
-      mesh_(m)
-    {}
-
-    void operator()(typename Edge::index_type e) {
-      mesh_.get_nodes(nodes_, e);
-      nbor_vec_[nodes_[0]].push_back(nodes_[1]);
-      nbor_vec_[nodes_[1]].push_back(nodes_[0]);
-    }
-
-    std::vector<std::vector<typename Node::index_type> > &nbor_vec_;
-    const PrismVolMesh            &mesh_;
-    typename Node::array_type   nodes_;
-  };
-
   /// This grid is used as an acceleration structure to expedite calls
   ///  to locate.  For each cell in the grid, we store a list of which
   ///  tets overlap that grid cell -- to find the tet which contains a
   ///  point, we simply find which grid cell contains that point, and
   ///  then search just those tets that overlap that grid cell.
-  std::vector<std::vector<typename Node::index_type> > node_neighbors_;
+  NodeAdjacency node_neighbors_;
 
   std::vector<unsigned char> boundary_faces_;
   boost::shared_ptr<SearchGridT<index_type> >  node_grid_;
@@ -2887,99 +2873,67 @@ PrismVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 
 template <class Basis>
 void
-PrismVolMesh<Basis>::hash_face(typename Node::index_type n1,
-			       typename Node::index_type n2,
-			       typename Node::index_type n3,
-			       typename Node::index_type n4,
-			       index_type combined_index,
-			       face_ht &table) const
+PrismVolMesh<Basis>::compute_faces()
 {
-  // Reorder nodes while maintaining CCW or CW orientation
-  // Check for degenerate faces, if faces has degeneracy it
-  // will be ignored (e.g. nodes on opposite corners are equal,
-  // or more then two nodes are equal)
-
-  if (!(order_face_nodes(n1,n2,n3,n4))) return;
-  PFace f(n1, n2, n3, n4);
+  // 5 faces -- each is entered CCW from outside looking in
+  static const int face_nodes[5][4] =
+    { {0, 1, 2, -1}, {5, 4, 3, -1}, {1, 4, 5, 2}, {2, 5, 3, 0}, {0, 3, 4, 1} };
+
+  // the triangles are matched node for node, as PFace::operator== does, with
+  // points_.size() standing in for PRISM_DUMMY_NODE_INDEX in the sort key
+  const index_type dummy = static_cast<index_type>(points_.size());
+  SortedTopology<4> topology;
+  topology.compute(static_cast<size_type>(cells_.size() / 6), 5, static_cast<size_type>(points_.size()),
+    [this, dummy](index_type cell, typename SortedTopology<4>::key_type* keys, index_type* combined)
+  {
+    const under_type* n = &cells_[cell * 6];
+    for (int i = 0; i < 5; ++i)
+    {
+      typename SortedTopology<4>::key_type& key = keys[i];
+      key = {{ n[face_nodes[i][0]], n[face_nodes[i][1]], n[face_nodes[i][2]],
+        face_nodes[i][3] < 0 ? dummy : n[face_nodes[i][3]] }};
+      // degenerate faces are ignored
+      if (key[3] != dummy)
+      {
+        if (!order_face_nodes(key[0], key[1], key[2], key[3])) key[0] = -1;
+        else canonical_face_key(key);
+      }
+      combined[i] = (cell << 3) + i;
+    }
+  });
 
-  typename face_ht::iterator iter = table.find(f);
-  if (iter == table.end())
-  {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
+  // dump faces into the faces_ container, with the ordered nodes of the face in its first cell
+  faces_.clear();
+  faces_.resize(topology.size());
+  Core::Thread::Parallel::For(0, topology.size(), [this, &topology](size_t begin, size_t end)
   {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "PrismVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index >> 3)
-           << " are illegally adjacent." << std::endl;*/
-    }
-    else if ((f.cells_[0]>>3) == (combined_index>>3))
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "PrismVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << " and #" << (combined_index>>3)
-           << " are the same." << std::endl;
-           */
-    }
-    else
+    for (size_t f = begin; f < end; ++f)
     {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
+      index_type cell = topology.occurrence(f, 0) >> 3;
+      index_type face = topology.occurrence(f, 0) & 0x7;
+      const under_type* n = &cells_[cell * 6];
+      typename Node::index_type n4 = face_nodes[face][3] < 0 ? PRISM_DUMMY_NODE_INDEX : typename Node::index_type(n[face_nodes[face][3]]);
+      PFace pface(n[face_nodes[face][0]], n[face_nodes[face][1]], n[face_nodes[face][2]], n4);
+      order_face_nodes(pface.nodes_[0], pface.nodes_[1], pface.nodes_[2], pface.nodes_[3]);
+      pface.cells_[0] = topology.occurrence(f, 0);
+      pface.cells_[1] = topology.neighbor(f, 3);
+      faces_[f] = pface;
     }
-  }
-}
+  });
 
-template <class Basis>
-void
-PrismVolMesh<Basis>::compute_faces()
-{
   face_table_.clear();
-
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(6);
-  while (ci != cie)
+  face_table_.reserve(faces_.size());
+  boundary_faces_.assign(cells_.size() / 6, 0);
+  for (size_t f = 0; f < faces_.size(); ++f)
   {
-    get_nodes(arr, *ci);
-    // 5 faces -- each is entered CCW from outside looking in
-    index_type cell_index = (*ci)<<3;
-    hash_face(arr[0], arr[1], arr[2], PRISM_DUMMY_NODE_INDEX, cell_index, face_table_);
-    hash_face(arr[5], arr[4], arr[3], PRISM_DUMMY_NODE_INDEX, cell_index + 1, face_table_);
-    hash_face(arr[1], arr[4], arr[5], arr[2], cell_index + 2, face_table_);
-    hash_face(arr[2], arr[5], arr[3], arr[0], cell_index + 3, face_table_);
-    hash_face(arr[0], arr[3], arr[4], arr[1], cell_index + 4, face_table_);
+    face_table_.emplace(faces_[f], static_cast<typename Face::index_type>(f));
 
-    ++ci;
-  }
-
-  // dump edges into the edges_ container.
-  faces_.resize(face_table_.size());
-  typename std::vector<PFace>::iterator f_iter = faces_.begin();
-  typename face_ht::iterator ht_iter = face_table_.begin();
-
-  boundary_faces_.resize(cells_.size() /6);
-
-  index_type i = 0;
-  while (ht_iter != face_table_.end())
-  {
-    *f_iter = (*ht_iter).first;
-    (*ht_iter).second = i;
-
-    if ((*f_iter).cells_[1] == -1)
+    if (faces_[f].cells_[1] == MESH_NO_NEIGHBOR)
     {
-      index_type cell = ((*f_iter).cells_[0]) >> 3;
-      index_type face = ((*f_iter).cells_[0]) & 0x7;
+      index_type cell = (faces_[f].cells_[0]) >> 3;
+      index_type face = (faces_[f].cells_[0]) & 0x7;
       boundary_faces_[cell] |= 1 << face;
     }
-    ++f_iter; ++ht_iter; i++;
   }
 
   synchronize_lock_.lock();
@@ -2987,66 +2941,47 @@ PrismVolMesh<Basis>::compute_faces()
   synchronize_lock_.unlock();
 }
 
-template <class Basis>
-void
-PrismVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-			       typename Node::index_type n2,
-			       typename Cell::index_type ci,
-			       edge_ht &table) const
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-  if (iter == table.end())
-  {
-    e.cells_.push_back(ci); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(ci); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 PrismVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr;
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    hash_edge(arr[0], arr[1], *ci, edge_table_);
-    hash_edge(arr[1], arr[2], *ci, edge_table_);
-    hash_edge(arr[2], arr[0], *ci, edge_table_);
+  static const int edge_nodes[9][2] =
+    { {0, 1}, {1, 2}, {2, 0}, {3, 4}, {4, 5}, {5, 3}, {0, 3}, {4, 1}, {2, 5} };
 
-    hash_edge(arr[3], arr[4], *ci, edge_table_);
-    hash_edge(arr[4], arr[5], *ci, edge_table_);
-    hash_edge(arr[5], arr[3], *ci, edge_table_);
-
-    hash_edge(arr[0], arr[3], *ci, edge_table_);
-    hash_edge(arr[4], arr[1], *ci, edge_table_);
-    hash_edge(arr[2], arr[5], *ci, edge_table_);
-    ++ci;
-  }
+  SortedTopology<2> topology;
+  topology.compute(static_cast<size_type>(cells_.size() / 6), 9, static_cast<size_type>(points_.size()),
+    [this](index_type cell, typename SortedTopology<2>::key_type* keys, index_type* combined)
+  {
+    const under_type* n = &cells_[cell * 6];
+    for (int i = 0; i < 9; ++i)
+    {
+      keys[i] = {{ n[edge_nodes[i][0]], n[edge_nodes[i][1]] }};
+      SortedTopology<2>::sortNodes(keys[i]);
+      if (keys[i][0] == keys[i][1]) keys[i][0] = -1;
+      combined[i] = cell;
+    }
+  });
 
   // dump edges into the edges_ container.
+  edges_.clear();
+  edges_.resize(topology.size());
+  Core::Thread::Parallel::For(0, topology.size(), [this, &topology](size_t begin, size_t end)
+  {
+    for (size_t e = begin; e < end; ++e)
+    {
+      PEdge& edge = edges_[e];
+      edge.nodes_[0] = topology.key(e)[0];
+      edge.nodes_[1] = topology.key(e)[1];
+      edge.cells_.resize(topology.count(e));
+      for (size_t j = 0; j < topology.count(e); ++j)
+        edge.cells_[j] = topology.occurrence(e, j);
+    }
+  });
 
-  edges_.resize(edge_table_.size());
-
-  typename std::vector<PEdge>::iterator e_iter = edges_.begin();
-  typename edge_ht::iterator ht_iter = edge_table_.begin();
-  while (ht_iter != edge_table_.end()) {
-    *e_iter = (*ht_iter).first;
-    (*ht_iter).second = static_cast<typename Edge::index_type>(
-                                                      e_iter - edges_.begin());
-    ++e_iter; ++ht_iter;
-  }
+  edge_table_.clear();
+  edge_table_.reserve(edges_.size());
+  for (size_t e = 0; e < edges_.size(); ++e)
+    edge_table_.emplace(edges_[e], static_cast<typename Edge::index_type>(e));
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::EDGES_E;
@@ -3338,11 +3273,10 @@ template <class Basis>
 void
 PrismVolMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  typename Edge::iterator ei, eie;
-  begin(ei); end(eie);
-  std::for_each(ei, eie, FillNodeNeighbors(node_neighbors_, *this));
+  // entry i is end i%2 of edge i/2 and stores the other end
+  node_neighbors_.build(points_.size(), 2 * edges_.size(),
+    [this](index_type i) { return static_cast<index_type>(edges_[i >> 1].nodes_[i & 1]); },
+    [this](index_type i) { return static_cast<index_type>(edges_[i >> 1].nodes_[1 - (i & 1)]); });
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
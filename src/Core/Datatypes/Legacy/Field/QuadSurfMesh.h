@@ -50,6 +50,7 @@
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
+#include <Core/Datatypes/Legacy/Field/NodeAdjacency.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Mesh/VirtualMeshFacade.h>
 
@@ -470,6 +471,14 @@ public:
   void get_elems(typename Elem::array_type &array,
                  typename Node::index_type idx) const
   { get_faces_from_node(array,idx); }
+  /// The faces around node idx without copying them; valid until the mesh
+  /// or its NODE_NEIGHBORS_E synchronization changes.
+  NodeAdjacency::Span get_elems_span(typename Node::index_type idx) const
+  {
+    ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
+	      "QuadSurfMesh: Must call synchronize NODE_NEIGHBORS_E on QuadSurfMesh first");
+    return node_neighbors_.elems(idx);
+  }
   void get_elems(typename Elem::array_type &array,
                  typename Edge::index_type idx) const
   { get_faces_from_edge(array,idx); }
@@ -1713,9 +1722,10 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
 	      "QuadSurfMesh: Must call synchronize NODE_NEIGHBORS_E on QuadSurfMesh first");
 
-    array.resize(node_neighbors_[idx].size());
-    for (size_t i = 0; i < node_neighbors_[idx].size(); ++i)
-      array[i] = static_cast<typename ARRAY::value_type>(node_neighbors_[idx][i]);
+    const NodeAdjacency::Span faces = node_neighbors_.elems(idx);
+    array.resize(faces.size());
+    for (size_t i = 0; i < faces.size(); ++i)
+      array[i] = static_cast<typename ARRAY::value_type>(faces[i]);
   }
 
 
@@ -1751,7 +1761,7 @@ protected:
     // Get the table of faces that are connected to the two nodes
     Core::Thread::Guard nn(synchronize_lock_.get());
 
-    const std::vector<typename Face::index_type>& faces  = node_neighbors_[idx];
+    const NodeAdjacency::Span faces = node_neighbors_.elems(idx);
     array.clear();
 
     typename ARRAY::value_type edge;
@@ -1855,7 +1865,7 @@ protected:
 
     // Get all the neighboring elements
     typename Node::array_type nodes;
-    const std::vector<typename Face::index_type>& faces  = node_neighbors_[idx];
+    const NodeAdjacency::Span faces = node_neighbors_.elems(idx);
     // Make a conservative estimate of the number of node neighbors
     array.reserve(2*faces.size());
 
@@ -2250,8 +2260,7 @@ protected:
   /// array with information from halfedge (computed directly from face) to the edge number
   std::vector<index_type>                    halfedge_to_edge_;  // halfedge->edge map
 
-  typedef std::vector<std::vector<typename Elem::index_type> > NodeNeighborMap;
-  NodeNeighborMap                       node_neighbors_;
+  NodeAdjacency                         node_neighbors_;
 
   std::vector<Core::Geometry::Vector>                           normals_; /// normalized per node
   boost::shared_ptr<SearchGridT<index_type> >  node_grid_; /// Lookup grid for nodes
@@ -2923,13 +2932,9 @@ template <class Basis>
 void
 QuadSurfMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  index_type i, num_elems = static_cast<index_type>(faces_.size());
-  for (i = 0; i < num_elems; i++)
-  {
-    node_neighbors_[faces_[i]].push_back(i/4);
-  }
+  node_neighbors_.build(points_.size(), faces_.size(),
+    [this](index_type i) { return static_cast<index_type>(faces_[i]); },
+    [](index_type i) { return i / 4; });
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
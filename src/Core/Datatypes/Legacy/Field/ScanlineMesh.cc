@@ -108,6 +108,13 @@ public:
   virtual void get_delems(VMesh::DElem::array_type& delems,
                           VMesh::Elem::index_type i) const;
 
+  virtual void get_elem_nodes(VMesh::Node::fixed_array_type& nodes,
+                              VMesh::Elem::index_type i) const;
+  virtual void get_elem_edges(VMesh::Edge::fixed_array_type& edges,
+                              VMesh::Elem::index_type i) const;
+  virtual void get_elem_delems(VMesh::DElem::fixed_array_type& delems,
+                               VMesh::Elem::index_type i) const;
+
   /// Get the center of a certain mesh element
   virtual void get_center(Point &point, VMesh::Node::index_type i) const;
   virtual void get_center(Point &point, VMesh::ENode::index_type i) const;
@@ -567,6 +574,30 @@ VScanlineMesh<MESH>::get_delems(VMesh::DElem::array_type &array,
   get_nodes_from_edge(array,idx);
 }
 
+template <class MESH>
+void
+VScanlineMesh<MESH>::get_elem_nodes(VMesh::Node::fixed_array_type &array,
+                                    VMesh::Elem::index_type idx) const
+{
+  get_nodes_from_edge(array,idx);
+}
+
+template <class MESH>
+void
+VScanlineMesh<MESH>::get_elem_edges(VMesh::Edge::fixed_array_type &array,
+                                    VMesh::Elem::index_type idx) const
+{
+  array.resize(1); array[0] = VMesh::Edge::index_type(idx);
+}
+
+template <class MESH>
+void
+VScanlineMesh<MESH>::get_elem_delems(VMesh::DElem::fixed_array_type &array,
+                                     VMesh::Elem::index_type idx) const
+{
+  get_nodes_from_edge(array,idx);
+}
+
 template <class MESH>
 void
 VScanlineMesh<MESH>::get_delems(VMesh::DElem::array_type &array,
@@ -0,0 +1,224 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Testing/Utils/SCIRunFieldSamples.h>
+
+#include <Core/Datatypes/Legacy/Field/BoundingVolumeHierarchy.h>
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <gtest/gtest.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  // boxes whose sizes span four orders of magnitude, like a graded mesh
+  std::vector<BBox> gradedBoxes(size_t count, unsigned seed)
+  {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<BBox> boxes(count);
+    for (auto& b : boxes)
+    {
+      const Point c(unit(rng), unit(rng), unit(rng));
+      const double size = std::pow(10.0, -1.0 - 3.0 * unit(rng));
+      b.extend(c);
+      b.extend(c + Vector(size * unit(rng), size * unit(rng), size * unit(rng)));
+    }
+    return boxes;
+  }
+
+  BoundingVolumeHierarchy buildOver(const std::vector<BBox>& boxes)
+  {
+    BoundingVolumeHierarchy bvh;
+    bvh.build(boxes.size(), [&boxes](index_type i, BBox& b) { b.extend(boxes[i]); }, 0.0);
+    return bvh;
+  }
+
+  bool inside(const BBox& b, const Point& p)
+  {
+    return b.get_min().x() <= p.x() && p.x() <= b.get_max().x() &&
+      b.get_min().y() <= p.y() && p.y() <= b.get_max().y() &&
+      b.get_min().z() <= p.z() && p.z() <= b.get_max().z();
+  }
+
+  double distance2(const BBox& b, const Point& p)
+  {
+    double d2 = 0.0;
+    for (int d = 0; d < 3; ++d)
+    {
+      const double v = std::max(std::max(b.get_min()[d] - p[d], p[d] - b.get_max()[d]), 0.0);
+      d2 += v * v;
+    }
+    return d2;
+  }
+}
+
+TEST(BoundingVolumeHierarchyTest, LocateFindsEveryContainingBox)
+{
+  const std::vector<BBox> boxes = gradedBoxes(20000, 5);
+  BoundingVolumeHierarchy bvh = buildOver(boxes);
+
+  std::mt19937 rng(6);
+  std::uniform_real_distribution<double> unit(-0.1, 1.1);
+  for (int q = 0; q < 2000; ++q)
+  {
+    const Point p(unit(rng), unit(rng), unit(rng));
+    std::vector<index_type> found;
+    bvh.locate(p, [&found](index_type i) { found.push_back(i); return false; });
+    std::sort(found.begin(), found.end());
+
+    std::vector<index_type> expected;
+    for (size_t i = 0; i < boxes.size(); ++i)
+      if (inside(boxes[i], p)) expected.push_back(i);
+    EXPECT_EQ(expected, found);
+  }
+}
+
+TEST(BoundingVolumeHierarchyTest, LocateStopsAtFirstAcceptedBox)
+{
+  std::vector<BBox> boxes(3, BBox(Point(0, 0, 0), Point(1, 1, 1)));
+  BoundingVolumeHierarchy bvh = buildOver(boxes);
+
+  int visits = 0;
+  EXPECT_TRUE(bvh.locate(Point(0.5, 0.5, 0.5), [&visits](index_type) { ++visits; return true; }));
+  EXPECT_EQ(1, visits);
+  EXPECT_FALSE(bvh.locate(Point(2, 2, 2), [](index_type) { return true; }));
+}
+
+TEST(BoundingVolumeHierarchyTest, OverlapFindsEveryOverlappingBox)
+{
+  const std::vector<BBox> boxes = gradedBoxes(20000, 7);
+  BoundingVolumeHierarchy bvh = buildOver(boxes);
+
+  std::mt19937 rng(8);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  for (int q = 0; q < 200; ++q)
+  {
+    const Point c(unit(rng), unit(rng), unit(rng));
+    const BBox query(c, c + Vector(0.05, 0.05, 0.05) * unit(rng));
+    std::vector<index_type> found;
+    bvh.overlap(query, [&found](index_type i) { found.push_back(i); });
+    std::sort(found.begin(), found.end());
+
+    std::vector<index_type> expected;
+    for (size_t i = 0; i < boxes.size(); ++i)
+      if (boxes[i].overlaps(query)) expected.push_back(i);
+    EXPECT_EQ(expected, found);
+  }
+}
+
+TEST(BoundingVolumeHierarchyTest, ClosestMatchesBruteForce)
+{
+  const std::vector<BBox> boxes = gradedBoxes(20000, 9);
+  BoundingVolumeHierarchy bvh = buildOver(boxes);
+
+  std::mt19937 rng(10);
+  std::uniform_real_distribution<double> unit(-1.0, 2.0);
+  for (int q = 0; q < 500; ++q)
+  {
+    const Point p(unit(rng), unit(rng), unit(rng));
+    double dmin2 = DBL_MAX;
+    bvh.closest(p, dmin2, [&](index_type i, double& d2)
+    {
+      d2 = std::min(d2, distance2(boxes[i], p));
+      return false;
+    });
+
+    double expected = DBL_MAX;
+    for (const auto& b : boxes)
+      expected = std::min(expected, distance2(b, p));
+    EXPECT_DOUBLE_EQ(expected, dmin2);
+  }
+}
+
+TEST(BoundingVolumeHierarchyTest, InsertAndRemoveAfterBuild)
+{
+  std::vector<BBox> boxes(10);
+  for (int i = 0; i < 10; ++i)
+    boxes[i] = BBox(Point(i, 0, 0), Point(i + 1, 1, 1));
+  BoundingVolumeHierarchy bvh = buildOver(boxes);
+
+  auto at = [&bvh](const Point& p)
+  {
+    std::vector<index_type> found;
+    bvh.locate(p, [&found](index_type i) { found.push_back(i); return false; });
+    std::sort(found.begin(), found.end());
+    return found;
+  };
+
+  bvh.remove(3);
+  EXPECT_TRUE(at(Point(3.5, 0.5, 0.5)).empty());
+
+  // a removed primitive can come back with new geometry
+  bvh.insert(3, BBox(Point(20, 0, 0), Point(21, 1, 1)));
+  bvh.insert(10, BBox(Point(3, 0, 0), Point(4, 1, 1)));
+  EXPECT_EQ((std::vector<index_type>{ 10 }), at(Point(3.5, 0.5, 0.5)));
+  EXPECT_EQ((std::vector<index_type>{ 3 }), at(Point(20.5, 0.5, 0.5)));
+
+  bvh.remove(10);
+  EXPECT_TRUE(at(Point(3.5, 0.5, 0.5)).empty());
+  EXPECT_EQ((std::vector<index_type>{ 5 }), at(Point(5.5, 0.5, 0.5)));
+}
+
+TEST(BoundingVolumeHierarchyTest, TetVolMeshLocatesLikeSearchGrid)
+{
+  FieldHandle gridField = CubeTetVolLinearBasis(DOUBLE_E);
+  FieldHandle bvhField = CubeTetVolLinearBasis(DOUBLE_E);
+  VMesh* gridMesh = gridField->vmesh();
+  VMesh* bvhMesh = bvhField->vmesh();
+  gridMesh->synchronize(Mesh::ELEM_LOCATE_E | Mesh::FIND_CLOSEST_ELEM_E);
+  bvhMesh->synchronize(Mesh::ELEM_LOCATE_BVH_E | Mesh::FIND_CLOSEST_ELEM_E);
+
+  std::mt19937 rng(11);
+  std::uniform_real_distribution<double> unit(-1.5, 1.5);
+  for (int q = 0; q < 1000; ++q)
+  {
+    const Point p(unit(rng), unit(rng), unit(rng));
+    VMesh::Elem::index_type gridElem, bvhElem;
+    const bool inGrid = gridMesh->locate(gridElem, p);
+    EXPECT_EQ(inGrid, bvhMesh->locate(bvhElem, p));
+    if (inGrid)
+      EXPECT_EQ(gridElem, bvhElem);
+
+    double gridDist, bvhDist;
+    Point gridResult, bvhResult;
+    VMesh::coords_type coords;
+    ASSERT_TRUE(gridMesh->find_closest_elem(gridDist, gridResult, coords, gridElem, p));
+    ASSERT_TRUE(bvhMesh->find_closest_elem(bvhDist, bvhResult, coords, bvhElem, p));
+    EXPECT_NEAR(gridDist, bvhDist, 1e-12);
+  }
+}
@@ -0,0 +1,193 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/GeometryPrimitives/Transform.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+#include <boost/timer.hpp>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  FieldHandle tetWithValues()
+  {
+    FieldHandle field = TetrahedronTetVolLinearBasis(DOUBLE_E);
+    std::vector<double> values { 1, 2, 3, 4 };
+    field->vfield()->set_values(values);
+    return field;
+  }
+
+  std::vector<double> valuesOf(FieldHandle field)
+  {
+    std::vector<double> values;
+    field->vfield()->get_values(values);
+    return values;
+  }
+}
+
+TEST(FieldCopyOnWriteTests, CloneSharesValuesUntilWrite)
+{
+  auto original = tetWithValues();
+  FieldHandle copy(original->clone());
+
+  EXPECT_TRUE(original->vfield()->values_shared());
+  EXPECT_TRUE(copy->vfield()->values_shared());
+  EXPECT_EQ(valuesOf(original), valuesOf(copy));
+  EXPECT_TRUE(copy->vfield()->values_shared());
+
+  copy->vfield()->set_value(10.0, VMesh::index_type(2));
+  EXPECT_FALSE(copy->vfield()->values_shared());
+  EXPECT_EQ(std::vector<double>({ 1, 2, 10, 4 }), valuesOf(copy));
+  EXPECT_EQ(std::vector<double>({ 1, 2, 3, 4 }), valuesOf(original));
+
+  original->vfield()->set_value(-1.0, VMesh::index_type(0));
+  EXPECT_FALSE(original->vfield()->values_shared());
+  EXPECT_EQ(std::vector<double>({ -1, 2, 3, 4 }), valuesOf(original));
+  EXPECT_EQ(std::vector<double>({ 1, 2, 10, 4 }), valuesOf(copy));
+}
+
+TEST(FieldCopyOnWriteTests, WritingTheOriginalLeavesTheCloneIntact)
+{
+  auto original = tetWithValues();
+  FieldHandle copy(original->clone());
+
+  original->vfield()->clear_all_values();
+  EXPECT_EQ(std::vector<double>({ 0, 0, 0, 0 }), valuesOf(original));
+  EXPECT_EQ(std::vector<double>({ 1, 2, 3, 4 }), valuesOf(copy));
+}
+
+TEST(FieldCopyOnWriteTests, RawValuePointerAccessDetaches)
+{
+  auto original = tetWithValues();
+  FieldHandle copy(original->clone());
+
+  auto data = static_cast<double*>(copy->vfield()->get_values_pointer());
+  data[1] = 20;
+  EXPECT_EQ(std::vector<double>({ 1, 20, 3, 4 }), valuesOf(copy));
+  EXPECT_EQ(std::vector<double>({ 1, 2, 3, 4 }), valuesOf(original));
+}
+
+TEST(FieldCopyOnWriteTests, ReadOnlyValuePointerKeepsValuesShared)
+{
+  auto original = tetWithValues();
+  FieldHandle copy(original->clone());
+
+  auto data = static_cast<const double*>(copy->vfield()->get_const_values_pointer());
+  EXPECT_EQ(original->vfield()->get_const_values_pointer(), data);
+  EXPECT_EQ(3, data[2]);
+  EXPECT_TRUE(copy->vfield()->values_shared());
+}
+
+TEST(FieldCopyOnWriteTests, OnlyTheFirstWriterCopies)
+{
+  auto original = tetWithValues();
+  FieldHandle copy(original->clone());
+  auto shared = original->vfield()->get_const_values_pointer();
+
+  copy->vfield()->set_value(10.0, VMesh::index_type(2));
+  EXPECT_NE(shared, copy->vfield()->get_const_values_pointer());
+
+  // the copy let go of the original values, so the original writes in place
+  original->vfield()->set_value(-1.0, VMesh::index_type(0));
+  EXPECT_EQ(shared, original->vfield()->get_const_values_pointer());
+  EXPECT_FALSE(original->vfield()->values_shared());
+  EXPECT_EQ(std::vector<double>({ -1, 2, 3, 4 }), valuesOf(original));
+  EXPECT_EQ(std::vector<double>({ 1, 2, 10, 4 }), valuesOf(copy));
+}
+
+TEST(FieldCopyOnWriteTests, DeepCloneCopiesMeshButSharesValues)
+{
+  auto original = tetWithValues();
+  FieldHandle copy(original->deep_clone());
+
+  EXPECT_NE(original->mesh(), copy->mesh());
+  EXPECT_TRUE(copy->vfield()->values_shared());
+
+  Transform shift;
+  shift.pre_translate(Vector(1, 0, 0));
+  copy->vmesh()->transform(shift);
+  Point p;
+  original->vmesh()->get_center(p, VMesh::Node::index_type(0));
+  Point q;
+  copy->vmesh()->get_center(q, VMesh::Node::index_type(0));
+  EXPECT_EQ(p + Vector(1, 0, 0), q);
+  EXPECT_EQ(valuesOf(original), valuesOf(copy));
+}
+
+TEST(FieldCopyOnWriteTests, StructuredFieldValues)
+{
+  auto original = CreateEmptyLatVol(3, 3, 3);
+  original->vfield()->set_all_values(1.0);
+  FieldHandle copy(original->clone());
+
+  copy->vfield()->set_value(5.0, VMesh::index_type(13));
+  double value;
+  original->vfield()->get_value(value, VMesh::index_type(13));
+  EXPECT_EQ(1.0, value);
+  copy->vfield()->get_value(value, VMesh::index_type(13));
+  EXPECT_EQ(5.0, value);
+}
+
+// Stages that clone their input but leave its values alone (such as the mesh-only
+// algorithms, which deep clone) never copy the values. Reports the time against
+// stages that each write one value and so take a full copy.
+TEST(FieldCopyOnWriteTests, ChainOfValuePreservingClonesSharesValues)
+{
+  const int size = 64, stages = 10;
+  auto field = CreateEmptyLatVol(size, size, size);
+  field->vfield()->set_all_values(1.0);
+  const auto valueBytes = field->vfield()->num_values() * sizeof(double);
+
+  boost::timer timer;
+  std::vector<FieldHandle> chain { field };
+  for (int i = 0; i < stages; ++i)
+    chain.emplace_back(chain.back()->clone());
+  const auto sharedTime = timer.elapsed();
+
+  timer.restart();
+  std::vector<FieldHandle> eager { field };
+  for (int i = 0; i < stages; ++i)
+  {
+    eager.emplace_back(eager.back()->clone());
+    eager.back()->vfield()->set_value(0.0, VMesh::index_type(0));
+  }
+  const auto copyTime = timer.elapsed();
+
+  for (const auto& stage : chain)
+    EXPECT_TRUE(stage->vfield()->values_shared());
+  std::cout << stages << " stages over " << valueBytes << " bytes of values: shared " << sharedTime
+    << " s, copied " << copyTime << " s (" << stages * valueBytes << " bytes)" << std::endl;
+}
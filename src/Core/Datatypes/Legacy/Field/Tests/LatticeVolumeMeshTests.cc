@@ -240,3 +240,38 @@ TEST_F(LatticeVolumeMeshTests, CubeIterationTest)
       ostr.str());
   }
 }
+
+TEST_F(LatticeVolumeMeshTests, FixedArrayElemAccessorsMatchVectorAccessors)
+{
+  FieldInformation lfi("LatVolMesh", 1, "double");
+  MeshHandle mesh = CreateMesh(lfi, 3, 4, 5, Point(0,0,0), Point(1,1,1));
+  auto vmesh = mesh->vmesh();
+
+  for (VMesh::Elem::index_type e = 0; e < vmesh->num_elems(); ++e)
+  {
+    VMesh::Node::array_type nodes;
+    VMesh::Node::fixed_array_type fixedNodes;
+    vmesh->get_nodes(nodes, e);
+    vmesh->get_elem_nodes(fixedNodes, e);
+    ASSERT_EQ(nodes.size(), fixedNodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+      EXPECT_EQ(nodes[i], fixedNodes[i]);
+
+    VMesh::Edge::array_type edges;
+    VMesh::Edge::fixed_array_type fixedEdges;
+    vmesh->get_edges(edges, e);
+    vmesh->get_elem_edges(fixedEdges, e);
+    ASSERT_EQ(12, edges.size());
+    ASSERT_EQ(edges.size(), fixedEdges.size());
+    for (size_t i = 0; i < edges.size(); ++i)
+      EXPECT_EQ(edges[i], fixedEdges[i]);
+
+    VMesh::Face::array_type faces;
+    VMesh::Face::fixed_array_type fixedFaces;
+    vmesh->get_faces(faces, e);
+    vmesh->get_elem_faces(fixedFaces, e);
+    ASSERT_EQ(faces.size(), fixedFaces.size());
+    for (size_t i = 0; i < faces.size(); ++i)
+      EXPECT_EQ(faces[i], fixedFaces[i]);
+  }
+}
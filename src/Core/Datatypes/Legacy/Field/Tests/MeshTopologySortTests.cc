@@ -0,0 +1,162 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Testing/Utils/SCIRunFieldSamples.h>
+
+#include <Core/Datatypes/Legacy/Field/MeshTopologySort.h>
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Thread/Parallel.h>
+
+#include <random>
+#include <gtest/gtest.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  typedef std::array<index_type, 4> Tet;
+
+  void tetFaces(const std::vector<Tet>& tets, SortedTopology<3>& topology, size_type numNodes)
+  {
+    topology.compute(static_cast<size_type>(tets.size()), 4, numNodes,
+      [&tets](index_type cell, SortedTopology<3>::key_type* keys, index_type* combined)
+    {
+      const Tet& n = tets[cell];
+      keys[0] = {{ n[0], n[2], n[1] }};
+      keys[1] = {{ n[1], n[2], n[3] }};
+      keys[2] = {{ n[0], n[1], n[3] }};
+      keys[3] = {{ n[0], n[3], n[2] }};
+      for (int i = 0; i < 4; ++i)
+      {
+        SortedTopology<3>::sortNodes(keys[i]);
+        combined[i] = (cell << 2) + i;
+      }
+    });
+  }
+}
+
+TEST(MeshTopologySortTest, TwoTetsShareOneFace)
+{
+  std::vector<Tet> tets { {{ 0, 1, 2, 3 }}, {{ 4, 2, 1, 3 }} };
+  SortedTopology<3> topology;
+  tetFaces(tets, topology, 5);
+
+  ASSERT_EQ(7, topology.size());
+  size_t boundary = 0;
+  for (size_t f = 0; f < topology.size(); ++f)
+  {
+    if (f > 0)
+      EXPECT_LT(topology.key(f - 1), topology.key(f));
+    if (topology.boundary(f))
+    {
+      ++boundary;
+      EXPECT_EQ(-1, topology.neighbor(f, 2));
+    }
+    else
+    {
+      EXPECT_EQ((SortedTopology<3>::key_type{{ 1, 2, 3 }}), topology.key(f));
+      EXPECT_EQ(1, topology.occurrence(f, 0));
+      EXPECT_EQ((1 << 2) + 1, topology.neighbor(f, 2));
+    }
+  }
+  EXPECT_EQ(6, boundary);
+}
+
+TEST(MeshTopologySortTest, SkipsEntriesMarkedNegative)
+{
+  SortedTopology<2> topology;
+  topology.compute(2, 2, 3, [](index_type elem, SortedTopology<2>::key_type* keys, index_type* combined)
+  {
+    keys[0] = {{ 0, 1 + elem }};
+    keys[1] = {{ -1, 0 }};
+    combined[0] = 2 * elem;
+    combined[1] = 2 * elem + 1;
+  });
+
+  ASSERT_EQ(2, topology.size());
+  EXPECT_EQ((SortedTopology<2>::key_type{{ 0, 1 }}), topology.key(0));
+  EXPECT_EQ((SortedTopology<2>::key_type{{ 0, 2 }}), topology.key(1));
+  EXPECT_EQ(2, topology.occurrence(1, 0));
+}
+
+TEST(MeshTopologySortTest, ResultDoesNotDependOnThreadCount)
+{
+  std::mt19937 rng(7);
+  const size_type numNodes = 5000;
+  std::vector<Tet> tets(100000);
+  for (auto& t : tets)
+    for (auto& n : t)
+      n = rng() % numNodes;
+
+  SortedTopology<3> serial, parallel;
+  Parallel::SetMaximumCores(1);
+  tetFaces(tets, serial, numNodes);
+  Parallel::SetMaximumCores(0);
+  tetFaces(tets, parallel, numNodes);
+
+  ASSERT_EQ(serial.size(), parallel.size());
+  size_t occurrences = 0;
+  for (size_t f = 0; f < serial.size(); ++f)
+  {
+    ASSERT_EQ(serial.key(f), parallel.key(f));
+    ASSERT_EQ(serial.count(f), parallel.count(f));
+    for (size_t j = 0; j < serial.count(f); ++j)
+    {
+      ASSERT_EQ(serial.occurrence(f, j), parallel.occurrence(f, j));
+      if (j > 0)
+        EXPECT_LT(serial.occurrence(f, j - 1), serial.occurrence(f, j));
+    }
+    occurrences += serial.count(f);
+  }
+  EXPECT_EQ(4 * tets.size(), occurrences);
+}
+
+TEST(MeshTopologySortTest, CubeTetVolFacesAndEdges)
+{
+  FieldHandle field = CubeTetVolLinearBasis(NONE_E);
+  VMesh* mesh = field->vmesh();
+  mesh->synchronize(Mesh::FACES_E | Mesh::EDGES_E | Mesh::ELEM_NEIGHBORS_E);
+
+  // 6 tets filling a cube without interior nodes: F = 2T + 6, E = V + F - T - 1
+  EXPECT_EQ(18, mesh->num_faces());
+  EXPECT_EQ(19, mesh->num_edges());
+
+  size_t boundaryFaces = 0;
+  VMesh::Elem::array_type neighbors;
+  for (VMesh::Elem::index_type e = 0; e < mesh->num_elems(); ++e)
+  {
+    mesh->get_neighbors(neighbors, e);
+    boundaryFaces += 4 - neighbors.size();
+  }
+  EXPECT_EQ(12, boundaryFaces);
+}
@@ -0,0 +1,150 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+
+#include <Testing/Utils/SCIRunFieldSamples.h>
+
+#include <Core/Datatypes/Legacy/Field/NodeAdjacency.h>
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Thread/Parallel.h>
+
+#include <algorithm>
+#include <random>
+#include <gtest/gtest.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  std::vector<index_type> spanValues(const NodeAdjacency::Span& span)
+  {
+    return std::vector<index_type>(span.begin(), span.end());
+  }
+}
+
+TEST(NodeAdjacencyTest, MatchesVectorPerNode)
+{
+  std::mt19937 rng(3);
+  const size_type numNodes = 2000;
+  std::vector<index_type> cells(4 * 50000);
+  for (auto& n : cells)
+    n = rng() % numNodes;
+
+  std::vector<std::vector<index_type> > expected(numNodes);
+  for (size_t i = 0; i < cells.size(); ++i)
+    expected[cells[i]].push_back(static_cast<index_type>(i));
+
+  for (unsigned int cores : { 1u, 0u })
+  {
+    Parallel::SetMaximumCores(cores);
+    NodeAdjacency adjacency;
+    adjacency.build(numNodes, cells.size(),
+      [&cells](index_type i) { return cells[i]; },
+      [](index_type i) { return i; }, 2);
+
+    ASSERT_EQ(numNodes, adjacency.num_nodes());
+    for (index_type n = 0; n < numNodes; ++n)
+    {
+      ASSERT_EQ(expected[n], spanValues(adjacency.entries(n)));
+      const NodeAdjacency::Span elems = adjacency.elems(n);
+      ASSERT_EQ(expected[n].size(), elems.size());
+      for (size_t j = 0; j < elems.size(); ++j)
+        EXPECT_EQ(expected[n][j] >> 2, elems[j]);
+    }
+  }
+  Parallel::SetMaximumCores(0);
+}
+
+TEST(NodeAdjacencyTest, SkipsNegativeNodes)
+{
+  std::vector<index_type> nodes { 1, -1, 0, 1, -1 };
+  NodeAdjacency adjacency;
+  adjacency.build(3, nodes.size(),
+    [&nodes](index_type i) { return nodes[i]; },
+    [](index_type i) { return 10 * i; });
+
+  EXPECT_EQ((std::vector<index_type>{ 20 }), spanValues(adjacency.entries(0)));
+  EXPECT_EQ((std::vector<index_type>{ 0, 30 }), spanValues(adjacency.entries(1)));
+  EXPECT_TRUE(adjacency.entries(2).empty());
+}
+
+TEST(NodeAdjacencyTest, EditsAfterBuild)
+{
+  std::vector<index_type> nodes { 0, 1, 1, 0 };
+  NodeAdjacency adjacency;
+  adjacency.build(2, nodes.size(),
+    [&nodes](index_type i) { return nodes[i]; },
+    [](index_type i) { return i; });
+
+  adjacency.add_node();
+  ASSERT_EQ(3, adjacency.num_nodes());
+  EXPECT_TRUE(adjacency.entries(2).empty());
+
+  adjacency.insert(2, 7);
+  adjacency.insert(0, 8);
+  EXPECT_TRUE(adjacency.erase(1, 1));
+  EXPECT_FALSE(adjacency.erase(1, 1));
+
+  EXPECT_EQ((std::vector<index_type>{ 0, 3, 8 }), spanValues(adjacency.entries(0)));
+  EXPECT_EQ((std::vector<index_type>{ 2 }), spanValues(adjacency.entries(1)));
+  EXPECT_EQ((std::vector<index_type>{ 7 }), spanValues(adjacency.entries(2)));
+
+  // a rebuild drops the edits
+  adjacency.build(2, nodes.size(),
+    [&nodes](index_type i) { return nodes[i]; },
+    [](index_type i) { return i; });
+  EXPECT_EQ((std::vector<index_type>{ 1, 2 }), spanValues(adjacency.entries(1)));
+}
+
+TEST(NodeAdjacencyTest, CubeTetVolElemsAroundNodes)
+{
+  FieldHandle field = CubeTetVolLinearBasis(NONE_E);
+  VMesh* mesh = field->vmesh();
+  mesh->synchronize(Mesh::NODE_NEIGHBORS_E);
+
+  size_t total = 0;
+  VMesh::Elem::array_type elems;
+  VMesh::Node::array_type elemNodes;
+  for (VMesh::Node::index_type n = 0; n < mesh->num_nodes(); ++n)
+  {
+    mesh->get_elems(elems, n);
+    EXPECT_FALSE(elems.empty());
+    for (size_t i = 0; i < elems.size(); ++i)
+    {
+      mesh->get_nodes(elemNodes, elems[i]);
+      EXPECT_NE(elemNodes.end(), std::find(elemNodes.begin(), elemNodes.end(), n));
+    }
+    total += elems.size();
+  }
+  EXPECT_EQ(4 * mesh->num_elems(), total);
+}
@@ -0,0 +1,177 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Testing/Utils/SCIRunFieldSamples.h>
+
+#include <Core/Datatypes/Legacy/Field/PointLocateBatch.h>
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+
+#include <algorithm>
+#include <random>
+#include <gtest/gtest.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  std::vector<Point> randomPoints(size_t count, double lo, double hi, unsigned seed)
+  {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(lo, hi);
+    std::vector<Point> points(count);
+    for (auto& p : points)
+      p = Point(unit(rng), unit(rng), unit(rng));
+    return points;
+  }
+
+  void expectLocatesLikeSinglePoints(VMesh* mesh, const std::vector<Point>& points)
+  {
+    std::vector<VMesh::Elem::index_type> elems;
+    std::vector<VMesh::coords_type> coords;
+    mesh->locate_points(points, elems, coords);
+    ASSERT_EQ(points.size(), elems.size());
+    ASSERT_EQ(points.size(), coords.size());
+
+    for (size_t k = 0; k < points.size(); ++k)
+    {
+      VMesh::Elem::index_type elem;
+      VMesh::coords_type expected;
+      if (mesh->locate(elem, points[k]))
+      {
+        EXPECT_EQ(elem, elems[k]);
+        mesh->get_coords(expected, points[k], elem);
+        ASSERT_EQ(expected.size(), coords[k].size());
+        for (size_t j = 0; j < expected.size(); ++j)
+          EXPECT_NEAR(expected[j], coords[k][j], 1e-12);
+      }
+      else
+      {
+        EXPECT_EQ(-1, elems[k]);
+      }
+    }
+  }
+}
+
+TEST(PointLocateBatchTest, MortonOrderIsStablePermutation)
+{
+  std::vector<Point> points = randomPoints(50000, 0.0, 1.0, 3);
+  // duplicates must keep their input order
+  points[10] = points[20] = points[30] = Point(0.5, 0.5, 0.5);
+
+  MortonOrder order;
+  order.compute(points);
+  ASSERT_EQ(points.size(), order.size());
+
+  std::vector<size_t> seen(points.size(), 0);
+  std::vector<size_t> duplicates;
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    ++seen[order[i]];
+    if (order[i] == 10 || order[i] == 20 || order[i] == 30) duplicates.push_back(order[i]);
+  }
+  EXPECT_EQ(std::vector<size_t>(points.size(), 1), seen);
+  EXPECT_EQ((std::vector<size_t>{10, 20, 30}), duplicates);
+}
+
+TEST(PointLocateBatchTest, MortonOrderFollowsTheCurve)
+{
+  // points on the x axis sort by x; the two halves of the box along z come
+  // one after the other
+  std::vector<Point> points;
+  for (int i = 99; i >= 0; --i)
+  {
+    points.push_back(Point(i, 0, 0));
+    points.push_back(Point(i, 0, 1000));
+  }
+  MortonOrder order;
+  order.compute(points);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    EXPECT_EQ(0.0, points[order[i]].z());
+    EXPECT_EQ(1000.0, points[order[i + 100]].z());
+    if (i > 0) EXPECT_LT(points[order[i - 1]].x(), points[order[i]].x());
+  }
+  EXPECT_EQ(0.0, points[order[0]].x());
+}
+
+TEST(PointLocateBatchTest, EmptyBatch)
+{
+  FieldHandle field = CubeTetVolLinearBasis(DOUBLE_E);
+  VMesh* mesh = field->vmesh();
+  mesh->synchronize(Mesh::ELEM_LOCATE_E);
+
+  std::vector<VMesh::Elem::index_type> elems(3);
+  std::vector<VMesh::coords_type> coords(3);
+  mesh->locate_points(std::vector<Point>(), elems, coords);
+  EXPECT_TRUE(elems.empty());
+  EXPECT_TRUE(coords.empty());
+}
+
+TEST(PointLocateBatchTest, TetVolMeshLocatesLikeSinglePoints)
+{
+  FieldHandle field = CubeTetVolLinearBasis(DOUBLE_E);
+  VMesh* mesh = field->vmesh();
+  mesh->synchronize(Mesh::ELEM_LOCATE_E);
+
+  expectLocatesLikeSinglePoints(mesh, randomPoints(20000, -1.5, 1.5, 7));
+}
+
+TEST(PointLocateBatchTest, TetVolMeshWithHierarchyLocatesLikeSinglePoints)
+{
+  FieldHandle field = CubeTetVolLinearBasis(DOUBLE_E);
+  VMesh* mesh = field->vmesh();
+  mesh->synchronize(Mesh::ELEM_LOCATE_BVH_E);
+
+  expectLocatesLikeSinglePoints(mesh, randomPoints(20000, -1.5, 1.5, 8));
+}
+
+TEST(PointLocateBatchTest, InterpolateManyPoints)
+{
+  FieldHandle field = CubeTetVolLinearBasis(DOUBLE_E);
+  VField* vfield = field->vfield();
+  for (VMesh::index_type i = 0; i < vfield->num_values(); ++i)
+    vfield->set_value(static_cast<double>(i), i);
+  field->vmesh()->synchronize(Mesh::ELEM_LOCATE_E);
+
+  const std::vector<Point> points = randomPoints(5000, -1.5, 1.5, 9);
+  std::vector<double> values;
+  vfield->minterpolate(values, points, -1.0);
+  ASSERT_EQ(points.size(), values.size());
+  for (size_t k = 0; k < points.size(); ++k)
+  {
+    double value;
+    vfield->interpolate(value, points[k], -1.0);
+    EXPECT_NEAR(value, values[k], 1e-9);
+  }
+}
@@ -134,6 +134,15 @@ public:
   virtual void get_delems(VMesh::DElem::array_type& delems,
                           VMesh::Elem::index_type i) const;
 
+  virtual void get_elem_nodes(VMesh::Node::fixed_array_type& nodes,
+                              VMesh::Elem::index_type i) const;
+  virtual void get_elem_edges(VMesh::Edge::fixed_array_type& edges,
+                              VMesh::Elem::index_type i) const;
+  virtual void get_elem_faces(VMesh::Face::fixed_array_type& faces,
+                              VMesh::Elem::index_type i) const;
+  virtual void get_elem_delems(VMesh::DElem::fixed_array_type& delems,
+                               VMesh::Elem::index_type i) const;
+
   virtual void set_nodes(VMesh::Node::array_type&,
                          VMesh::Elem::index_type);
 
@@ -492,6 +501,38 @@ VTetVolMesh<MESH>::get_delems(VMesh::DElem::array_type &delems,
   this->mesh_->get_faces_from_cell(delems,idx);
 }
 
+template <class MESH>
+void
+VTetVolMesh<MESH>::get_elem_nodes(VMesh::Node::fixed_array_type &nodes,
+                                  VMesh::Elem::index_type idx) const
+{
+  this->mesh_->get_nodes_from_cell(nodes,idx);
+}
+
+template <class MESH>
+void
+VTetVolMesh<MESH>::get_elem_edges(VMesh::Edge::fixed_array_type &edges,
+                                  VMesh::Elem::index_type idx) const
+{
+  this->mesh_->get_edges_from_cell(edges,idx);
+}
+
+template <class MESH>
+void
+VTetVolMesh<MESH>::get_elem_faces(VMesh::Face::fixed_array_type &faces,
+                                  VMesh::Elem::index_type idx) const
+{
+  this->mesh_->get_faces_from_cell(faces,idx);
+}
+
+template <class MESH>
+void
+VTetVolMesh<MESH>::get_elem_delems(VMesh::DElem::fixed_array_type &delems,
+                                   VMesh::Elem::index_type idx) const
+{
+  this->mesh_->get_faces_from_cell(delems,idx);
+}
+
 template <class MESH>
 void
 VTetVolMesh<MESH>::get_delems(VMesh::DElem::array_type &delems,
@@ -48,9 +48,12 @@
 #include <Core/Basis/TetQuadraticLgn.h>
 #include <Core/Basis/TetCubicHmt.h>
 
+#include <Core/Datatypes/Legacy/Field/BoundingVolumeHierarchy.h>
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshTopologySort.h>
+#include <Core/Datatypes/Legacy/Field/NodeAdjacency.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Mesh/VirtualMeshFacade.h>
 #include <Core/Math/MiscMath.h>
@@ -330,7 +333,8 @@ public:
               mesh_->synchronize_cond_.wait(lock);
           }
           if (sync_ & Mesh::NODE_LOCATE_E) mesh_->compute_node_grid();
-          if (sync_ & Mesh::ELEM_LOCATE_E) mesh_->compute_elem_grid();
+          if (sync_ & Mesh::ELEM_LOCATE_BVH_E) mesh_->compute_elem_bvh();
+          else if (sync_ & Mesh::ELEM_LOCATE_E) mesh_->compute_elem_grid();
         }
 
         mesh_->synchronize_lock_.lock();
@@ -502,6 +506,14 @@ public:
   void get_elems(typename Elem::array_type &array,
                  typename Node::index_type idx) const
     { get_cells_from_node(array,idx); }
+  /// The cells around node idx without copying them; valid until the mesh
+  /// or its NODE_NEIGHBORS_E synchronization changes.
+  NodeAdjacency::Span get_elems_span(typename Node::index_type idx) const
+  {
+    ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
+            "TetVolMesh: Must call synchronize NODE_NEIGHBORS_E first.");
+    return node_neighbors_.elems(idx);
+  }
   void get_elems(typename Elem::array_type &array,
                  typename Edge::index_type idx) const
     { get_cells_from_edge(array,idx); }
@@ -1187,6 +1199,9 @@ public:
     ASSERTMSG(synchronized_ & Mesh::ELEM_LOCATE_E,
               "TetVolMesh: need to synchronize ELEM_LOCATE_E first");
 
+    if (elem_bvh_)
+      return (find_closest_elem_in_bvh(pdist, result, coords, elem, p, maxdist));
+
     // First check are we inside an element
     SearchGridT<index_type>::iterator it, eit;
     if (elem_grid_->lookup(it, eit, p))
@@ -1705,10 +1720,10 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
             "TetVolMesh: Must call synchronize NODE_NEIGHBORS_E first.");
 
-    array.resize(node_neighbors_[idx].size());
-    for (size_t i = 0; i < node_neighbors_[idx].size(); ++i)
-      array[i] = static_cast<typename ARRAY::value_type>(
-                                                  (node_neighbors_[idx][i])>>2);
+    const NodeAdjacency::Span cells = node_neighbors_.elems(idx);
+    array.resize(cells.size());
+    for (size_t i = 0; i < cells.size(); ++i)
+      array[i] = static_cast<typename ARRAY::value_type>(cells[i]);
   }
 
   template<class ARRAY, class INDEX>
@@ -1720,7 +1735,7 @@ protected:
       "HexVolMesh: Must call synchronize EDGES_E first");
 
     // Get all the nodes that share an edge with this node
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const NodeAdjacency::Span neighbors = node_neighbors_.entries(idx);
 
     array.clear();
     array.reserve(neighbors.size());
@@ -1796,7 +1811,7 @@ protected:
       "TetVolMesh: Must call synchronize FACES_E first");
 
     // Get all the nodes that share an edge with this node
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const NodeAdjacency::Span neighbors = node_neighbors_.entries(idx);
 
     array.clear();
     array.reserve(neighbors.size());
@@ -1932,12 +1947,12 @@ protected:
   {
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
               "Must call synchronize NODE_NEIGHBORS_E on TetVolMesh first.");
-    size_t sz = node_neighbors_[node].size();
+    const NodeAdjacency::Span neighbors = node_neighbors_.entries(node);
 
     std::set<index_type> inserted;
-    for (size_t i = 0; i < sz; i++)
+    for (size_t i = 0; i < neighbors.size(); i++)
     {
-      const index_type base = ((node_neighbors_[node][i])&(~0x3));
+      const index_type base = ((neighbors[i])&(~0x3));
       for (index_type c = base; c < base+4; ++c)
       {
         if (cells_[c] != node) inserted.insert(cells_[c]);
@@ -2115,6 +2130,14 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::ELEM_LOCATE_E,
                 "TetVolMesh: need to synchronize ELEM_LOCATE_E first");
 
+    if (elem_bvh_)
+    {
+      index_type found;
+      if (!locate_in_bvh(found, p)) return (false);
+      elem = static_cast<INDEX>(found);
+      return (true);
+    }
+
     typename SearchGridT<index_type>::iterator it, eit;
     if (elem_grid_->lookup(it, eit, p))
     {
@@ -2140,6 +2163,13 @@ protected:
               "TetVolMesh::locate_elems requires synchronize(ELEM_LOCATE_E).")
 
     array.clear();
+    if (elem_bvh_)
+    {
+      elem_bvh_->overlap(b, [&array](index_type ci)
+        { array.push_back(typename ARRAY::value_type(ci)); });
+      return (array.size() > 0);
+    }
+
     index_type is,js,ks;
     index_type ie,je,ke;
     elem_grid_->locate_clamp(is,js,ks,b.get_min());
@@ -2188,6 +2218,16 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::ELEM_LOCATE_E,
                 "TetVolMesh: need to synchronize ELEM_LOCATE_E first");
 
+    if (elem_bvh_)
+    {
+      index_type found;
+      if (!locate_in_bvh(found, p)) return (false);
+      elem = static_cast<INDEX>(found);
+      ElemData ed(*this, elem);
+      basis_.get_coords(coords, p, ed);
+      return (true);
+    }
+
     typename SearchGridT<index_type>::iterator it, eit;
     if (elem_grid_->lookup(it, eit, p))
     {
@@ -2262,10 +2302,82 @@ protected:
   void compute_faces();
   void compute_node_grid();
   void compute_elem_grid();
+  void compute_elem_bvh();
   void compute_bounding_box();
 
   void insert_elem_into_grid(typename Elem::index_type ci);
   void remove_elem_from_grid(typename Elem::index_type ci);
+
+  /// Element containing p, searched through elem_bvh_.
+  bool locate_in_bvh(index_type& elem, const Core::Geometry::Point& p) const
+  {
+    return (elem_bvh_->locate(p, [&](index_type ci)
+    {
+      if (!inside(typename Elem::index_type(ci), p)) return (false);
+      elem = ci;
+      return (true);
+    }));
+  }
+
+  /// find_closest_elem through elem_bvh_: the element containing p, or else
+  /// the closest point on a boundary face, searched nearest boxes first.
+  template <class INDEX, class ARRAY>
+  bool find_closest_elem_in_bvh(double& pdist,
+                                Core::Geometry::Point &result,
+                                ARRAY &coords,
+                                INDEX &elem,
+                                const Core::Geometry::Point &p,
+                                double maxdist) const
+  {
+    index_type found;
+    if (locate_in_bvh(found, p))
+    {
+      pdist = 0.0;
+      result = p;
+      elem = static_cast<INDEX>(found);
+      ElemData ed(*this, elem);
+      basis_.get_coords(coords, p, ed);
+      return (true);
+    }
+
+    // Boundary faces in the order of the boundary_faces_ bits
+    static const int faces[4][3] = { {0, 2, 1}, {1, 2, 3}, {0, 1, 3}, {0, 3, 2} };
+
+    double dmin = maxdist;
+    bool found_one = false;
+    elem_bvh_->closest(p, dmin, [&](index_type cidx, double& dmin2) -> bool
+    {
+      const unsigned char b = boundary_faces_[cidx];
+      const index_type idx = cidx*4;
+      for (int f = 0; f < 4; ++f)
+      {
+        if (!(b & (1 << f))) continue;
+        Core::Geometry::Point r;
+        closest_point_on_tri(r, p,
+                             points_[cells_[idx+faces[f][0]]],
+                             points_[cells_[idx+faces[f][1]]],
+                             points_[cells_[idx+faces[f][2]]]);
+        const double dtmp = (p - r).length2();
+        if (dtmp < dmin2)
+        {
+          found_one = true;
+          result = r;
+          elem = INDEX(cidx);
+          dmin2 = dtmp;
+          if (dmin2 < epsilon2_) return (true);
+        }
+      }
+      return (false);
+    });
+
+    if (!found_one) return (false);
+
+    ElemData ed(*this,elem);
+    basis_.get_coords(coords,result,ed);
+
+    pdist = sqrt(dmin);
+    return (true);
+  }
   void insert_node_into_grid(typename Node::index_type ci);
   void remove_node_from_grid(typename Node::index_type ci);
 
@@ -2549,9 +2661,7 @@ protected:
     }
   };
 
-  using face_ht = boost::unordered_map<PFace, typename Face::index_type, FaceHash>;
   using face_nt = boost::unordered_map<PFaceNode, typename Face::index_type, FaceHash>;
-  using edge_ht = boost::unordered_map<PEdge, typename Edge::index_type, EdgeHash>;
   using edge_nt = boost::unordered_map<PEdgeNode, typename Edge::index_type, EdgeHash>;
 
   typedef std::vector<PFaceCell> face_ct;
@@ -2573,11 +2683,6 @@ protected:
 			  typename Cell::index_type ci,
 			  bool table_only = false);
 
-  inline void hash_edge(typename Node::index_type n1,
-                        typename Node::index_type n2,
-                        index_type combined_index,
-                        edge_ht& table);
-
   inline void add_edge(typename Node::index_type n1,
                         typename Node::index_type n2,
                         index_type combined_index);
@@ -2587,16 +2692,12 @@ protected:
                           typename Node::index_type n3,
                           typename Cell::index_type ci,
                           bool table_only = false);
-  inline void hash_face(typename Node::index_type n1,
-                        typename Node::index_type n2,
-                        typename Node::index_type n3,
-                        index_type ci, face_ht& table);
   inline void add_face(typename Node::index_type n1,
                        typename Node::index_type n2,
                        typename Node::index_type n3,
                        index_type combined_index);
 
-  std::vector<std::vector<typename Cell::index_type> > node_neighbors_;
+  NodeAdjacency node_neighbors_;
   std::vector<unsigned char> boundary_faces_;
 
   /// This grid is used as an acceleration structure to expedite calls
@@ -2606,6 +2707,8 @@ protected:
   ///  then search just those tets that overlap that grid cell.
   boost::shared_ptr<SearchGridT<index_type> >  node_grid_;
   boost::shared_ptr<SearchGridT<index_type> >  elem_grid_;
+  /// Replaces elem_grid_ when ELEM_LOCATE_BVH_E was synchronized.
+  boost::shared_ptr<BoundingVolumeHierarchy>   elem_bvh_;
 
   // Lock and Condition Variable for hand shaking
   mutable Core::Thread::Mutex                 synchronize_lock_;
@@ -2900,6 +3003,7 @@ TetVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 
   if (node_grid_) { node_grid_->transform(t); }
   if (elem_grid_) { elem_grid_->transform(t); }
+  if (elem_bvh_) { elem_bvh_->transform(t); }
 
   synchronize_lock_.unlock();
 }
@@ -2950,101 +3054,55 @@ TetVolMesh<Basis>::remove_face(typename Node::index_type n1,
 
 template <class Basis>
 void
-TetVolMesh<Basis>::hash_face(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             typename Node::index_type n3,
-                             index_type combined_index,
-                             face_ht& table)
+TetVolMesh<Basis>::compute_faces()
 {
-  PFace f(n1, n2, n3);
-
-  typename face_ht::iterator iter = table.find(f);
-  if (iter == table.end())
+  SortedTopology<3> topology;
+  topology.compute(static_cast<size_type>(cells_.size() >> 2), 4, static_cast<size_type>(points_.size()),
+    [this](index_type cell, typename SortedTopology<3>::key_type* keys, index_type* combined)
   {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
-  {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "TetVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>2) << ", #" << (f.cells_[1]>>2) << ", and #"
-           << (combined_index>>2) << " are illegally adjacent." << std::endl;
-           */
-    }
-    else if ((f.cells_[0]>>2) == (combined_index>>2))
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "TetVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>2) << " and #" << (combined_index>>2)
-           << " are the same." << std::endl;*/
-    }
-    else
+    // 4 faces -- each is entered CCW from outside looking in
+    const under_type* n = &cells_[cell << 2];
+    keys[0] = {{ n[0], n[2], n[1] }};
+    keys[1] = {{ n[1], n[2], n[3] }};
+    keys[2] = {{ n[0], n[1], n[3] }};
+    keys[3] = {{ n[0], n[3], n[2] }};
+    for (int i = 0; i < 4; ++i)
     {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
+      SortedTopology<3>::sortNodes(keys[i]);
+      combined[i] = (cell << 2) + i;
     }
-  }
-}
+  });
 
-template <class Basis>
-void
-TetVolMesh<Basis>::compute_faces()
-{
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(4);
-
-  face_ht table;
-
-  while (ci != cie)
+  faces_.clear();
+  faces_.resize(topology.size());
+  Core::Thread::Parallel::For(0, topology.size(), [this, &topology](size_t begin, size_t end)
   {
-    get_nodes(arr, *ci);
-    // 4 faces -- each is entered CCW from outside looking in
-
-    index_type cell_index = (*ci)<<2;
-    hash_face(arr[0], arr[2], arr[1], cell_index, table);
-    hash_face(arr[1], arr[2], arr[3], cell_index + 1, table);
-    hash_face(arr[0], arr[1], arr[3], cell_index + 2, table);
-    hash_face(arr[0], arr[3], arr[2], cell_index + 3, table);
-    ++ci;
-  }
-
-  faces_.resize(table.size());
-
-  typename face_ht::iterator ht_iter = table.begin();
-  typename face_ht::iterator ht_iter_end = table.end();
-
-  boundary_faces_.resize(cells_.size() >> 2);
+    for (size_t f = begin; f < end; ++f)
+    {
+      faces_[f].cells_[0] = topology.occurrence(f, 0);
+      faces_[f].cells_[1] = topology.neighbor(f, 2);
+    }
+  });
 
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
+  face_table_.clear();
+  face_table_.reserve(topology.size());
+  boundary_faces_.assign(cells_.size() >> 2, 0);
+  for (size_t f = 0; f < topology.size(); ++f)
   {
-    const PFace& pface = (*ht_iter).first;
-    faces_[uidx].cells_[0] = pface.cells_[0];
-    faces_[uidx].cells_[1] = pface.cells_[1];
-    face_table_[PFaceNode(pface.nodes_[0],pface.nodes_[1],pface.nodes_[2])] = uidx;
+    const typename SortedTopology<3>::key_type& key = topology.key(f);
+    face_table_.emplace(PFaceNode(key[0], key[1], key[2]), static_cast<typename Face::index_type>(f));
 
-    if (pface.cells_[1] == -1)
+    if (faces_[f].cells_[1] == MESH_NO_NEIGHBOR)
     {
-      index_type cell = (pface.cells_[0]) >> 2;
-      index_type face = (pface.cells_[0]) & 0x3;
+      index_type cell = (faces_[f].cells_[0]) >> 2;
+      index_type face = (faces_[f].cells_[0]) & 0x3;
       boundary_faces_[cell] |= 1 << face;
     }
-    ++ht_iter; uidx++;
   }
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::FACES_E;
   synchronize_lock_.unlock();
-
-
 }
 
 
@@ -3082,66 +3140,45 @@ TetVolMesh<Basis>::add_face(typename Node::index_type n1,
   }
 }
 
-template <class Basis>
-void
-TetVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             index_type combined_index,
-                             edge_ht& table)
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-
-  if (iter == table.end())
-  {
-    e.cells_.push_back(combined_index); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(combined_index); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 TetVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  edge_ht table;
+  SortedTopology<2> topology;
+  topology.compute(static_cast<size_type>(cells_.size() >> 2), 6, static_cast<size_type>(points_.size()),
+    [this](index_type cell, typename SortedTopology<2>::key_type* keys, index_type* combined)
+  {
+    const under_type* n = &cells_[cell << 2];
+    keys[0] = {{ n[0], n[1] }};
+    keys[1] = {{ n[1], n[2] }};
+    keys[2] = {{ n[2], n[0] }};
+    keys[3] = {{ n[3], n[0] }};
+    keys[4] = {{ n[3], n[1] }};
+    keys[5] = {{ n[3], n[2] }};
+    for (int i = 0; i < 6; ++i)
+    {
+      combined[i] = (cell << 3) + i;
+      SortedTopology<2>::sortNodes(keys[i]);
+      if (keys[i][0] == keys[i][1]) keys[i][0] = -1;
+    }
+  });
 
-  typename Node::array_type arr;
-  while (ci != cie)
+  edges_.clear();
+  edges_.resize(topology.size());
+  Core::Thread::Parallel::For(0, topology.size(), [this, &topology](size_t begin, size_t end)
   {
-    get_nodes(arr, *ci);
-    index_type cell_index = (*ci)<<3;
-    hash_edge(arr[0], arr[1], cell_index  ,table);
-    hash_edge(arr[1], arr[2], cell_index+1,table);
-    hash_edge(arr[2], arr[0], cell_index+2,table);
-    hash_edge(arr[3], arr[0], cell_index+3,table);
-    hash_edge(arr[3], arr[1], cell_index+4,table);
-    hash_edge(arr[3], arr[2], cell_index+5,table);
-    ++ci;
-  }
-
-  edges_.resize(table.size());
-
-  typename edge_ht::iterator ht_iter = table.begin();
-  typename edge_ht::iterator ht_iter_end = table.end();
+    for (size_t e = begin; e < end; ++e)
+    {
+      edges_[e].cells_.resize(topology.count(e));
+      for (size_t j = 0; j < topology.count(e); ++j)
+        edges_[e].cells_[j] = topology.occurrence(e, j);
+    }
+  });
 
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
-  {
-    const PEdge& pedge = (*ht_iter).first;
-    edges_[uidx].cells_ = pedge.cells_;
-    edge_table_[PEdgeNode(pedge.nodes_[0],pedge.nodes_[1])] = uidx;
-    ++ht_iter; uidx++;
-  }
+  edge_table_.clear();
+  edge_table_.reserve(topology.size());
+  for (size_t e = 0; e < topology.size(); ++e)
+    edge_table_.emplace(PEdgeNode(topology.key(e)[0], topology.key(e)[1]), static_cast<typename Edge::index_type>(e));
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::EDGES_E;
@@ -3183,15 +3220,24 @@ TetVolMesh<Basis>::synchronize(mask_type sync)
   if (sync & Mesh::FIND_CLOSEST_ELEM_E)
   { sync |= ELEM_LOCATE_E|FACES_E; sync &=  ~(Mesh::FIND_CLOSEST_ELEM_E); }
 
+  if (sync & Mesh::ELEM_LOCATE_BVH_E) sync |= Mesh::ELEM_LOCATE_E;
+
   if (sync & (Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E)) sync |= Mesh::BOUNDING_BOX_E;
 
   // Filter out the only tables available
   sync &= (Mesh::EDGES_E|Mesh::FACES_E|
            Mesh::NODE_NEIGHBORS_E|Mesh::BOUNDING_BOX_E|
-           Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E);
+           Mesh::NODE_LOCATE_E|Mesh::ELEM_LOCATE_E|Mesh::ELEM_LOCATE_BVH_E);
 
   Core::Thread::UniqueLock lock(synchronize_lock_.get());
 
+  // A hierarchy asked for on a mesh located through the grid replaces the grid;
+  // a plain ELEM_LOCATE_E keeps whichever structure is there.
+  if ((sync & Mesh::ELEM_LOCATE_BVH_E) && !(synchronized_ & Mesh::ELEM_LOCATE_BVH_E))
+    synchronized_ &= ~Mesh::ELEM_LOCATE_E;
+  else
+    sync &= ~Mesh::ELEM_LOCATE_BVH_E;
+
   // Only sync was hasn't been synched
   sync &= (~synchronized_);
 
@@ -3265,7 +3311,7 @@ TetVolMesh<Basis>::synchronize(mask_type sync)
     boost::thread syncthread(syncclass);
   }
 
-  if (sync == Mesh::ELEM_LOCATE_E)
+  if ((sync & ~Mesh::ELEM_LOCATE_BVH_E) == Mesh::ELEM_LOCATE_E)
   {
     Synchronize Synchronize(this,sync);
     synchronize_lock_.unlock();
@@ -3274,7 +3320,7 @@ TetVolMesh<Basis>::synchronize(mask_type sync)
   }
   else if (sync & Mesh::ELEM_LOCATE_E)
   {
-    mask_type tosync = Mesh::ELEM_LOCATE_E;
+    mask_type tosync = sync & (Mesh::ELEM_LOCATE_E|Mesh::ELEM_LOCATE_BVH_E);
     Synchronize syncclass(this,tosync);
     boost::thread syncthread(syncclass);
   }
@@ -3315,6 +3361,7 @@ TetVolMesh<Basis>::clear_synchronization()
 
   node_grid_.reset();
   elem_grid_.reset();
+  elem_bvh_.reset();
 
   synchronize_lock_.unlock();
 
@@ -3542,7 +3589,7 @@ TetVolMesh<Basis>::create_cell_node_neighbors(typename Cell::index_type c)
 {
   for (index_type i = c*4; i < c*4+4; ++i)
   {
-    node_neighbors_[cells_[i]].push_back(i);
+    node_neighbors_.insert(cells_[i], i);
   }
 }
 
@@ -3553,17 +3600,9 @@ TetVolMesh<Basis>::delete_cell_node_neighbors(typename Cell::index_type c)
 {
   for (index_type i = c*4; i < c*4+4; ++i)
   {
-    const index_type n = cells_[i];
-    typename std::vector<typename Cell::index_type>::iterator node_cells_end =
-      node_neighbors_[n].end();
-    typename std::vector<typename Cell::index_type>::iterator cell =
-      node_neighbors_[n].begin();
-    while (cell != node_cells_end && (*cell) != i) ++cell;
-
     /// ASSERT that the node_neighbors_ structure contains this cell
-    ASSERT(cell != node_cells_end);
-
-    node_neighbors_[n].erase(cell);
+    const bool found = node_neighbors_.erase(cells_[i], i);
+    ASSERT(found);
   }
 }
 
@@ -3671,13 +3710,11 @@ template <class Basis>
 void
 TetVolMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  index_type i, num_cells = cells_.size();
-  for (i = 0; i < num_cells; i++)
-  {
-    node_neighbors_[cells_[i]].push_back(i);
-  }
+  // entry i of cells_ is node i%4 of cell i/4; keep i so the local node is
+  // known, and shift it out for get_elems
+  node_neighbors_.build(points_.size(), cells_.size(),
+    [this](index_type i) { return static_cast<index_type>(cells_[i]); },
+    [](index_type i) { return i; }, 2);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
@@ -3733,7 +3770,8 @@ TetVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
   box.extend(points_[cells_[idx+2]]);
   box.extend(points_[cells_[idx+3]]);
   box.extend(epsilon_);
-  elem_grid_->insert(ci, box);
+  if (elem_bvh_) elem_bvh_->insert(ci, box);
+  else elem_grid_->insert(ci, box);
 }
 
 
@@ -3748,7 +3786,8 @@ TetVolMesh<Basis>::remove_elem_from_grid(typename Elem::index_type ci)
   box.extend(points_[cells_[idx+2]]);
   box.extend(points_[cells_[idx+3]]);
   box.extend(epsilon_);
-  elem_grid_->remove(ci, box);
+  if (elem_bvh_) elem_bvh_->remove(ci);
+  else elem_grid_->remove(ci, box);
 }
 
 template <class Basis>
@@ -3788,6 +3827,7 @@ TetVolMesh<Basis>::compute_elem_grid()
 
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
+    elem_bvh_.reset();
 
     typename Elem::iterator ci, cie;
     begin(ci); end(cie);
@@ -3803,6 +3843,32 @@ TetVolMesh<Basis>::compute_elem_grid()
   synchronize_lock_.unlock();
 }
 
+template <class Basis>
+void
+TetVolMesh<Basis>::compute_elem_bvh()
+{
+  if (bbox_.valid())
+  {
+    typename Elem::size_type esz;  size(esz);
+
+    boost::shared_ptr<BoundingVolumeHierarchy> bvh(new BoundingVolumeHierarchy);
+    bvh->build(esz, [this](index_type ci, Core::Geometry::BBox& box)
+    {
+      const index_type idx = ci*4;
+      box.extend(points_[cells_[idx]]);
+      box.extend(points_[cells_[idx+1]]);
+      box.extend(points_[cells_[idx+2]]);
+      box.extend(points_[cells_[idx+3]]);
+    }, epsilon_);
+    elem_bvh_ = bvh;
+    elem_grid_.reset();
+  }
+
+  synchronize_lock_.lock();
+  synchronized_ |= Mesh::ELEM_LOCATE_E|Mesh::ELEM_LOCATE_BVH_E;
+  synchronize_lock_.unlock();
+}
+
 template <class Basis>
 void
 TetVolMesh<Basis>::compute_node_grid()
@@ -3889,7 +3955,7 @@ TetVolMesh<Basis>::add_find_point(const Core::Geometry::Point &p, double /*err*/
     if (synchronized_ & Mesh::NODE_NEIGHBORS_E)
     {
       synchronize_lock_.lock();
-      node_neighbors_.push_back(std::vector<typename Cell::index_type>());
+      node_neighbors_.add_node();
       synchronize_lock_.unlock();
     }
     return static_cast<typename Node::index_type>(points_.size() - 1);
@@ -0,0 +1,181 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+/// @file elemLocateBenchmarkMain.cc
+/// Compares element location through the uniform search grid
+/// (synchronize(ELEM_LOCATE_E)) with the bounding volume hierarchy
+/// (synchronize(ELEM_LOCATE_BVH_E)) on graded tetrahedral meshes: build time,
+/// locate for points inside the mesh, and find_closest_elem for points around it.
+///
+/// usage: elem_locate_benchmark [grid size] [queries]
+/// The mesh splits a grid^3 block of cubes into 6 tets each; the grid lines
+/// are pulled towards the center by x -> sign(x) |x|^g for gradings g = 1
+/// (uniform), 2, 4 and 8, so the element sizes range over a factor up to
+/// about g grid^(g-1).
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <vector>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  MeshHandle gradedTetVol(index_type n, double grading)
+  {
+    FieldInformation fi(TETVOLMESH_E, LINEARDATA_E, DOUBLE_E);
+    MeshHandle handle = CreateMesh(fi);
+    VMesh* mesh = handle->vmesh();
+
+    std::vector<double> coord(n + 1);
+    for (index_type i = 0; i <= n; ++i)
+    {
+      const double u = 2.0 * i / n - 1.0;
+      coord[i] = (u < 0.0 ? -1.0 : 1.0) * std::pow(std::fabs(u), grading);
+    }
+
+    mesh->node_reserve((n + 1) * (n + 1) * (n + 1));
+    for (index_type k = 0; k <= n; ++k)
+      for (index_type j = 0; j <= n; ++j)
+        for (index_type i = 0; i <= n; ++i)
+          mesh->add_point(Point(coord[i], coord[j], coord[k]));
+
+    // Kuhn split of every cube, corner v has bit 0 = x, bit 1 = y, bit 2 = z
+    static const int paths[6][2] = { {1, 3}, {1, 5}, {2, 3}, {2, 6}, {4, 5}, {4, 6} };
+    mesh->elem_reserve(6 * n * n * n);
+    VMesh::Node::array_type nodes(4);
+    for (index_type k = 0; k < n; ++k)
+      for (index_type j = 0; j < n; ++j)
+        for (index_type i = 0; i < n; ++i)
+        {
+          auto corner = [&](int v)
+          {
+            return VMesh::Node::index_type(((k + ((v >> 2) & 1)) * (n + 1) + j + ((v >> 1) & 1)) * (n + 1) + i + (v & 1));
+          };
+          for (auto& p : paths)
+          {
+            nodes[0] = corner(0);
+            nodes[1] = corner(p[0]);
+            nodes[2] = corner(p[1]);
+            nodes[3] = corner(7);
+            mesh->add_elem(nodes);
+          }
+        }
+    return handle;
+  }
+
+  double seconds(const std::function<void()>& task)
+  {
+    auto start = std::chrono::steady_clock::now();
+    task();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+  }
+
+  struct Timing
+  {
+    double build, locate, closest;
+    size_t located;
+  };
+
+  Timing run(VMesh* mesh, Mesh::mask_type locate, const std::vector<Point>& inner, const std::vector<Point>& outer)
+  {
+    Timing t;
+    t.build = seconds([&]() { mesh->synchronize(locate | Mesh::FACES_E); });
+    // boundary faces for find_closest_elem, so the build above is timed alone
+    mesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E);
+
+    t.located = 0;
+    t.locate = seconds([&]()
+    {
+      VMesh::Elem::index_type elem;
+      for (const auto& p : inner)
+        if (mesh->locate(elem, p)) ++t.located;
+    }) / inner.size();
+
+    t.closest = seconds([&]()
+    {
+      VMesh::Elem::index_type elem;
+      double dist;
+      Point result;
+      for (const auto& p : outer)
+        mesh->find_closest_elem(dist, result, elem, p);
+    }) / outer.size();
+    return t;
+  }
+}
+
+int main(int argc, const char* argv[])
+{
+  const index_type n = argc > 1 ? std::atoi(argv[1]) : 40;
+  const size_t numQueries = argc > 2 ? std::atoi(argv[2]) : 200000;
+
+  // Queries are spread like the nodes, half of them near the fine center
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> unit(-1.0, 1.0);
+  std::vector<Point> inner(numQueries), outer(numQueries / 10 + 1);
+  for (size_t q = 0; q < inner.size(); ++q)
+  {
+    const double scale = (q % 2) ? 1.0 : 0.05;
+    inner[q] = Point(scale * unit(rng), scale * unit(rng), scale * unit(rng));
+  }
+  for (auto& p : outer)
+  {
+    Vector d(unit(rng), unit(rng), unit(rng));
+    d.safe_normalize();
+    p = Point(0, 0, 0) + d * (2.0 + unit(rng));
+  }
+
+  std::printf("%ld^3 cubes, %ld elements, %ld locate and %ld closest queries\n",
+    static_cast<long>(n), static_cast<long>(6 * n * n * n),
+    static_cast<long>(inner.size()), static_cast<long>(outer.size()));
+  std::printf("%8s %-6s %10s %14s %14s %10s\n",
+    "grading", "method", "build (s)", "locate (ns)", "closest (ns)", "found");
+  for (double grading : { 1.0, 2.0, 4.0, 8.0 })
+  {
+    MeshHandle gridMesh = gradedTetVol(n, grading);
+    MeshHandle bvhMesh = gradedTetVol(n, grading);
+    const Timing grid = run(gridMesh->vmesh(), Mesh::ELEM_LOCATE_E, inner, outer);
+    const Timing bvh = run(bvhMesh->vmesh(), Mesh::ELEM_LOCATE_BVH_E, inner, outer);
+
+    std::printf("%8.0f %-6s %10.3f %14.1f %14.1f %10ld\n", grading, "grid",
+      grid.build, 1e9 * grid.locate, 1e9 * grid.closest, static_cast<long>(grid.located));
+    std::printf("%8.0f %-6s %10.3f %14.1f %14.1f %10ld\n", grading, "bvh",
+      bvh.build, 1e9 * bvh.locate, 1e9 * bvh.closest, static_cast<long>(bvh.located));
+  }
+  return 0;
+}
@@ -0,0 +1,225 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+/// @file meshTopologyBenchmarkMain.cc
+/// Times face and edge synchronization of the unstructured meshes across mesh
+/// sizes and thread counts.
+///
+/// usage: mesh_topology_benchmark [largest grid size] [repetitions]
+/// Each mesh fills a grid^3 block of cubes: 6 tets, 1 hex or 2 prisms per cube.
+/// The TriSurfMesh is a flat triangulated grid with about as many triangles as
+/// the TetVolMesh has tets. Grid sizes double from 16 up to the largest.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <Core/Datatypes/Legacy/Field/TetVolMesh.h>
+#include <Core/Datatypes/Legacy/Field/HexVolMesh.h>
+#include <Core/Datatypes/Legacy/Field/PrismVolMesh.h>
+#include <Core/Datatypes/Legacy/Field/TriSurfMesh.h>
+#include <Core/Thread/Parallel.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Basis;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  typedef TetVolMesh<TetLinearLgn<Point> > TVMesh;
+  typedef HexVolMesh<HexTrilinearLgn<Point> > HVMesh;
+  typedef PrismVolMesh<PrismLinearLgn<Point> > PVMesh;
+  typedef TriSurfMesh<TriLinearLgn<Point> > TSMesh;
+
+  template <class MESH>
+  void addGridPoints(MESH& mesh, index_type nx, index_type ny, index_type nz)
+  {
+    mesh.node_reserve((nx + 1) * (ny + 1) * (nz + 1));
+    for (index_type k = 0; k <= nz; ++k)
+      for (index_type j = 0; j <= ny; ++j)
+        for (index_type i = 0; i <= nx; ++i)
+          mesh.add_point(Point(i, j, k));
+  }
+
+  // corner c of cube (i, j, k), bit 0 = x, bit 1 = y, bit 2 = z
+  struct Grid
+  {
+    explicit Grid(index_type n) : n(n) {}
+    index_type corner(index_type i, index_type j, index_type k, int c) const
+    {
+      return ((k + ((c >> 2) & 1)) * (n + 1) + j + ((c >> 1) & 1)) * (n + 1) + i + (c & 1);
+    }
+    index_type n;
+  };
+
+  template <class MESH>
+  void addCubes(MESH& mesh, index_type n, const std::function<void(MESH&, const index_type*)>& split)
+  {
+    Grid grid(n);
+    addGridPoints(mesh, n, n, n);
+    for (index_type k = 0; k < n; ++k)
+      for (index_type j = 0; j < n; ++j)
+        for (index_type i = 0; i < n; ++i)
+        {
+          index_type c[8];
+          for (int v = 0; v < 8; ++v)
+            c[v] = grid.corner(i, j, k, v);
+          split(mesh, c);
+        }
+  }
+
+  TVMesh* tetMesh(index_type n)
+  {
+    auto mesh = new TVMesh;
+    mesh->elem_reserve(6 * n * n * n);
+    // Kuhn triangulation: every tet runs along the 0-7 diagonal
+    static const int paths[6][2] = { {1, 3}, {1, 5}, {2, 3}, {2, 6}, {4, 5}, {4, 6} };
+    addCubes<TVMesh>(*mesh, n, [](TVMesh& m, const index_type* c)
+    {
+      for (auto& p : paths)
+      {
+        std::vector<index_type> tet = { c[0], c[p[0]], c[p[1]], c[7] };
+        m.add_elem(tet);
+      }
+    });
+    return mesh;
+  }
+
+  HVMesh* hexMesh(index_type n)
+  {
+    auto mesh = new HVMesh;
+    mesh->elem_reserve(n * n * n);
+    addCubes<HVMesh>(*mesh, n, [](HVMesh& m, const index_type* c)
+    {
+      std::vector<index_type> hex = { c[0], c[1], c[3], c[2], c[4], c[5], c[7], c[6] };
+      m.add_elem(hex);
+    });
+    return mesh;
+  }
+
+  PVMesh* prismMesh(index_type n)
+  {
+    auto mesh = new PVMesh;
+    mesh->elem_reserve(2 * n * n * n);
+    addCubes<PVMesh>(*mesh, n, [](PVMesh& m, const index_type* c)
+    {
+      std::vector<index_type> lower = { c[0], c[1], c[2], c[4], c[5], c[6] };
+      std::vector<index_type> upper = { c[1], c[3], c[2], c[5], c[7], c[6] };
+      m.add_elem(lower);
+      m.add_elem(upper);
+    });
+    return mesh;
+  }
+
+  TSMesh* triMesh(index_type n)
+  {
+    auto mesh = new TSMesh;
+    const index_type side = static_cast<index_type>(std::sqrt(3.0 * n * n * n));
+    addGridPoints(*mesh, side, side, 0);
+    mesh->elem_reserve(2 * side * side);
+    for (index_type j = 0; j < side; ++j)
+      for (index_type i = 0; i < side; ++i)
+      {
+        index_type c = j * (side + 1) + i;
+        std::vector<index_type> lower = { c, c + 1, c + side + 2 };
+        std::vector<index_type> upper = { c, c + side + 2, c + side + 1 };
+        mesh->add_elem(lower);
+        mesh->add_elem(upper);
+      }
+    return mesh;
+  }
+
+  // best of several runs on freshly built meshes, in seconds
+  template <class MESH>
+  double timeSynchronize(const std::function<MESH*()>& build, mask_type sync, int repetitions, size_t& faces, size_t& edges)
+  {
+    double best = 1e30;
+    for (int r = 0; r < repetitions; ++r)
+    {
+      std::unique_ptr<MESH> mesh(build());
+      auto start = std::chrono::steady_clock::now();
+      mesh->synchronize(sync);
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      best = std::min(best, elapsed.count());
+      typename MESH::Face::size_type nf;
+      typename MESH::Edge::size_type ne;
+      mesh->size(nf);
+      mesh->size(ne);
+      faces = nf;
+      edges = ne;
+    }
+    return best;
+  }
+
+  template <class MESH>
+  void report(const char* name, const std::function<MESH*(index_type)>& build, mask_type sync,
+    index_type largest, int repetitions)
+  {
+    std::printf("%s\n%8s %12s %12s %12s %8s %10s %8s\n", name, "grid", "elements", "faces", "edges", "threads", "ms", "speedup");
+    for (index_type n = 16; n <= largest; n *= 2)
+    {
+      std::unique_ptr<MESH> probe(build(n));
+      typename MESH::Elem::size_type elems;
+      probe->size(elems);
+      probe.reset();
+
+      double serial = 0;
+      for (unsigned int threads = 1; ; threads *= 2)
+      {
+        threads = std::min(threads, std::thread::hardware_concurrency());
+        Parallel::SetMaximumCores(threads);
+        size_t faces = 0, edges = 0;
+        double seconds = timeSynchronize<MESH>([&build, n]() { return build(n); }, sync, repetitions, faces, edges);
+        if (threads == 1)
+          serial = seconds;
+        std::printf("%8ld %12ld %12lu %12lu %8u %10.1f %8.2f\n", static_cast<long>(n), static_cast<long>(elems),
+          static_cast<unsigned long>(faces), static_cast<unsigned long>(edges), threads, 1e3 * seconds, serial / seconds);
+        if (threads >= std::thread::hardware_concurrency())
+          break;
+      }
+    }
+  }
+}
+
+int main(int argc, const char* argv[])
+{
+  const index_type largest = argc > 1 ? std::atoi(argv[1]) : 64;
+  const int repetitions = argc > 2 ? std::atoi(argv[2]) : 3;
+
+  report<TVMesh>("TetVolMesh FACES_E | EDGES_E", tetMesh, Mesh::FACES_E | Mesh::EDGES_E, largest, repetitions);
+  report<HVMesh>("HexVolMesh FACES_E | EDGES_E", hexMesh, Mesh::FACES_E | Mesh::EDGES_E, largest, repetitions);
+  report<PVMesh>("PrismVolMesh FACES_E | EDGES_E", prismMesh, Mesh::FACES_E | Mesh::EDGES_E, largest, repetitions);
+  report<TSMesh>("TriSurfMesh EDGES_E", triMesh, Mesh::EDGES_E, largest, repetitions);
+  return 0;
+}
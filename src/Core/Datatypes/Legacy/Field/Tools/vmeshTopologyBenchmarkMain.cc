@@ -0,0 +1,254 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+/// @file vmeshTopologyBenchmarkMain.cc
+/// Per element cost of the VMesh topology accessors for each mesh type:
+/// get_nodes/get_edges/get_faces/get_delems into a vector array declared in
+/// the loop (the common pattern), into one vector array reused across the
+/// loop, and get_elem_nodes/... into a fixed_array_type, again declared in the
+/// loop or reused.
+///
+/// usage: vmesh_topology_benchmark [grid size] [repetitions]
+/// Volume meshes fill a grid^3 block of cubes (6 tets, 1 hex or 2 prisms per
+/// cube); surface and curve meshes get about as many elements.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  void addGridPoints(VMesh* mesh, index_type nx, index_type ny, index_type nz)
+  {
+    mesh->node_reserve((nx + 1) * (ny + 1) * (nz + 1));
+    for (index_type k = 0; k <= nz; ++k)
+      for (index_type j = 0; j <= ny; ++j)
+        for (index_type i = 0; i <= nx; ++i)
+          mesh->add_point(Point(i, j, k));
+  }
+
+  void addElem(VMesh* mesh, std::initializer_list<index_type> nodes)
+  {
+    VMesh::Node::array_type array;
+    for (index_type n : nodes)
+      array.push_back(VMesh::Node::index_type(n));
+    mesh->add_elem(array);
+  }
+
+  // calls split with the 8 corners of every cube, bit 0 = x, bit 1 = y, bit 2 = z
+  void addCubes(VMesh* mesh, index_type n, const std::function<void(const index_type*)>& split)
+  {
+    addGridPoints(mesh, n, n, n);
+    for (index_type k = 0; k < n; ++k)
+      for (index_type j = 0; j < n; ++j)
+        for (index_type i = 0; i < n; ++i)
+        {
+          index_type c[8];
+          for (int v = 0; v < 8; ++v)
+            c[v] = ((k + ((v >> 2) & 1)) * (n + 1) + j + ((v >> 1) & 1)) * (n + 1) + i + (v & 1);
+          split(c);
+        }
+  }
+
+  MeshHandle unstructured(mesh_info_type type, index_type n)
+  {
+    FieldInformation fi(type, LINEARDATA_E, DOUBLE_E);
+    MeshHandle handle = CreateMesh(fi);
+    VMesh* mesh = handle->vmesh();
+    const index_type side = static_cast<index_type>(std::sqrt(static_cast<double>(n * n * n)));
+
+    switch (type)
+    {
+    case TETVOLMESH_E:
+      mesh->elem_reserve(6 * n * n * n);
+      addCubes(mesh, n, [mesh](const index_type* c)
+      {
+        static const int paths[6][2] = { {1, 3}, {1, 5}, {2, 3}, {2, 6}, {4, 5}, {4, 6} };
+        for (auto& p : paths)
+          addElem(mesh, { c[0], c[p[0]], c[p[1]], c[7] });
+      });
+      break;
+    case HEXVOLMESH_E:
+      mesh->elem_reserve(n * n * n);
+      addCubes(mesh, n, [mesh](const index_type* c)
+      {
+        addElem(mesh, { c[0], c[1], c[3], c[2], c[4], c[5], c[7], c[6] });
+      });
+      break;
+    case PRISMVOLMESH_E:
+      mesh->elem_reserve(2 * n * n * n);
+      addCubes(mesh, n, [mesh](const index_type* c)
+      {
+        addElem(mesh, { c[0], c[1], c[2], c[4], c[5], c[6] });
+        addElem(mesh, { c[1], c[3], c[2], c[5], c[7], c[6] });
+      });
+      break;
+    case TRISURFMESH_E:
+    case QUADSURFMESH_E:
+      addGridPoints(mesh, side, side, 0);
+      for (index_type j = 0; j < side; ++j)
+        for (index_type i = 0; i < side; ++i)
+        {
+          const index_type c = j * (side + 1) + i;
+          if (type == QUADSURFMESH_E)
+            addElem(mesh, { c, c + 1, c + side + 2, c + side + 1 });
+          else
+          {
+            addElem(mesh, { c, c + 1, c + side + 2 });
+            addElem(mesh, { c, c + side + 2, c + side + 1 });
+          }
+        }
+      break;
+    case CURVEMESH_E:
+      addGridPoints(mesh, n * n * n, 0, 0);
+      for (index_type i = 0; i < n * n * n; ++i)
+        addElem(mesh, { i, i + 1 });
+      break;
+    default:
+      break;
+    }
+    return handle;
+  }
+
+  MeshHandle structured(mesh_info_type type, index_type n)
+  {
+    FieldInformation fi(type, LINEARDATA_E, DOUBLE_E);
+    const index_type side = static_cast<index_type>(std::sqrt(static_cast<double>(n * n * n)));
+    if (type == LATVOLMESH_E || type == STRUCTHEXVOLMESH_E)
+      return CreateMesh(fi, n + 1, n + 1, n + 1);
+    if (type == IMAGEMESH_E || type == STRUCTQUADSURFMESH_E)
+      return CreateMesh(fi, side + 1, side + 1);
+    return CreateMesh(fi, n * n * n + 1);
+  }
+
+  // best of several passes over all elements, in nanoseconds per element
+  double timePass(VMesh* mesh, int repetitions, const std::function<size_t(VMesh::Elem::index_type)>& visit)
+  {
+    const VMesh::Elem::size_type numElems = mesh->num_elems();
+    double best = 1e30;
+    size_t checksum = 0;
+    for (int r = 0; r < repetitions; ++r)
+    {
+      auto start = std::chrono::steady_clock::now();
+      for (VMesh::Elem::index_type e = 0; e < numElems; ++e)
+        checksum += visit(e);
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      best = std::min(best, elapsed.count());
+    }
+    // keep the loop from being optimized away
+    if (checksum == static_cast<size_t>(-1))
+      std::printf(" ");
+    return 1e9 * best / std::max<VMesh::Elem::size_type>(1, numElems);
+  }
+
+  template <class ARRAY, class FIXED>
+  void row(const char* accessor, VMesh* mesh, int repetitions,
+    const std::function<void(ARRAY&, VMesh::Elem::index_type)>& get,
+    const std::function<void(FIXED&, VMesh::Elem::index_type)>& getFixed)
+  {
+    double fresh = timePass(mesh, repetitions, [&get](VMesh::Elem::index_type e)
+    {
+      ARRAY array;
+      get(array, e);
+      return array.size();
+    });
+    ARRAY reused;
+    double kept = timePass(mesh, repetitions, [&get, &reused](VMesh::Elem::index_type e)
+    {
+      get(reused, e);
+      return reused.size();
+    });
+    double fixed = timePass(mesh, repetitions, [&getFixed](VMesh::Elem::index_type e)
+    {
+      FIXED array;
+      getFixed(array, e);
+      return array.size();
+    });
+    FIXED hoisted;
+    double fixedKept = timePass(mesh, repetitions, [&getFixed, &hoisted](VMesh::Elem::index_type e)
+    {
+      getFixed(hoisted, e);
+      return hoisted.size();
+    });
+    std::printf("  %-8s %14.1f %14.1f %14.1f %14.1f %8.2f\n", accessor, fresh, kept, fixed, fixedKept, fresh / fixed);
+  }
+
+  void report(const char* name, MeshHandle handle, int repetitions)
+  {
+    VMesh* mesh = handle->vmesh();
+    if (mesh->is_unstructuredmesh())
+      mesh->synchronize(Mesh::EDGES_E | Mesh::FACES_E);
+
+    std::printf("%s, %ld elements\n  %-8s %14s %14s %14s %14s %8s\n", name, static_cast<long>(mesh->num_elems()),
+      "ns/elem", "vector (new)", "vector (kept)", "fixed (new)", "fixed (kept)", "speedup");
+    row<VMesh::Node::array_type, VMesh::Node::fixed_array_type>("nodes", mesh, repetitions,
+      [mesh](VMesh::Node::array_type& a, VMesh::Elem::index_type e) { mesh->get_nodes(a, e); },
+      [mesh](VMesh::Node::fixed_array_type& a, VMesh::Elem::index_type e) { mesh->get_elem_nodes(a, e); });
+    if (mesh->dimensionality() < 1)
+      return;
+    row<VMesh::Edge::array_type, VMesh::Edge::fixed_array_type>("edges", mesh, repetitions,
+      [mesh](VMesh::Edge::array_type& a, VMesh::Elem::index_type e) { mesh->get_edges(a, e); },
+      [mesh](VMesh::Edge::fixed_array_type& a, VMesh::Elem::index_type e) { mesh->get_elem_edges(a, e); });
+    if (mesh->dimensionality() >= 2)
+      row<VMesh::Face::array_type, VMesh::Face::fixed_array_type>("faces", mesh, repetitions,
+        [mesh](VMesh::Face::array_type& a, VMesh::Elem::index_type e) { mesh->get_faces(a, e); },
+        [mesh](VMesh::Face::fixed_array_type& a, VMesh::Elem::index_type e) { mesh->get_elem_faces(a, e); });
+    row<VMesh::DElem::array_type, VMesh::DElem::fixed_array_type>("delems", mesh, repetitions,
+      [mesh](VMesh::DElem::array_type& a, VMesh::Elem::index_type e) { mesh->get_delems(a, e); },
+      [mesh](VMesh::DElem::fixed_array_type& a, VMesh::Elem::index_type e) { mesh->get_elem_delems(a, e); });
+  }
+}
+
+int main(int argc, const char* argv[])
+{
+  const index_type n = argc > 1 ? std::atoi(argv[1]) : 32;
+  const int repetitions = argc > 2 ? std::atoi(argv[2]) : 5;
+
+  report("TetVolMesh", unstructured(TETVOLMESH_E, n), repetitions);
+  report("HexVolMesh", unstructured(HEXVOLMESH_E, n), repetitions);
+  report("PrismVolMesh", unstructured(PRISMVOLMESH_E, n), repetitions);
+  report("TriSurfMesh", unstructured(TRISURFMESH_E, n), repetitions);
+  report("QuadSurfMesh", unstructured(QUADSURFMESH_E, n), repetitions);
+  report("CurveMesh", unstructured(CURVEMESH_E, n), repetitions);
+  report("LatVolMesh", structured(LATVOLMESH_E, n), repetitions);
+  report("StructHexVolMesh", structured(STRUCTHEXVOLMESH_E, n), repetitions);
+  report("ImageMesh", structured(IMAGEMESH_E, n), repetitions);
+  report("StructQuadSurfMesh", structured(STRUCTQUADSURFMESH_E, n), repetitions);
+  report("ScanlineMesh", structured(SCANLINEMESH_E, n), repetitions);
+  report("StructCurveMesh", structured(STRUCTCURVEMESH_E, n), repetitions);
+  return 0;
+}
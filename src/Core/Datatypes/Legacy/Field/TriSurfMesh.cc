@@ -108,6 +108,15 @@ public:
   virtual void get_delems(VMesh::DElem::array_type& delems,
                           VMesh::Elem::index_type i) const;
 
+  virtual void get_elem_nodes(VMesh::Node::fixed_array_type& nodes,
+                              VMesh::Elem::index_type i) const;
+  virtual void get_elem_edges(VMesh::Edge::fixed_array_type& edges,
+                              VMesh::Elem::index_type i) const;
+  virtual void get_elem_faces(VMesh::Face::fixed_array_type& faces,
+                              VMesh::Elem::index_type i) const;
+  virtual void get_elem_delems(VMesh::DElem::fixed_array_type& delems,
+                               VMesh::Elem::index_type i) const;
+
   virtual void set_nodes(VMesh::Node::array_type&,
                          VMesh::Elem::index_type);
 
@@ -365,6 +374,38 @@ VTriSurfMesh<MESH>::get_delems(VMesh::DElem::array_type& delems,
   this->mesh_->get_edges_from_face(delems,i);
 }
 
+template <class MESH>
+void
+VTriSurfMesh<MESH>::get_elem_nodes(VMesh::Node::fixed_array_type& nodes,
+                                   VMesh::Elem::index_type i) const
+{
+  this->mesh_->get_nodes_from_face(nodes,i);
+}
+
+template <class MESH>
+void
+VTriSurfMesh<MESH>::get_elem_edges(VMesh::Edge::fixed_array_type& edges,
+                                   VMesh::Elem::index_type i) const
+{
+  this->mesh_->get_edges_from_face(edges,i);
+}
+
+template <class MESH>
+void
+VTriSurfMesh<MESH>::get_elem_faces(VMesh::Face::fixed_array_type& faces,
+                                   VMesh::Elem::index_type i) const
+{
+  faces.resize(1); faces[0] = static_cast<VMesh::Face::index_type>(i);
+}
+
+template <class MESH>
+void
+VTriSurfMesh<MESH>::get_elem_delems(VMesh::DElem::fixed_array_type& delems,
+                                    VMesh::Elem::index_type i) const
+{
+  this->mesh_->get_edges_from_face(delems,i);
+}
+
 template <class MESH>
 void
 VTriSurfMesh<MESH>::set_nodes(VMesh::Node::array_type& nodes,
@@ -52,6 +52,8 @@
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
+#include <Core/Datatypes/Legacy/Field/MeshTopologySort.h>
+#include <Core/Datatypes/Legacy/Field/NodeAdjacency.h>
 #include <Core/Datatypes/Legacy/Base/Types.h>
 
 #include <Core/Thread/Mutex.h>
@@ -422,6 +424,14 @@ public:
 
   void get_elems(typename Elem::array_type &array, typename Node::index_type idx) const
     { get_faces_from_node(array,idx); }
+  /// The faces around node idx without copying them; valid until the mesh
+  /// or its NODE_NEIGHBORS_E synchronization changes.
+  NodeAdjacency::Span get_elems_span(typename Node::index_type idx) const
+  {
+    ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
+	      "TriSurfMesh: Must call synchronize NODE_NEIGHBORS_E on TriSurfMesh first");
+    return node_neighbors_.elems(idx);
+  }
   void get_elems(typename Elem::array_type &array, typename Edge::index_type idx) const
     { get_faces_from_edge(array,idx); }
   void get_elems(typename Elem::array_type &array, typename Face::index_type idx) const
@@ -1547,9 +1557,10 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
 	      "TriSurfMesh: Must call synchronize NODE_NEIGHBORS_E on TriSurfMesh first");
 
-    array.resize(node_neighbors_[idx].size());
-    for (size_t i = 0; i < node_neighbors_[idx].size(); ++i)
-      array[i] = static_cast<typename ARRAY::value_type>(node_neighbors_[idx][i]);
+    const NodeAdjacency::Span faces = node_neighbors_.elems(idx);
+    array.resize(faces.size());
+    for (size_t i = 0; i < faces.size(); ++i)
+      array[i] = static_cast<typename ARRAY::value_type>(faces[i]);
   }
 
 
@@ -1582,7 +1593,7 @@ protected:
               "Must call synchronize NODE_NEIGHBORS_E on TriSurfMesh first");
 
     // Get the table of faces that are connected to the two nodes
-    const std::vector<index_type>& faces  = node_neighbors_[idx];
+    const NodeAdjacency::Span faces = node_neighbors_.elems(idx);
     array.clear();
 
     typename ARRAY::value_type edge;
@@ -1710,7 +1721,7 @@ protected:
     array.clear();
 
     // Get all the neighboring elements
-    const std::vector<index_type>& faces  = node_neighbors_[idx];
+    const NodeAdjacency::Span faces = node_neighbors_.elems(idx);
     // Make a conservative estimate of the number of node neighbors
     array.reserve(2*faces.size());
 
@@ -2006,6 +2017,7 @@ protected:
   void compute_edges();
   // Fixes bug #887 (gforge)
   void compute_edges_bugfix();
+  void compute_edge_topology(SortedTopology<2>& topology);
   void compute_edge_neighbors();
 
   void compute_node_grid();
@@ -2033,7 +2045,7 @@ protected:
   std::vector<index_type>    faces_;               // Connectivity of this mesh
   std::vector<index_type>    edge_neighbors_;      // Neighbor connectivity
   std::vector<Core::Geometry::Vector>        normals_;             // normalized per node normal.
-  std::vector<std::vector<index_type> > node_neighbors_; // Node neighbor connectivity
+  NodeAdjacency node_neighbors_; // Node neighbor connectivity
   std::vector<std::vector<index_type> > edge_on_node_; // Edges emanating from a node
 
   boost::shared_ptr<SearchGridT<index_type> > node_grid_; // Lookup table for nodes
@@ -2066,7 +2078,6 @@ protected:
   };
 
   using EdgeMapType = boost::unordered_map<std::pair<index_type, index_type>, index_type, edgehash>;
-  using EdgeMapType2 = boost::unordered_map<std::pair<index_type, index_type>, std::vector<index_type>, edgehash>;
 };
 
 
@@ -2109,7 +2120,6 @@ TriSurfMesh<Basis>::TriSurfMesh()
   : points_(0),
     faces_(0),
     edge_neighbors_(0),
-    node_neighbors_(0),
     synchronize_lock_("TriSurfMesh lock"),
     synchronize_cond_("TriSurfMesh condition variable"),
     synchronized_(Mesh::NODES_E | Mesh::FACES_E | Mesh::CELLS_E),
@@ -2133,7 +2143,6 @@ TriSurfMesh<Basis>::TriSurfMesh(const TriSurfMesh &copy)
     faces_(0),
     edge_neighbors_(0),
     normals_(0),
-    node_neighbors_(0),
     synchronize_lock_("TriSurfMesh lock"),
     synchronize_cond_("TriSurfMesh condition variable"),
     synchronized_(Mesh::NODES_E | Mesh::FACES_E | Mesh::CELLS_E),
@@ -3172,13 +3181,9 @@ template <class Basis>
 void
 TriSurfMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  size_type nfaces = static_cast<size_type>(faces_.size());
-  for (index_type f = 0; f < nfaces; ++f)
-  {
-    node_neighbors_[faces_[f]].push_back(f/3);
-  }
+  node_neighbors_.build(points_.size(), faces_.size(),
+    [this](index_type f) { return faces_[f]; },
+    [](index_type f) { return f / 3; });
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
   synchronize_lock_.unlock();
@@ -3187,45 +3192,46 @@ TriSurfMesh<Basis>::compute_node_neighbors()
 
 template <class Basis>
 void
-TriSurfMesh<Basis>::compute_edges()
+TriSurfMesh<Basis>::compute_edge_topology(SortedTopology<2>& topology)
 {
-  EdgeMapType2 edge_map;
-
-  size_type num_faces = static_cast<index_type>(faces_.size())/3;
-  for (index_type i=0; i < num_faces; i++)
+  topology.compute(static_cast<size_type>(faces_.size() / 3), 3, static_cast<size_type>(points_.size()),
+    [this](index_type i, typename SortedTopology<2>::key_type* keys, index_type* combined)
   {
-    index_type n0 = faces_[3*i];
-    index_type n1 = faces_[3*i+1];
-    index_type n2 = faces_[3*i+2];
-
-    if (n0 > n1) edge_map[std::pair<index_type, index_type>(n1,n0)].push_back(i<<2);
-    else  edge_map[std::pair<index_type, index_type>(n0,n1)].push_back(i<<2);
-
-    if (n1 > n2) edge_map[std::pair<index_type, index_type>(n2,n1)].push_back((i<<2)+1);
-    else  edge_map[std::pair<index_type, index_type>(n1,n2)].push_back((i<<2)+1);
-
-    if (n2 > n0) edge_map[std::pair<index_type, index_type>(n0,n2)].push_back((i<<2)+2);
-    else  edge_map[std::pair<index_type, index_type>(n2,n0)].push_back((i<<2)+2);
-  }
+    const index_type* n = &faces_[3 * i];
+    keys[0] = {{ n[0], n[1] }};
+    keys[1] = {{ n[1], n[2] }};
+    keys[2] = {{ n[2], n[0] }};
+    for (int j = 0; j < 3; ++j)
+    {
+      SortedTopology<2>::sortNodes(keys[j]);
+      combined[j] = (i << 2) + j;
+    }
+  });
 
-  typename EdgeMapType2::iterator itr;
   edges_.clear();
-  edges_.resize(edge_map.size());
+  edges_.resize(topology.size());
   halfedge_to_edge_.resize(faces_.size());
-
-  size_t k=0;
-  for (itr = edge_map.begin(); itr != edge_map.end(); ++itr)
+  Core::Thread::Parallel::For(0, topology.size(), [this, &topology](size_t begin, size_t end)
   {
-    const std::vector<index_type >& hedges = (*itr).second;
-    for (size_t j=0; j<hedges.size(); j++)
+    for (size_t k = begin; k < end; ++k)
     {
-      index_type h = hedges[j];
-      edges_[k].push_back(h);
-      halfedge_to_edge_[(h>>2)*3 + (h&0x3)] = k;
-
+      edges_[k].resize(topology.count(k));
+      for (size_t j = 0; j < topology.count(k); ++j)
+      {
+        index_type h = topology.occurrence(k, j);
+        edges_[k][j] = h;
+        halfedge_to_edge_[(h>>2)*3 + (h&0x3)] = k;
+      }
     }
-    k++;
-  }
+  });
+}
+
+template <class Basis>
+void
+TriSurfMesh<Basis>::compute_edges()
+{
+  SortedTopology<2> topology;
+  compute_edge_topology(topology);
 
   synchronize_lock_.lock();
   synchronized_ |= (Mesh::EDGES_E);
@@ -3237,45 +3243,15 @@ template <class Basis>
 void
 TriSurfMesh<Basis>::compute_edges_bugfix()
 {
-  EdgeMapType2 edge_map;
-
-  size_type num_faces = static_cast<index_type>(faces_.size())/3;
-  for (index_type i=0; i < num_faces; i++)
-  {
-    index_type n0 = faces_[3*i];
-    index_type n1 = faces_[3*i+1];
-    index_type n2 = faces_[3*i+2];
+  SortedTopology<2> topology;
+  compute_edge_topology(topology);
 
-    if (n0 > n1) edge_map[std::pair<index_type, index_type>(n1,n0)].push_back(i<<2);
-    else  edge_map[std::pair<index_type, index_type>(n0,n1)].push_back(i<<2);
-
-    if (n1 > n2) edge_map[std::pair<index_type, index_type>(n2,n1)].push_back((i<<2)+1);
-    else  edge_map[std::pair<index_type, index_type>(n1,n2)].push_back((i<<2)+1);
-
-    if (n2 > n0) edge_map[std::pair<index_type, index_type>(n0,n2)].push_back((i<<2)+2);
-    else  edge_map[std::pair<index_type, index_type>(n2,n0)].push_back((i<<2)+2);
-  }
-
-  typename EdgeMapType2::iterator itr;
-  edges_.clear();
-  edges_.resize(edge_map.size());
-  halfedge_to_edge_.resize(faces_.size());
   edge_on_node_.clear();
   edge_on_node_.resize(points_.size());
-
-  size_t k=0;
-  for (itr = edge_map.begin(); itr != edge_map.end(); ++itr)
+  for (size_t k = 0; k < topology.size(); ++k)
   {
-    const std::vector<index_type >& hedges = (*itr).second;
-    for (size_t j=0; j<hedges.size(); j++)
-    {
-      index_type h = hedges[j];
-      edges_[k].push_back(h);
-      halfedge_to_edge_[(h>>2)*3 + (h&0x3)] = k;
-    }
-    edge_on_node_[(*itr).first.first].push_back(k);
-    edge_on_node_[(*itr).first.second].push_back(k);
-    k++;
+    edge_on_node_[topology.key(k)[0]].push_back(k);
+    edge_on_node_[topology.key(k)[1]].push_back(k);
   }
 
   synchronize_lock_.lock();
@@ -3296,7 +3272,7 @@ TriSurfMesh<Basis>::add_find_point(const Core::Geometry::Point &p, double err)
   {
     synchronize_lock_.lock();
     points_.push_back(p);
-    node_neighbors_.push_back(std::vector<under_type>());
+    node_neighbors_.add_node();
     synchronize_lock_.unlock();
     return static_cast<typename Node::index_type>(points_.size() - 1);
   }
@@ -32,6 +32,7 @@
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Legacy/Field/VFData.h>
 #include <Core/Datatypes/Legacy/Base/PropertyManager.h>
+#include <atomic>
 
 
 #include <Core/Datatypes/Legacy/Field/share.h>
@@ -61,7 +62,8 @@ public:
     is_scalar_(false),
     is_pair_(false),
     is_vector_(false),
-    is_tensor_(false)
+    is_tensor_(false),
+    shared_values_(false)
   {
     DEBUG_CONSTRUCTOR("VField")
   }
@@ -102,6 +104,7 @@ public:
   /// resize the data fields to match the number of nodes/edges in the mesh
   inline void resize_fdata()
   {
+    prepare_write();
     if (basis_order_ == -1)
     {
       VMesh::dimension_type dim;
@@ -221,29 +224,29 @@ public:
   /// Insert values into field, for every get_value there is an equivalent set_value
   /// likewise get_evalue is replaced by set set_evalue
   template<class T> inline void set_value(const T& val, index_type idx)
-  { vfdata_->set_value(val,idx); }
+  { prepare_write(); vfdata_->set_value(val,idx); }
   template<class T> inline void set_evalue(const T& val, index_type idx)
-  { vfdata_->set_evalue(val,idx); }
+  { prepare_write(); vfdata_->set_evalue(val,idx); }
   template<class T>  inline void set_value(const T& val, VMesh::Node::index_type idx)
-  { vfdata_->set_value(val,static_cast<VMesh::index_type>(idx)); }
+  { prepare_write(); vfdata_->set_value(val,static_cast<VMesh::index_type>(idx)); }
   template<class T>  inline void set_value(const T& val, VMesh::Edge::index_type idx)
-  { vfdata_->set_value(val,static_cast<VMesh::index_type>(idx)); }
+  { prepare_write(); vfdata_->set_value(val,static_cast<VMesh::index_type>(idx)); }
   template<class T>  inline void set_value(const T& val, VMesh::Face::index_type idx)
-  { vfdata_->set_value(val,static_cast<VMesh::index_type>(idx)); }
+  { prepare_write(); vfdata_->set_value(val,static_cast<VMesh::index_type>(idx)); }
   template<class T>  inline void set_value(const T& val, VMesh::Cell::index_type idx)
-  { vfdata_->set_value(val,static_cast<VMesh::index_type>(idx)); }
+  { prepare_write(); vfdata_->set_value(val,static_cast<VMesh::index_type>(idx)); }
   template<class T>  inline void set_value(const T& val, VMesh::Elem::index_type idx)
-  { vfdata_->set_value(val,static_cast<VMesh::index_type>(idx)); }
+  { prepare_write(); vfdata_->set_value(val,static_cast<VMesh::index_type>(idx)); }
   template<class T>  inline void set_value(const T& val, VMesh::DElem::index_type idx)
-  { vfdata_->set_value(val,static_cast<VMesh::index_type>(idx)); }
+  { prepare_write(); vfdata_->set_value(val,static_cast<VMesh::index_type>(idx)); }
   template<class T>  inline void set_value(const T& val, VMesh::ENode::index_type idx)
-  { vfdata_->set_evalue(val,static_cast<VMesh::index_type>(idx)); }
+  { prepare_write(); vfdata_->set_evalue(val,static_cast<VMesh::index_type>(idx)); }
 
   /// Get/Set all values at once
   template<class T> inline void set_values(const std::vector<T>& values)
-  { if (!values.empty()) vfdata_->set_values(&(values[0]),values.size(),0); }
+  { prepare_write(); if (!values.empty()) vfdata_->set_values(&(values[0]),values.size(),0); }
   template<class T> inline void set_values(const T* data, size_type sz, index_type offset = 0)
-  { vfdata_->set_values(data,sz,offset); }
+  { prepare_write(); vfdata_->set_values(data,sz,offset); }
   template<class T> inline void get_values(std::vector<T>& values) const
   { values.resize(vfdata_->fdata_size()); if (values.size()) vfdata_->get_values(&(values[0]),values.size(),0); }
   template<class T> inline void get_values(T* data, size_type sz, index_type offset = 0) const
@@ -251,17 +254,17 @@ public:
 
   // Set/Get values per element array or node array
   template<class T> inline void set_values(const std::vector<T>& values, VMesh::Node::array_type nodes)
-  { if (values.size() > 0) vfdata_->set_values(&(values[0]),nodes); }
+  { prepare_write(); if (values.size() > 0) vfdata_->set_values(&(values[0]),nodes); }
   template<class T> inline void set_values(const std::vector<T>& values, VMesh::Elem::array_type elems)
-  { if (values.size() > 0) vfdata_->set_values(&(values[0]),elems); }
+  { prepare_write(); if (values.size() > 0) vfdata_->set_values(&(values[0]),elems); }
   template<class T,class ARRAY> inline void set_values(const std::vector<T>& values, ARRAY& idx)
-  { if (values.size() > 0) vfdata_->set_values(&(values[0]),&(idx[0]),static_cast<size_type>(idx.size())); }
+  { prepare_write(); if (values.size() > 0) vfdata_->set_values(&(values[0]),&(idx[0]),static_cast<size_type>(idx.size())); }
   template<class T> inline void set_values(const T* values, VMesh::Node::array_type nodes)
-  { vfdata_->set_values(values,nodes); }
+  { prepare_write(); vfdata_->set_values(values,nodes); }
   template<class T> inline void set_values(const T* values, VMesh::Elem::array_type elems)
-  { vfdata_->set_values(values,elems); }
+  { prepare_write(); vfdata_->set_values(values,elems); }
   template<class T,class ARRAY> inline void set_values(const T* values, ARRAY& idx)
-  { vfdata_->set_values(values,&(idx[0]),static_cast<size_type>(idx.size())); }
+  { prepare_write(); vfdata_->set_values(values,&(idx[0]),static_cast<size_type>(idx.size())); }
 
   template<class T> inline void get_values(std::vector<T>& values, VMesh::Node::array_type nodes) const
   { values.resize(nodes.size()); if (values.size() > 0) vfdata_->get_values(&(values[0]),nodes); }
@@ -278,31 +281,31 @@ public:
 
   /// Set all values to a specific value
   template<class T> inline void set_all_values(const T& val)
-  { vfdata_->set_all_values(val); }
+  { prepare_write(); vfdata_->set_all_values(val); }
 
   /// Functions for getting a weighted value
   template<class INDEX> inline void copy_weighted_value(VField* field, const index_type* idx, const weight_type* w, size_type sz, INDEX i) const
-  { vfdata_->copy_weighted_value(field->vfdata_,idx,w,sz,index_type(i)); }
+  { prepare_write(); vfdata_->copy_weighted_value(field->vfdata_,idx,w,sz,index_type(i)); }
   template<class INDEX, class ARRAY> inline void copy_weighted_value(VField* field, ARRAY idx, weight_array_type w, INDEX i) const
-  { vfdata_->copy_weighted_value(field->vfdata_,&(idx[0]),&(w[0]),idx.size(),index_type(i)); }
+  { prepare_write(); vfdata_->copy_weighted_value(field->vfdata_,&(idx[0]),&(w[0]),idx.size(),index_type(i)); }
   template<class INDEX> inline void copy_weighted_evalue(VField* field, const index_type* idx, const weight_type* w, size_type sz, INDEX i) const
-  { vfdata_->copy_weighted_evalue(field->vfdata_,idx,w,sz,index_type(i)); }
+  { prepare_write(); vfdata_->copy_weighted_evalue(field->vfdata_,idx,w,sz,index_type(i)); }
   template<class INDEX, class ARRAY> inline void copy_weighted_evalue(VField* field, ARRAY idx, weight_array_type w, INDEX i) const
-  { vfdata_->copy_weighted_value(field->vfdata_,&(idx[0]),&(w[0]),idx.size(),index_type(i)); }
+  { prepare_write(); vfdata_->copy_weighted_value(field->vfdata_,&(idx[0]),&(w[0]),idx.size(),index_type(i)); }
 
   /// Set all values to zero or its equivalent, all none double data will be casted
   /// to the proper value automatically. This way we do not need an additional
   /// virtual function call
   inline void clear_all_values()
-  { vfdata_->set_all_values(static_cast<double>(0)); }
+  { prepare_write(); vfdata_->set_all_values(static_cast<double>(0)); }
 
   /// The following cases are more specialized cases for copying entiry sets of
   /// data. These functions need to know the size of the inserted data as they
   /// perform a safety check on the length of the fdata array.
   template<class T> inline void set_evalues(const std::vector<T>& values)
-  { vfdata_->set_evalues(&(values[0]),values.size(),0); }
+  { prepare_write(); vfdata_->set_evalues(&(values[0]),values.size(),0); }
   template<class T> inline void set_evalues(const T* data, size_type sz, index_type offset=0)
-  { vfdata_->set_evalues(data,sz,offset); }
+  { prepare_write(); vfdata_->set_evalues(data,sz,offset); }
 
   template<class T> inline void get_evalues(std::vector<T>& values) const
   {
@@ -321,6 +324,7 @@ public:
   template<class INDEX1, class INDEX2>
   inline void copy_value(VField* field, INDEX1 idx1, INDEX2 idx2)
   {
+    prepare_write();
     vfdata_->copy_value(field->vfdata_,index_type(idx1),index_type(idx2));
   }
 
@@ -328,12 +332,14 @@ public:
   template<class INDEX1, class INDEX2>
   inline void copy_evalue(VField* field, INDEX1 idx1, INDEX2 idx2)
   {
+    prepare_write();
     vfdata_->copy_evalue(field->vfdata_,index_type(idx1),index_type(idx2));
   }
 
   template<class INDEX1, class INDEX2>
   inline void copy_values(VField* field, INDEX1 idx1, INDEX2 idx2, size_type sz)
   {
+    prepare_write();
     if (sz > 0)
       vfdata_->copy_values(field->vfdata_,index_type(idx1),index_type(idx2),sz);
   }
@@ -342,6 +348,7 @@ public:
   template<class INDEX1, class INDEX2>
   inline void copy_evalues(VField* field, INDEX1 idx1, INDEX2 idx2, size_type sz)
   {
+    prepare_write();
     if (sz > 0)
       vfdata_->copy_evalues(field->vfdata_,index_type(idx1),index_type(idx2),sz);
   }
@@ -349,10 +356,10 @@ public:
   /// Copy all the values from one container to another container
   /// call these functions from the destination field to import data from another field
   inline void copy_values(VField* field)
-  { vfdata_->copy_values(field->vfdata_); }
+  { prepare_write(); vfdata_->copy_values(field->vfdata_); }
 
   inline void copy_evalues(VField* field)
-  { vfdata_->copy_evalues(field->vfdata_); }
+  { prepare_write(); vfdata_->copy_evalues(field->vfdata_); }
 
   /// Maximum and minimum of values (with index to see where maximum is located)
   inline bool min(double& mn,index_type& idx)
@@ -588,6 +595,12 @@ public:
   template<class T>  inline void gradient(StackVector<T,3>& val, const VMesh::coords_type &coords, VMesh::DElem::index_type idx) const
   { gradient(val, coords, static_cast<VMesh::index_type>(idx)); }
 
+  /// Values of a cloned field stay shared with the original until either one
+  /// writes to them through this interface; the writer then takes a private copy.
+  /// Can remain set after the other field detached, until this one writes.
+  inline bool values_shared() const { return (shared_values_.load(std::memory_order_acquire)); }
+  inline void mark_values_shared() { shared_values_.store(true, std::memory_order_release); }
+
   /// internal function - this one may change in the future
   void update_mesh_pointer(Mesh* mesh)
   {
@@ -597,11 +610,16 @@ public:
 
   // Use these two functions with extra care, as they can cause segmentation
   // errors if the type of the data is not taken into account
-  inline void* get_values_pointer()   { return (vfdata_->fdata_pointer()); }
-  inline void* get_evalues_pointer()   { return (vfdata_->efdata_pointer()); }
+  inline void* get_values_pointer()   { prepare_write(); return (vfdata_->fdata_pointer()); }
+  inline void* get_evalues_pointer()   { prepare_write(); return (vfdata_->efdata_pointer()); }
+
+  inline void* fdata_pointer()   { prepare_write(); return (vfdata_->fdata_pointer()); }
+  inline void* efdata_pointer()   { prepare_write(); return (vfdata_->efdata_pointer()); }
 
-  inline void* fdata_pointer()   { return (vfdata_->fdata_pointer()); }
-  inline void* efdata_pointer()   { return (vfdata_->efdata_pointer()); }
+  // Read-only access: these do not take a private copy of shared values, so the
+  // pointer is only valid until this field is next written to
+  inline const void* get_const_values_pointer() const  { return (vfdata_->fdata_pointer()); }
+  inline const void* get_const_evalues_pointer() const { return (vfdata_->efdata_pointer()); }
 
   inline bool is_nodata()        { return (basis_order_ == -1); }
   inline bool is_constantdata()  { return (basis_order_ == 0); }
@@ -719,6 +737,17 @@ protected:
 
   std::string   data_type_;
 
+  // Set while the value container may be shared with another field
+  mutable std::atomic<bool> shared_values_;
+
+  /// Called on the first write while the values are shared
+  virtual void unshare_values() const {}
+
+  inline void prepare_write() const
+  {
+    if (shared_values_.load(std::memory_order_acquire))
+      unshare_values();
+  }
 };
 
 
@@ -30,6 +30,7 @@
 
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/PointLocateBatch.h>
 
 #include <Core/GeometryPrimitives/Transform.h>
 #include <Core/GeometryPrimitives/BBox.h>
@@ -360,6 +361,51 @@ VMesh::get_delems(DElem::array_type& delems, DElem::index_type i) const
   delems[0] = i;
 }
 
+/// The fast path falls back on the vector version for meshes that do not
+/// provide their own.
+namespace
+{
+  template <class FIXED, class ARRAY>
+  void copy_to_fixed(FIXED& fixed, const ARRAY& array)
+  {
+    fixed.clear();
+    for (size_t k = 0; k < array.size(); ++k)
+      fixed.push_back(array[k]);
+  }
+}
+
+void
+VMesh::get_elem_nodes(Node::fixed_array_type& nodes, Elem::index_type i) const
+{
+  Node::array_type array;
+  get_nodes(array, i);
+  copy_to_fixed(nodes, array);
+}
+
+void
+VMesh::get_elem_edges(Edge::fixed_array_type& edges, Elem::index_type i) const
+{
+  Edge::array_type array;
+  get_edges(array, i);
+  copy_to_fixed(edges, array);
+}
+
+void
+VMesh::get_elem_faces(Face::fixed_array_type& faces, Elem::index_type i) const
+{
+  Face::array_type array;
+  get_faces(array, i);
+  copy_to_fixed(faces, array);
+}
+
+void
+VMesh::get_elem_delems(DElem::fixed_array_type& delems, Elem::index_type i) const
+{
+  DElem::array_type array;
+  get_delems(array, i);
+  copy_to_fixed(delems, array);
+}
+
 
 bool
 VMesh::get_elem(Elem::index_type&, Node::array_type&) const
@@ -544,6 +590,25 @@ VMesh::mlocate(std::vector<Elem::index_type> &, const std::vector<Point> &) cons
   ASSERTFAIL("VMesh interface: mlocate(std::vector<Elem::index_type>,Point) has not been implemented");
 }
 
+void
+VMesh::locate_points(const std::vector<Point> &point,
+                     std::vector<Elem::index_type> &elems) const
+{
+  locate_point_batch(point, elems, static_cast<std::vector<coords_type>*>(nullptr),
+    [this](Elem::index_type& elem, coords_type&, const Point& p)
+    { return locate(elem, p); });
+}
+
+void
+VMesh::locate_points(const std::vector<Point> &point,
+                     std::vector<Elem::index_type> &elems,
+                     std::vector<coords_type> &coords) const
+{
+  locate_point_batch(point, elems, &coords,
+    [this](Elem::index_type& elem, coords_type& c, const Point& p)
+    { return locate(elem, p) && get_coords(c, p, elem); });
+}
+
 
 bool
 VMesh::find_closest_node(double&, Point&, VMesh::Node::index_type&, const Point &) const
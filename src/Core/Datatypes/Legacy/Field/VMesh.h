@@ -106,6 +106,7 @@ public:
       typedef VNodeIndex<VMesh::index_type>      index_type;
       typedef VNodeIndex<VMesh::size_type>       size_type;
       typedef StackBasedVector<index_type,8>     array_type;
+      typedef StackVector<index_type,8>          fixed_array_type;
   };
 
   typedef std::vector<Node::array_type>                nodes_array_type;
@@ -127,6 +128,7 @@ public:
       typedef VEdgeIndex<VMesh::index_type>      index_type;
       typedef VEdgeIndex<VMesh::size_type>       size_type;
       typedef StackBasedVector<index_type,12>    array_type;
+      typedef StackVector<index_type,12>         fixed_array_type;
   };
 
   /// Class for indexing faces
@@ -136,6 +138,7 @@ public:
       typedef VFaceIndex<VMesh::index_type>      index_type;
       typedef VFaceIndex<VMesh::size_type>       size_type;
       typedef StackBasedVector<index_type,12>    array_type;
+      typedef StackVector<index_type,6>          fixed_array_type;
   };
 
   /// Class for indexing cells
@@ -182,6 +185,7 @@ public:
       typedef VDElemIndex<VMesh::index_type>     index_type;
       typedef VDElemIndex<VMesh::size_type>      size_type;
       typedef StackBasedVector<index_type,12>    array_type;
+      typedef StackVector<index_type,6>          fixed_array_type;
  };
 
 
@@ -242,7 +246,8 @@ public:
     num_edges_per_elem_(0),
     num_faces_per_elem_(0),
     num_nodes_per_face_(0),
-    num_edges_per_face_(0)
+    num_edges_per_face_(0),
+    generation_(0)
   {
     /// This call is only made in DEBUG mode, to keep a record of all the
     /// objects that are being allocated and freed.
@@ -406,6 +411,17 @@ public:
   virtual void get_delems(DElem::array_type& delems, Elem::index_type i) const;
   virtual void get_delems(DElem::array_type& delems, DElem::index_type i) const;
 
+  /// Fast path for the topology of a single element. The array_type
+  /// containers above are std::vectors and allocate when they are created;
+  /// fixed_array_type lives on the stack and holds the largest element (a hex:
+  /// 8 nodes, 12 edges and 6 faces), so these calls never touch the heap.
+  /// Use them in loops that visit every element, declaring the array outside
+  /// the loop: a new array zero-fills all of its slots.
+  virtual void get_elem_nodes(Node::fixed_array_type& nodes, Elem::index_type i) const;
+  virtual void get_elem_edges(Edge::fixed_array_type& edges, Elem::index_type i) const;
+  virtual void get_elem_faces(Face::fixed_array_type& faces, Elem::index_type i) const;
+  virtual void get_elem_delems(DElem::fixed_array_type& delems, Elem::index_type i) const;
+
   /// Get the topology index from the vertex indices
   virtual bool get_elem(Elem::index_type& elem, Node::array_type& nodes) const;
   virtual bool get_delem(DElem::index_type& delem, Node::array_type& nodes) const;
@@ -584,6 +600,17 @@ public:
   virtual void mlocate(std::vector<Elem::index_type> &i,
                        const std::vector<Core::Geometry::Point> &point) const;
 
+  /// Locate a large batch of points, e.g. all the nodes of a destination mesh.
+  /// The points are searched in Morton order, each starting from the element
+  /// of the previous hit, and in parallel; see locate_point_batch in
+  /// PointLocateBatch.h. elems[k] (and coords[k]) belong to point[k]; points
+  /// outside the mesh get element -1. Requires synchronize(ELEM_LOCATE_E).
+  virtual void locate_points(const std::vector<Core::Geometry::Point> &point,
+                             std::vector<Elem::index_type> &elems) const;
+  virtual void locate_points(const std::vector<Core::Geometry::Point> &point,
+                             std::vector<Elem::index_type> &elems,
+                             std::vector<coords_type> &coords) const;
+
   /// Find elements that are inside or close to the bounding box. This function
   /// uses the underlying search structure to find candidates that are close.
   /// This functionality is general intended to speed up searching for elements
@@ -30,6 +30,7 @@
 #define CORE_DATATYPES_VUNSTRUCTUREDMESH_H
 
 #include <Core/Datatypes/Legacy/Field/VMeshShared.h>
+#include <Core/Datatypes/Legacy/Field/PointLocateBatch.h>
 
 /// Include needed for Windows: declares SCISHARE
 #include <Core/Datatypes/Legacy/Field/share.h>
@@ -80,6 +81,11 @@ public:
 
   virtual void mlocate(std::vector<VMesh::Node::index_type> &i, const std::vector<Core::Geometry::Point> &point) const;
   virtual void mlocate(std::vector<VMesh::Elem::index_type> &i, const std::vector<Core::Geometry::Point> &point) const;
+  virtual void locate_points(const std::vector<Core::Geometry::Point> &point,
+                             std::vector<VMesh::Elem::index_type> &elems) const;
+  virtual void locate_points(const std::vector<Core::Geometry::Point> &point,
+                             std::vector<VMesh::Elem::index_type> &elems,
+                             std::vector<VMesh::coords_type> &coords) const;
 
   virtual bool get_coords(VMesh::coords_type &coords,
                           const Core::Geometry::Point &point, VMesh::Elem::index_type i) const;
@@ -373,6 +379,34 @@ mlocate(std::vector<VMesh::Elem::index_type> &idx, const std::vector<Core::Geome
   }
 }
 
+template <class MESH>
+void
+VUnstructuredMesh<MESH>::
+locate_points(const std::vector<Core::Geometry::Point> &point,
+              std::vector<VMesh::Elem::index_type> &elems) const
+{
+  locate_point_batch(point, elems, static_cast<std::vector<VMesh::coords_type>*>(nullptr),
+    [this](VMesh::Elem::index_type& elem, VMesh::coords_type&, const Core::Geometry::Point& p)
+    { return this->mesh_->locate_elem(elem, p); });
+}
+
+template <class MESH>
+void
+VUnstructuredMesh<MESH>::
+locate_points(const std::vector<Core::Geometry::Point> &point,
+              std::vector<VMesh::Elem::index_type> &elems,
+              std::vector<VMesh::coords_type> &coords) const
+{
+  locate_point_batch(point, elems, &coords,
+    [this](VMesh::Elem::index_type& elem, VMesh::coords_type& c, const Core::Geometry::Point& p)
+    {
+      // locate_elem(elem, coords, p) skips the coordinates for higher order
+      // elements; get_coords handles every order.
+      return this->mesh_->locate_elem(elem, p) &&
+        this->mesh_->get_coords(c, p, typename MESH::Elem::index_type(elem));
+    });
+}
+
 template <class MESH>
 bool
 VUnstructuredMesh<MESH>::
@@ -876,7 +910,8 @@ get_minterpolate_weights(const std::vector<Core::Geometry::Point>& point,
                          int basis_order) const
 {
   ei.resize(point.size());
-  typename MESH::Elem::index_type elem;
+  std::vector<VMesh::Elem::index_type> elems;
+  this->locate_points(point,elems);
 
   switch (basis_order)
   {
@@ -884,8 +919,8 @@ get_minterpolate_weights(const std::vector<Core::Geometry::Point>& point,
       {
         for (size_t i=0; i<ei.size();i++)
         {
-          if (i == 0) elem = ei[0].elem_index;
-          if(this->mesh_->locate(elem,point[i]))
+          typename MESH::Elem::index_type elem(elems[i]);
+          if (elems[i] >= 0)
           {
             ei[i].basis_order = basis_order;
             ei[i].elem_index = elem;
@@ -903,8 +938,8 @@ get_minterpolate_weights(const std::vector<Core::Geometry::Point>& point,
         StackVector<double,3> coords;
         for (size_t i=0; i<ei.size();i++)
         {
-          if (i == 0) elem = ei[0].elem_index;
-          if(this->mesh_->locate(elem,point[i]))
+          typename MESH::Elem::index_type elem(elems[i]);
+          if (elems[i] >= 0)
           {
             this->mesh_->get_coords(coords,point[i],elem);
             ei[i].basis_order = basis_order;
@@ -927,8 +962,8 @@ get_minterpolate_weights(const std::vector<Core::Geometry::Point>& point,
 
         for (size_t i=0; i<ei.size();i++)
         {
-          if (i == 0) elem = ei[0].elem_index;
-          if(this->mesh_->locate(elem,point[i]))
+          typename MESH::Elem::index_type elem(elems[i]);
+          if (elems[i] >= 0)
           {
             this->mesh_->get_coords(coords,point[i],elem);
             ei[i].basis_order = basis_order;
@@ -952,8 +987,8 @@ get_minterpolate_weights(const std::vector<Core::Geometry::Point>& point,
 
         for (size_t i=0; i<ei.size();i++)
         {
-          if (i == 0) elem = ei[0].elem_index;
-          if(this->mesh_->locate(elem,point[i]))
+          typename MESH::Elem::index_type elem(elems[i]);
+          if (elems[i] >= 0)
           {
             this->mesh_->get_coords(coords,point[i],elem);
             ei[i].basis_order = basis_order;
@@ -1145,15 +1180,17 @@ get_mgradient_weights(const std::vector<Core::Geometry::Point>& point,
                       int basis_order) const
 {
   eg.resize(point.size());
+  std::vector<VMesh::Elem::index_type> elems;
+  this->locate_points(point,elems);
 
   switch (basis_order)
   {
     case 0:
       {
-        typename MESH::Elem::index_type elem;
         for (size_t i=0; i< point.size(); i++)
         {
-          if(this->mesh_->locate(elem,point[i]))
+          typename MESH::Elem::index_type elem(elems[i]);
+          if (elems[i] >= 0)
           {
             eg[i].basis_order = basis_order;
             eg[i].elem_index = elem;
@@ -1168,12 +1205,12 @@ get_mgradient_weights(const std::vector<Core::Geometry::Point>& point,
       return;
     case 1:
       {
-        typename MESH::Elem::index_type elem;
         StackVector<double,3> coords;
         for (size_t i=0; i< point.size(); i++)
         {
           eg[i].basis_order = basis_order;
-          if(this->mesh_->locate(elem,point[i]))
+          typename MESH::Elem::index_type elem(elems[i]);
+          if (elems[i] >= 0)
           {
             eg[i].elem_index = elem;
             this->mesh_->get_coords(coords,point[i],elem);
@@ -1194,12 +1231,12 @@ get_mgradient_weights(const std::vector<Core::Geometry::Point>& point,
       return;
     case 2:
       {
-        typename MESH::Elem::index_type elem;
         StackVector<double,3> coords;
         for (size_t i=0; i< point.size(); i++)
         {
           eg[i].basis_order = basis_order;
-          if(this->mesh_->locate(elem,point[i]))
+          typename MESH::Elem::index_type elem(elems[i]);
+          if (elems[i] >= 0)
           {
             eg[i].elem_index = elem;
             this->mesh_->get_coords(coords,point[i],elem);
@@ -1222,12 +1259,12 @@ get_mgradient_weights(const std::vector<Core::Geometry::Point>& point,
       return;
     case 3:
       {
-        typename MESH::Elem::index_type elem;
         StackBasedVector<double,3> coords;
         for (size_t i=0; i< point.size(); i++)
         {
           eg[i].basis_order = basis_order;
-          if(this->mesh_->locate(elem,point[i]))
+          typename MESH::Elem::index_type elem(elems[i]);
+          if (elems[i] >= 0)
           {
             eg[i].elem_index = elem;
             this->mesh_->get_coords(coords,point[i],elem);
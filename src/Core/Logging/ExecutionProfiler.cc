@@ -0,0 +1,336 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Logging/ExecutionProfiler.h>
+#include <boost/filesystem/fstream.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using namespace SCIRun::Core::Logging;
+
+CORE_SINGLETON_IMPLEMENTATION(ExecutionProfiler)
+
+namespace
+{
+  typedef boost::lock_guard<boost::mutex> Guard;
+
+  std::string jsonEscape(const std::string& s)
+  {
+    std::ostringstream ostr;
+    for (auto c : s)
+    {
+      switch (c)
+      {
+      case '"': ostr << "\\\""; break;
+      case '\\': ostr << "\\\\"; break;
+      case '\n': ostr << "\\n"; break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+          ostr << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        else
+          ostr << c;
+      }
+    }
+    return ostr.str();
+  }
+
+  long long microseconds(double seconds)
+  {
+    return static_cast<long long>(seconds * 1e6);
+  }
+}
+
+ExecutionProfiler::ExecutionProfiler() : enabled_(false), epoch_(Clock::now())
+{
+}
+
+void ExecutionProfiler::setEnabled(bool enabled)
+{
+  if (enabled && !enabled_)
+    clear();
+  enabled_ = enabled;
+}
+
+void ExecutionProfiler::clear()
+{
+  Guard g(lock_);
+  epoch_ = Clock::now();
+  scheduled_.clear();
+  queued_.clear();
+  running_.clear();
+  finished_.clear();
+  spans_.clear();
+}
+
+double ExecutionProfiler::secondsSinceEpoch(Clock::time_point t) const
+{
+  return boost::chrono::duration<double>(t - epoch_).count();
+}
+
+int ExecutionProfiler::threadIndex()
+{
+  auto id = boost::this_thread::get_id();
+  auto i = threads_.find(id);
+  if (i != threads_.end())
+    return i->second;
+  auto index = static_cast<int>(threads_.size()) + 1;
+  threads_[id] = index;
+  return index;
+}
+
+long long ExecutionProfiler::peakResidentBytes()
+{
+#ifdef _WIN32
+  return 0;
+#else
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#ifdef __APPLE__
+  return usage.ru_maxrss;
+#else
+  return usage.ru_maxrss * 1024LL;
+#endif
+#endif
+}
+
+void ExecutionProfiler::moduleScheduled(const std::string& moduleId)
+{
+  if (!enabled_)
+    return;
+  auto now = Clock::now();
+  Guard g(lock_);
+  scheduled_[moduleId] = secondsSinceEpoch(now);
+}
+
+void ExecutionProfiler::moduleQueued(const std::string& moduleId)
+{
+  if (!enabled_)
+    return;
+  auto now = Clock::now();
+  Guard g(lock_);
+  queued_[moduleId] = secondsSinceEpoch(now);
+}
+
+void ExecutionProfiler::moduleStarted(const std::string& moduleId)
+{
+  if (!enabled_)
+    return;
+  auto rss = peakResidentBytes();
+  auto now = Clock::now();
+  Guard g(lock_);
+  ModuleExecution record { moduleId, 0, 0, secondsSinceEpoch(now), 0, 0, rss, threadIndex() };
+  auto q = queued_.find(moduleId);
+  if (q != queued_.end())
+  {
+    record.queued = q->second;
+    queued_.erase(q);
+  }
+  else
+    record.queued = record.started;
+  auto s = scheduled_.find(moduleId);
+  if (s != scheduled_.end())
+  {
+    record.scheduled = std::min(s->second, record.queued);
+    scheduled_.erase(s);
+  }
+  else
+    record.scheduled = record.queued;
+  running_[moduleId] = record;
+}
+
+void ExecutionProfiler::moduleInputFetch(const std::string& moduleId, double seconds)
+{
+  if (!enabled_)
+    return;
+  Guard g(lock_);
+  auto r = running_.find(moduleId);
+  if (r != running_.end())
+    r->second.inputFetch += seconds;
+}
+
+void ExecutionProfiler::moduleFinished(const std::string& moduleId)
+{
+  if (!enabled_)
+    return;
+  auto now = Clock::now();
+  auto rss = peakResidentBytes();
+  Guard g(lock_);
+  auto r = running_.find(moduleId);
+  if (r == running_.end())
+    return;
+  auto record = r->second;
+  running_.erase(r);
+  record.finished = secondsSinceEpoch(now);
+  // peakRssDelta held the peak at start until now
+  record.peakRssDelta = rss - record.peakRssDelta;
+  finished_.push_back(record);
+}
+
+void ExecutionProfiler::recordSpan(const std::string& name, const std::string& category, Clock::time_point begin, Clock::time_point end)
+{
+  if (!enabled_)
+    return;
+  Guard g(lock_);
+  spans_.push_back({ name, category, secondsSinceEpoch(begin), secondsSinceEpoch(end), threadIndex() });
+}
+
+std::vector<ExecutionProfiler::ModuleExecution> ExecutionProfiler::moduleExecutions() const
+{
+  Guard g(lock_);
+  return finished_;
+}
+
+std::vector<ExecutionProfiler::Span> ExecutionProfiler::spans() const
+{
+  Guard g(lock_);
+  return spans_;
+}
+
+bool ExecutionProfiler::writeChromeTrace(const boost::filesystem::path& file) const
+{
+  auto modules = moduleExecutions();
+  auto spans = this->spans();
+
+  boost::filesystem::ofstream out(file);
+  if (!out)
+    return false;
+
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"SCIRun\"}}";
+  long long asyncId = 0;
+  for (const auto& m : modules)
+  {
+    auto name = jsonEscape(m.moduleId);
+    out << ",\n{\"name\":\"" << name << "\",\"cat\":\"module\",\"ph\":\"X\",\"pid\":1,\"tid\":" << m.thread
+      << ",\"ts\":" << microseconds(m.started) << ",\"dur\":" << microseconds(m.finished - m.started)
+      << ",\"args\":{\"upstream_wait_us\":" << microseconds(m.queued - m.scheduled)
+      << ",\"queue_wait_us\":" << microseconds(m.started - m.queued)
+      << ",\"input_fetch_us\":" << microseconds(m.inputFetch)
+      << ",\"peak_rss_delta_bytes\":" << m.peakRssDelta << "}}";
+    // async pairs, since the waits of different modules overlap freely
+    auto writeWait = [&](const char* category, double begin, double end)
+    {
+      if (end <= begin)
+        return;
+      ++asyncId;
+      out << ",\n{\"name\":\"" << name << "\",\"cat\":\"" << category << "\",\"ph\":\"b\",\"id\":" << asyncId
+        << ",\"pid\":1,\"tid\":0,\"ts\":" << microseconds(begin) << "}";
+      out << ",\n{\"name\":\"" << name << "\",\"cat\":\"" << category << "\",\"ph\":\"e\",\"id\":" << asyncId
+        << ",\"pid\":1,\"tid\":0,\"ts\":" << microseconds(end) << "}";
+    };
+    writeWait("upstream", m.scheduled, m.queued);
+    writeWait("queued", m.queued, m.started);
+  }
+  for (const auto& s : spans)
+  {
+    out << ",\n{\"name\":\"" << jsonEscape(s.name) << "\",\"cat\":\"" << jsonEscape(s.category)
+      << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << s.thread
+      << ",\"ts\":" << microseconds(s.begin) << ",\"dur\":" << microseconds(s.end - s.begin) << "}";
+  }
+  out << "\n]}\n";
+  return static_cast<bool>(out);
+}
+
+std::string ExecutionProfiler::summaryTable() const
+{
+  struct Totals
+  {
+    size_t runs = 0;
+    double compute = 0, upstream = 0, queued = 0, fetch = 0;
+    long long peakRssDelta = 0;
+  };
+  std::map<std::string, Totals> byModule;
+  double first = 0, last = 0, compute = 0;
+  bool any = false;
+  for (const auto& m : moduleExecutions())
+  {
+    auto& t = byModule[m.moduleId];
+    ++t.runs;
+    t.compute += m.finished - m.started;
+    t.upstream += m.queued - m.scheduled;
+    t.queued += m.started - m.queued;
+    t.fetch += m.inputFetch;
+    t.peakRssDelta = std::max(t.peakRssDelta, m.peakRssDelta);
+    compute += m.finished - m.started;
+    first = any ? std::min(first, m.scheduled) : m.scheduled;
+    last = any ? std::max(last, m.finished) : m.finished;
+    any = true;
+  }
+
+  std::vector<std::pair<std::string, Totals>> rows(byModule.begin(), byModule.end());
+  std::sort(rows.begin(), rows.end(), [](const std::pair<std::string, Totals>& a, const std::pair<std::string, Totals>& b)
+    { return a.second.compute > b.second.compute; });
+
+  std::ostringstream ostr;
+  ostr << std::left << std::setw(32) << "Module" << std::right << std::setw(6) << "Runs"
+    << std::setw(12) << "Compute(s)" << std::setw(13) << "Upstream(s)" << std::setw(12) << "Queued(s)"
+    << std::setw(12) << "Fetch(s)"
+    << std::setw(14) << "PeakRSS+(MB)" << "\n";
+  ostr << std::fixed << std::setprecision(3);
+  for (const auto& row : rows)
+  {
+    ostr << std::left << std::setw(32) << row.first << std::right << std::setw(6) << row.second.runs
+      << std::setw(12) << row.second.compute << std::setw(13) << row.second.upstream
+      << std::setw(12) << row.second.queued << std::setw(12) << row.second.fetch << std::setw(14) << row.second.peakRssDelta / (1024.0 * 1024.0) << "\n";
+  }
+
+  double parallel = 0;
+  size_t parallelSpans = 0;
+  for (const auto& s : spans())
+  {
+    if (s.category == "parallel")
+    {
+      parallel += s.end - s.begin;
+      ++parallelSpans;
+    }
+  }
+  ostr << "Wall time " << (last - first) << " s, summed module compute " << compute << " s";
+  if (last > first)
+    ostr << " (average parallelism " << compute / (last - first) << ")";
+  ostr << ", " << parallelSpans << " parallel task spans totalling " << parallel << " s\n";
+  return ostr.str();
+}
+
+ExecutionProfiler::ScopedSpan::ScopedSpan(const char* name, const char* category) :
+  name_(name), category_(category), active_(ExecutionProfiler::Instance().enabled())
+{
+  if (active_)
+    begin_ = Clock::now();
+}
+
+ExecutionProfiler::ScopedSpan::~ScopedSpan()
+{
+  if (active_)
+    ExecutionProfiler::Instance().recordSpan(name_, category_, begin_, Clock::now());
+}
@@ -0,0 +1,135 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_LOGGING_EXECUTIONPROFILER_H
+#define CORE_LOGGING_EXECUTIONPROFILER_H
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/chrono.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <Core/Utils/Singleton.h>
+#include <Core/Logging/share.h>
+
+namespace SCIRun
+{
+  namespace Core
+  {
+    namespace Logging
+    {
+      /// Records when each module execution was scheduled, queued, started and finished, how
+      /// long it spent fetching data from its input ports and how much it raised peak RSS, plus
+      /// spans of named work such as Parallel::RunTasks tasks. Exports a Chrome trace-event file (load it in
+      /// chrome://tracing or Perfetto) and a per-module summary table. Every hook returns
+      /// immediately while the profiler is disabled.
+      class SCISHARE ExecutionProfiler : boost::noncopyable
+      {
+        CORE_SINGLETON(ExecutionProfiler)
+      public:
+        typedef boost::chrono::steady_clock Clock;
+
+        struct ModuleExecution
+        {
+          std::string moduleId;
+          /// Seconds since the profiler was enabled. scheduled is when a network execution took
+          /// the module, queued when its upstream modules were done and it was handed to a
+          /// worker; queued equals started for executors without a run queue, and scheduled
+          /// equals queued when nothing scheduled it.
+          double scheduled, queued, started, finished;
+          /// Seconds spent in port getData calls, including reloads of evicted data.
+          double inputFetch;
+          long long peakRssDelta;
+          int thread;
+        };
+
+        struct Span
+        {
+          std::string name, category;
+          double begin, end;
+          int thread;
+        };
+
+        void setEnabled(bool enabled);
+        bool enabled() const { return enabled_; }
+        /// Drops everything recorded and restarts the clock.
+        void clear();
+
+        void moduleScheduled(const std::string& moduleId);
+        void moduleQueued(const std::string& moduleId);
+        void moduleStarted(const std::string& moduleId);
+        void moduleInputFetch(const std::string& moduleId, double seconds);
+        void moduleFinished(const std::string& moduleId);
+        void recordSpan(const std::string& name, const std::string& category, Clock::time_point begin, Clock::time_point end);
+
+        std::vector<ModuleExecution> moduleExecutions() const;
+        std::vector<Span> spans() const;
+
+        bool writeChromeTrace(const boost::filesystem::path& file) const;
+        std::string summaryTable() const;
+
+        /// Process peak resident set size in bytes, 0 where unsupported.
+        static long long peakResidentBytes();
+
+        /// Records its own lifetime as a span on the current thread.
+        class SCISHARE ScopedSpan : boost::noncopyable
+        {
+        public:
+          ScopedSpan(const char* name, const char* category);
+          ~ScopedSpan();
+        private:
+          const char* name_;
+          const char* category_;
+          bool active_;
+          Clock::time_point begin_;
+        };
+
+      private:
+        ExecutionProfiler();
+        double secondsSinceEpoch(Clock::time_point t) const;
+        int threadIndex();
+
+        std::atomic<bool> enabled_;
+        Clock::time_point epoch_;
+        mutable boost::mutex lock_;
+        std::map<std::string, double> scheduled_;
+        std::map<std::string, double> queued_;
+        std::map<std::string, ModuleExecution> running_;
+        std::vector<ModuleExecution> finished_;
+        std::vector<Span> spans_;
+        std::map<boost::thread::id, int> threads_;
+      };
+    }
+  }
+}
+
+#endif
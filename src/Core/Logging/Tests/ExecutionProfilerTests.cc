@@ -0,0 +1,174 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+#include <boost/thread/thread.hpp>
+#include <fstream>
+#include <sstream>
+#include <Core/Logging/ExecutionProfiler.h>
+
+using namespace SCIRun::Core::Logging;
+
+class ExecutionProfilerTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ExecutionProfiler::Instance().setEnabled(true);
+  }
+  void TearDown() override
+  {
+    ExecutionProfiler::Instance().setEnabled(false);
+    ExecutionProfiler::Instance().clear();
+  }
+};
+
+TEST_F(ExecutionProfilerTests, RecordsNothingWhenDisabled)
+{
+  auto& profiler = ExecutionProfiler::Instance();
+  profiler.setEnabled(false);
+  profiler.clear();
+
+  profiler.moduleQueued("ReadMatrix:0");
+  profiler.moduleStarted("ReadMatrix:0");
+  profiler.moduleFinished("ReadMatrix:0");
+  {
+    ExecutionProfiler::ScopedSpan span("task", "parallel");
+  }
+
+  EXPECT_TRUE(profiler.moduleExecutions().empty());
+  EXPECT_TRUE(profiler.spans().empty());
+}
+
+TEST_F(ExecutionProfilerTests, RecordsQueueWaitAndComputeTimes)
+{
+  auto& profiler = ExecutionProfiler::Instance();
+
+  profiler.moduleQueued("ReadMatrix:0");
+  boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+  profiler.moduleStarted("ReadMatrix:0");
+  profiler.moduleInputFetch("ReadMatrix:0", 0.005);
+  boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+  profiler.moduleFinished("ReadMatrix:0");
+
+  auto runs = profiler.moduleExecutions();
+  ASSERT_EQ(1, runs.size());
+  const auto& run = runs[0];
+  EXPECT_EQ("ReadMatrix:0", run.moduleId);
+  EXPECT_LE(run.queued, run.started);
+  EXPECT_LE(run.started, run.finished);
+  EXPECT_GE(run.started - run.queued, 0.015);
+  EXPECT_GE(run.finished - run.started, 0.005);
+  EXPECT_DOUBLE_EQ(0.005, run.inputFetch);
+  EXPECT_GE(run.peakRssDelta, 0);
+}
+
+TEST_F(ExecutionProfilerTests, StartWithoutQueueUsesStartAsQueueTime)
+{
+  auto& profiler = ExecutionProfiler::Instance();
+
+  profiler.moduleStarted("ShowField:1");
+  profiler.moduleFinished("ShowField:1");
+
+  auto runs = profiler.moduleExecutions();
+  ASSERT_EQ(1, runs.size());
+  EXPECT_EQ(runs[0].queued, runs[0].started);
+  EXPECT_EQ(runs[0].scheduled, runs[0].queued);
+}
+
+TEST_F(ExecutionProfilerTests, SeparatesUpstreamWaitFromQueueWait)
+{
+  auto& profiler = ExecutionProfiler::Instance();
+
+  profiler.moduleScheduled("ShowField:1");
+  boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+  profiler.moduleQueued("ShowField:1");
+  boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+  profiler.moduleStarted("ShowField:1");
+  profiler.moduleFinished("ShowField:1");
+
+  // a serial executor schedules but never queues
+  profiler.moduleScheduled("ReadField:0");
+  boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+  profiler.moduleStarted("ReadField:0");
+  profiler.moduleFinished("ReadField:0");
+
+  auto runs = profiler.moduleExecutions();
+  ASSERT_EQ(2, runs.size());
+  EXPECT_GE(runs[0].queued - runs[0].scheduled, 0.015);
+  EXPECT_GE(runs[0].started - runs[0].queued, 0.005);
+  EXPECT_GE(runs[1].queued - runs[1].scheduled, 0.005);
+  EXPECT_EQ(runs[1].queued, runs[1].started);
+}
+
+TEST_F(ExecutionProfilerTests, ScopedSpanRecordsLifetime)
+{
+  auto& profiler = ExecutionProfiler::Instance();
+  {
+    ExecutionProfiler::ScopedSpan span("Parallel::RunTasks", "parallel");
+    boost::this_thread::sleep(boost::posix_time::milliseconds(5));
+  }
+
+  auto spans = profiler.spans();
+  ASSERT_EQ(1, spans.size());
+  EXPECT_EQ("Parallel::RunTasks", spans[0].name);
+  EXPECT_EQ("parallel", spans[0].category);
+  EXPECT_GE(spans[0].end - spans[0].begin, 0.004);
+}
+
+TEST_F(ExecutionProfilerTests, WritesChromeTraceAndSummary)
+{
+  auto& profiler = ExecutionProfiler::Instance();
+  profiler.moduleQueued("ReadMatrix:0");
+  profiler.moduleStarted("ReadMatrix:0");
+  profiler.moduleFinished("ReadMatrix:0");
+  {
+    ExecutionProfiler::ScopedSpan span("Parallel::RunTasks", "parallel");
+  }
+
+  auto file = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("profile-%%%%-%%%%.json");
+  ASSERT_TRUE(profiler.writeChromeTrace(file));
+
+  std::ifstream in(file.string());
+  std::stringstream contents;
+  contents << in.rdbuf();
+  in.close();
+  boost::filesystem::remove(file);
+  const auto trace = contents.str();
+
+  EXPECT_NE(std::string::npos, trace.find("\"traceEvents\""));
+  EXPECT_NE(std::string::npos, trace.find("\"name\":\"ReadMatrix:0\""));
+  EXPECT_NE(std::string::npos, trace.find("\"upstream_wait_us\""));
+  EXPECT_NE(std::string::npos, trace.find("\"queue_wait_us\""));
+  EXPECT_NE(std::string::npos, trace.find("\"input_fetch_us\""));
+  EXPECT_NE(std::string::npos, trace.find("\"name\":\"Parallel::RunTasks\""));
+
+  const auto summary = profiler.summaryTable();
+  EXPECT_NE(std::string::npos, summary.find("ReadMatrix:0"));
+}
@@ -0,0 +1,103 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Thread/CoreBudget.h>
+#include <Core/Thread/Parallel.h>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <algorithm>
+
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  boost::mutex budgetMutex;
+  boost::condition_variable coreFreed;
+  unsigned int coresInUse = 0;
+
+  unsigned int budgetCapacity()
+  {
+    return std::max(Parallel::NumCores(), 1u);
+  }
+}
+
+void CoreBudget::acquire()
+{
+  boost::this_thread::disable_interruption noInterrupt;
+  boost::unique_lock<boost::mutex> lock(budgetMutex);
+  while (coresInUse >= budgetCapacity())
+    coreFreed.wait(lock);
+  ++coresInUse;
+}
+
+unsigned int CoreBudget::tryAcquire(unsigned int wanted)
+{
+  boost::lock_guard<boost::mutex> lock(budgetMutex);
+  const auto cap = budgetCapacity();
+  const auto granted = coresInUse < cap ? std::min(wanted, cap - coresInUse) : 0u;
+  coresInUse += granted;
+  return granted;
+}
+
+void CoreBudget::acquireUnchecked(unsigned int count)
+{
+  boost::lock_guard<boost::mutex> lock(budgetMutex);
+  coresInUse += count;
+}
+
+void CoreBudget::release(unsigned int count)
+{
+  if (0 == count)
+    return;
+  {
+    boost::lock_guard<boost::mutex> lock(budgetMutex);
+    coresInUse -= std::min(count, coresInUse);
+  }
+  coreFreed.notify_all();
+}
+
+unsigned int CoreBudget::inUse()
+{
+  boost::lock_guard<boost::mutex> lock(budgetMutex);
+  return coresInUse;
+}
+
+unsigned int CoreBudget::capacity()
+{
+  return budgetCapacity();
+}
+
+void CoreBudget::capacityChanged()
+{
+  {
+    boost::lock_guard<boost::mutex> lock(budgetMutex);
+  }
+  coreFreed.notify_all();
+}
@@ -0,0 +1,76 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_THREAD_COREBUDGET_H
+#define CORE_THREAD_COREBUDGET_H
+
+#include <boost/noncopyable.hpp>
+#include <Core/Thread/share.h>
+
+namespace SCIRun
+{
+namespace Core
+{
+namespace Thread
+{
+  /// Process-wide count of busy cores, shared by dataflow module execution and
+  /// algorithm-level parallelism so that together they stay within Parallel::NumCores()
+  /// (and hence --max-cores). A thread that holds a core lends it to any work it
+  /// blocks on, so callers only claim the cores they add on top of their own.
+  class SCISHARE CoreBudget : boost::noncopyable
+  {
+  public:
+    /// Blocks, without being interruptible, until a core is free and claims it.
+    static void acquire();
+    /// Claims up to wanted cores without blocking; returns the number granted.
+    static unsigned int tryAcquire(unsigned int wanted);
+    /// Claims cores even past the limit, for work that must all run at once.
+    /// Later acquire() calls wait until the total drops back under the limit.
+    static void acquireUnchecked(unsigned int count);
+    static void release(unsigned int count);
+
+    static unsigned int inUse();
+    static unsigned int capacity();
+    /// Wakes blocked acquire() calls after Parallel::SetMaximumCores changes the limit.
+    static void capacityChanged();
+  };
+
+  /// Releases a number of claimed cores on scope exit.
+  class SCISHARE ScopedCoreClaim : boost::noncopyable
+  {
+  public:
+    explicit ScopedCoreClaim(unsigned int count) : count_(count) {}
+    ~ScopedCoreClaim() { CoreBudget::release(count_); }
+  private:
+    unsigned int count_;
+  };
+
+}}}
+
+#endif
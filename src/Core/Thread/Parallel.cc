@@ -27,32 +27,241 @@
 
 
 #include <Core/Thread/Parallel.h>
+#include <Core/Thread/ThreadPool.h>
+#include <Core/Thread/CoreBudget.h>
 #include <Core/Logging/Log.h>
+#include <Core/Logging/ExecutionProfiler.h>
 #include <boost/thread/thread.hpp>
+#include <boost/make_shared.hpp>
+#include <atomic>
+#include <exception>
 #include <vector>
 #include <iostream>
 
 using namespace SCIRun::Core::Thread;
 using namespace SCIRun::Core::Logging;
 
+namespace
+{
+  boost::mutex poolMutex;
+  // Intentionally never destroyed: joining threads from static destructors
+  // deadlocks on some platforms, and idle workers cost nothing at exit.
+  ThreadPool* poolInstance = nullptr;
+
+  ThreadPool* sharedPool()
+  {
+    boost::lock_guard<boost::mutex> lock(poolMutex);
+    if (!poolInstance)
+      poolInstance = new ThreadPool(Parallel::NumCores());
+    return poolInstance;
+  }
+
+  void resizeSharedPool()
+  {
+    boost::lock_guard<boost::mutex> lock(poolMutex);
+    if (poolInstance)
+      poolInstance->resize(Parallel::NumCores());
+  }
+
+  /// Completion latch shared by a caller and the threads running its tasks;
+  /// keeps the first exception thrown by a task so the caller can rethrow it.
+  class TaskGroup : boost::noncopyable
+  {
+  public:
+    explicit TaskGroup(int size) : remaining_(size) {}
+
+    template <class Func>
+    void run(const Func& func)
+    {
+      try
+      {
+        func();
+      }
+      catch (boost::thread_interrupted&)
+      {
+        interrupted_ = true;
+        failed_ = true;
+      }
+      catch (...)
+      {
+        boost::lock_guard<boost::mutex> lock(mutex_);
+        if (!error_)
+          error_ = std::current_exception();
+        failed_ = true;
+      }
+      finished();
+    }
+
+    void finished()
+    {
+      boost::lock_guard<boost::mutex> lock(mutex_);
+      if (--remaining_ == 0)
+        done_.notify_all();
+    }
+
+    void wait()
+    {
+      boost::unique_lock<boost::mutex> lock(mutex_);
+      while (remaining_ > 0)
+        done_.wait(lock);
+    }
+
+    bool failed() const { return failed_; }
+    bool interrupted() const { return interrupted_; }
+
+    void rethrowIfFailed()
+    {
+      boost::lock_guard<boost::mutex> lock(mutex_);
+      if (error_)
+        std::rethrow_exception(error_);
+    }
+
+  private:
+    boost::mutex mutex_;
+    boost::condition_variable done_;
+    int remaining_;
+    std::exception_ptr error_;
+    std::atomic<bool> failed_ { false };
+    std::atomic<bool> interrupted_ { false };
+  };
+
+  /// Chunk range owned by one participant of Parallel::For. The owner takes chunks
+  /// from the front; once its own range is drained it steals from the others' the same way.
+  struct ChunkRange
+  {
+    std::atomic<size_t> next;
+    size_t end;
+  };
+
+  class ForLoop : boost::noncopyable
+  {
+  public:
+    ForLoop(size_t begin, size_t end, size_t grain, size_t participants, const Parallel::RangeTask& task) :
+      begin_(begin), end_(end), grain_(grain), ranges_(participants), task_(task), participants_(static_cast<int>(participants))
+    {
+      const size_t chunks = (end - begin + grain - 1) / grain;
+      for (size_t p = 0; p < participants; ++p)
+      {
+        ranges_[p].next = chunks * p / participants;
+        ranges_[p].end = chunks * (p + 1) / participants;
+      }
+    }
+
+    void participate(size_t self)
+    {
+      for (size_t i = 0; i < ranges_.size() && !participants_.failed(); ++i)
+      {
+        auto& range = ranges_[(self + i) % ranges_.size()];
+        size_t chunk;
+        while (!participants_.failed() && (chunk = range.next.fetch_add(1)) < range.end)
+        {
+          const size_t chunkBegin = begin_ + chunk * grain_;
+          task_(chunkBegin, std::min(chunkBegin + grain_, end_));
+        }
+      }
+    }
+
+    TaskGroup& participants() { return participants_; }
+
+  private:
+    const size_t begin_, end_, grain_;
+    std::vector<ChunkRange> ranges_;
+    Parallel::RangeTask task_;
+    TaskGroup participants_;
+  };
+}
+
 void Parallel::RunTasks(IndexedTask task, int numProcs)
 {
+  const int numTasks = static_cast<int>(capByUserCoreCount(std::max(numProcs, 0)));
+  if (numTasks == 0)
+    return;
+
+  // every task must be live at once, so the cores are claimed even past the budget;
+  // the caller blocks for the duration and lends its own core to task 0
+  const auto extraCores = static_cast<unsigned int>(numTasks - 1);
+  CoreBudget::acquireUnchecked(extraCores);
+  ScopedCoreClaim claim(extraCores);
+
+  auto group = boost::make_shared<TaskGroup>(numTasks);
+  auto pool = sharedPool();
+  std::vector<ThreadPool::Ticket> pooled;
   boost::thread_group threads;
 
-  for (int i = 0; i < capByUserCoreCount(numProcs); ++i)
+  for (int i = 0; i < numTasks; ++i)
   {
-    threads.create_thread(boost::bind(task, i));
+    ThreadPool::Job job = [group, task, i]()
+    {
+      group->run([&task, i]()
+      {
+        ExecutionProfiler::ScopedSpan span("Parallel::RunTasks", "parallel");
+        task(i);
+      });
+    };
+    auto ticket = pool->tryRun(job);
+    if (ticket)
+      pooled.push_back(*ticket);
+    else
+      threads.create_thread(job);
   }
 
   try
   {
+    group->wait();
     threads.join_all();
   }
   catch (boost::thread_interrupted&)
   {
+    for (const auto& ticket : pooled)
+      ticket.interrupt();
     threads.interrupt_all();
     throw;
   }
+  group->rethrowIfFailed();
+}
+
+void Parallel::For(size_t begin, size_t end, const RangeTask& task, size_t grainSize)
+{
+  if (end <= begin)
+    return;
+
+  const size_t count = end - begin;
+  const size_t cores = std::max(NumCores(), 1u);
+  // default grain: enough chunks per core for stealing to even out imbalance
+  const size_t grain = grainSize > 0 ? grainSize : std::max<size_t>(1, count / (cores * 8));
+  const size_t chunks = (count + grain - 1) / grain;
+  const size_t participants = std::min(cores, chunks);
+  if (participants <= 1)
+  {
+    task(begin, end);
+    return;
+  }
+
+  auto loop = boost::make_shared<ForLoop>(begin, end, grain, participants, task);
+  auto pool = sharedPool();
+  // helpers only take cores nobody else (e.g. a concurrently executing module) is using
+  const size_t granted = CoreBudget::tryAcquire(static_cast<unsigned int>(participants - 1));
+  size_t helpers = 0;
+  for (size_t p = 1; p <= granted; ++p)
+  {
+    if (!pool->tryRun([loop, p]() { loop->participants().run([&loop, p]() { ScopedCoreClaim claim(1); loop->participate(p); }); }))
+      break;
+    ++helpers;
+  }
+  CoreBudget::release(static_cast<unsigned int>(granted - helpers));
+  // chunks of participants that found no idle worker are stolen by the others
+  for (size_t p = helpers + 1; p < participants; ++p)
+    loop->participants().finished();
+
+  loop->participants().run([&loop]() { loop->participate(0); });
+  {
+    // helpers reference the caller's task state, so they must all finish first
+    boost::this_thread::disable_interruption noInterrupt;
+    loop->participants().wait();
+  }
+  if (loop->participants().interrupted())
+    throw boost::thread_interrupted();
+  loop->participants().rethrowIfFailed();
 }
 
 unsigned int Parallel::NumCores()
@@ -72,6 +281,8 @@ void Parallel::SetMaximumCores(unsigned int max)
     logWarning("Maximum cores available for parallel algorithms set to {}", max);
   }
   maximumCoresSetByUser_ = max;
+  CoreBudget::capacityChanged();
+  resizeSharedPool();
 }
 
 unsigned int Parallel::capByUserCoreCount(unsigned int numProcs)
@@ -39,11 +39,30 @@ namespace Core
 {
 namespace Thread
 {
+  /// Algorithm-level parallelism. Work runs on a process-wide ThreadPool that is
+  /// created on first use, sized by NumCores() and resized by SetMaximumCores, so
+  /// repeated kernels do not spawn threads.
   class SCISHARE Parallel : public boost::noncopyable
   {
   public:
     typedef boost::function<void(int)> IndexedTask;
+    typedef boost::function<void(size_t, size_t)> RangeTask;
+
+    /// Runs task(0)..task(n-1) concurrently, n = numProcs capped by SetMaximumCores.
+    /// All tasks are guaranteed to be live at the same time, so they may synchronize
+    /// with a Barrier; tasks that find no idle pool worker get a dedicated thread.
+    /// The extra cores are charged to CoreBudget, even past its limit. Each task runs
+    /// start to finish on one thread; use For when the work should be load-balanced.
     static void RunTasks(IndexedTask task, int numProcs);
+
+    /// Calls task(chunkBegin, chunkEnd) over [begin, end) in chunks of grainSize
+    /// indices (0 picks one), load-balanced by work stealing. The calling thread
+    /// processes chunks too, so For is safe to nest inside RunTasks/For bodies or on
+    /// executor threads: it degrades to a serial loop when the pool is busy or
+    /// CoreBudget has no free cores.
+    /// Chunks must not synchronize with each other.
+    static void For(size_t begin, size_t end, const RangeTask& task, size_t grainSize = 0);
+
     static unsigned int NumCores();
     static void SetMaximumCores(unsigned int max);
   private:
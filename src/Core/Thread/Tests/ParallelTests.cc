@@ -31,6 +31,11 @@
 #include <fstream>
 
 #include <Core/Thread/Parallel.h>
+#include <Core/Thread/Barrier.h>
+#include <Core/Thread/CoreBudget.h>
+#include <Core/Thread/ThreadPool.h>
+#include <boost/thread/thread.hpp>
+#include <atomic>
 #include <boost/filesystem/path.hpp>
 #include <Testing/Utils/SCIRunUnitTests.h>
 
@@ -52,11 +57,9 @@ TEST(ParallelTests, CanDoubleNumberInParallel)
   EXPECT_EQ(expectedSum * 2, std::accumulate(nums.begin(), nums.end(), 0, std::plus<int>()));
 }
 
-/// @todo
-#if 0
-TEST(ParallelTests, CanDoubleNumberWithParallelForEach)
+TEST(ParallelTests, CanDoubleNumberWithParallelFor)
 {
-  int size = 1000; //
+  int size = 1000;
   std::vector<int> nums(size);
   int i = 0;
   std::generate(nums.begin(), nums.end(), [&]() {return i++;});
@@ -64,13 +67,134 @@ TEST(ParallelTests, CanDoubleNumberWithParallelForEach)
   int expectedSum = size * (size-1) / 2;
   EXPECT_EQ(expectedSum, std::accumulate(nums.begin(), nums.end(), 0, std::plus<int>()));
 
-  Parallel::ForEach([&](int i) {nums[i]*=2; std::cout << i << std::endl;}, Parallel::NumCores());
+  Parallel::For(0, nums.size(), [&](size_t begin, size_t end) { for (auto j = begin; j < end; ++j) nums[j] *= 2; }, 7);
 
   EXPECT_EQ(expectedSum * 2, std::accumulate(nums.begin(), nums.end(), 0, std::plus<int>()));
+}
+
+TEST(ParallelTests, ParallelForVisitsEachIndexOnceWithDefaultGrain)
+{
+  const size_t size = 100003;
+  std::vector<std::atomic<int>> visits(size);
+  for (auto& v : visits)
+    v = 0;
+
+  Parallel::For(3, size, [&](size_t begin, size_t end) { for (auto j = begin; j < end; ++j) ++visits[j]; });
+
+  for (size_t j = 0; j < size; ++j)
+    ASSERT_EQ(j < 3 ? 0 : 1, visits[j]) << j;
+}
+
+TEST(ParallelTests, CanNestParallelForInsideRunTasks)
+{
+  const int outer = Parallel::NumCores();
+  const size_t inner = 5000;
+  std::atomic<size_t> total(0);
+
+  Parallel::RunTasks([&](int)
+  {
+    Parallel::For(0, inner, [&](size_t begin, size_t end) { total += end - begin; }, 16);
+  }, outer);
+
+  EXPECT_EQ(outer * inner, total);
+}
+
+TEST(ParallelTests, RunTasksKeepsAllTasksLiveForBarriers)
+{
+  // two rounds back to back: the pool is already partly busy for the second one
+  for (int round = 0; round < 2; ++round)
+  {
+    const int numProcs = Parallel::NumCores() + 2;
+    Barrier barrier("RunTasksKeepsAllTasksLiveForBarriers", numProcs);
+    std::atomic<int> passed(0);
+    Parallel::RunTasks([&](int) { barrier.wait(); ++passed; }, numProcs);
+    EXPECT_EQ(numProcs, passed);
+  }
+}
+
+TEST(ParallelTests, TaskExceptionsPropagateToCaller)
+{
+  EXPECT_THROW(Parallel::RunTasks([](int i) { if (i == 0) throw std::runtime_error("task failed"); }, 2), std::runtime_error);
+  EXPECT_THROW(Parallel::For(0, 100, [](size_t begin, size_t end) { if (begin <= 50 && 50 < end) throw std::runtime_error("chunk failed"); }, 1), std::runtime_error);
+}
+
+TEST(CoreBudgetTests, GrantsOnlyFreeCores)
+{
+  const auto capacity = CoreBudget::capacity();
+  ASSERT_EQ(0, CoreBudget::inUse());
+
+  EXPECT_EQ(capacity, CoreBudget::tryAcquire(capacity + 5));
+  EXPECT_EQ(0, CoreBudget::tryAcquire(1));
+  CoreBudget::release(1);
+  EXPECT_EQ(1, CoreBudget::tryAcquire(3));
+  CoreBudget::release(capacity);
+  EXPECT_EQ(0, CoreBudget::inUse());
+}
+
+TEST(CoreBudgetTests, ParallelForStaysOnCallerWhenBudgetIsExhausted)
+{
+  const auto capacity = CoreBudget::capacity();
+  CoreBudget::acquireUnchecked(capacity);
+
+  const auto caller = boost::this_thread::get_id();
+  std::atomic<int> elsewhere(0);
+  Parallel::For(0, 1000, [&](size_t, size_t) { if (boost::this_thread::get_id() != caller) ++elsewhere; }, 1);
+  EXPECT_EQ(0, elsewhere);
 
-  //EXPECT_TRUE(false);
+  CoreBudget::release(capacity);
+  EXPECT_EQ(0, CoreBudget::inUse());
+}
+
+TEST(CoreBudgetTests, RunTasksChargesItsExtraCores)
+{
+  const int numProcs = 3;
+  Barrier barrier("RunTasksChargesItsExtraCores", numProcs);
+  std::atomic<unsigned int> observed(0);
+  Parallel::RunTasks([&](int i) { barrier.wait(); if (0 == i) observed = CoreBudget::inUse(); barrier.wait(); }, numProcs);
+
+  EXPECT_EQ(numProcs - 1, observed);
+  EXPECT_EQ(0, CoreBudget::inUse());
+}
+
+TEST(ParallelTests, RepeatedDispatchRunsEveryTask)
+{
+  const int calls = 2000;
+  const int numProcs = Parallel::NumCores();
+  std::vector<double> sink(numProcs);
+
+  for (int c = 0; c < calls; ++c)
+    Parallel::RunTasks([&](int i) { sink[i] += 1; }, numProcs);
+  for (int c = 0; c < calls; ++c)
+    Parallel::For(0, numProcs, [&](size_t begin, size_t end) { for (auto i = begin; i < end; ++i) sink[i] += 1; }, 1);
+
+  for (int i = 0; i < numProcs; ++i)
+    EXPECT_EQ(2.0 * calls, sink[i]);
+}
+
+TEST(ThreadPoolTests, ResizeLimitsConcurrentJobs)
+{
+  ThreadPool pool(1);
+  std::atomic<bool> release(false);
+  std::atomic<int> running(0);
+  ThreadPool::Job block = [&]() { ++running; while (!release) boost::this_thread::yield(); --running; };
+  auto waitForIdle = [&](unsigned int n) { while (pool.idleWorkers() != n || running != 0) boost::this_thread::yield(); };
+
+  pool.resize(3);
+  EXPECT_EQ(3, pool.size());
+  for (int i = 0; i < 3; ++i)
+    EXPECT_TRUE(pool.tryRun(block));
+  EXPECT_FALSE(pool.tryRun(block));
+  release = true;
+  waitForIdle(3);
+
+  release = false;
+  pool.resize(1);
+  EXPECT_EQ(1, pool.idleWorkers());
+  EXPECT_TRUE(pool.tryRun(block));
+  EXPECT_FALSE(pool.tryRun(block));
+  release = true;
+  waitForIdle(1);
 }
-#endif
 
 namespace
 {
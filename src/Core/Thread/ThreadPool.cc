@@ -0,0 +1,161 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Thread/ThreadPool.h>
+#include <Core/Logging/Log.h>
+#include <algorithm>
+
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Logging;
+
+namespace
+{
+  thread_local bool isPoolWorker = false;
+}
+
+ThreadPool::ThreadPool(unsigned int numWorkers) : limit_(0), shutdown_(false)
+{
+  resize(numWorkers);
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    shutdown_ = true;
+    for (auto& worker : workers_)
+      worker->wake.notify_one();
+  }
+  for (auto& worker : workers_)
+    worker->thread.join();
+}
+
+unsigned int ThreadPool::size() const
+{
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  return static_cast<unsigned int>(limit_);
+}
+
+void ThreadPool::resize(unsigned int numWorkers)
+{
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  limit_ = numWorkers;
+  while (workers_.size() < limit_)
+  {
+    const auto index = workers_.size();
+    workers_.emplace_back(new Worker);
+    workers_[index]->thread = boost::thread([this, index]() { workerLoop(index); });
+    idle_.push_back(index);
+  }
+}
+
+unsigned int ThreadPool::idleWorkers() const
+{
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  const auto busy = workers_.size() - idle_.size();
+  return busy >= limit_ ? 0 : static_cast<unsigned int>(std::min(idle_.size(), limit_ - busy));
+}
+
+boost::optional<ThreadPool::Ticket> ThreadPool::tryRun(const Job& job)
+{
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  if (shutdown_ || idle_.empty() || workers_.size() - idle_.size() >= limit_)
+    return boost::none;
+
+  // most recently idled worker first: its stack and caches are still warm
+  auto index = idle_.back();
+  idle_.pop_back();
+  auto& worker = *workers_[index];
+  worker.job = job;
+  worker.wake.notify_one();
+  return Ticket(this, index, worker.generation);
+}
+
+bool ThreadPool::isWorkerThread()
+{
+  return isPoolWorker;
+}
+
+void ThreadPool::Ticket::interrupt() const
+{
+  pool_->interrupt(worker_, generation_);
+}
+
+void ThreadPool::interrupt(size_t worker, unsigned long generation)
+{
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  if (workers_[worker]->generation == generation)
+    workers_[worker]->thread.interrupt();
+}
+
+void ThreadPool::workerLoop(size_t index)
+{
+  isPoolWorker = true;
+  boost::unique_lock<boost::mutex> lock(mutex_);
+  auto& worker = *workers_[index];
+  while (true)
+  {
+    {
+      boost::this_thread::disable_interruption noInterrupt;
+      while (!shutdown_ && worker.job.empty())
+        worker.wake.wait(lock);
+    }
+    if (worker.job.empty())
+      return;
+
+    Job job;
+    job.swap(worker.job);
+    lock.unlock();
+    try
+    {
+      job();
+    }
+    catch (boost::thread_interrupted&)
+    {
+    }
+    catch (...)
+    {
+      logCritical("Uncaught exception in thread pool job");
+    }
+
+    // retire the ticket first, then swallow any interruption aimed at the finished job
+    lock.lock();
+    ++worker.generation;
+    lock.unlock();
+    try
+    {
+      boost::this_thread::interruption_point();
+    }
+    catch (boost::thread_interrupted&)
+    {
+    }
+    lock.lock();
+    idle_.push_back(index);
+  }
+}
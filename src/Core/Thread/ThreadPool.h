@@ -0,0 +1,114 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_THREAD_THREADPOOL_H
+#define CORE_THREAD_THREADPOOL_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/function.hpp>
+#include <boost/optional.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <memory>
+#include <vector>
+#include <Core/Thread/share.h>
+
+namespace SCIRun
+{
+namespace Core
+{
+namespace Thread
+{
+  /// Set of long-lived worker threads that Parallel dispatches onto, so
+  /// algorithm kernels do not pay thread creation and teardown on every call.
+  /// Jobs are only handed to workers that are idle at that moment: a caller that
+  /// needs all of its tasks running at once (barrier-synchronized kernels) sees
+  /// the pool is saturated and can spawn a thread instead of deadlocking.
+  /// Each job runs to completion on the worker that took it; there is no stealing
+  /// between jobs.
+  class SCISHARE ThreadPool : boost::noncopyable
+  {
+  public:
+    typedef boost::function<void()> Job;
+
+    /// Identifies one job on the worker running it, so the submitter can forward
+    /// a thread interruption without hitting whatever that worker runs next.
+    class SCISHARE Ticket
+    {
+    public:
+      Ticket(ThreadPool* pool, size_t worker, unsigned long generation) : pool_(pool), worker_(worker), generation_(generation) {}
+      void interrupt() const;
+    private:
+      ThreadPool* pool_;
+      size_t worker_;
+      unsigned long generation_;
+    };
+
+    explicit ThreadPool(unsigned int numWorkers);
+    ~ThreadPool();
+
+    /// Number of jobs that may run at once.
+    unsigned int size() const;
+    unsigned int idleWorkers() const;
+
+    /// Changes how many jobs may run at once. Workers are started as needed;
+    /// shrinking takes effect as running jobs finish, and surplus workers stay parked.
+    void resize(unsigned int numWorkers);
+
+    /// Hands the job to an idle worker. Returns none, without running the job,
+    /// when every worker is busy.
+    boost::optional<Ticket> tryRun(const Job& job);
+
+    /// True when called from a worker of any ThreadPool.
+    static bool isWorkerThread();
+
+  private:
+    struct Worker
+    {
+      Worker() : generation(0) {}
+      boost::thread thread;
+      boost::condition_variable wake;
+      Job job;
+      unsigned long generation;
+    };
+
+    void workerLoop(size_t index);
+    void interrupt(size_t worker, unsigned long generation);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<size_t> idle_;
+    size_t limit_;
+    mutable boost::mutex mutex_;
+    bool shutdown_;
+  };
+
+}}}
+
+#endif
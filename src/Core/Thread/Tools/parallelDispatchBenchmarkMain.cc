@@ -0,0 +1,87 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+/// @file parallelDispatchBenchmarkMain.cc
+/// Reports the cost of dispatching trivial tasks: one thread per task, as
+/// Parallel::RunTasks used to do, against the pooled RunTasks and Parallel::For.
+///
+/// usage: parallel_dispatch_benchmark [tasks] [calls]
+/// tasks defaults to Parallel::NumCores().
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+#include <boost/bind/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <Core/Thread/Parallel.h>
+
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  void threadPerTask(Parallel::IndexedTask task, int numProcs)
+  {
+    boost::thread_group threads;
+    for (int i = 0; i < numProcs; ++i)
+      threads.create_thread(boost::bind(task, i));
+    threads.join_all();
+  }
+
+  // best of several runs, reported as microseconds per call
+  double perCall(int calls, const std::function<void()>& dispatch)
+  {
+    double best = 1e30;
+    for (int run = 0; run < 5; ++run)
+    {
+      auto start = std::chrono::steady_clock::now();
+      for (int c = 0; c < calls; ++c)
+        dispatch();
+      std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+      best = std::min(best, elapsed.count() / calls);
+    }
+    return best;
+  }
+}
+
+int main(int argc, const char* argv[])
+{
+  const int tasks = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(Parallel::NumCores());
+  const int calls = argc > 2 ? std::atoi(argv[2]) : 2000;
+
+  std::vector<double> sink(tasks);
+  auto task = [&sink](int i) { sink[i] += 1; };
+  auto range = [&sink](size_t begin, size_t end) { for (auto i = begin; i < end; ++i) sink[i] += 1; };
+
+  std::printf("dispatch of %d trivial tasks, best mean over %d calls\n", tasks, calls);
+  std::printf("%-24s %10.2f us\n", "thread per task", perCall(calls, [&]() { threadPerTask(task, tasks); }));
+  std::printf("%-24s %10.2f us\n", "pooled RunTasks", perCall(calls, [&]() { Parallel::RunTasks(task, tasks); }));
+  std::printf("%-24s %10.2f us\n", "Parallel::For", perCall(calls, [&]() { Parallel::For(0, tasks, range, 1); }));
+  return 0;
+}
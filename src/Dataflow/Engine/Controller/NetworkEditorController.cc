@@ -528,6 +528,20 @@ void NetworkEditorController::loadNetwork(const NetworkFileHandle& xml)
   }
 }
 
+boost::shared_ptr<NetworkEditorController> NetworkEditorController::createNetworkInstance(const NetworkFileHandle& xml) const
+{
+  auto instance = boost::make_shared<NetworkEditorController>(
+    boost::make_shared<Network>(moduleFactory_, stateFactory_, algoFactory_, reexFactory_), executorFactory_);
+  instance->moduleFactory_ = moduleFactory_;
+  instance->stateFactory_ = stateFactory_;
+  instance->algoFactory_ = algoFactory_;
+  instance->reexFactory_ = reexFactory_;
+  instance->loadingContext_ = false;
+  instance->dynamicPortManager_.reset(new DynamicPortManager(instance->connectionAdded_, instance->connectionRemoved_, instance.get()));
+  instance->loadNetwork(xml);
+  return instance;
+}
+
 namespace
 {
   const int xMoveIncrement = 300;
@@ -165,6 +165,10 @@ namespace Engine {
 
     std::vector<Dataflow::Networks::ModuleExecutionState::Value> moduleExecutionStates() const;
 
+    /// A separate controller holding its own copy of xml, built from this controller's factories.
+    /// It does not register with the Python API or fire application events; batch runs use it.
+    boost::shared_ptr<NetworkEditorController> createNetworkInstance(const Networks::NetworkFileHandle& xml) const;
+
   private:
     void printNetwork() const;
     Networks::ModuleHandle addModuleImpl(const Networks::ModuleLookupInfo& info);
@@ -0,0 +1,292 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <boost/algorithm/string.hpp>
+#include <boost/atomic.hpp>
+#include <boost/chrono.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
+#include <Dataflow/Engine/Controller/ParameterSweep.h>
+#include <Dataflow/Engine/Scheduler/BoostGraphSerialScheduler.h>
+#include <Dataflow/Network/Connection.h>
+#include <Dataflow/Network/ModuleInterface.h>
+#include <Dataflow/Network/ModuleStateInterface.h>
+#include <Dataflow/Network/NetworkInterface.h>
+#include <Dataflow/Network/PortInterface.h>
+#include <Core/Thread/Mutex.h>
+#include <Core/Logging/Log.h>
+#include <Core/Utils/Exception.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Thread;
+
+ParameterSweep ParameterSweep::parse(std::istream& in)
+{
+  ParameterSweep sweep;
+  ParameterSet current;
+  std::string line;
+  size_t lineNumber = 0;
+  while (std::getline(in, line))
+  {
+    ++lineNumber;
+    boost::trim(line);
+    if (line.empty())
+    {
+      if (!current.empty())
+      {
+        sweep.addRun(current);
+        current.clear();
+      }
+      continue;
+    }
+    if (line[0] == '#')
+      continue;
+
+    std::istringstream fields(line);
+    std::string module, key, value;
+    fields >> module >> key;
+    std::getline(fields, value);
+    boost::trim(value);
+    if (value.empty())
+      THROW_INVALID_ARGUMENT("Parameter sweep line " + boost::lexical_cast<std::string>(lineNumber) + " needs a module id, a state key and a value: " + line);
+    current.push_back({ ModuleId(module), Name(key), value });
+  }
+  if (!current.empty())
+    sweep.addRun(current);
+  return sweep;
+}
+
+ParameterSweep ParameterSweep::load(const boost::filesystem::path& file)
+{
+  std::ifstream in(file.string());
+  if (!in)
+    THROW_INVALID_ARGUMENT("Cannot open parameter sweep file " + file.string());
+  return parse(in);
+}
+
+namespace
+{
+  class StateValueParser : public boost::static_visitor<Variable::Value>
+  {
+  public:
+    explicit StateValueParser(const std::string& text) : text_(text) {}
+    Variable::Value operator()(int) const { return boost::lexical_cast<int>(text_); }
+    Variable::Value operator()(double) const { return boost::lexical_cast<double>(text_); }
+    Variable::Value operator()(const std::string&) const { return text_; }
+    Variable::Value operator()(bool) const
+    {
+      auto lower = boost::to_lower_copy(text_);
+      if (lower == "true" || lower == "1")
+        return true;
+      if (lower == "false" || lower == "0")
+        return false;
+      THROW_INVALID_ARGUMENT("Not a boolean state value: " + text_);
+    }
+    Variable::Value operator()(const AlgoOption& option) const
+    {
+      if (!option.options_.empty() && 0 == option.options_.count(text_))
+        THROW_INVALID_ARGUMENT("Not one of the allowed options: " + text_);
+      return AlgoOption(text_, option.options_);
+    }
+    Variable::Value operator()(const Variable::List&) const
+    {
+      THROW_INVALID_ARGUMENT("List state values cannot be swept: " + text_);
+    }
+  private:
+    const std::string& text_;
+  };
+
+  typedef std::pair<ModuleId, Name> StateKey;
+
+  DatatypeHandleOption sentData(const OutputPortHandle& port)
+  {
+    for (size_t i = 0; i < port->nconnections(); ++i)
+    {
+      auto c = port->connection(i);
+      if (c && c->iport_)
+      {
+        auto data = c->iport_->getData();
+        if (data && *data)
+          return data;
+      }
+    }
+    return DatatypeHandleOption();
+  }
+
+  ModuleHandle findModule(const NetworkInterface& network, const ModuleId& id)
+  {
+    auto module = network.lookupModule(id);
+    if (!module)
+      THROW_INVALID_ARGUMENT("Parameter sweep names a module not in the network: " + id.id_);
+    return module;
+  }
+}
+
+Variable::Value SCIRun::Dataflow::Engine::parseStateValue(const Variable::Value& current, const std::string& text)
+{
+  try
+  {
+    return boost::apply_visitor(StateValueParser(text), current);
+  }
+  catch (boost::bad_lexical_cast&)
+  {
+    THROW_INVALID_ARGUMENT("Cannot convert " + text + " to the type of the state value");
+  }
+}
+
+ParameterSweepRunner::ParameterSweepRunner(const std::vector<NetworkHandle>& instances) : instances_(instances)
+{
+  if (instances_.empty())
+    THROW_INVALID_ARGUMENT("Parameter sweep needs at least one network instance");
+  for (const auto& network : instances_)
+    ENSURE_NOT_NULL(network, "Parameter sweep network instance");
+}
+
+std::vector<SweepRunResult> ParameterSweepRunner::run(const ParameterSweep& sweep, ProgressCallback progress)
+{
+  const auto& first = *instances_.front();
+  const auto& runs = sweep.runs();
+
+  // resolve every value up front, so a typo fails the batch before anything executes
+  std::set<StateKey> keySet;
+  std::vector<std::map<StateKey, Variable::Value>> values(runs.size());
+  for (size_t r = 0; r < runs.size(); ++r)
+  {
+    for (const auto& setting : runs[r])
+    {
+      auto state = findModule(first, setting.module)->get_state();
+      if (!state || !state->containsKey(setting.key))
+        THROW_INVALID_ARGUMENT("Module " + setting.module.id_ + " has no state key " + setting.key.name());
+      auto text = boost::replace_all_copy(setting.value, "{run}", boost::lexical_cast<std::string>(r));
+      StateKey key(setting.module, setting.key);
+      values[r][key] = parseStateValue(state->getValue(setting.key).value(), text);
+      keySet.insert(key);
+    }
+  }
+  const std::vector<StateKey> keys(keySet.begin(), keySet.end());
+
+  // a module is shared when no swept key belongs to it or to anything upstream
+  shared_.clear();
+  std::vector<ModuleId> perRun;
+  auto order = BoostGraphSerialScheduler().schedule(first);
+  for (const auto& id : order)
+  {
+    auto varies = std::any_of(keys.begin(), keys.end(), [&id](const StateKey& key) { return key.first == id; });
+    for (const auto& input : findModule(first, id)->inputPorts())
+    {
+      for (size_t i = 0; i < input->nconnections(); ++i)
+      {
+        auto c = input->connection(i);
+        if (c && c->oport_ && 0 == shared_.count(c->oport_->getUnderlyingModuleId()))
+          varies = true;
+      }
+    }
+    if (varies)
+      perRun.push_back(id);
+    else
+      shared_.insert(id);
+  }
+
+  std::vector<SweepRunResult> results(runs.size());
+  for (size_t r = 0; r < results.size(); ++r)
+    results[r] = { r, 0, false, 0 };
+
+  for (const auto& id : order)
+  {
+    if (shared_.count(id) && !findModule(first, id)->executeWithSignals())
+    {
+      logError("Parameter sweep: shared module {} failed, no runs executed", id.id_);
+      return results;
+    }
+  }
+
+  for (size_t i = 1; i < instances_.size(); ++i)
+  {
+    for (const auto& id : shared_)
+    {
+      auto outputs = findModule(first, id)->outputPorts();
+      auto copies = findModule(*instances_[i], id)->outputPorts();
+      for (size_t p = 0; p < outputs.size() && p < copies.size(); ++p)
+      {
+        auto data = sentData(outputs[p]);
+        if (data)
+          copies[p]->sendData(*data);
+      }
+    }
+  }
+
+  boost::atomic<size_t> nextRun(0);
+  Mutex progressLock("parameterSweepProgress");
+  auto worker = [&](size_t instance)
+  {
+    const auto& network = *instances_[instance];
+    std::vector<ModuleStateHandle> states;
+    std::vector<Variable::Value> loaded;
+    for (const auto& key : keys)
+    {
+      states.push_back(findModule(network, key.first)->get_state());
+      loaded.push_back(states.back()->getValue(key.second).value());
+    }
+    std::vector<ModuleHandle> modules;
+    for (const auto& id : perRun)
+      modules.push_back(findModule(network, id));
+
+    for (size_t r = nextRun++; r < runs.size(); r = nextRun++)
+    {
+      auto start = boost::chrono::steady_clock::now();
+      for (size_t k = 0; k < keys.size(); ++k)
+      {
+        auto value = values[r].find(keys[k]);
+        states[k]->setValue(keys[k].second, value != values[r].end() ? value->second : loaded[k]);
+      }
+      auto succeeded = std::all_of(modules.begin(), modules.end(), [](const ModuleHandle& m) { return m->executeWithSignals(); });
+      boost::chrono::duration<double> elapsed = boost::chrono::steady_clock::now() - start;
+      results[r] = { r, instance, succeeded, elapsed.count() };
+      if (progress)
+      {
+        Guard g(progressLock.get());
+        progress(results[r]);
+      }
+    }
+  };
+
+  boost::thread_group threads;
+  for (size_t i = 1; i < instances_.size(); ++i)
+    threads.create_thread([&worker, i]() { worker(i); });
+  worker(0);
+  threads.join_all();
+  return results;
+}
@@ -0,0 +1,112 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef ENGINE_NETWORK_PARAMETERSWEEP_H
+#define ENGINE_NETWORK_PARAMETERSWEEP_H
+
+#include <iosfwd>
+#include <set>
+#include <vector>
+#include <boost/filesystem/path.hpp>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <Core/Algorithms/Base/Variable.h>
+#include <Dataflow/Network/NetworkFwd.h>
+#include <Dataflow/Network/ModuleDescription.h>
+#include <Dataflow/Engine/Controller/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Engine {
+
+  /// One module state change: module id, state key and the new value as text.
+  struct SCISHARE ParameterSetting
+  {
+    Networks::ModuleId module;
+    Core::Algorithms::Name key;
+    std::string value;
+  };
+
+  typedef std::vector<ParameterSetting> ParameterSet;
+
+  /// The runs of a batch sweep, read from a text file with one "module-id state-key value"
+  /// line per setting and a blank line between runs. The value is the rest of the line, so
+  /// it may contain spaces; "{run}" in a value is replaced by the run index, which gives
+  /// each run its own writer filenames. Lines starting with '#' are comments.
+  class SCISHARE ParameterSweep
+  {
+  public:
+    static ParameterSweep parse(std::istream& in);
+    static ParameterSweep load(const boost::filesystem::path& file);
+
+    void addRun(const ParameterSet& settings) { runs_.push_back(settings); }
+    const std::vector<ParameterSet>& runs() const { return runs_; }
+  private:
+    std::vector<ParameterSet> runs_;
+  };
+
+  /// Converts text to a state value of the same type as current; throws if it does not parse.
+  SCISHARE Core::Algorithms::Variable::Value parseStateValue(const Core::Algorithms::Variable::Value& current, const std::string& text);
+
+  struct SCISHARE SweepRunResult
+  {
+    size_t run;
+    size_t instance;
+    bool succeeded;
+    double seconds;
+  };
+
+  /// Executes a parameter sweep over already loaded copies of one network. Modules that no
+  /// run changes, directly or through their inputs, execute once on the first instance;
+  /// their outputs are then sent unchanged into the other instances, which share the same
+  /// read-only data. Each instance then takes runs from a shared counter on its own thread,
+  /// sets every swept key to the run's value or back to its loaded value, and executes the
+  /// remaining modules in dependency order, stopping a run at its first module error.
+  class SCISHARE ParameterSweepRunner : boost::noncopyable
+  {
+  public:
+    typedef boost::function<void(const SweepRunResult&)> ProgressCallback;
+
+    /// Instances must hold the same modules and connections.
+    explicit ParameterSweepRunner(const std::vector<Networks::NetworkHandle>& instances);
+
+    /// Throws before executing anything if a setting names a missing module or state key,
+    /// or has a value that does not parse. Results are in run order.
+    std::vector<SweepRunResult> run(const ParameterSweep& sweep, ProgressCallback progress = ProgressCallback());
+
+    /// Modules executed only once by the last call to run.
+    const std::set<Networks::ModuleId>& sharedModules() const { return shared_; }
+  private:
+    std::vector<Networks::NetworkHandle> instances_;
+    std::set<Networks::ModuleId> shared_;
+  };
+
+}}}
+
+#endif
@@ -39,6 +39,8 @@
 #include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
 #include <Core/Algorithms/Base/AlgorithmBase.h>
 #include <Dataflow/Engine/Controller/PythonImpl.h>
+#include <Dataflow/Engine/Scheduler/StreamingNetworkExecutor.h>
+#include <Dataflow/Engine/Scheduler/LoopExecutor.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/String.h>
 #include <Core/Datatypes/DenseMatrix.h>
@@ -621,6 +623,66 @@ std::string PythonImpl::executeAll(const ExecutableLookup* lookup)
   return "Execution started."; //TODO: attach log for execution ended event.
 }
 
+std::string PythonImpl::executeStreaming(const std::string& sourceModuleId, size_t queueCapacity)
+{
+  try
+  {
+    StreamingNetworkExecutor executor(*nec_.getNetwork(), queueCapacity);
+    if (!executor.execute(ModuleId(sourceModuleId)))
+      return "Streaming execution failed; see the log for the stage that stopped.";
+    return "Streamed " + std::to_string(executor.chunksProcessed(ModuleId(sourceModuleId))) + " chunks from " + sourceModuleId;
+  }
+  catch (const std::exception& e)
+  {
+    return std::string("Streaming execution not started: ") + e.what();
+  }
+}
+
+ConnectionId PythonImpl::connectionBetween(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex) const
+{
+  auto network = nec_.getNetwork();
+  auto modFrom = network->lookupModule(ModuleId(moduleIdFrom));
+  auto modTo = network->lookupModule(ModuleId(moduleIdTo));
+  if (!modFrom || !modTo)
+    THROW_INVALID_ARGUMENT("No module by that id");
+  auto outputPort = modFrom->outputPorts().at(fromIndex);
+  auto inputPort = modTo->inputPorts().at(toIndex);
+  return ConnectionId::create(ConnectionDescription(
+    OutgoingConnectionDescription(modFrom->id(), outputPort->id()),
+    IncomingConnectionDescription(modTo->id(), inputPort->id())));
+}
+
+std::string PythonImpl::setLoopCarried(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex, bool loopCarried)
+{
+  try
+  {
+    if (!nec_.getNetwork()->setLoopCarried(connectionBetween(moduleIdFrom, fromIndex, moduleIdTo, toIndex), loopCarried))
+      return "PythonImpl::setLoopCarried: connection not found";
+    return loopCarried ? "Connection is loop-carried" : "Connection is not loop-carried";
+  }
+  catch (const std::exception& e)
+  {
+    return std::string("PythonImpl::setLoopCarried: ") + e.what();
+  }
+}
+
+std::string PythonImpl::executeLoop(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex, size_t maxIterations, double tolerance)
+{
+  try
+  {
+    LoopExecutor loop(*nec_.getNetwork(), connectionBetween(moduleIdFrom, fromIndex, moduleIdTo, toIndex));
+    auto result = loop.run(LoopTermination(maxIterations, tolerance > 0 ? matrixChangeBelow(tolerance) : LoopTermination::ConvergenceTest()));
+    auto iterations = std::to_string(result.iterations) + " iterations";
+    if (result.failed)
+      return "Loop failed after " + iterations + "; see the log for the module that stopped it.";
+    return result.converged ? "Loop converged after " + iterations : "Loop ran " + iterations;
+  }
+  catch (const std::exception& e)
+  {
+    return std::string("Loop execution not started: ") + e.what();
+  }
+}
+
 std::string PythonImpl::connect(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex)
 {
   auto network = nec_.getNetwork();
@@ -56,6 +56,9 @@ namespace Engine {
     virtual std::vector<boost::shared_ptr<PyModule>> moduleList() const override;
     virtual boost::shared_ptr<PyModule> findModule(const std::string& id) const override;
     virtual std::string executeAll(const Networks::ExecutableLookup* lookup) override;
+    virtual std::string executeStreaming(const std::string& sourceModuleId, size_t queueCapacity) override;
+    virtual std::string setLoopCarried(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex, bool loopCarried) override;
+    virtual std::string executeLoop(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex, size_t maxIterations, double tolerance) override;
     virtual std::string connect(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex) override;
     virtual std::string disconnect(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex) override;
     virtual std::string saveNetwork(const std::string& filename) override;
@@ -72,6 +75,7 @@ namespace Engine {
     void pythonModuleRemovedSlot(const Networks::ModuleId&);
     void executionFromPythonStart();
     void executionFromPythonFinish(int);
+    Networks::ConnectionId connectionBetween(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex) const;
     boost::shared_ptr<PythonImplImpl> impl_;
     std::map<std::string, boost::shared_ptr<PyModule>> modules_;
     NetworkEditorController& nec_;
@@ -0,0 +1,360 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Controller/ParameterSweep.h>
+#include <Dataflow/Network/Connection.h>
+#include <Dataflow/Network/Module.h>
+#include <Dataflow/Network/ModuleBuilder.h>
+#include <Dataflow/Network/SimpleSourceSink.h>
+#include <Dataflow/Network/Tests/MockNetwork.h>
+#include <Dataflow/State/SimpleMapModuleState.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <boost/functional/factory.hpp>
+#include <boost/thread/mutex.hpp>
+#include <gtest/gtest.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Dataflow::Networks::Mocks;
+using namespace SCIRun::Dataflow::State;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Datatypes;
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+namespace
+{
+  ModuleLookupInfo named(const std::string& name)
+  {
+    ModuleLookupInfo info;
+    info.module_name_ = name;
+    return info;
+  }
+
+  double valueOf(const DatatypeHandleOption& data)
+  {
+    return (*boost::dynamic_pointer_cast<DenseMatrix>(*data))(0, 0);
+  }
+
+  const Name Factor("Factor");
+  const Name Filename("Filename");
+
+  class SweepModule : public Module
+  {
+  public:
+    explicit SweepModule(const std::string& name) :
+      Module(named(name), false, DefaultModuleFactories::defaultAlgoFactory_, boost::make_shared<SimpleMapModuleStateFactory>()),
+      executions(0) {}
+    int executions;
+  };
+
+  /// Sends a fixed 1x1 matrix.
+  class Reader : public SweepModule
+  {
+  public:
+    Reader() : SweepModule("Reader") {}
+    void setStateDefaults() override {}
+    void execute() override
+    {
+      ++executions;
+      send_output_handle(PortId(0, "Output"), boost::make_shared<DenseMatrix>(DenseMatrix::Constant(1, 1, 2.0)));
+    }
+  };
+
+  /// Multiplies its input by the Factor state value; errors on a negative factor.
+  class Scale : public SweepModule
+  {
+  public:
+    Scale() : SweepModule("Scale") {}
+    void setStateDefaults() override { get_state()->setValue(Factor, 1.0); }
+    void execute() override
+    {
+      ++executions;
+      auto factor = get_state()->getValue(Factor).toDouble();
+      if (factor < 0)
+      {
+        error("negative factor");
+        return;
+      }
+      auto input = getInputPort(PortId(0, "Input"))->getData();
+      send_output_handle(PortId(0, "Output"), boost::make_shared<DenseMatrix>(DenseMatrix::Constant(1, 1, factor * valueOf(input))));
+    }
+  };
+
+  typedef std::map<std::string, double> WrittenFiles;
+
+  /// Records its input under the Filename state value.
+  class Writer : public SweepModule
+  {
+  public:
+    Writer(WrittenFiles& written, boost::mutex& lock) : SweepModule("Writer"), written_(written), lock_(lock) {}
+    void setStateDefaults() override { get_state()->setValue(Filename, std::string("out.mat")); }
+    void execute() override
+    {
+      ++executions;
+      auto input = getInputPort(PortId(0, "Input"))->getData();
+      boost::mutex::scoped_lock g(lock_);
+      written_[get_state()->getValue(Filename).toString()] = valueOf(input);
+    }
+  private:
+    WrittenFiles& written_;
+    boost::mutex& lock_;
+  };
+
+  /// One copy of reader -> scale -> writer behind a mock network.
+  struct Instance
+  {
+    Instance(WrittenFiles& written, boost::mutex& lock) : network(boost::make_shared<NiceMock<MockNetwork>>())
+    {
+      Module::resetIdGenerator();
+      reader = build<Reader>([]() { return new Reader; }, false);
+      scale = build<Scale>([]() { return new Scale; }, true);
+      writer = build<Writer>([&written, &lock]() { return new Writer(written, lock); }, true, false);
+      connect(reader, scale);
+      connect(scale, writer);
+
+      ON_CALL(*network, nmodules()).WillByDefault(Return(modules.size()));
+      ON_CALL(*network, module(_)).WillByDefault(Invoke([this](size_t i) { return modules[i]; }));
+      ON_CALL(*network, lookupModule(_)).WillByDefault(Invoke([this](const ModuleId& id)
+      {
+        for (const auto& m : modules)
+          if (m->id() == id)
+            return m;
+        return ModuleHandle();
+      }));
+      ON_CALL(*network, connections(_)).WillByDefault(Invoke([this](bool)
+      {
+        NetworkInterface::ConnectionDescriptionList list;
+        for (const auto& c : connectionHandles)
+          list.push_back(ConnectionDescription(
+            OutgoingConnectionDescription(c->oport_->getUnderlyingModuleId(), c->oport_->id()),
+            IncomingConnectionDescription(c->iport_->getUnderlyingModuleId(), c->iport_->id())));
+        return list;
+      }));
+    }
+
+    template <class T>
+    boost::shared_ptr<T> build(boost::function<T*()> make, bool hasInput, bool hasOutput = true)
+    {
+      ModuleBuilder builder;
+      builder.using_func([make]() { return make(); });
+      if (hasInput)
+        builder.add_input_port(Port::ConstructionParams(PortId(0, "Input"), "Matrix", false));
+      if (hasOutput)
+        builder.add_output_port(Port::ConstructionParams(PortId(0, "Output"), "Matrix", false));
+      auto module = boost::dynamic_pointer_cast<T>(builder.setStateDefaults().build());
+      modules.push_back(module);
+      return module;
+    }
+
+    void connect(ModuleHandle from, ModuleHandle to)
+    {
+      auto oport = from->outputPorts()[0];
+      auto iport = to->inputPorts()[0];
+      auto id = ConnectionId::create(ConnectionDescription(
+        OutgoingConnectionDescription(from->id(), oport->id()),
+        IncomingConnectionDescription(to->id(), iport->id())));
+      connectionHandles.push_back(boost::make_shared<Connection>(oport, iport, id, false));
+    }
+
+    boost::shared_ptr<NiceMock<MockNetwork>> network;
+    std::vector<ModuleHandle> modules;
+    std::vector<ConnectionHandle> connectionHandles;
+    boost::shared_ptr<Reader> reader;
+    boost::shared_ptr<Scale> scale;
+    boost::shared_ptr<Writer> writer;
+  };
+
+  ParameterSetting setting(const std::string& module, const Name& key, const std::string& value)
+  {
+    return { ModuleId(module), key, value };
+  }
+}
+
+class ParameterSweepTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ModuleBuilder::use_source_type(boost::factory<SimpleSource*>());
+    ModuleBuilder::use_sink_type(boost::factory<SimpleSink*>());
+  }
+
+  ParameterSweep factorSweep(int runs)
+  {
+    ParameterSweep sweep;
+    for (int r = 0; r < runs; ++r)
+      sweep.addRun({ setting("Scale:0", Factor, std::to_string(r + 1)), setting("Writer:0", Filename, "out_{run}.mat") });
+    return sweep;
+  }
+
+  WrittenFiles written_;
+  boost::mutex lock_;
+};
+
+TEST(ParameterSweepParseTests, ReadsRunsSeparatedByBlankLines)
+{
+  std::istringstream in(
+    "# sweep\n"
+    "ReadField:0 Filename /data/heart mesh.fld\n"
+    "SolveLinearSystem:2   TargetError   1e-6\n"
+    "\n"
+    "\n"
+    "ReadField:0 Filename /data/torso.fld\n");
+
+  auto sweep = ParameterSweep::parse(in);
+
+  ASSERT_EQ(2, sweep.runs().size());
+  ASSERT_EQ(2, sweep.runs()[0].size());
+  EXPECT_EQ(ModuleId("ReadField:0"), sweep.runs()[0][0].module);
+  EXPECT_EQ(Name("Filename"), sweep.runs()[0][0].key);
+  EXPECT_EQ("/data/heart mesh.fld", sweep.runs()[0][0].value);
+  EXPECT_EQ(ModuleId("SolveLinearSystem:2"), sweep.runs()[0][1].module);
+  EXPECT_EQ("1e-6", sweep.runs()[0][1].value);
+  ASSERT_EQ(1, sweep.runs()[1].size());
+  EXPECT_EQ("/data/torso.fld", sweep.runs()[1][0].value);
+}
+
+TEST(ParameterSweepParseTests, RejectsLineWithoutValue)
+{
+  std::istringstream in("ReadField:0 Filename\n");
+  EXPECT_THROW(ParameterSweep::parse(in), std::exception);
+}
+
+TEST(ParameterSweepParseTests, StateValuesKeepTheirType)
+{
+  EXPECT_EQ(Variable::Value(3), parseStateValue(1, "3"));
+  EXPECT_EQ(Variable::Value(0.25), parseStateValue(1.0, "0.25"));
+  EXPECT_EQ(Variable::Value(true), parseStateValue(false, "true"));
+  EXPECT_EQ(Variable::Value(std::string("a b")), parseStateValue(std::string(), "a b"));
+  auto option = boost::get<AlgoOption>(parseStateValue(AlgoOption("cg", { "cg", "jacobi" }), "jacobi"));
+  EXPECT_EQ("jacobi", option.option_);
+  EXPECT_THROW(parseStateValue(1, "x"), std::exception);
+  EXPECT_THROW(parseStateValue(false, "maybe"), std::exception);
+  EXPECT_THROW(parseStateValue(AlgoOption("cg", { "cg", "jacobi" }), "gmres"), std::exception);
+}
+
+TEST_F(ParameterSweepTests, RunsBackToBackAndExecutesUnsweptModulesOnce)
+{
+  Instance instance(written_, lock_);
+  ParameterSweepRunner runner({ instance.network });
+
+  auto results = runner.run(factorSweep(3));
+
+  ASSERT_EQ(3, results.size());
+  for (size_t r = 0; r < results.size(); ++r)
+  {
+    EXPECT_EQ(r, results[r].run);
+    EXPECT_TRUE(results[r].succeeded);
+  }
+  EXPECT_EQ((WrittenFiles{ { "out_0.mat", 2 }, { "out_1.mat", 4 }, { "out_2.mat", 6 } }), written_);
+  EXPECT_EQ(1, instance.reader->executions);
+  EXPECT_EQ(3, instance.scale->executions);
+  EXPECT_EQ(std::set<ModuleId>{ ModuleId("Reader:0") }, runner.sharedModules());
+}
+
+TEST_F(ParameterSweepTests, KeysARunDoesNotSetGoBackToLoadedValues)
+{
+  Instance instance(written_, lock_);
+  ParameterSweep sweep;
+  sweep.addRun({ setting("Scale:0", Factor, "5"), setting("Writer:0", Filename, "first.mat") });
+  sweep.addRun({ setting("Writer:0", Filename, "second.mat") });
+  ParameterSweepRunner runner({ instance.network });
+
+  runner.run(sweep);
+
+  EXPECT_EQ(10, written_["first.mat"]);
+  EXPECT_EQ(2, written_["second.mat"]);
+}
+
+TEST_F(ParameterSweepTests, FailedModuleFailsOnlyItsRun)
+{
+  Instance instance(written_, lock_);
+  ParameterSweep sweep;
+  sweep.addRun({ setting("Scale:0", Factor, "-1"), setting("Writer:0", Filename, "bad.mat") });
+  sweep.addRun({ setting("Scale:0", Factor, "2"), setting("Writer:0", Filename, "good.mat") });
+  ParameterSweepRunner runner({ instance.network });
+
+  auto results = runner.run(sweep);
+
+  EXPECT_FALSE(results[0].succeeded);
+  EXPECT_TRUE(results[1].succeeded);
+  EXPECT_EQ((WrittenFiles{ { "good.mat", 4 } }), written_);
+}
+
+TEST_F(ParameterSweepTests, BadSettingThrowsBeforeAnythingExecutes)
+{
+  Instance instance(written_, lock_);
+  ParameterSweepRunner runner({ instance.network });
+
+  ParameterSweep missingModule;
+  missingModule.addRun({ setting("Scale:7", Factor, "2") });
+  EXPECT_THROW(runner.run(missingModule), std::exception);
+
+  ParameterSweep missingKey;
+  missingKey.addRun({ setting("Scale:0", Name("Offset"), "2") });
+  EXPECT_THROW(runner.run(missingKey), std::exception);
+
+  ParameterSweep badValue;
+  badValue.addRun({ setting("Scale:0", Factor, "2") });
+  badValue.addRun({ setting("Scale:0", Factor, "two") });
+  EXPECT_THROW(runner.run(badValue), std::exception);
+
+  EXPECT_EQ(0, instance.reader->executions);
+  EXPECT_EQ(0, instance.scale->executions);
+}
+
+TEST_F(ParameterSweepTests, InstancesShareUnsweptOutputsAndSplitRuns)
+{
+  Instance first(written_, lock_), second(written_, lock_);
+  ParameterSweepRunner runner({ first.network, second.network });
+  const int runs = 40;
+  size_t reported = 0;
+
+  auto results = runner.run(factorSweep(runs), [&reported](const SweepRunResult&) { ++reported; });
+
+  EXPECT_EQ(runs, reported);
+  ASSERT_EQ(runs, written_.size());
+  for (int r = 0; r < runs; ++r)
+  {
+    EXPECT_TRUE(results[r].succeeded);
+    EXPECT_EQ(2 * (r + 1), written_["out_" + std::to_string(r) + ".mat"]);
+  }
+  EXPECT_EQ(1, first.reader->executions);
+  EXPECT_EQ(0, second.reader->executions);
+  EXPECT_EQ(runs, first.scale->executions + second.scale->executions);
+  // the second instance reads the very object the first instance's reader produced
+  auto shared = first.scale->getInputPort(PortId(0, "Input"))->getData();
+  auto copied = second.scale->getInputPort(PortId(0, "Input"))->getData();
+  ASSERT_TRUE(shared && copied);
+  EXPECT_EQ(*shared, *copied);
+}
@@ -32,6 +32,8 @@
 #include <iostream>
 #include <Dataflow/Engine/Python/NetworkEditorPythonInterface.h>
 #include <Dataflow/Engine/Python/NetworkEditorPythonAPI.h>
+#include <Dataflow/Network/ModuleCostHistory.h>
+#include <Core/Logging/ExecutionProfiler.h>
 #include <boost/range/adaptors.hpp>
 #include <Core/Python/PythonDatatypeConverter.h>
 
@@ -149,6 +151,51 @@ std::string NetworkEditorPythonAPI::executeAll()
   }
 }
 
+std::string NetworkEditorPythonAPI::executeStreaming(const std::string& sourceModuleId, size_t queueCapacity)
+{
+  Guard g(pythonLock_.get());
+
+  if (impl_ && impl_->isModuleContext())
+    return "In module context--function not available";
+
+  if (impl_)
+    return impl_->executeStreaming(sourceModuleId, queueCapacity);
+  else
+  {
+    return "Null implementation or execution context: NetworkEditorPythonAPI::executeStreaming()";
+  }
+}
+
+std::string NetworkEditorPythonAPI::setLoopCarried(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex, bool loopCarried)
+{
+  Guard g(pythonLock_.get());
+
+  if (impl_ && impl_->isModuleContext())
+    return "In module context--function not available";
+
+  if (impl_)
+    return impl_->setLoopCarried(moduleIdFrom, fromIndex, moduleIdTo, toIndex, loopCarried);
+  else
+  {
+    return "Null implementation or execution context: NetworkEditorPythonAPI::setLoopCarried()";
+  }
+}
+
+std::string NetworkEditorPythonAPI::executeLoop(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex, size_t maxIterations, double tolerance)
+{
+  Guard g(pythonLock_.get());
+
+  if (impl_ && impl_->isModuleContext())
+    return "In module context--function not available";
+
+  if (impl_)
+    return impl_->executeLoop(moduleIdFrom, fromIndex, moduleIdTo, toIndex, maxIterations, tolerance);
+  else
+  {
+    return "Null implementation or execution context: NetworkEditorPythonAPI::executeLoop()";
+  }
+}
+
 void NetworkEditorPythonAPI::unlock()
 {
   if (executeLockedFromPython_)
@@ -437,6 +484,35 @@ boost::python::object SimplePythonAPI::scirun_module_ids()
   return Core::Python::toPythonList(ids);
 }
 
+boost::python::object SimplePythonAPI::scirun_module_cost_history()
+{
+  boost::python::list history;
+  for (const auto& entry : ModuleCostHistory::Instance().entries())
+  {
+    boost::python::dict cost;
+    cost["module"] = entry.moduleName;
+    cost["input_size_class"] = entry.inputSizeClass;
+    cost["runs"] = entry.runs;
+    cost["mean_seconds"] = entry.meanSeconds;
+    history.append(cost);
+  }
+  return history;
+}
+
+std::string SimplePythonAPI::scirun_enable_profiler(bool enable)
+{
+  Core::Logging::ExecutionProfiler::Instance().setEnabled(enable);
+  return enable ? "Execution profiler enabled" : "Execution profiler disabled";
+}
+
+std::string SimplePythonAPI::scirun_write_profile_trace(const std::string& filename)
+{
+  auto& profiler = Core::Logging::ExecutionProfiler::Instance();
+  if (!profiler.writeChromeTrace(filename))
+    return "Could not write profile trace to " + filename;
+  return profiler.summaryTable();
+}
+
 NetworkEditorPythonAPI::PythonModuleContextApiDisabler::PythonModuleContextApiDisabler()
 {
   if (impl_)
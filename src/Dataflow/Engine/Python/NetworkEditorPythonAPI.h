@@ -70,6 +70,9 @@ namespace SCIRun {
     static boost::python::object scirun_get_module_input_value(const std::string& moduleId, const std::string& portName);
 
     static std::string executeAll();
+    static std::string executeStreaming(const std::string& sourceModuleId, size_t queueCapacity);
+    static std::string setLoopCarried(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex, bool loopCarried);
+    static std::string executeLoop(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex, size_t maxIterations, double tolerance);
     static std::string saveNetwork(const std::string& filename);
     static std::string loadNetwork(const std::string& filename);
     static std::string importNetwork(const std::string& filename);
@@ -109,6 +112,9 @@ namespace SCIRun {
     static std::string scirun_quit();
     static std::string scirun_force_quit();
     static boost::python::object scirun_module_ids();
+    static boost::python::object scirun_module_cost_history();
+    static std::string scirun_enable_profiler(bool enable);
+    static std::string scirun_write_profile_trace(const std::string& filename);
   private:
     SimplePythonAPI() = delete;
   };
@@ -132,6 +132,9 @@ namespace SCIRun
     virtual std::string connect(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex) = 0;
     virtual std::string disconnect(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex) = 0;
     virtual std::string executeAll(const Dataflow::Networks::ExecutableLookup* lookup) = 0;
+    virtual std::string executeStreaming(const std::string& sourceModuleId, size_t queueCapacity) = 0;
+    virtual std::string setLoopCarried(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex, bool loopCarried) = 0;
+    virtual std::string executeLoop(const std::string& moduleIdFrom, int fromIndex, const std::string& moduleIdTo, int toIndex, size_t maxIterations, double tolerance) = 0;
     virtual std::string saveNetwork(const std::string& filename) = 0;
     virtual std::string loadNetwork(const std::string& filename) = 0;
     virtual std::string importNetwork(const std::string& filename) = 0;
@@ -77,10 +77,16 @@ BOOST_PYTHON_MODULE(SCIRunPythonAPI)
   boost::python::def("scirun_add_module", &SimplePythonAPI::scirun_add_module);
   boost::python::def("scirun_remove_module", &NetworkEditorPythonAPI::removeModule);
   boost::python::def("scirun_execute_all", &NetworkEditorPythonAPI::executeAll);
+  boost::python::def("scirun_execute_streaming", &NetworkEditorPythonAPI::executeStreaming);
   boost::python::def("scirun_module_ids", &SimplePythonAPI::scirun_module_ids);
+  boost::python::def("scirun_module_cost_history", &SimplePythonAPI::scirun_module_cost_history);
+  boost::python::def("scirun_enable_profiler", &SimplePythonAPI::scirun_enable_profiler);
+  boost::python::def("scirun_write_profile_trace", &SimplePythonAPI::scirun_write_profile_trace);
 
   boost::python::def("scirun_connect_modules", &NetworkEditorPythonAPI::connect);
   boost::python::def("scirun_disconnect_modules", &NetworkEditorPythonAPI::disconnect);
+  boost::python::def("scirun_set_loop_carried", &NetworkEditorPythonAPI::setLoopCarried);
+  boost::python::def("scirun_execute_loop", &NetworkEditorPythonAPI::executeLoop);
 
   boost::python::def("scirun_get_module_state", &NetworkEditorPythonAPI::scirun_get_module_state);
   boost::python::def("scirun_set_module_state", &NetworkEditorPythonAPI::scirun_set_module_state);
@@ -32,11 +32,13 @@
 #include <Dataflow/Network/ModuleDescription.h>
 #include <Dataflow/Network/NetworkInterface.h>
 #include <Core/Thread/Parallel.h>
+#include <Core/Logging/ExecutionProfiler.h>
 #include <boost/thread.hpp>
 
 using namespace SCIRun::Dataflow::Engine;
 using namespace SCIRun::Dataflow::Networks;
 using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Logging;
 
 namespace
 {
@@ -52,6 +54,8 @@ namespace
       Guard g(executionLock_->get());
       /// @todo ESSENTIAL: scoped start/finish signaling
       bounds_.executeStarts_();
+      for (const auto& groupAndModule : order_)
+        ExecutionProfiler::Instance().moduleScheduled(groupAndModule.second.id_);
       for (int group = order_.minGroup(); group <= order_.maxGroup(); ++group)
       {
         auto groupIter = order_.getGroup(group);
@@ -64,6 +68,9 @@ namespace
           return [=]() { lookup_->lookupExecutable(mod.second)->executeWithSignals(); };
         });
 
+        // a group is handed to the threads once every earlier group is done
+        for (auto mod = groupIter.first; mod != groupIter.second; ++mod)
+          ExecutionProfiler::Instance().moduleQueued(mod->second.id_);
         Parallel::RunTasks([&](int i) { tasks[i](); }, tasks.size());
       }
       bounds_.executeFinishes_(lookup_->errorCode());
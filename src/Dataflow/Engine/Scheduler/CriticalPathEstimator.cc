@@ -0,0 +1,66 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Scheduler/CriticalPathEstimator.h>
+#include <Dataflow/Network/NetworkInterface.h>
+#include <Dataflow/Network/ModuleInterface.h>
+#include <Dataflow/Network/ModuleCostHistory.h>
+#include <algorithm>
+#include <limits>
+
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Networks;
+
+const double CriticalPathEstimator::UnknownModuleCost = 0.01;
+
+CriticalPathEstimator::CriticalPathEstimator(const NetworkInterface& network) : network_(network)
+{
+}
+
+double CriticalPathEstimator::moduleCost(const ModuleId& id) const
+{
+  auto module = network_.lookupModule(id);
+  if (!module)
+    return UnknownModuleCost;
+  auto estimate = ModuleCostHistory::Instance().estimate(module->name(), ModuleCostHistory::inputSizeClass(*module));
+  return estimate ? *estimate : UnknownModuleCost;
+}
+
+std::vector<int> CriticalPathEstimator::priorities(const ModuleDependencyGraph& graph) const
+{
+  std::vector<double> costs(graph.size());
+  for (size_t i = 0; i < graph.size(); ++i)
+    costs[i] = moduleCost(graph.moduleAt(static_cast<int>(i)));
+
+  const double maxPriority = std::numeric_limits<int>::max();
+  std::vector<int> priorities;
+  for (auto seconds : graph.criticalPathCosts(costs))
+    priorities.push_back(static_cast<int>(std::min(seconds * 1000, maxPriority)));
+  return priorities;
+}
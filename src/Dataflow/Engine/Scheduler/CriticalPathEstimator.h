@@ -0,0 +1,61 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef ENGINE_SCHEDULER_CRITICAL_PATH_ESTIMATOR_H
+#define ENGINE_SCHEDULER_CRITICAL_PATH_ESTIMATOR_H
+
+#include <Dataflow/Network/NetworkFwd.h>
+#include <Dataflow/Engine/Scheduler/ModuleDependencyGraph.h>
+#include <Dataflow/Engine/Scheduler/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Engine {
+
+  /// Turns ModuleCostHistory into scheduling priorities, so a ready module with a
+  /// long, expensive chain below it starts before cheap modules at the same depth.
+  class SCISHARE CriticalPathEstimator
+  {
+  public:
+    explicit CriticalPathEstimator(const Networks::NetworkInterface& network);
+    /// Expected wall-clock seconds of the module's next run, using the input data
+    /// currently on its ports to pick the size class.
+    double moduleCost(const Networks::ModuleId& id) const;
+    /// Per vertex: estimated milliseconds on the most expensive path to a sink.
+    std::vector<int> priorities(const ModuleDependencyGraph& graph) const;
+
+    /// Assumed cost of a module type that has never been timed.
+    static const double UnknownModuleCost;
+  private:
+    const Networks::NetworkInterface& network_;
+  };
+
+}}}
+
+#endif
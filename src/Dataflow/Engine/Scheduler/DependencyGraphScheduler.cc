@@ -0,0 +1,67 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Scheduler/DependencyGraphScheduler.h>
+#include <Dataflow/Network/NetworkInterface.h>
+#include <Dataflow/Network/ConnectionId.h>
+
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Networks;
+
+DependencyGraphScheduler::DependencyGraphScheduler(const ModuleFilter& filter) : filter_(filter) {}
+
+ModuleDependencyGraph DependencyGraphScheduler::schedule(const NetworkInterface& network) const
+{
+  std::vector<ModuleId> modules;
+  std::map<ModuleId, int> vertexLookup;
+
+  for (size_t i = 0; i < network.nmodules(); ++i)
+  {
+    auto module = network.module(i);
+    if (filter_(module))
+    {
+      vertexLookup[module->id()] = static_cast<int>(modules.size());
+      modules.push_back(module->id());
+    }
+  }
+
+  std::vector<std::vector<int>> downstream(modules.size());
+  for (const ConnectionDescription& cd : network.connections(false))
+  {
+    auto from = vertexLookup.find(cd.out_.moduleId_);
+    auto to = vertexLookup.find(cd.in_.moduleId_);
+    if (from != vertexLookup.end() && to != vertexLookup.end())
+      downstream[from->second].push_back(to->second);
+  }
+
+  ModuleDependencyGraph graph(modules, downstream);
+  if (!graph.isAcyclic())
+    BOOST_THROW_EXCEPTION(NetworkHasCyclesException() << Core::ErrorMessage("The graph must be a DAG."));
+  return graph;
+}
@@ -30,6 +30,7 @@
 #include <Dataflow/Engine/Scheduler/SerialExecutionStrategy.h>
 #include <Dataflow/Engine/Scheduler/BasicParallelExecutionStrategy.h>
 #include <Dataflow/Engine/Scheduler/DynamicParallelExecutionStrategy.h>
+#include <Dataflow/Engine/Scheduler/EventDrivenExecutionStrategy.h>
 #include <Dataflow/Engine/Scheduler/DesktopExecutionStrategyFactory.h>
 #include <Dataflow/Network/NetworkInterface.h>
 #include <Core/Logging/Log.h>
@@ -42,7 +43,8 @@ DesktopExecutionStrategyFactory::DesktopExecutionStrategyFactory(const boost::op
   threadMode_(threadMode),
   serial_(new SerialExecutionStrategy),
   parallel_(new BasicParallelExecutionStrategy),
-  dynamic_(new DynamicParallelExecutionStrategy)
+  dynamic_(new DynamicParallelExecutionStrategy),
+  eventDriven_(new EventDrivenExecutionStrategy)
 {
 }
 
@@ -56,6 +58,8 @@ ExecutionStrategyHandle DesktopExecutionStrategyFactory::create(ExecutionStrateg
     return parallel_;
   case ExecutionStrategy::DYNAMIC_PARALLEL:
     return dynamic_;
+  case ExecutionStrategy::EVENT_DRIVEN:
+    return eventDriven_;
   default:
     THROW_INVALID_ARGUMENT("Unknown execution strategy type.");
   }
@@ -73,6 +77,8 @@ ExecutionStrategyHandle DesktopExecutionStrategyFactory::createDefault() const
       return create(ExecutionStrategy::BASIC_PARALLEL);
     if (*threadMode_ == "dynamicParallel")
       return create(ExecutionStrategy::DYNAMIC_PARALLEL);
+    if (*threadMode_ == "eventDriven")
+      return create(ExecutionStrategy::EVENT_DRIVEN);
     else
       return create(latestWorkingVersion);
   }
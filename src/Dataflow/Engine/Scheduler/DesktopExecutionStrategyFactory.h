@@ -44,7 +44,7 @@ namespace Engine {
     virtual ExecutionStrategyHandle createDefault() const;
   private:
     boost::optional<std::string> threadMode_;
-    ExecutionStrategyHandle serial_, parallel_, dynamic_;
+    ExecutionStrategyHandle serial_, parallel_, dynamic_, eventDriven_;
   };
 }
 }}
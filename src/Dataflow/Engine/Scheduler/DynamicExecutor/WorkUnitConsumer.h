@@ -32,8 +32,10 @@
 #include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkQueue.h>
 #include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkUnitProducerInterface.h>
 #include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkUnitExecutor.h>
+#include <Dataflow/Engine/Scheduler/ModuleExecutionPool.h>
 #include <Dataflow/Network/NetworkInterface.h>
 #include <Core/Logging/Log.h>
+#include <Core/Logging/ExecutionProfiler.h>
 #include <Core/Thread/Mutex.h>
 #include <boost/thread/thread.hpp>
 
@@ -44,6 +46,8 @@ namespace Dataflow {
 namespace Engine {
 namespace DynamicExecutor {
 
+  /// Tracks the module executions one network execution has handed to the shared
+  /// ModuleExecutionPool, with optional per-module priority hints.
   class SCISHARE ExecutionThreadGroup : boost::noncopyable
   {
   public:
@@ -53,40 +57,62 @@ namespace DynamicExecutor {
     }
     void startExecution(const ModuleExecutor& executor)
     {
-      auto thread = executeThreads_->create_thread(boost::bind(&ModuleExecutor::run, executor));
-      Core::Thread::Guard g(mapLock_->get());
-      threadsByModuleId_[executor.module_->id().id_] = thread;
+      startExecution(executor.module_->id().id_, boost::bind(&ModuleExecutor::run, executor));
+    }
+    void startExecution(const std::string& moduleId, const boost::function<void()>& task)
+    {
+      startExecution(moduleId, task, priorityOf(moduleId));
+    }
+    void startExecution(const std::string& moduleId, const boost::function<void()>& task, int priority)
+    {
+      auto pending = pending_;
+      pending->started();
+      Core::Logging::ExecutionProfiler::Instance().moduleQueued(moduleId);
+      ModuleExecutionPool::Instance().submit(moduleId, [pending, task]()
+      {
+        try
+        {
+          task();
+        }
+        catch (...)
+        {
+          pending->finished();
+          throw;
+        }
+        pending->finished();
+      }, priority);
     }
     void joinAll()
     {
-      executeThreads_->join_all();
+      pending_->waitForAll();
     }
     void clear()
     {
-      executeThreads_.reset(new boost::thread_group);
-      threadsByModuleId_.clear();
+      pending_.reset(new PendingModuleTasks);
       std::ostringstream lockName;
       lockName << "threadMap " << this;
       mapLock_.reset(new Core::Thread::Mutex(lockName.str()));
+      priorities_.clear();
     }
-    boost::thread* getThreadForModule(const std::string& moduleId) const
+    /// Higher values run first when more modules are ready than the pool can run.
+    void setPriorities(const std::map<std::string, int>& priorities)
     {
-      if (!mapLock_)
-      {
-        return nullptr;
-      }
       Core::Thread::Guard g(mapLock_->get());
-
-      auto it = threadsByModuleId_.find(moduleId);
-      if (it == threadsByModuleId_.end())
-        return nullptr;
-      if (!executeThreads_->is_thread_in(it->second))
-        return nullptr;
-      return it->second;
+      priorities_ = priorities;
+    }
+    bool interruptModule(const std::string& moduleId) const
+    {
+      return ModuleExecutionPool::Instance().interrupt(moduleId);
     }
   private:
-    mutable boost::shared_ptr<boost::thread_group> executeThreads_;
-    std::map<std::string, boost::thread*> threadsByModuleId_;
+    int priorityOf(const std::string& moduleId) const
+    {
+      Core::Thread::Guard g(mapLock_->get());
+      auto it = priorities_.find(moduleId);
+      return it != priorities_.end() ? it->second : 0;
+    }
+    boost::shared_ptr<PendingModuleTasks> pending_;
+    std::map<std::string, int> priorities_;
     mutable boost::shared_ptr<Core::Thread::Mutex> mapLock_;
   };
 
@@ -32,6 +32,9 @@
 #include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkUnitProducer.h>
 
 #include <Dataflow/Engine/Scheduler/DynamicMultithreadedNetworkExecutor.h>
+#include <Dataflow/Engine/Scheduler/DependencyGraphScheduler.h>
+#include <Dataflow/Engine/Scheduler/CriticalPathEstimator.h>
+#include <Dataflow/Network/ModuleInterface.h>
 
 using namespace SCIRun::Dataflow::Engine;
 using namespace SCIRun::Dataflow::Networks;
@@ -53,16 +56,17 @@ namespace SCIRun {
       {
       public:
         DynamicMultithreadedNetworkExecutorImpl(const ExecutionContext& context, const NetworkInterface* network,
-          Mutex* lock, size_t numModules, Mutex* executionLock, DynamicExecutor::ExecutionThreadGroupPtr threadGroup) :
+          Mutex* lock, const std::vector<std::string>& moduleIds, Mutex* executionLock, DynamicExecutor::ExecutionThreadGroupPtr threadGroup) :
           executeThreads_(threadGroup),
           lookup_(&context.lookup),
           bounds_(&context.bounds()),
-          work_(new DynamicExecutor::ModuleWorkQueue(numModules)),
+          work_(new DynamicExecutor::ModuleWorkQueue(moduleIds.size())),
           producer_(new DynamicExecutor::ModuleProducer(context.addAdditionalFilter(ModuleWaitingFilter::Instance()),
-            network, lock, work_, numModules)),
+            network, lock, work_, moduleIds.size())),
             consumer_(new DynamicExecutor::ModuleConsumer(work_, lookup_, producer_, executeThreads_)),
           network_(network),
-          executionLock_(executionLock)
+          executionLock_(executionLock),
+          moduleIds_(moduleIds)
         {
         }
         ~DynamicMultithreadedNetworkExecutorImpl()
@@ -81,6 +85,8 @@ namespace SCIRun {
           ScopedExecutionBoundsSignaller signaller(bounds_, [=]() { return lookup_->errorCode(); });
 
           waitForStartupInit(*network_);
+          for (const auto& id : moduleIds_)
+            ExecutionProfiler::Instance().moduleScheduled(id);
 
           boost::thread consume(boost::ref(*consumer_));
           boost::thread produce(boost::ref(*producer_));
@@ -93,11 +99,7 @@ namespace SCIRun {
         {
           if (executeThreads_)
           {
-            auto thread = executeThreads_->getThreadForModule(id);
-            if (thread)
-            {
-              thread->interrupt();
-            }
+            executeThreads_->interruptModule(id);
           }
         }
       private:
@@ -109,6 +111,7 @@ namespace SCIRun {
         DynamicExecutor::ModuleConsumerPtr consumer_;
         const NetworkInterface* network_;
         Mutex* executionLock_;
+        std::vector<std::string> moduleIds_;
         mutable boost::signals2::connection interruptCxn_;
       };
 }}}
@@ -127,7 +130,21 @@ void DynamicMultithreadedNetworkExecutor::execute(const ExecutionContext& contex
     LOG_TRACE("DMTNE::executeAll order received: {}", order);
 
   threadGroup_->clear();
-  DynamicMultithreadedNetworkExecutorImpl runner(context, &network_, &lock, order.size(), &executionLock, threadGroup_);
+  // critical-path hint: estimated cost of the most expensive chain still to run below each module
+  std::set<ModuleId> scheduled;
+  std::vector<std::string> moduleIds;
+  for (const auto& groupAndModule : order)
+  {
+    scheduled.insert(groupAndModule.second);
+    moduleIds.push_back(groupAndModule.second.id_);
+  }
+  auto graph = DependencyGraphScheduler([&scheduled](ModuleHandle mh) { return scheduled.count(mh->id()) > 0; }).schedule(network_);
+  auto costs = CriticalPathEstimator(network_).priorities(graph);
+  std::map<std::string, int> priorities;
+  for (size_t i = 0; i < graph.size(); ++i)
+    priorities[graph.moduleAt(static_cast<int>(i)).id_] = costs[i];
+  threadGroup_->setPriorities(priorities);
+  DynamicMultithreadedNetworkExecutorImpl runner(context, &network_, &lock, moduleIds, &executionLock, threadGroup_);
   boost::thread execution(runner);
 }
 
@@ -0,0 +1,195 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkUnitConsumer.h>
+#include <Dataflow/Engine/Scheduler/EventDrivenNetworkExecutor.h>
+#include <Dataflow/Engine/Scheduler/CriticalPathEstimator.h>
+#include <Dataflow/Network/ModuleInterface.h>
+#include <Core/Thread/ConditionVariable.h>
+#include <boost/atomic.hpp>
+
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Thread;
+
+namespace SCIRun {
+  namespace Dataflow {
+    namespace Engine {
+
+      /// Per-execution ready set. Upstream counters are decremented lock-free by the
+      /// finishing module's thread; only the run queue itself is guarded.
+      class ReadyModuleTracker : boost::noncopyable
+      {
+      public:
+        ReadyModuleTracker(const ModuleDependencyGraph& graph, const std::vector<int>& priorities) :
+          graph_(graph),
+          remainingUpstream_(graph.size()),
+          priorities_(priorities),
+          finishedCount_(0),
+          queueLock_("eventDrivenReadyQueue"),
+          moduleReady_("eventDrivenReadyQueue")
+        {
+          for (size_t i = 0; i < graph_.size(); ++i)
+            remainingUpstream_[i].store(graph_.upstreamCount(static_cast<int>(i)));
+          ready_ = graph_.roots();
+        }
+
+        const ModuleDependencyGraph& graph() const { return graph_; }
+        int priority(int vertex) const { return priorities_[vertex]; }
+
+        void moduleFinished(int vertex)
+        {
+          std::vector<int> released;
+          for (auto to : graph_.downstream(vertex))
+          {
+            if (1 == remainingUpstream_[to].fetch_sub(1))
+              released.push_back(to);
+          }
+          {
+            Guard g(queueLock_.get());
+            ready_.insert(ready_.end(), released.begin(), released.end());
+            ++finishedCount_;
+          }
+          moduleReady_.conditionBroadcast();
+        }
+
+        /// Blocks until modules are ready to run. Returns false once every module has finished.
+        bool waitForReady(std::vector<int>& ready)
+        {
+          UniqueLock lock(queueLock_.get());
+          while (ready_.empty() && finishedCount_ < graph_.size())
+            moduleReady_.wait(lock);
+          ready.swap(ready_);
+          return !ready.empty();
+        }
+
+      private:
+        const ModuleDependencyGraph graph_;
+        std::vector<boost::atomic<int>> remainingUpstream_;
+        const std::vector<int> priorities_;
+        std::vector<int> ready_;
+        size_t finishedCount_;
+        Mutex queueLock_;
+        ConditionVariable moduleReady_;
+      };
+
+      class EventDrivenNetworkExecutorImpl : public WaitsForStartupInitialization
+      {
+      public:
+        EventDrivenNetworkExecutorImpl(const ExecutionContext& context, const NetworkInterface* network,
+          const ModuleDependencyGraph& graph, Mutex* executionLock, DynamicExecutor::ExecutionThreadGroupPtr threadGroup) :
+          executeThreads_(threadGroup),
+          lookup_(&context.lookup),
+          bounds_(&context.bounds()),
+          tracker_(boost::make_shared<ReadyModuleTracker>(graph, CriticalPathEstimator(*network).priorities(graph))),
+          network_(network),
+          executionLock_(executionLock)
+        {
+        }
+        ~EventDrivenNetworkExecutorImpl()
+        {
+          interruptCxn_.disconnect();
+        }
+        void operator()() const
+        {
+          Guard g(executionLock_->get());
+
+          if (network_)
+          {
+            interruptCxn_ = network_->connectModuleInterrupted([&](const std::string& id) { interruptModule(id); });
+          }
+
+          ScopedExecutionBoundsSignaller signaller(bounds_, [=]() { return lookup_->errorCode(); });
+
+          waitForStartupInit(*network_);
+          for (size_t i = 0; i < tracker_->graph().size(); ++i)
+            Core::Logging::ExecutionProfiler::Instance().moduleScheduled(tracker_->graph().moduleAt(static_cast<int>(i)).id_);
+
+          std::vector<int> ready;
+          while (tracker_->waitForReady(ready))
+          {
+            for (auto vertex : ready)
+              launch(vertex);
+            ready.clear();
+          }
+          executeThreads_->joinAll();
+        }
+
+        void interruptModule(const std::string& id) const
+        {
+          if (executeThreads_)
+          {
+            executeThreads_->interruptModule(id);
+          }
+        }
+      private:
+        void launch(int vertex) const
+        {
+          const auto& id = tracker_->graph().moduleAt(vertex);
+          auto module = network_->lookupModule(id);
+          // same rule as ModuleProducer: modules not marked Waiting are passed through so their successors still run.
+          if (!module || module->executionState().currentState() != ModuleExecutionState::Waiting)
+          {
+            tracker_->moduleFinished(vertex);
+            return;
+          }
+
+          auto tracker = tracker_;
+          auto lookup = lookup_;
+          executeThreads_->startExecution(id.id_, [tracker, lookup, id, vertex]()
+          {
+            lookup->lookupExecutable(id)->executeWithSignals();
+            tracker->moduleFinished(vertex);
+          }, tracker_->priority(vertex));
+        }
+
+        mutable DynamicExecutor::ExecutionThreadGroupPtr executeThreads_;
+        const ExecutableLookup* lookup_;
+        const ExecutionBounds* bounds_;
+        boost::shared_ptr<ReadyModuleTracker> tracker_;
+        const NetworkInterface* network_;
+        Mutex* executionLock_;
+        mutable boost::signals2::connection interruptCxn_;
+      };
+}}}
+
+EventDrivenNetworkExecutor::EventDrivenNetworkExecutor(const NetworkInterface& network) :
+  network_(network),
+  threadGroup_(new DynamicExecutor::ExecutionThreadGroup)
+{
+}
+
+void EventDrivenNetworkExecutor::execute(const ExecutionContext& context, ModuleDependencyGraph graph, Mutex& executionLock)
+{
+  LOG_TRACE("EventDrivenNetworkExecutor::execute graph of {} modules received", graph.size());
+
+  threadGroup_->clear();
+  EventDrivenNetworkExecutorImpl runner(context, &network_, graph, &executionLock, threadGroup_);
+  boost::thread execution(runner);
+}
@@ -50,8 +50,9 @@ namespace Engine {
     {
       SERIAL,
       BASIC_PARALLEL,
-      DYNAMIC_PARALLEL
-      // next: pausable, then with loops
+      DYNAMIC_PARALLEL,
+      EVENT_DRIVEN
+      // next: pausable. Feedback loops run through LoopExecutor.
     };
 
   };
@@ -30,11 +30,13 @@
 #include <Dataflow/Engine/Scheduler/LinearSerialNetworkExecutor.h>
 #include <Dataflow/Network/ModuleInterface.h>
 #include <Dataflow/Network/NetworkInterface.h>
+#include <Core/Logging/ExecutionProfiler.h>
 #include <boost/thread.hpp>
 
 using namespace SCIRun::Dataflow::Engine;
 using namespace SCIRun::Dataflow::Networks;
 using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Logging;
 
 namespace
 {
@@ -49,6 +51,8 @@ namespace
       waitForStartupInit(lookup_);
       Guard g(executionLock_->get());
       bounds_.executeStarts_();
+      for (const ModuleId& id : order_)
+        ExecutionProfiler::Instance().moduleScheduled(id.id_);
       for (const ModuleId& id : order_)
       {
         ExecutableObject* obj = lookup_.lookupExecutable(id);
@@ -0,0 +1,221 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Scheduler/LoopExecutor.h>
+#include <Dataflow/Network/NetworkInterface.h>
+#include <Dataflow/Network/Connection.h>
+#include <Dataflow/Network/PortInterface.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Utils/Exception.h>
+#include <Core/Logging/Log.h>
+#include <map>
+#include <set>
+
+using namespace SCIRun;
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+
+namespace
+{
+  bool ordersExecution(const Connection* c)
+  {
+    return c && !c->disabled() && !c->isVirtual() && !c->isLoopCarried();
+  }
+
+  template <class Next>
+  std::set<std::string> reachableFrom(const ModuleHandle& start, Next next)
+  {
+    std::set<std::string> reached { start->id().id_ };
+    std::vector<ModuleHandle> frontier { start };
+    while (!frontier.empty())
+    {
+      auto module = frontier.back();
+      frontier.pop_back();
+      for (const auto& neighbor : next(module))
+        if (neighbor && reached.insert(neighbor->id().id_).second)
+          frontier.push_back(neighbor);
+    }
+    return reached;
+  }
+}
+
+LoopTermination::ConvergenceTest SCIRun::Dataflow::Engine::matrixChangeBelow(double tolerance)
+{
+  return [tolerance](const DatatypeHandle& previous, const DatatypeHandle& current)
+  {
+    auto p = boost::dynamic_pointer_cast<DenseMatrix>(previous);
+    auto c = boost::dynamic_pointer_cast<DenseMatrix>(current);
+    if (!p || !c || p->rows() != c->rows() || p->cols() != c->cols())
+      return false;
+    return p->size() == 0 || (*p - *c).cwiseAbs().maxCoeff() <= tolerance;
+  };
+}
+
+LoopExecutor::LoopExecutor(const NetworkInterface& network, const ConnectionId& loopCarried) : carried_(nullptr)
+{
+  auto desc = loopCarried.describe();
+  auto tail = network.lookupModule(desc.out_.moduleId_);
+  if (!tail)
+    THROW_INVALID_ARGUMENT("Loop connection not found: " + loopCarried.id_);
+  auto oport = tail->getOutputPort(desc.out_.portId_);
+  for (size_t i = 0; i < oport->nconnections(); ++i)
+  {
+    if (oport->connection(i)->id_ == loopCarried)
+      carried_ = oport->connection(i);
+  }
+  if (!carried_)
+    THROW_INVALID_ARGUMENT("Loop connection not found: " + loopCarried.id_);
+  if (!carried_->isLoopCarried())
+    THROW_INVALID_ARGUMENT("Connection is not loop-carried: " + loopCarried.id_);
+
+  auto head = network.lookupModule(carried_->iport_->getUnderlyingModuleId());
+  auto downstreamOfHead = reachableFrom(head, [&network](const ModuleHandle& m)
+  {
+    std::vector<ModuleHandle> next;
+    for (const auto& port : m->outputPorts())
+      for (size_t i = 0; i < port->nconnections(); ++i)
+        if (ordersExecution(port->connection(i)))
+          next.push_back(network.lookupModule(port->connection(i)->iport_->getUnderlyingModuleId()));
+    return next;
+  });
+  auto upstreamOfTail = reachableFrom(tail, [&network](const ModuleHandle& m)
+  {
+    std::vector<ModuleHandle> next;
+    for (const auto& port : m->inputPorts())
+      for (size_t i = 0; i < port->nconnections(); ++i)
+        if (ordersExecution(port->connection(i)))
+          next.push_back(network.lookupModule(port->connection(i)->oport_->getUnderlyingModuleId()));
+    return next;
+  });
+
+  std::map<std::string, ModuleHandle> members;
+  for (const auto& id : downstreamOfHead)
+    if (upstreamOfTail.count(id))
+      members[id] = network.lookupModule(ModuleId(id));
+  if (!members.count(head->id().id_))
+    THROW_INVALID_ARGUMENT("Loop-carried connection does not close a loop: " + loopCarried.id_);
+
+  // Kahn's algorithm over the edges inside the body
+  std::map<std::string, int> upstreamCount;
+  for (const auto& member : members)
+  {
+    upstreamCount[member.first];
+    for (const auto& port : member.second->outputPorts())
+      for (size_t i = 0; i < port->nconnections(); ++i)
+      {
+        auto c = port->connection(i);
+        auto to = c->iport_->getUnderlyingModuleId().id_;
+        if (ordersExecution(c) && members.count(to))
+          upstreamCount[to]++;
+      }
+  }
+  std::vector<ModuleHandle> ready { head };
+  while (!ready.empty())
+  {
+    auto module = ready.back();
+    ready.pop_back();
+    body_.push_back(module);
+    for (const auto& port : module->outputPorts())
+      for (size_t i = 0; i < port->nconnections(); ++i)
+      {
+        auto c = port->connection(i);
+        auto to = members.find(c->iport_->getUnderlyingModuleId().id_);
+        if (ordersExecution(c) && to != members.end() && 0 == --upstreamCount[to->first])
+          ready.push_back(to->second);
+      }
+  }
+  if (body_.size() != members.size())
+    THROW_INVALID_ARGUMENT("Loop body has cycles besides its loop-carried connection: " + loopCarried.id_);
+}
+
+bool LoopExecutor::runIteration(size_t iteration)
+{
+  for (const auto& module : body_)
+  {
+    auto logger = module->getLogger();
+    try
+    {
+      logger->setErrorFlag(false);
+      module->execute();
+      if (!logger->errorReported())
+        continue;
+      logError("Loop iteration {} stopped: module {} reported an error", iteration, module->id().id_);
+    }
+    catch (const std::exception& e)
+    {
+      logError("Loop iteration {} stopped: module {} threw: {}", iteration, module->id().id_, e.what());
+    }
+    catch (...)
+    {
+      logError("Loop iteration {} stopped: module {} threw", iteration, module->id().id_);
+    }
+    module->executionState().setExpandedState(ModuleExecutionState::Errored);
+    return false;
+  }
+  return true;
+}
+
+LoopResult LoopExecutor::run(const LoopTermination& termination)
+{
+  for (const auto& module : body_)
+    module->executionState().transitionTo(ModuleExecutionState::Executing);
+
+  LoopResult result { 0, false, false };
+  DatatypeHandle previous;
+  while (result.iterations < termination.maxIterations)
+  {
+    if (!runIteration(result.iterations))
+    {
+      result.failed = true;
+      break;
+    }
+    ++result.iterations;
+
+    if (termination.converged)
+    {
+      auto current = carried_->iport_->getData();
+      if (previous && current && termination.converged(previous, *current))
+      {
+        result.converged = true;
+        break;
+      }
+      previous = current ? *current : nullptr;
+    }
+  }
+  LOG_DEBUG("Loop over {} modules ran {} iterations", body_.size(), result.iterations);
+
+  for (const auto& module : body_)
+  {
+    auto failed = module->executionState().expandedState() == ModuleExecutionState::Errored;
+    module->executionState().transitionTo(ModuleExecutionState::Completed);
+    module->executionState().setExpandedState(failed ? ModuleExecutionState::Errored : ModuleExecutionState::Completed);
+  }
+  return result;
+}
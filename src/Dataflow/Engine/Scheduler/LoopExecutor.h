@@ -0,0 +1,89 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef ENGINE_SCHEDULER_LOOPEXECUTOR_H
+#define ENGINE_SCHEDULER_LOOPEXECUTOR_H
+
+#include <Dataflow/Network/NetworkFwd.h>
+#include <Dataflow/Network/ConnectionId.h>
+#include <Core/Datatypes/Datatype.h>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <Dataflow/Engine/Scheduler/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Engine {
+
+  /// When a loop stops: after maxIterations, or earlier once converged accepts the data
+  /// carried back by two consecutive iterations.
+  struct SCISHARE LoopTermination
+  {
+    typedef boost::function<bool(const Core::Datatypes::DatatypeHandle& previous, const Core::Datatypes::DatatypeHandle& current)> ConvergenceTest;
+
+    explicit LoopTermination(size_t maxIterations, ConvergenceTest converged = ConvergenceTest()) :
+      maxIterations(maxIterations), converged(converged) {}
+
+    size_t maxIterations;
+    ConvergenceTest converged;
+  };
+
+  /// Converged when two matrices of equal size differ by at most tolerance in every entry.
+  SCISHARE LoopTermination::ConvergenceTest matrixChangeBelow(double tolerance);
+
+  struct SCISHARE LoopResult
+  {
+    size_t iterations;
+    bool converged;
+    bool failed;
+  };
+
+  /// Iterates the modules between the two ends of a loop-carried connection. The body is
+  /// every module downstream of the connection's input module and upstream of its output
+  /// module, found once at construction and run in dependency order on the calling thread.
+  /// Only the body re-executes; modules feeding it from outside keep their outputs. Body
+  /// modules execute directly, without the per-module signals and bookkeeping of a network
+  /// run, so a trivial iteration costs microseconds.
+  class SCISHARE LoopExecutor : boost::noncopyable
+  {
+  public:
+    /// Throws if the connection is missing or is not marked loop-carried.
+    LoopExecutor(const Networks::NetworkInterface& network, const Networks::ConnectionId& loopCarried);
+
+    const std::vector<Networks::ModuleHandle>& body() const { return body_; }
+    LoopResult run(const LoopTermination& termination);
+  private:
+    bool runIteration(size_t iteration);
+    Networks::Connection* carried_;
+    std::vector<Networks::ModuleHandle> body_;
+  };
+
+}}}
+
+#endif
@@ -0,0 +1,119 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Scheduler/ModuleDependencyGraph.h>
+#include <algorithm>
+
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Networks;
+
+ModuleDependencyGraph::ModuleDependencyGraph()
+{
+}
+
+ModuleDependencyGraph::ModuleDependencyGraph(const std::vector<ModuleId>& modules, const std::vector<std::vector<int>>& downstream) :
+  modules_(modules), downstream_(downstream), upstreamCount_(modules.size(), 0)
+{
+  downstream_.resize(modules_.size());
+  for (const auto& edges : downstream_)
+  {
+    for (auto to : edges)
+      upstreamCount_[to]++;
+  }
+}
+
+size_t ModuleDependencyGraph::size() const
+{
+  return modules_.size();
+}
+
+const ModuleId& ModuleDependencyGraph::moduleAt(int vertex) const
+{
+  return modules_[vertex];
+}
+
+const std::vector<int>& ModuleDependencyGraph::downstream(int vertex) const
+{
+  return downstream_[vertex];
+}
+
+int ModuleDependencyGraph::upstreamCount(int vertex) const
+{
+  return upstreamCount_[vertex];
+}
+
+std::vector<int> ModuleDependencyGraph::roots() const
+{
+  std::vector<int> roots;
+  for (size_t i = 0; i < upstreamCount_.size(); ++i)
+  {
+    if (0 == upstreamCount_[i])
+      roots.push_back(static_cast<int>(i));
+  }
+  return roots;
+}
+
+std::vector<int> ModuleDependencyGraph::topologicalOrder() const
+{
+  auto remaining = upstreamCount_;
+  auto ready = roots();
+  std::vector<int> order;
+  order.reserve(modules_.size());
+  while (!ready.empty())
+  {
+    auto vertex = ready.back();
+    ready.pop_back();
+    order.push_back(vertex);
+    for (auto to : downstream_[vertex])
+    {
+      if (0 == --remaining[to])
+        ready.push_back(to);
+    }
+  }
+  return order;
+}
+
+bool ModuleDependencyGraph::isAcyclic() const
+{
+  return topologicalOrder().size() == modules_.size();
+}
+
+std::vector<double> ModuleDependencyGraph::criticalPathCosts(const std::vector<double>& moduleCosts) const
+{
+  std::vector<double> cost(moduleCosts);
+  auto order = topologicalOrder();
+  for (auto vertex = order.rbegin(); vertex != order.rend(); ++vertex)
+  {
+    double longestDownstream = 0;
+    for (auto to : downstream_[*vertex])
+      longestDownstream = std::max(longestDownstream, cost[to]);
+    cost[*vertex] += longestDownstream;
+  }
+  return cost;
+}
@@ -0,0 +1,70 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef ENGINE_SCHEDULER_MODULE_DEPENDENCY_GRAPH_H
+#define ENGINE_SCHEDULER_MODULE_DEPENDENCY_GRAPH_H
+
+#include <vector>
+#include <Dataflow/Network/ModuleDescription.h>
+#include <Dataflow/Engine/Scheduler/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Engine {
+
+  /// Module dependencies of one execution, flattened into adjacency lists.
+  /// Vertices are indices into modules(); a module may run once upstreamCount(i)
+  /// of its upstream edges have completed. Parallel connections between the same
+  /// pair of modules count as separate edges on both sides.
+  class SCISHARE ModuleDependencyGraph
+  {
+  public:
+    ModuleDependencyGraph();
+    ModuleDependencyGraph(const std::vector<Networks::ModuleId>& modules, const std::vector<std::vector<int>>& downstream);
+    size_t size() const;
+    const Networks::ModuleId& moduleAt(int vertex) const;
+    const std::vector<int>& downstream(int vertex) const;
+    int upstreamCount(int vertex) const;
+    std::vector<int> roots() const;
+    /// True if every module is reachable by repeatedly removing modules with no remaining upstream.
+    bool isAcyclic() const;
+    /// Total cost of the most expensive downstream chain starting at each module,
+    /// itself included, given a cost per vertex. Requires an acyclic graph.
+    std::vector<double> criticalPathCosts(const std::vector<double>& moduleCosts) const;
+  private:
+    std::vector<int> topologicalOrder() const;
+    std::vector<Networks::ModuleId> modules_;
+    std::vector<std::vector<int>> downstream_;
+    std::vector<int> upstreamCount_;
+  };
+
+}
+}}
+
+#endif
@@ -0,0 +1,207 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Scheduler/ModuleExecutionPool.h>
+#include <Core/Thread/CoreBudget.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/Logging/Log.h>
+
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  boost::mutex instanceMutex;
+  unsigned int requestedLimit = 0;
+  ModuleExecutionPool* sharedPool = nullptr;
+
+  unsigned int effectiveLimit(unsigned int limit)
+  {
+    return limit > 0 ? limit : std::max(Parallel::NumCores(), 1u);
+  }
+}
+
+ModuleExecutionPool::ModuleExecutionPool(unsigned int concurrencyLimit) :
+  limit_(effectiveLimit(concurrencyLimit)), running_(0), submitted_(0), shutdown_(false)
+{
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  addWorkers();
+}
+
+ModuleExecutionPool::~ModuleExecutionPool()
+{
+  {
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  wake_.notify_all();
+  for (auto& worker : workers_)
+    worker->thread.join();
+}
+
+ModuleExecutionPool& ModuleExecutionPool::Instance()
+{
+  // never destroyed, like the Parallel pool: joining from static destructors can deadlock
+  boost::lock_guard<boost::mutex> lock(instanceMutex);
+  if (!sharedPool)
+    sharedPool = new ModuleExecutionPool(requestedLimit);
+  return *sharedPool;
+}
+
+void ModuleExecutionPool::SetConcurrencyLimit(unsigned int limit)
+{
+  boost::lock_guard<boost::mutex> lock(instanceMutex);
+  requestedLimit = limit;
+  if (sharedPool)
+    sharedPool->setConcurrencyLimit(limit);
+}
+
+unsigned int ModuleExecutionPool::concurrencyLimit() const
+{
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  return limit_;
+}
+
+void ModuleExecutionPool::setConcurrencyLimit(unsigned int limit)
+{
+  {
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    limit_ = effectiveLimit(limit);
+    addWorkers();
+  }
+  wake_.notify_all();
+}
+
+void ModuleExecutionPool::addWorkers()
+{
+  // workers beyond a lowered limit stay parked; they are only joined at shutdown
+  while (workers_.size() < limit_)
+  {
+    // the thread gets its Worker directly: workers_ may reallocate as more are added
+    auto worker = new Worker;
+    workers_.emplace_back(worker);
+    worker->thread = boost::thread([this, worker]() { workerLoop(*worker); });
+  }
+}
+
+void ModuleExecutionPool::submit(const std::string& moduleId, const Task& task, int priority)
+{
+  {
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    queue_.push(QueuedTask { moduleId, task, priority, submitted_++ });
+  }
+  wake_.notify_one();
+}
+
+bool ModuleExecutionPool::interrupt(const std::string& moduleId)
+{
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  for (auto& worker : workers_)
+  {
+    if (worker->runningModule == moduleId)
+    {
+      worker->thread.interrupt();
+      return true;
+    }
+  }
+  return false;
+}
+
+void ModuleExecutionPool::workerLoop(Worker& worker)
+{
+  boost::unique_lock<boost::mutex> lock(mutex_);
+  while (true)
+  {
+    {
+      boost::this_thread::disable_interruption noInterrupt;
+      while (!shutdown_ && (queue_.empty() || running_ >= limit_))
+        wake_.wait(lock);
+    }
+    if (shutdown_)
+      return;
+
+    auto next = queue_.top();
+    queue_.pop();
+    ++running_;
+    lock.unlock();
+
+    CoreBudget::acquire();
+    lock.lock();
+    worker.runningModule = next.moduleId;
+    lock.unlock();
+    try
+    {
+      next.task();
+    }
+    catch (boost::thread_interrupted&)
+    {
+    }
+    catch (...)
+    {
+      logCritical("Uncaught exception executing module {}", next.moduleId);
+    }
+    CoreBudget::release(1);
+
+    // stop accepting interrupts for this module, then swallow any that arrived late
+    lock.lock();
+    worker.runningModule.clear();
+    lock.unlock();
+    try
+    {
+      boost::this_thread::interruption_point();
+    }
+    catch (boost::thread_interrupted&)
+    {
+    }
+    lock.lock();
+    --running_;
+    if (!queue_.empty())
+      wake_.notify_one();
+  }
+}
+
+void PendingModuleTasks::started()
+{
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  ++pending_;
+}
+
+void PendingModuleTasks::finished()
+{
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  if (--pending_ == 0)
+    allDone_.notify_all();
+}
+
+void PendingModuleTasks::waitForAll()
+{
+  boost::unique_lock<boost::mutex> lock(mutex_);
+  while (pending_ > 0)
+    allDone_.wait(lock);
+}
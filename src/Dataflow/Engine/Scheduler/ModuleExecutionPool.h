@@ -0,0 +1,121 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef ENGINE_SCHEDULER_MODULE_EXECUTION_POOL_H
+#define ENGINE_SCHEDULER_MODULE_EXECUTION_POOL_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+#include <Dataflow/Engine/Scheduler/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Engine {
+
+  /// Fixed set of worker threads that runs module executions, replacing a thread per
+  /// module. At most concurrencyLimit() modules run at once, and each also claims a
+  /// core from Core::Thread::CoreBudget before it starts, so modules and the
+  /// Parallel kernels they call share one core count. Queued modules run highest
+  /// priority first, in submission order among equals.
+  class SCISHARE ModuleExecutionPool : boost::noncopyable
+  {
+  public:
+    typedef boost::function<void()> Task;
+
+    explicit ModuleExecutionPool(unsigned int concurrencyLimit);
+    ~ModuleExecutionPool();
+
+    /// Pool shared by the parallel executors, created on first use.
+    static ModuleExecutionPool& Instance();
+    /// Sets the shared pool's limit; 0 means Core::Thread::Parallel::NumCores().
+    static void SetConcurrencyLimit(unsigned int limit);
+
+    unsigned int concurrencyLimit() const;
+    void setConcurrencyLimit(unsigned int limit);
+
+    void submit(const std::string& moduleId, const Task& task, int priority);
+    /// Interrupts the module if it is running; returns false if it is queued or done.
+    bool interrupt(const std::string& moduleId);
+
+  private:
+    struct QueuedTask
+    {
+      std::string moduleId;
+      Task task;
+      int priority;
+      unsigned long sequence;
+      bool operator<(const QueuedTask& other) const
+      {
+        return priority != other.priority ? priority < other.priority : sequence > other.sequence;
+      }
+    };
+
+    struct Worker
+    {
+      boost::thread thread;
+      std::string runningModule;
+    };
+
+    void addWorkers();
+    void workerLoop(Worker& worker);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::priority_queue<QueuedTask> queue_;
+    unsigned int limit_;
+    unsigned int running_;
+    unsigned long submitted_;
+    bool shutdown_;
+    mutable boost::mutex mutex_;
+    boost::condition_variable wake_;
+  };
+
+  /// Counts the tasks one execution has handed to the pool so it can wait for all of them.
+  class SCISHARE PendingModuleTasks : boost::noncopyable
+  {
+  public:
+    PendingModuleTasks() : pending_(0) {}
+    void started();
+    void finished();
+    void waitForAll();
+  private:
+    int pending_;
+    boost::mutex mutex_;
+    boost::condition_variable allDone_;
+  };
+
+}}}
+
+#endif
@@ -0,0 +1,251 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Scheduler/StreamingNetworkExecutor.h>
+#include <Dataflow/Network/NetworkInterface.h>
+#include <Dataflow/Network/Connection.h>
+#include <Dataflow/Network/ConnectionStream.h>
+#include <Dataflow/Network/PortInterface.h>
+#include <Dataflow/Network/ModuleExceptions.h>
+#include <Dataflow/Network/SimpleSourceSink.h>
+#include <Core/Utils/Exception.h>
+#include <Core/Logging/Log.h>
+#include <boost/atomic.hpp>
+#include <boost/thread/thread.hpp>
+#include <deque>
+#include <set>
+
+using namespace SCIRun;
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+
+namespace
+{
+  struct StreamedInput
+  {
+    SimpleSink* sink;
+    ConnectionStreamHandle stream;
+  };
+
+  struct StreamStage
+  {
+    ModuleHandle module;
+    std::vector<StreamedInput> inputs;
+    std::vector<ConnectionStreamHandle> outputs;
+    size_t* chunks;
+    std::vector<DatatypeHandle> held;
+  };
+
+  bool streamsData(const Connection* c)
+  {
+    return c && !c->disabled() && !c->isVirtual() && !c->isLoopCarried();
+  }
+
+  class StreamRun
+  {
+  public:
+    StreamRun(std::vector<StreamStage>& stages, std::vector<Connection*>& connections) :
+      stages_(stages), connections_(connections), failed_(false) {}
+
+    bool run()
+    {
+      boost::thread_group threads;
+      for (auto& stage : stages_)
+      {
+        stage.module->executionState().transitionTo(ModuleExecutionState::Executing);
+        threads.create_thread([this, &stage]() { runStage(stage); });
+      }
+      threads.join_all();
+      return !failed_;
+    }
+
+  private:
+    void runStage(StreamStage& stage)
+    {
+      bool ok = true;
+      try
+      {
+        if (stage.inputs.empty())
+        {
+          ok = executeOnce(stage);
+          for (const auto& output : stage.outputs)
+            *stage.chunks = std::max(*stage.chunks, output->pushed());
+        }
+        else
+        {
+          while (ok && nextChunk(stage))
+          {
+            ok = executeOnce(stage);
+            if (ok)
+              ++*stage.chunks;
+          }
+        }
+      }
+      catch (const StreamAbortedException&)
+      {
+        // a downstream stage stopped taking chunks; whoever aborted reports the failure
+      }
+      catch (const std::exception& e)
+      {
+        logError("Streaming execution of {} failed on chunk {}: {}", stage.module->id().id_, *stage.chunks, e.what());
+        ok = false;
+      }
+      catch (...)
+      {
+        logError("Streaming execution of {} failed on chunk {}", stage.module->id().id_, *stage.chunks);
+        ok = false;
+      }
+
+      if (!ok)
+      {
+        failed_ = true;
+        for (auto c : connections_)
+          c->stream()->abort();
+      }
+      // a stage that stops early must not leave its producers blocked on a full queue
+      for (const auto& input : stage.inputs)
+        input.stream->abort();
+      for (const auto& output : stage.outputs)
+        output->close();
+
+      stage.module->executionState().transitionTo(ModuleExecutionState::Completed);
+      stage.module->executionState().setExpandedState(ok ? ModuleExecutionState::Completed : ModuleExecutionState::Errored);
+    }
+
+    // Modules report most failures through their logger rather than by throwing.
+    bool executeOnce(StreamStage& stage)
+    {
+      auto logger = stage.module->getLogger();
+      logger->setErrorFlag(false);
+      stage.module->execute();
+      if (!logger->errorReported())
+        return true;
+      logError("Streaming execution of {} stopped on chunk {}: module reported an error", stage.module->id().id_, *stage.chunks);
+      return false;
+    }
+
+    // Hands one chunk per streamed input to the module's sinks. Sinks only hold weak
+    // references, so the chunks are kept alive here until the next one replaces them.
+    bool nextChunk(StreamStage& stage)
+    {
+      stage.held.clear();
+      for (const auto& input : stage.inputs)
+      {
+        auto chunk = input.stream->pop();
+        if (!chunk)
+          return false;
+        input.sink->setData(*chunk);
+        stage.held.push_back(*chunk);
+      }
+      return true;
+    }
+
+    std::vector<StreamStage>& stages_;
+    std::vector<Connection*>& connections_;
+    boost::atomic<bool> failed_;
+  };
+}
+
+StreamingNetworkExecutor::StreamingNetworkExecutor(const NetworkInterface& network, size_t queueCapacity) :
+  network_(network), queueCapacity_(queueCapacity)
+{
+  if (0 == queueCapacity_)
+    THROW_INVALID_ARGUMENT("Streaming queue capacity must be positive");
+}
+
+bool StreamingNetworkExecutor::execute(const ModuleId& source)
+{
+  auto sourceModule = network_.lookupModule(source);
+  if (!sourceModule)
+    THROW_INVALID_ARGUMENT("Stream source module not found: " + source.id_);
+
+  std::vector<ModuleHandle> modules;
+  std::vector<Connection*> connections;
+  std::set<std::string> visited { source.id_ };
+  std::deque<ModuleHandle> frontier { sourceModule };
+  while (!frontier.empty())
+  {
+    auto module = frontier.front();
+    frontier.pop_front();
+    modules.push_back(module);
+    for (const auto& oport : module->outputPorts())
+    {
+      for (size_t i = 0; i < oport->nconnections(); ++i)
+      {
+        auto c = oport->connection(i);
+        if (!streamsData(c))
+          continue;
+        if (!dynamic_cast<SimpleSink*>(c->iport_->sink().get()))
+          THROW_INVALID_ARGUMENT("Streaming requires SimpleSink input ports: " + c->id());
+        connections.push_back(c);
+        auto downstream = c->iport_->getUnderlyingModuleId();
+        if (visited.insert(downstream.id_).second)
+          frontier.push_back(network_.lookupModule(downstream));
+      }
+    }
+  }
+
+  for (auto c : connections)
+    c->setStream(boost::make_shared<ConnectionStream>(queueCapacity_));
+
+  chunksProcessed_.clear();
+  std::vector<StreamStage> stages;
+  for (const auto& module : modules)
+  {
+    StreamStage stage { module, {}, {}, &chunksProcessed_[module->id().id_], {} };
+    for (auto c : connections)
+    {
+      if (c->oport_->getUnderlyingModuleId() == module->id())
+        stage.outputs.push_back(c->stream());
+      if (c->iport_->getUnderlyingModuleId() == module->id())
+        stage.inputs.push_back({ static_cast<SimpleSink*>(c->iport_->sink().get()), c->stream() });
+    }
+    stages.push_back(stage);
+  }
+
+  LOG_DEBUG("Streaming from {} through {} modules and {} connections", source.id_, modules.size(), connections.size());
+  StreamRun run(stages, connections);
+  auto ok = run.run();
+
+  for (auto c : connections)
+  {
+    c->setStream(nullptr);
+    // leave the network as a normal execution would: each sink sees its last chunk
+    if (ok && c->oport_->hasData())
+      c->oport_->source()->send(c->iport_->sink());
+  }
+  return ok;
+}
+
+size_t StreamingNetworkExecutor::chunksProcessed(const ModuleId& id) const
+{
+  auto i = chunksProcessed_.find(id.id_);
+  return i != chunksProcessed_.end() ? i->second : 0;
+}
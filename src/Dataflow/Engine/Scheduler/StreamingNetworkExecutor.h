@@ -0,0 +1,72 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef ENGINE_SCHEDULER_STREAMINGNETWORKEXECUTOR_H
+#define ENGINE_SCHEDULER_STREAMINGNETWORKEXECUTOR_H
+
+#include <Dataflow/Network/NetworkFwd.h>
+#include <Dataflow/Network/ModuleDescription.h>
+#include <boost/noncopyable.hpp>
+#include <map>
+#include <Dataflow/Engine/Scheduler/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Engine {
+
+  /// Pipelined execution of a module that emits a sequence of chunks, such as one column
+  /// of a time series per sendOutput call. The source executes once; every module
+  /// downstream of it runs on its own thread and executes once per chunk, so stage k works
+  /// on chunk i while stage k-1 produces chunk i+1. Connections inside the stream carry
+  /// chunks through bounded queues, which throttle fast producers. Downstream modules are
+  /// expected to be stateless, one chunk in and one chunk out; inputs from outside the
+  /// stream keep the data they already hold. Per-chunk executions skip the execution
+  /// signals, scheduling and status updates of a normal run.
+  class SCISHARE StreamingNetworkExecutor : boost::noncopyable
+  {
+  public:
+    enum { DefaultQueueCapacity = 4 };
+
+    explicit StreamingNetworkExecutor(const Networks::NetworkInterface& network, size_t queueCapacity = DefaultQueueCapacity);
+
+    /// Blocks until the stream drains. Returns false if any stage threw, in which case the
+    /// remaining stages are cancelled. Afterwards each streamed connection holds its last chunk.
+    bool execute(const Networks::ModuleId& source);
+
+    /// Chunks the module executed on in the last stream; for the source, chunks it sent.
+    size_t chunksProcessed(const Networks::ModuleId& id) const;
+  private:
+    const Networks::NetworkInterface& network_;
+    size_t queueCapacity_;
+    std::map<std::string, size_t> chunksProcessed_;
+  };
+
+}}}
+
+#endif
@@ -0,0 +1,223 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Scheduler/LoopExecutor.h>
+#include <Dataflow/Network/Connection.h>
+#include <Dataflow/Network/Module.h>
+#include <Dataflow/Network/ModuleBuilder.h>
+#include <Dataflow/Network/SimpleSourceSink.h>
+#include <Dataflow/Network/Tests/MockNetwork.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <boost/chrono.hpp>
+#include <boost/functional/factory.hpp>
+#include <gtest/gtest.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Dataflow::Networks::Mocks;
+using namespace SCIRun::Core::Datatypes;
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+namespace
+{
+  DenseMatrixHandle scalar(double value)
+  {
+    return boost::make_shared<DenseMatrix>(DenseMatrix::Constant(1, 1, value));
+  }
+
+  double valueOf(const DatatypeHandleOption& data)
+  {
+    return (*boost::dynamic_pointer_cast<DenseMatrix>(*data))(0, 0);
+  }
+
+  ModuleLookupInfo named(const std::string& name)
+  {
+    ModuleLookupInfo info;
+    info.module_name_ = name;
+    return info;
+  }
+
+  /// Sends seed on the first iteration and next(feedback) afterwards; fails once it has
+  /// executed failAfter times.
+  class StepModule : public Module
+  {
+  public:
+    StepModule(const std::string& name, boost::function<double(double)> next, int failAfter) :
+      Module(named(name), false), next_(next), failAfter_(failAfter), executions(0) {}
+    void execute() override
+    {
+      if (++executions == failAfter_)
+        error("step failed");
+      auto feedback = getInputPort(PortId(1, "Feedback"))->getData();
+      auto input = getInputPort(PortId(0, "Input"))->getData();
+      auto in = feedback ? valueOf(feedback) : input ? valueOf(input) : 0;
+      send_output_handle(PortId(0, "Output"), scalar(next_(in)));
+    }
+    void setStateDefaults() override {}
+  private:
+    boost::function<double(double)> next_;
+    int failAfter_;
+  public:
+    int executions;
+  };
+}
+
+class LoopExecutorTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ModuleBuilder::use_source_type(boost::factory<SimpleSource*>());
+    ModuleBuilder::use_sink_type(boost::factory<SimpleSink*>());
+    Module::resetIdGenerator();
+    ON_CALL(network_, lookupModule(_)).WillByDefault(Invoke([this](const ModuleId& id)
+    {
+      for (const auto& m : modules_)
+        if (m->id() == id)
+          return ModuleHandle(m);
+      return ModuleHandle();
+    }));
+
+    // seed -> head -> tail -> report, with tail feeding back into head
+    seed_ = add("Seed", [](double) { return 10; });
+    head_ = add("Head", [](double x) { return x / 2 + 1; });
+    tail_ = add("Tail", [](double x) { return x; });
+    report_ = add("Report", [](double x) { return x; });
+    connect(seed_, 0, head_, 0);
+    connect(head_, 0, tail_, 0);
+    connect(tail_, 0, report_, 0);
+    feedback_ = connect(tail_, 0, head_, 1);
+    feedback_->setLoopCarried(true);
+
+    seed_->execute();
+  }
+
+  boost::shared_ptr<StepModule> add(const std::string& name, boost::function<double(double)> next, int failAfter = -1)
+  {
+    auto m = boost::dynamic_pointer_cast<StepModule>(ModuleBuilder().using_func([=]() { return new StepModule(name, next, failAfter); })
+      .add_input_port(Port::ConstructionParams(PortId(0, "Input"), "Matrix", false))
+      .add_input_port(Port::ConstructionParams(PortId(1, "Feedback"), "Matrix", false))
+      .add_output_port(Port::ConstructionParams(PortId(0, "Output"), "Matrix", false))
+      .build());
+    modules_.push_back(m);
+    return m;
+  }
+
+  Connection* connect(ModuleHandle from, size_t out, ModuleHandle to, size_t in)
+  {
+    auto oport = from->outputPorts()[out];
+    auto iport = to->inputPorts()[in];
+    auto id = ConnectionId::create(ConnectionDescription(
+      OutgoingConnectionDescription(from->id(), oport->id()),
+      IncomingConnectionDescription(to->id(), iport->id())));
+    connections_.push_back(boost::make_shared<Connection>(oport, iport, id, false));
+    return connections_.back().get();
+  }
+
+  double lastValue() const
+  {
+    return valueOf(feedback_->iport_->getData());
+  }
+
+  NiceMock<MockNetwork> network_;
+  std::vector<boost::shared_ptr<StepModule>> modules_;
+  std::vector<ConnectionHandle> connections_;
+  boost::shared_ptr<StepModule> seed_, head_, tail_, report_;
+  Connection* feedback_;
+};
+
+TEST_F(LoopExecutorTests, BodyIsModulesBetweenLoopEnds)
+{
+  LoopExecutor loop(network_, feedback_->id_);
+  ASSERT_EQ(2, loop.body().size());
+  EXPECT_EQ(head_, loop.body()[0]);
+  EXPECT_EQ(tail_, loop.body()[1]);
+}
+
+TEST_F(LoopExecutorTests, RequiresLoopCarriedConnection)
+{
+  feedback_->setLoopCarried(false);
+  EXPECT_THROW(LoopExecutor(network_, feedback_->id_), std::exception);
+  EXPECT_THROW(LoopExecutor(network_, ConnectionId("missing")), std::exception);
+}
+
+TEST_F(LoopExecutorTests, RunsIterationCountAndOnlyReexecutesBody)
+{
+  LoopExecutor loop(network_, feedback_->id_);
+  auto result = loop.run(LoopTermination(3));
+  EXPECT_EQ(3, result.iterations);
+  EXPECT_FALSE(result.converged);
+  EXPECT_FALSE(result.failed);
+  // 10 -> 6 -> 4 -> 3
+  EXPECT_EQ(3, lastValue());
+  EXPECT_EQ(1, seed_->executions);
+  EXPECT_EQ(3, head_->executions);
+  EXPECT_EQ(3, tail_->executions);
+  EXPECT_EQ(0, report_->executions);
+}
+
+TEST_F(LoopExecutorTests, StopsOnceCarriedDataConverges)
+{
+  LoopExecutor loop(network_, feedback_->id_);
+  auto result = loop.run(LoopTermination(1000, matrixChangeBelow(1e-9)));
+  EXPECT_TRUE(result.converged);
+  EXPECT_LT(result.iterations, 50);
+  EXPECT_NEAR(2, lastValue(), 1e-8);
+}
+
+TEST_F(LoopExecutorTests, ModuleErrorStopsLoop)
+{
+  auto failing = add("Failing", [](double x) { return x; }, 4);
+  connections_.clear();
+  connect(seed_, 0, head_, 0);
+  connect(head_, 0, failing, 0);
+  feedback_ = connect(failing, 0, head_, 1);
+  feedback_->setLoopCarried(true);
+
+  LoopExecutor loop(network_, feedback_->id_);
+  auto result = loop.run(LoopTermination(10));
+  EXPECT_TRUE(result.failed);
+  EXPECT_EQ(3, result.iterations);
+  EXPECT_EQ(ModuleExecutionState::Errored, failing->executionState().expandedState());
+  EXPECT_EQ(ModuleExecutionState::Completed, head_->executionState().expandedState());
+}
+
+TEST_F(LoopExecutorTests, TrivialIterationCostsUnderAMillisecond)
+{
+  LoopExecutor loop(network_, feedback_->id_);
+  const size_t iterations = 2000;
+  auto start = boost::chrono::steady_clock::now();
+  auto result = loop.run(LoopTermination(iterations));
+  auto elapsed = boost::chrono::duration<double>(boost::chrono::steady_clock::now() - start).count();
+  EXPECT_EQ(iterations, result.iterations);
+  EXPECT_LT(elapsed / iterations, 1e-3);
+}
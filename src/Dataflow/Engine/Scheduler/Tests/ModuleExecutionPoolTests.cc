@@ -0,0 +1,154 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+#include <Dataflow/Engine/Scheduler/ModuleExecutionPool.h>
+#include <Core/Thread/CoreBudget.h>
+#include <boost/thread.hpp>
+#include <atomic>
+
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  class Gate
+  {
+  public:
+    void open()
+    {
+      boost::lock_guard<boost::mutex> lock(mutex_);
+      open_ = true;
+      cv_.notify_all();
+    }
+    void wait()
+    {
+      boost::unique_lock<boost::mutex> lock(mutex_);
+      while (!open_)
+        cv_.wait(lock);
+    }
+  private:
+    boost::mutex mutex_;
+    boost::condition_variable cv_;
+    bool open_ = false;
+  };
+}
+
+TEST(ModuleExecutionPoolTests, RunsHighestPriorityFirst)
+{
+  ModuleExecutionPool pool(1);
+  PendingModuleTasks pending;
+  Gate gate;
+  boost::mutex orderLock;
+  std::vector<std::string> order;
+
+  auto record = [&](const std::string& id) { boost::lock_guard<boost::mutex> lock(orderLock); order.push_back(id); };
+
+  std::atomic<bool> blockerStarted(false);
+  pending.started();
+  pool.submit("Blocker:0", [&]() { blockerStarted = true; gate.wait(); record("Blocker:0"); pending.finished(); }, 0);
+  // the only worker is busy from here on, so the rest queue up
+  while (!blockerStarted)
+    boost::this_thread::yield();
+
+  const std::vector<std::pair<std::string, int>> modules { {"Low:1", 1}, {"High:2", 5}, {"Mid:3", 3}, {"High:4", 5} };
+  for (const auto& m : modules)
+  {
+    pending.started();
+    auto id = m.first;
+    pool.submit(id, [&, id]() { record(id); pending.finished(); }, m.second);
+  }
+  gate.open();
+  pending.waitForAll();
+
+  std::vector<std::string> expected { "Blocker:0", "High:2", "High:4", "Mid:3", "Low:1" };
+  EXPECT_EQ(expected, order);
+}
+
+TEST(ModuleExecutionPoolTests, NeverExceedsConcurrencyLimit)
+{
+  const unsigned int limit = 2;
+  ModuleExecutionPool pool(limit);
+  PendingModuleTasks pending;
+  std::atomic<int> running(0), maxRunning(0);
+
+  for (int i = 0; i < 20; ++i)
+  {
+    pending.started();
+    pool.submit("M:" + std::to_string(i), [&]()
+    {
+      auto now = ++running;
+      int seen = maxRunning;
+      while (now > seen && !maxRunning.compare_exchange_weak(seen, now)) {}
+      boost::this_thread::sleep(boost::posix_time::milliseconds(2));
+      --running;
+      pending.finished();
+    }, 0);
+  }
+  pending.waitForAll();
+
+  EXPECT_LE(maxRunning, static_cast<int>(std::min(limit, CoreBudget::capacity())));
+  EXPECT_GE(maxRunning, 1);
+}
+
+TEST(ModuleExecutionPoolTests, CanInterruptRunningModule)
+{
+  ModuleExecutionPool pool(1);
+  PendingModuleTasks pending;
+  std::atomic<bool> started(false), interrupted(false);
+
+  pending.started();
+  pool.submit("Sleeper:0", [&]()
+  {
+    started = true;
+    try
+    {
+      boost::this_thread::sleep(boost::posix_time::seconds(30));
+    }
+    catch (boost::thread_interrupted&)
+    {
+      interrupted = true;
+    }
+    pending.finished();
+  }, 0);
+
+  while (!started)
+    boost::this_thread::yield();
+  EXPECT_FALSE(pool.interrupt("NotRunning:1"));
+  EXPECT_TRUE(pool.interrupt("Sleeper:0"));
+  pending.waitForAll();
+  EXPECT_TRUE(interrupted);
+
+  // the worker is reusable and does not carry the interruption into the next module
+  std::atomic<bool> ranToEnd(false);
+  pending.started();
+  pool.submit("Next:2", [&]() { boost::this_thread::sleep(boost::posix_time::milliseconds(5)); ranToEnd = true; pending.finished(); }, 0);
+  pending.waitForAll();
+  EXPECT_TRUE(ranToEnd);
+}
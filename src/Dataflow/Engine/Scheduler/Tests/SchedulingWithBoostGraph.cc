@@ -47,6 +47,10 @@
 #include <Dataflow/Engine/Scheduler/BoostGraphParallelScheduler.h>
 #include <Dataflow/Engine/Scheduler/BasicMultithreadedNetworkExecutor.h>
 #include <Dataflow/Engine/Scheduler/BasicParallelExecutionStrategy.h>
+#include <Dataflow/Engine/Scheduler/DependencyGraphScheduler.h>
+#include <Dataflow/Engine/Scheduler/CriticalPathEstimator.h>
+#include <Dataflow/Network/ModuleCostHistory.h>
+#include <Dataflow/Engine/Scheduler/EventDrivenExecutionStrategy.h>
 #include <Core/Algorithms/Factory/HardCodedAlgorithmFactory.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Logging/Log.h>
@@ -362,6 +366,115 @@ TEST_F(SchedulingWithBoostGraph, ParallelNetworkOrderWithSomeModulesDone)
   EXPECT_EQ(expected, ostr.str());
 }
 
+TEST_F(SchedulingWithBoostGraph, DependencyGraphCountsUpstreamModules)
+{
+  setupBasicNetwork();
+
+  DependencyGraphScheduler scheduler(ExecuteAllModules::Instance());
+  auto graph = scheduler.schedule(matrixMathNetwork);
+  ASSERT_EQ(9, graph.size());
+
+  std::map<std::string, int> upstream;
+  std::map<std::string, size_t> downstream;
+  for (size_t i = 0; i < graph.size(); ++i)
+  {
+    upstream[graph.moduleAt(i).id_] = graph.upstreamCount(i);
+    downstream[graph.moduleAt(i).id_] = graph.downstream(i).size();
+  }
+
+  EXPECT_EQ(2, graph.roots().size());
+  EXPECT_EQ(0, upstream["CreateMatrix:0"]);
+  EXPECT_EQ(2, downstream["CreateMatrix:0"]);
+  EXPECT_EQ(1, upstream["EvaluateLinearAlgebraUnary:3"]);
+  EXPECT_EQ(2, upstream["EvaluateLinearAlgebraBinary:5"]);
+  EXPECT_EQ(2, upstream["EvaluateLinearAlgebraBinary:6"]);
+  EXPECT_EQ(2, downstream["EvaluateLinearAlgebraBinary:6"]);
+  EXPECT_EQ(1, upstream["ReportMatrixInfo:8"]);
+  EXPECT_EQ(0, downstream["ReportMatrixInfo:8"]);
+  EXPECT_TRUE(graph.isAcyclic());
+}
+
+TEST_F(SchedulingWithBoostGraph, DependencyGraphWithSomeModulesDone)
+{
+  setupBasicNetwork();
+
+  ModuleFilter filter = [](ModuleHandle mh) { return mh->name().find("Unary") == std::string::npos; };
+  DependencyGraphScheduler scheduler(filter);
+  auto graph = scheduler.schedule(matrixMathNetwork);
+  ASSERT_EQ(6, graph.size());
+
+  std::vector<std::string> roots;
+  for (auto root : graph.roots())
+    roots.push_back(graph.moduleAt(root).id_);
+  std::sort(roots.begin(), roots.end());
+
+  std::vector<std::string> expected { "CreateMatrix:0", "CreateMatrix:1", "EvaluateLinearAlgebraBinary:5" };
+  EXPECT_EQ(expected, roots);
+}
+
+TEST_F(SchedulingWithBoostGraph, DependencyGraphSchedulerDetectsConnectionCycles)
+{
+  ModuleHandle negate = addModuleToNetwork(matrixMathNetwork, "EvaluateLinearAlgebraUnary");
+  ModuleHandle scalar = addModuleToNetwork(matrixMathNetwork, "EvaluateLinearAlgebraUnary");
+  ModuleHandle info = addModuleToNetwork(matrixMathNetwork, "ReportMatrixInfo");
+  matrixMathNetwork.connect(ConnectionOutputPort(negate, 0), ConnectionInputPort(scalar, 0));
+  matrixMathNetwork.connect(ConnectionOutputPort(scalar, 0), ConnectionInputPort(negate, 0));
+  matrixMathNetwork.connect(ConnectionOutputPort(scalar, 0), ConnectionInputPort(info, 0));
+
+  DependencyGraphScheduler scheduler(ExecuteAllModules::Instance());
+
+  EXPECT_THROW(scheduler.schedule(matrixMathNetwork), NetworkHasCyclesException);
+}
+
+TEST_F(SchedulingWithBoostGraph, CriticalPathPrioritiesFollowModuleCostHistory)
+{
+  setupBasicNetwork();
+  auto& history = ModuleCostHistory::Instance();
+  history.clear();
+  history.record("EvaluateLinearAlgebraBinary", 0, 1.0);
+
+  DependencyGraphScheduler scheduler(ExecuteAllModules::Instance());
+  auto graph = scheduler.schedule(matrixMathNetwork);
+  auto priorities = CriticalPathEstimator(matrixMathNetwork).priorities(graph);
+  history.clear();
+
+  std::map<std::string, int> priority;
+  for (size_t i = 0; i < graph.size(); ++i)
+    priority[graph.moduleAt(i).id_] = priorities[i];
+
+  const double unknown = 1000 * CriticalPathEstimator::UnknownModuleCost;
+  // send -> negate -> multiply -> add -> report
+  EXPECT_NEAR(2000 + 3 * unknown, priority["CreateMatrix:0"], 1);
+  EXPECT_NEAR(2000 + 2 * unknown, priority["EvaluateLinearAlgebraUnary:3"], 1);
+  // transpose skips the multiply
+  EXPECT_NEAR(1000 + 2 * unknown, priority["EvaluateLinearAlgebraUnary:2"], 1);
+  EXPECT_GT(priority["EvaluateLinearAlgebraUnary:3"], priority["EvaluateLinearAlgebraUnary:2"]);
+  EXPECT_NEAR(unknown, priority["ReportMatrixInfo:7"], 1);
+}
+
+TEST_F(SchedulingWithBoostGraph, NetworkFromMatrixCalculatorEventDriven)
+{
+  setupBasicNetwork();
+
+  EventDrivenExecutionStrategy strategy;
+  ExecutionContext context(matrixMathNetwork, matrixMathNetwork, ExecuteAllModules::Instance());
+  context.preexecute();
+  Mutex m("exec");
+  strategy.execute(context, m);
+
+  /// @todo: let executor thread finish.  should be an event generated or something.
+  boost::this_thread::sleep(boost::posix_time::milliseconds(800));
+
+  ReportMatrixInfoAlgorithm::Outputs reportOutput = transient_value_cast<ReportMatrixInfoAlgorithm::Outputs>(report->get_state()->getTransientValue("ReportedInfo"));
+  EXPECT_EQ(3, reportOutput.get<1>());
+  EXPECT_EQ(3, reportOutput.get<2>());
+  EXPECT_EQ(9, reportOutput.get<3>());
+  EXPECT_EQ(22, reportOutput.get<4>());
+  EXPECT_EQ(186, reportOutput.get<5>());
+  for (size_t i = 0; i < matrixMathNetwork.nmodules(); ++i)
+    EXPECT_EQ(ModuleExecutionState::Completed, matrixMathNetwork.module(i)->executionState().currentState());
+}
+
 TEST_F(SchedulingWithBoostGraph, ParallelNetworkOrderExecutedFromAModuleInADisjointSubnetwork)
 {
   setupBasicNetwork();
@@ -0,0 +1,314 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Scheduler/StreamingNetworkExecutor.h>
+#include <Dataflow/Network/ConnectionStream.h>
+#include <Dataflow/Network/Connection.h>
+#include <Dataflow/Network/Module.h>
+#include <Dataflow/Network/ModuleBuilder.h>
+#include <Dataflow/Network/SimpleSourceSink.h>
+#include <Dataflow/Network/Tests/MockNetwork.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <boost/atomic.hpp>
+#include <boost/functional/factory.hpp>
+#include <boost/thread/thread.hpp>
+#include <gtest/gtest.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Dataflow::Networks::Mocks;
+using namespace SCIRun::Core::Datatypes;
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+namespace
+{
+  DenseMatrixHandle chunk(double value)
+  {
+    return boost::make_shared<DenseMatrix>(DenseMatrix::Constant(1, 1, value));
+  }
+
+  double valueOf(const DatatypeHandleOption& data)
+  {
+    return (*boost::dynamic_pointer_cast<DenseMatrix>(*data))(0, 0);
+  }
+
+  ModuleLookupInfo named(const std::string& name)
+  {
+    ModuleLookupInfo info;
+    info.module_name_ = name;
+    return info;
+  }
+
+  class ChunkSource : public Module
+  {
+  public:
+    explicit ChunkSource(int chunks) : Module(named("ChunkSource"), false), chunks_(chunks) {}
+    void execute() override
+    {
+      for (int i = 0; i < chunks_; ++i)
+      {
+        ++attempted;
+        send_output_handle(PortId(0, "Output"), chunk(i));
+      }
+    }
+    void setStateDefaults() override {}
+    int attempted {0};
+  private:
+    int chunks_;
+  };
+
+  boost::atomic<int> busyStages(0);
+  boost::atomic<int> maxBusyStages(0);
+
+  class ScaleStage : public Module
+  {
+  public:
+    ScaleStage(const std::string& name, int failOnChunk, int errorOnChunk) : Module(named(name), false),
+      failOnChunk_(failOnChunk), errorOnChunk_(errorOnChunk), seen_(0) {}
+    void execute() override
+    {
+      auto busy = ++busyStages;
+      int max = maxBusyStages;
+      while (busy > max && !maxBusyStages.compare_exchange_weak(max, busy)) {}
+      boost::this_thread::sleep(boost::posix_time::milliseconds(2));
+      --busyStages;
+
+      auto index = seen_++;
+      if (index == failOnChunk_)
+        throw std::runtime_error("bad chunk");
+      if (index == errorOnChunk_)
+      {
+        error("bad chunk");
+        return;
+      }
+      auto input = getInputPort(PortId(0, "Input"))->getData();
+      values.push_back(valueOf(input));
+      send_output_handle(PortId(0, "Output"), chunk(2 * valueOf(input)));
+    }
+    void setStateDefaults() override {}
+    std::vector<double> values;
+  private:
+    int failOnChunk_;
+    int errorOnChunk_;
+    int seen_;
+  };
+}
+
+class StreamingNetworkExecutorTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ModuleBuilder::use_source_type(boost::factory<SimpleSource*>());
+    ModuleBuilder::use_sink_type(boost::factory<SimpleSink*>());
+    Module::resetIdGenerator();
+    busyStages = 0;
+    maxBusyStages = 0;
+    ON_CALL(network_, lookupModule(_)).WillByDefault(Invoke([this](const ModuleId& id)
+    {
+      for (const auto& m : modules_)
+        if (m->id() == id)
+          return m;
+      return ModuleHandle();
+    }));
+  }
+
+  boost::shared_ptr<ChunkSource> addSource(int chunks)
+  {
+    return boost::dynamic_pointer_cast<ChunkSource>(add(ModuleBuilder().using_func([chunks]() { return new ChunkSource(chunks); })
+      .add_output_port(Port::ConstructionParams(PortId(0, "Output"), "Matrix", false))
+      .build()));
+  }
+
+  boost::shared_ptr<ScaleStage> addStage(const std::string& name, int failOnChunk = -1, int errorOnChunk = -1)
+  {
+    return boost::dynamic_pointer_cast<ScaleStage>(add(ModuleBuilder().using_func([name, failOnChunk, errorOnChunk]() { return new ScaleStage(name, failOnChunk, errorOnChunk); })
+      .add_input_port(Port::ConstructionParams(PortId(0, "Input"), "Matrix", false))
+      .add_output_port(Port::ConstructionParams(PortId(0, "Output"), "Matrix", false))
+      .build()));
+  }
+
+  Connection* connect(ModuleHandle from, ModuleHandle to)
+  {
+    connections_.push_back(boost::make_shared<Connection>(from->getOutputPort(PortId(0, "Output")),
+      to->getInputPort(PortId(0, "Input")), from->id().id_ + "_" + to->id().id_, false));
+    return connections_.back().get();
+  }
+
+  NiceMock<MockNetwork> network_;
+  std::vector<ModuleHandle> modules_;
+  std::vector<ConnectionHandle> connections_;
+private:
+  ModuleHandle add(ModuleHandle m)
+  {
+    modules_.push_back(m);
+    return m;
+  }
+};
+
+TEST(ConnectionStreamTests, ProducerBlocksWhileQueueIsFull)
+{
+  ConnectionStream stream(2);
+  EXPECT_TRUE(stream.push(chunk(0)));
+  EXPECT_TRUE(stream.push(chunk(1)));
+
+  boost::atomic<bool> pushed(false);
+  boost::thread producer([&]() { stream.push(chunk(2)); pushed = true; });
+  boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+  EXPECT_FALSE(pushed);
+  EXPECT_EQ(2, stream.size());
+
+  EXPECT_EQ(0, valueOf(stream.pop()));
+  producer.join();
+  EXPECT_TRUE(pushed);
+  EXPECT_EQ(3, stream.pushed());
+}
+
+TEST(ConnectionStreamTests, ClosedStreamDrainsBeforeEnding)
+{
+  ConnectionStream stream(4);
+  stream.push(chunk(7));
+  stream.close();
+  EXPECT_EQ(7, valueOf(stream.pop()));
+  EXPECT_FALSE(stream.pop());
+}
+
+TEST(ConnectionStreamTests, AbortReleasesBlockedProducer)
+{
+  ConnectionStream stream(1);
+  stream.push(chunk(0));
+  boost::atomic<int> result(-1);
+  boost::thread producer([&]() { result = stream.push(chunk(1)) ? 1 : 0; });
+  boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+  stream.abort();
+  producer.join();
+  EXPECT_EQ(0, result);
+  EXPECT_FALSE(stream.pop());
+}
+
+TEST_F(StreamingNetworkExecutorTests, EveryStageProcessesEveryChunkInOrder)
+{
+  const int chunks = 50;
+  auto source = addSource(chunks);
+  auto scale = addStage("Scale");
+  auto rescale = addStage("Rescale");
+  auto c1 = connect(source, scale);
+  auto c2 = connect(scale, rescale);
+
+  StreamingNetworkExecutor executor(network_, 2);
+  EXPECT_TRUE(executor.execute(source->id()));
+
+  EXPECT_EQ(chunks, executor.chunksProcessed(source->id()));
+  EXPECT_EQ(chunks, executor.chunksProcessed(scale->id()));
+  EXPECT_EQ(chunks, executor.chunksProcessed(rescale->id()));
+  ASSERT_EQ(chunks, rescale->values.size());
+  for (int i = 0; i < chunks; ++i)
+  {
+    EXPECT_EQ(i, scale->values[i]);
+    EXPECT_EQ(2 * i, rescale->values[i]);
+  }
+
+  EXPECT_FALSE(c1->stream());
+  EXPECT_FALSE(c2->stream());
+  EXPECT_EQ(2 * (chunks - 1), valueOf(rescale->getInputPort(PortId(0, "Input"))->getData()));
+  EXPECT_EQ(ModuleExecutionState::Completed, rescale->executionState().currentState());
+}
+
+TEST_F(StreamingNetworkExecutorTests, StagesOverlap)
+{
+  auto source = addSource(30);
+  auto scale = addStage("Scale");
+  auto rescale = addStage("Rescale");
+  connect(source, scale);
+  connect(scale, rescale);
+
+  StreamingNetworkExecutor executor(network_);
+  EXPECT_TRUE(executor.execute(source->id()));
+  EXPECT_EQ(2, maxBusyStages);
+}
+
+TEST_F(StreamingNetworkExecutorTests, FanOutFeedsEveryBranch)
+{
+  auto source = addSource(10);
+  auto left = addStage("Left");
+  auto right = addStage("Right");
+  connect(source, left);
+  connect(source, right);
+
+  StreamingNetworkExecutor executor(network_, 1);
+  EXPECT_TRUE(executor.execute(source->id()));
+  EXPECT_EQ(10, left->values.size());
+  EXPECT_EQ(10, right->values.size());
+}
+
+TEST_F(StreamingNetworkExecutorTests, FailingStageCancelsStream)
+{
+  auto source = addSource(1000);
+  auto scale = addStage("Scale", 3);
+  auto rescale = addStage("Rescale");
+  auto c1 = connect(source, scale);
+  connect(scale, rescale);
+
+  StreamingNetworkExecutor executor(network_, 2);
+  EXPECT_FALSE(executor.execute(source->id()));
+  EXPECT_EQ(3, scale->values.size());
+  EXPECT_EQ(3, rescale->values.size());
+  EXPECT_FALSE(c1->stream());
+  EXPECT_EQ(ModuleExecutionState::Errored, scale->executionState().expandedState());
+}
+
+TEST_F(StreamingNetworkExecutorTests, StageReportingErrorCancelsStream)
+{
+  auto source = addSource(1000);
+  auto scale = addStage("Scale", -1, 3);
+  auto rescale = addStage("Rescale");
+  connect(source, scale);
+  connect(scale, rescale);
+
+  StreamingNetworkExecutor executor(network_, 2);
+  EXPECT_FALSE(executor.execute(source->id()));
+  EXPECT_EQ(3, scale->values.size());
+  EXPECT_EQ(3, executor.chunksProcessed(scale->id()));
+  EXPECT_EQ(ModuleExecutionState::Errored, scale->executionState().expandedState());
+}
+
+TEST_F(StreamingNetworkExecutorTests, ProducerStopsOnceStreamIsAborted)
+{
+  auto source = addSource(1000);
+  auto scale = addStage("Scale", 3);
+  connect(source, scale);
+
+  StreamingNetworkExecutor executor(network_, 2);
+  EXPECT_FALSE(executor.execute(source->id()));
+  EXPECT_LT(source->attempted, 1000);
+  EXPECT_EQ(ModuleExecutionState::Completed, source->executionState().expandedState());
+}
@@ -55,9 +55,18 @@ namespace SCIRun {
         void setDisable(bool disable);
 
         bool isVirtual() const { return virtual_; }
+        /// Feedback edge of a loop: data flows from an iteration to the next one, and the
+        /// schedulers ignore it, so a network closed by such edges stays acyclic.
+        bool isLoopCarried() const { return loopCarried_; }
+        void setLoopCarried(bool loopCarried) { loopCarried_ = loopCarried; }
+        /// Non-null while a streaming execution routes this connection's data through a bounded queue.
+        ConnectionStreamHandle stream() const { return stream_; }
+        void setStream(ConnectionStreamHandle stream) { stream_ = stream; }
       private:
         bool disabled_ {false};
         bool virtual_ {false};
+        bool loopCarried_ {false};
+        ConnectionStreamHandle stream_;
       };
 
 }}}
@@ -0,0 +1,108 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Network/ConnectionStream.h>
+#include <Core/Utils/Exception.h>
+
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Thread;
+
+ConnectionStream::ConnectionStream(size_t capacity) :
+  capacity_(capacity),
+  lock_("connectionStream"),
+  changed_("connectionStream")
+{
+  if (0 == capacity_)
+    THROW_INVALID_ARGUMENT("Connection stream capacity must be positive");
+}
+
+bool ConnectionStream::push(DatatypeHandle chunk)
+{
+  {
+    UniqueLock lock(lock_.get());
+    while (chunks_.size() >= capacity_ && !aborted_)
+      changed_.wait(lock);
+    if (aborted_)
+      return false;
+    if (closed_)
+      THROW_INVALID_ARGUMENT("Cannot push onto a closed connection stream");
+    chunks_.push_back(chunk);
+    ++pushed_;
+  }
+  changed_.conditionBroadcast();
+  return true;
+}
+
+DatatypeHandleOption ConnectionStream::pop()
+{
+  DatatypeHandleOption chunk;
+  {
+    UniqueLock lock(lock_.get());
+    while (chunks_.empty() && !closed_ && !aborted_)
+      changed_.wait(lock);
+    if (aborted_ || chunks_.empty())
+      return chunk;
+    chunk = chunks_.front();
+    chunks_.pop_front();
+  }
+  changed_.conditionBroadcast();
+  return chunk;
+}
+
+void ConnectionStream::close()
+{
+  {
+    Guard g(lock_.get());
+    closed_ = true;
+  }
+  changed_.conditionBroadcast();
+}
+
+void ConnectionStream::abort()
+{
+  {
+    Guard g(lock_.get());
+    aborted_ = true;
+    chunks_.clear();
+  }
+  changed_.conditionBroadcast();
+}
+
+size_t ConnectionStream::size() const
+{
+  Guard g(lock_.get());
+  return chunks_.size();
+}
+
+size_t ConnectionStream::pushed() const
+{
+  Guard g(lock_.get());
+  return pushed_;
+}
@@ -0,0 +1,76 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef DATAFLOW_NETWORK_CONNECTIONSTREAM_H
+#define DATAFLOW_NETWORK_CONNECTIONSTREAM_H
+
+#include <Dataflow/Network/NetworkFwd.h>
+#include <Core/Datatypes/Datatype.h>
+#include <Core/Thread/ConditionVariable.h>
+#include <deque>
+#include <Dataflow/Network/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Networks {
+
+  /// Bounded FIFO of datatypes carried by one connection during streaming execution.
+  /// The producer blocks while the queue is full, so a slow consumer throttles its upstream
+  /// instead of letting chunks pile up in memory.
+  class SCISHARE ConnectionStream : boost::noncopyable
+  {
+  public:
+    explicit ConnectionStream(size_t capacity);
+
+    /// Blocks while the queue is full. Returns false, dropping the chunk, once the stream is aborted.
+    bool push(Core::Datatypes::DatatypeHandle chunk);
+    /// Blocks until a chunk arrives. Returns none once the stream is closed and drained, or aborted.
+    Core::Datatypes::DatatypeHandleOption pop();
+    /// Producer is finished; consumers drain what is queued and then see end of stream.
+    void close();
+    /// Drops queued chunks and wakes every waiter; used when a stage fails.
+    void abort();
+
+    size_t capacity() const { return capacity_; }
+    size_t size() const;
+    /// Number of chunks pushed over the stream's lifetime.
+    size_t pushed() const;
+  private:
+    const size_t capacity_;
+    std::deque<Core::Datatypes::DatatypeHandle> chunks_;
+    size_t pushed_ {0};
+    bool closed_ {false};
+    bool aborted_ {false};
+    mutable Core::Thread::Mutex lock_;
+    Core::Thread::ConditionVariable changed_;
+  };
+
+}}}
+
+#endif
@@ -49,6 +49,8 @@ namespace Networks {
     virtual void send(DatatypeSinkInterfaceHandle receiver) const = 0;
     virtual bool hasData() const = 0;
     virtual std::string describeData() const = 0;
+    /// Approximate element count of the last cached data; readable without receiving it.
+    virtual size_t dataSize() const = 0;
   };
 
   typedef boost::signals2::signal<void(SCIRun::Core::Datatypes::DatatypeHandle)> DataHasChangedSignalType;
@@ -0,0 +1,212 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Network/DatatypeContentHash.h>
+#include <Core/Datatypes/String.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  class Fnv1aHash
+  {
+  public:
+    Fnv1aHash() : hash_(14695981039346656037ULL) {}
+
+    void bytes(const void* data, size_t count)
+    {
+      auto byte = static_cast<const unsigned char*>(data);
+      for (size_t i = 0; i < count; ++i)
+      {
+        hash_ ^= byte[i];
+        hash_ *= 1099511628211ULL;
+      }
+    }
+
+    template <typename T>
+    void value(const T& t)
+    {
+      bytes(&t, sizeof(T));
+    }
+
+    void text(const std::string& str)
+    {
+      value(str.size());
+      bytes(str.data(), str.size());
+    }
+
+    boost::uint64_t result() const { return hash_; }
+  private:
+    boost::uint64_t hash_;
+  };
+
+  bool hashField(Fnv1aHash& hash, Field& field)
+  {
+    auto mesh = field.vmesh();
+    auto values = field.vfield();
+    if (!mesh || !values || !(values->is_scalar() || values->is_vector() || values->is_nodata()))
+      return false;
+
+    hash.value(mesh->dimensionality());
+    hash.value(mesh->basis_order());
+    VMesh::Node::size_type numNodes = mesh->num_nodes();
+    hash.value(numNodes);
+    for (VMesh::Node::index_type i = 0; i < numNodes; ++i)
+    {
+      Point p;
+      mesh->get_center(p, i);
+      hash.value(p.x());
+      hash.value(p.y());
+      hash.value(p.z());
+    }
+    VMesh::Elem::size_type numElems = mesh->num_elems();
+    hash.value(numElems);
+    VMesh::Node::array_type nodes;
+    for (VMesh::Elem::index_type i = 0; i < numElems; ++i)
+    {
+      mesh->get_nodes(nodes, i);
+      for (auto node : nodes)
+        hash.value(static_cast<index_type>(node));
+    }
+
+    hash.value(values->basis_order());
+    hash.text(values->get_data_type());
+    VMesh::size_type numValues = values->num_values();
+    hash.value(numValues);
+    for (VMesh::index_type i = 0; i < numValues; ++i)
+    {
+      if (values->is_scalar())
+      {
+        double v;
+        values->get_value(v, i);
+        hash.value(v);
+      }
+      else if (values->is_vector())
+      {
+        Vector v;
+        values->get_value(v, i);
+        hash.value(v.x());
+        hash.value(v.y());
+        hash.value(v.z());
+      }
+    }
+    return true;
+  }
+}
+
+boost::uint64_t SCIRun::Dataflow::Networks::contentHash(const DatatypeHandle& data)
+{
+  Fnv1aHash hash;
+  if (!data)
+    return hash.result();
+
+  hash.text(data->dynamic_type_name());
+
+  auto dense = boost::dynamic_pointer_cast<DenseMatrix>(data);
+  if (dense)
+  {
+    hash.value(dense->rows());
+    hash.value(dense->cols());
+    hash.bytes(dense->data(), dense->size() * sizeof(double));
+    return hash.result();
+  }
+
+  auto column = boost::dynamic_pointer_cast<DenseColumnMatrix>(data);
+  if (column)
+  {
+    hash.value(column->rows());
+    hash.bytes(column->data(), column->size() * sizeof(double));
+    return hash.result();
+  }
+
+  auto sparse = boost::dynamic_pointer_cast<SparseRowMatrix>(data);
+  if (sparse && sparse->isCompressed())
+  {
+    hash.value(sparse->rows());
+    hash.value(sparse->cols());
+    hash.bytes(sparse->outerIndexPtr(), (sparse->rows() + 1) * sizeof(SparseRowMatrix::Index));
+    hash.bytes(sparse->innerIndexPtr(), sparse->nonZeros() * sizeof(SparseRowMatrix::Index));
+    hash.bytes(sparse->valuePtr(), sparse->nonZeros() * sizeof(double));
+    return hash.result();
+  }
+
+  auto str = boost::dynamic_pointer_cast<String>(data);
+  if (str)
+  {
+    hash.text(str->value());
+    return hash.result();
+  }
+
+  auto field = boost::dynamic_pointer_cast<Field>(data);
+  if (field && hashField(hash, *field))
+    return hash.result();
+
+  hash.value(data->id());
+  return hash.result();
+}
+
+boost::uint64_t SCIRun::Dataflow::Networks::contentHash(const std::string& text)
+{
+  Fnv1aHash hash;
+  hash.text(text);
+  return hash.result();
+}
+
+size_t SCIRun::Dataflow::Networks::approximateElementCount(const DatatypeHandle& data)
+{
+  if (!data)
+    return 0;
+
+  auto sparse = boost::dynamic_pointer_cast<SparseRowMatrix>(data);
+  if (sparse)
+    return static_cast<size_t>(sparse->nonZeros());
+
+  auto matrix = boost::dynamic_pointer_cast<Matrix>(data);
+  if (matrix)
+    return matrix->nrows() * matrix->ncols();
+
+  auto field = boost::dynamic_pointer_cast<Field>(data);
+  if (field && field->vmesh())
+    return field->vmesh()->num_nodes() + field->vmesh()->num_elems();
+
+  auto str = boost::dynamic_pointer_cast<String>(data);
+  if (str)
+    return str->value().size();
+
+  return 1;
+}
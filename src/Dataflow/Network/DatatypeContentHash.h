@@ -0,0 +1,53 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef DATAFLOW_NETWORK_DATATYPE_CONTENT_HASH_H
+#define DATAFLOW_NETWORK_DATATYPE_CONTENT_HASH_H
+
+#include <Core/Datatypes/DatatypeFwd.h>
+#include <string>
+#include <boost/cstdint.hpp>
+#include <Dataflow/Network/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Networks {
+
+  /// 64-bit FNV-1a hash of a datatype's contents: dense and sparse matrices, strings,
+  /// and fields with scalar or vector data. Equal contents built by separate executions
+  /// hash equal. Other types hash by object id, so they only match themselves.
+  SCISHARE boost::uint64_t contentHash(const Core::Datatypes::DatatypeHandle& data);
+  SCISHARE boost::uint64_t contentHash(const std::string& text);
+
+  /// Rough number of stored values: matrix entries, field nodes plus elements, string length.
+  SCISHARE size_t approximateElementCount(const Core::Datatypes::DatatypeHandle& data);
+
+}}}
+
+#endif
@@ -0,0 +1,101 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Network/DatatypeSpill.h>
+#include <Core/Datatypes/Matrix.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Persistent/Pstreams.h>
+#include <Core/Logging/Log.h>
+#include <boost/filesystem.hpp>
+
+using namespace SCIRun;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+
+bool SCIRun::Dataflow::Networks::canSpill(const DatatypeHandle& data)
+{
+  return boost::dynamic_pointer_cast<Matrix>(data) || boost::dynamic_pointer_cast<Field>(data);
+}
+
+boost::optional<SpilledDatatype> SCIRun::Dataflow::Networks::spillToFile(const DatatypeHandle& data,
+  const boost::filesystem::path& file)
+{
+  auto matrix = boost::dynamic_pointer_cast<Matrix>(data);
+  auto field = boost::dynamic_pointer_cast<Field>(data);
+  if (!matrix && !field)
+    return boost::none;
+
+  SpilledDatatype spilled{ file, !!field };
+  bool failed;
+  {
+    auto stream = auto_ostream(file.string(), "Binary");
+    if (matrix)
+      Pio(*stream, matrix);
+    else
+      Pio(*stream, field);
+    failed = stream->error();
+  }
+  if (failed)
+  {
+    logWarning("Could not spill {} to {}", data->dynamic_type_name(), file.string());
+    removeSpillFile(spilled);
+    return boost::none;
+  }
+  return spilled;
+}
+
+DatatypeHandle SCIRun::Dataflow::Networks::restoreFromFile(const SpilledDatatype& spilled)
+{
+  auto stream = auto_istream(spilled.file.string());
+  if (!stream)
+    return nullptr;
+
+  DatatypeHandle data;
+  if (spilled.isField)
+  {
+    FieldHandle field;
+    Pio(*stream, field);
+    data = field;
+  }
+  else
+  {
+    MatrixHandle matrix;
+    Pio(*stream, matrix);
+    data = matrix;
+  }
+  if (stream->error())
+    return nullptr;
+  return data;
+}
+
+void SCIRun::Dataflow::Networks::removeSpillFile(const SpilledDatatype& spilled)
+{
+  boost::system::error_code ignored;
+  boost::filesystem::remove(spilled.file, ignored);
+}
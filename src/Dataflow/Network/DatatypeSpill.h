@@ -0,0 +1,63 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef DATAFLOW_NETWORK_DATATYPE_SPILL_H
+#define DATAFLOW_NETWORK_DATATYPE_SPILL_H
+
+#include <Core/Datatypes/DatatypeFwd.h>
+#include <boost/optional.hpp>
+#include <boost/filesystem/path.hpp>
+#include <Dataflow/Network/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Networks {
+
+  /// A matrix or field written to a scratch file by spillToFile.
+  struct SCISHARE SpilledDatatype
+  {
+    boost::filesystem::path file;
+    bool isField;
+  };
+
+  /// Only matrices and fields have Pio serialization to spill through.
+  SCISHARE bool canSpill(const Core::Datatypes::DatatypeHandle& data);
+
+  /// Writes data with binary Pio; none if it cannot be spilled or the write failed.
+  SCISHARE boost::optional<SpilledDatatype> spillToFile(const Core::Datatypes::DatatypeHandle& data,
+    const boost::filesystem::path& file);
+
+  /// Reads a spilled file back; null if it is missing or unreadable. The file is kept.
+  SCISHARE Core::Datatypes::DatatypeHandle restoreFromFile(const SpilledDatatype& spilled);
+
+  SCISHARE void removeSpillFile(const SpilledDatatype& spilled);
+
+}}}
+
+#endif
@@ -47,8 +47,12 @@
 // ReSharper disable once CppUnusedIncludeDirective
 #include <Dataflow/Network/DataflowInterfaces.h>
 #include <Dataflow/Network/ModuleBuilder.h>
+#include <Dataflow/Network/ModuleCostHistory.h>
+#include <Dataflow/Network/ModuleOutputMemoCache.h>
+#include <Dataflow/Network/PortDataCache.h>
 #include <Core/Logging/ConsoleLogger.h>
 #include <Core/Logging/Log.h>
+#include <Core/Logging/ExecutionProfiler.h>
 #include <Core/Thread/Mutex.h>
 #include <Core/Thread/Interruptible.h>
 
@@ -201,6 +205,9 @@ namespace SCIRun
         UiToggleFunc uiToggleFunc_;
 
         bool returnCode_{ false };
+        boost::optional<ModuleOutputMemoCache::Outputs> recordedOutputs_;
+        // set once an execution changed the module state, which outputs do not capture
+        std::atomic<bool> publishesState_ { false };
       };
     }
   }
@@ -385,6 +392,8 @@ bool Module::executeWithSignals() NOEXCEPT
 #endif
   impl_->executeBegins_(id());
   boost::timer executionTimer;
+  auto inputSizeClass = ModuleCostHistory::inputSizeClass(*this);
+  auto wallClockStart = boost::posix_time::microsec_clock::universal_time();
   {
     auto isoString = boost::posix_time::to_simple_string(boost::posix_time::microsec_clock::universal_time());
     impl_->metadata_.setMetadata("Last execution timestamp", isoString);
@@ -394,14 +403,16 @@ bool Module::executeWithSignals() NOEXCEPT
   status(starting);
   /// @todo: need separate logger per module
   //LOG_DEBUG("STARTING MODULE: " << id_.id_);
+  ExecutionProfiler::Instance().moduleStarted(id().id_);
   impl_->executionState_->transitionTo(ModuleExecutionState::Executing);
   impl_->returnCode_ = false;
   bool threadStopValue = false;
+  bool executed = false;
 
   try
   {
     if (!executionDisabled())
-      execute();
+      executed = executeWithMemoization();
 
     impl_->returnCode_ = true;
     getLogger()->setErrorFlag(false);
@@ -447,8 +458,14 @@ bool Module::executeWithSignals() NOEXCEPT
     error("MODULE ERROR: unhandled exception caught");
   }
   impl_->threadStopped_ = threadStopValue;
+  ExecutionProfiler::Instance().moduleFinished(id().id_);
 
   auto executionTime = executionTimer.elapsed();
+  if (impl_->returnCode_ && executed)
+  {
+    auto wallClockTime = boost::posix_time::microsec_clock::universal_time() - wallClockStart;
+    ModuleCostHistory::Instance().record(name(), inputSizeClass, wallClockTime.total_microseconds() * 1e-6);
+  }
   {
     std::ostringstream ostr;
     ostr << executionTime;
@@ -483,6 +500,60 @@ bool Module::executeWithSignals() NOEXCEPT
   return impl_->returnCode_;
 }
 
+bool Module::executeWithMemoization()
+{
+  auto& memo = ModuleOutputMemoCache::Instance();
+  boost::optional<std::string> key;
+  if (memo.enabled() && !impl_->publishesState_)
+    key = memo.keyFor(*this);
+  if (!key)
+  {
+    execute();
+    return true;
+  }
+
+  auto outputs = memo.find(*key);
+  if (outputs)
+  {
+    // consume the ports' change flags as execute() would have
+    for (const auto& input : inputPorts())
+      input->hasChanged();
+    for (const auto& output : *outputs)
+      send_output_handle(output.first, output.second);
+    status("Outputs restored from memoization cache.");
+    return false;
+  }
+
+  // Results published through the state (reports, plots, values shown in the GUI)
+  // would go stale on a replay, so a module that changes its state while executing
+  // is never memoized.
+  std::atomic<bool> stateChanged { false };
+  boost::signals2::scoped_connection stateWatch;
+  if (impl_->state_)
+    stateWatch = impl_->state_->connectStateChanged([&stateChanged]() { stateChanged = true; });
+
+  impl_->recordedOutputs_ = ModuleOutputMemoCache::Outputs();
+  try
+  {
+    execute();
+  }
+  catch (...)
+  {
+    impl_->recordedOutputs_.reset();
+    throw;
+  }
+  stateWatch.disconnect();
+  if (stateChanged)
+  {
+    LOG_DEBUG("{} publishes results through its state, outputs are not memoized", id().id_);
+    impl_->publishesState_ = true;
+  }
+  else if (!getLogger()->errorReported())
+    memo.store(*key, *impl_->recordedOutputs_);
+  impl_->recordedOutputs_.reset();
+  return true;
+}
+
 void Module::runProgrammablePortInput()
 {
   auto prog = getOptionalInputAtIndex<MetadataObject>(ProgrammablePortId());
@@ -564,6 +635,26 @@ namespace //TODO: flesh out requirements for metadata on input handles.
       return "Null data handle";
     return "Datatype id# " + boost::lexical_cast<std::string>((*data)->id());
   }
+
+  /// Charges the time spent in port getData, including reloads of evicted port data, to the module's profile.
+  class ScopedInputFetch : boost::noncopyable
+  {
+  public:
+    explicit ScopedInputFetch(const ModuleId& id) : id_(id), active_(ExecutionProfiler::Instance().enabled())
+    {
+      if (active_)
+        begin_ = ExecutionProfiler::Clock::now();
+    }
+    ~ScopedInputFetch()
+    {
+      if (active_)
+        ExecutionProfiler::Instance().moduleInputFetch(id_.id_, boost::chrono::duration<double>(ExecutionProfiler::Clock::now() - begin_).count());
+    }
+  private:
+    const ModuleId& id_;
+    bool active_;
+    ExecutionProfiler::Clock::time_point begin_;
+  };
 }
 
 DatatypeHandleOption Module::get_input_handle(const PortId& id)
@@ -587,7 +678,11 @@ DatatypeHandleOption Module::get_input_handle(const PortId& id)
     //Log::get() << DEBUG_LOG << id_ << ":: inputsChanged is now " << inputsChanged_ << std::endl;
   }
 
-  auto data = port->getData();
+  DatatypeHandleOption data;
+  {
+    ScopedInputFetch fetch(this->id());
+    data = port->getData();
+  }
   impl_->metadata_.setMetadata("Input " + id.toString(), metaInfo(data));
   return data;
 }
@@ -610,8 +705,11 @@ std::vector<DatatypeHandleOption> Module::get_dynamic_input_handles(const PortId
   }
 
   std::vector<DatatypeHandleOption> options;
-  auto getData = [](InputPortHandle input) { return input->getData(); };
-  std::transform(portsWithName.begin(), portsWithName.end(), std::back_inserter(options), getData);
+  {
+    ScopedInputFetch fetch(id());
+    auto getData = [](InputPortHandle input) { return input->getData(); };
+    std::transform(portsWithName.begin(), portsWithName.end(), std::back_inserter(options), getData);
+  }
 
   impl_->metadata_.setMetadata("Input " + pid.toString(), metaInfo(options.empty() ? boost::none : options[0]));
 
@@ -626,6 +724,8 @@ void Module::send_output_handle(const PortId& id, DatatypeHandle data)
     THROW_OUT_OF_RANGE("Output port does not exist: " + id.toString());
   }
 
+  if (impl_->recordedOutputs_)
+    impl_->recordedOutputs_->push_back(std::make_pair(id, data));
   impl_->oports_[id]->sendData(data);
 }
 
@@ -1002,6 +1102,9 @@ bool OutputPortsCachedCheckerImpl::outputPortsCached() const
   {
     if (output->hasConnectionCountIncreased())
       value = false;
+    // evicted by the port data budget with nothing to reload from
+    if (output->nconnections() > 0 && PortDataCache::Instance().evicted(output->source().get()))
+      value = false;
   }
   LOG_DEBUG("reexecute {}?--output ports cached: {}", module_.id().id_, value);
   return value;
@@ -1129,6 +1232,14 @@ bool Module::isStoppable() const
   return dynamic_cast<const Interruptible*>(this) != nullptr;
 }
 
+bool Module::hasSideEffects() const
+{
+  // file readers and writers, viewers and interpreters; geometry goes to the renderer
+  const auto& category = info().category_name_;
+  return category == "DataIO" || category == "Matlab" || category == "Render" || category == "Python"
+    || dynamic_cast<const GeometryGeneratingModule*>(this) != nullptr;
+}
+
 void Module::sendFeedbackUpstreamAlongIncomingConnections(const ModuleFeedback& feedback) const
 {
   for (const auto& inputPort : inputPorts())
@@ -107,6 +107,7 @@ namespace Networks {
     std::vector<InputPortHandle> inputPorts() const override final;
     std::vector<OutputPortHandle> outputPorts() const override final;
     bool isStoppable() const override final;
+    bool hasSideEffects() const override;
     bool oport_connected(const PortId& id) const;
     bool inputsChanged() const;
     std::string name() const override final;
@@ -193,6 +194,10 @@ namespace Networks {
     Core::Datatypes::DatatypeHandleOption get_input_handle(const PortId& id) override final;
     std::vector<Core::Datatypes::DatatypeHandleOption> get_dynamic_input_handles(const PortId& id) override final;
     void runProgrammablePortInput();
+    /// Runs execute(), or replays memoized outputs when ModuleOutputMemoCache is enabled
+    /// and has an entry for the current state and inputs. Modules whose execution changes
+    /// their state always execute. Returns whether execute() ran.
+    bool executeWithMemoization();
     template <class T>
     boost::shared_ptr<T> getRequiredInputAtIndex(const PortId& id);
     template <class T>
@@ -0,0 +1,140 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Network/ModuleCostHistory.h>
+#include <Dataflow/Network/ModuleInterface.h>
+#include <Dataflow/Network/PortInterface.h>
+#include <Dataflow/Network/Connection.h>
+#include <Dataflow/Network/DataflowInterfaces.h>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <cmath>
+#include <limits>
+
+using namespace SCIRun;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Thread;
+
+CORE_SINGLETON_IMPLEMENTATION( ModuleCostHistory )
+
+const size_t ModuleCostHistory::AveragingWindow = 10;
+
+ModuleCostHistory::ModuleCostHistory() : lock_("moduleCostHistory")
+{
+}
+
+int ModuleCostHistory::inputSizeClass(const ModuleInterface& module)
+{
+  size_t total = 0;
+  // read the size the upstream source recorded: receiving here would reload spilled data
+  for (const auto& port : module.inputPorts())
+  {
+    for (size_t i = 0; i < port->nconnections(); ++i)
+    {
+      auto conn = port->connection(i);
+      if (conn && conn->oport_ && conn->oport_->source())
+        total += conn->oport_->source()->dataSize();
+    }
+  }
+
+  int sizeClass = 0;
+  while (total > 1)
+  {
+    total >>= 1;
+    ++sizeClass;
+  }
+  return sizeClass;
+}
+
+void ModuleCostHistory::record(const std::string& moduleName, int inputSizeClass, double seconds)
+{
+  Guard g(lock_.get());
+  auto& stats = costs_.insert(std::make_pair(std::make_pair(moduleName, inputSizeClass), Stats{ 0, 0.0 })).first->second;
+  if (stats.runs < AveragingWindow)
+    ++stats.runs;
+  stats.meanSeconds += (seconds - stats.meanSeconds) / stats.runs;
+}
+
+boost::optional<double> ModuleCostHistory::estimate(const std::string& moduleName, int inputSizeClass) const
+{
+  Guard g(lock_.get());
+  boost::optional<double> nearest;
+  int nearestDistance = 0;
+  for (auto i = costs_.lower_bound(std::make_pair(moduleName, std::numeric_limits<int>::min()));
+    i != costs_.end() && i->first.first == moduleName; ++i)
+  {
+    auto distance = std::abs(i->first.second - inputSizeClass);
+    if (!nearest || distance < nearestDistance)
+    {
+      nearest = i->second.meanSeconds;
+      nearestDistance = distance;
+    }
+  }
+  return nearest;
+}
+
+std::vector<ModuleCostHistory::Entry> ModuleCostHistory::entries() const
+{
+  Guard g(lock_.get());
+  std::vector<Entry> entries;
+  for (const auto& cost : costs_)
+    entries.push_back(Entry{ cost.first.first, cost.first.second, cost.second.runs, cost.second.meanSeconds });
+  return entries;
+}
+
+void ModuleCostHistory::clear()
+{
+  Guard g(lock_.get());
+  costs_.clear();
+}
+
+void ModuleCostHistory::setStorageFile(const boost::filesystem::path& file)
+{
+  Guard g(lock_.get());
+  file_ = file;
+  std::ifstream in(file.string().c_str());
+  std::string name;
+  int sizeClass;
+  Stats stats;
+  while (in >> name >> sizeClass >> stats.runs >> stats.meanSeconds)
+    costs_[std::make_pair(name, sizeClass)] = stats;
+}
+
+bool ModuleCostHistory::save() const
+{
+  Guard g(lock_.get());
+  if (file_.empty())
+    return false;
+  std::ofstream out(file_.string().c_str());
+  out.precision(9);
+  for (const auto& cost : costs_)
+    out << cost.first.first << ' ' << cost.first.second << ' ' << cost.second.runs << ' ' << cost.second.meanSeconds << '\n';
+  return static_cast<bool>(out);
+}
@@ -0,0 +1,94 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef DATAFLOW_NETWORK_MODULE_COST_HISTORY_H
+#define DATAFLOW_NETWORK_MODULE_COST_HISTORY_H
+
+#include <map>
+#include <vector>
+#include <boost/optional.hpp>
+#include <boost/filesystem/path.hpp>
+#include <Core/Utils/Singleton.h>
+#include <Core/Thread/Mutex.h>
+#include <Dataflow/Network/NetworkFwd.h>
+#include <Dataflow/Network/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Networks {
+
+  /// Wall-clock execution times of past module runs, keyed by module type and a
+  /// coarse input-size signature. Schedulers use it to estimate how much work lies
+  /// downstream of each ready module.
+  class SCISHARE ModuleCostHistory : boost::noncopyable
+  {
+    CORE_SINGLETON(ModuleCostHistory)
+  public:
+    struct Entry
+    {
+      std::string moduleName;
+      int inputSizeClass;
+      size_t runs;
+      double meanSeconds;
+    };
+
+    /// Power-of-two class (floor of log2) of the total element count on the module's
+    /// connected inputs: matrix entries, field nodes plus elements, string length.
+    static int inputSizeClass(const ModuleInterface& module);
+
+    void record(const std::string& moduleName, int inputSizeClass, double seconds);
+    /// Mean time of the recorded size class nearest to the requested one; none if the
+    /// module type has never been recorded.
+    boost::optional<double> estimate(const std::string& moduleName, int inputSizeClass) const;
+    std::vector<Entry> entries() const;
+    void clear();
+
+    /// Loads any history saved at the given path and remembers it for save().
+    void setStorageFile(const boost::filesystem::path& file);
+    bool save() const;
+
+    /// Runs after which the mean turns into a moving average, so the history follows
+    /// changes in hardware or module implementation.
+    static const size_t AveragingWindow;
+  private:
+    ModuleCostHistory();
+    struct Stats
+    {
+      size_t runs;
+      double meanSeconds;
+    };
+    typedef std::map<std::pair<std::string, int>, Stats> CostMap;
+    CostMap costs_;
+    boost::filesystem::path file_;
+    mutable Core::Thread::Mutex lock_;
+  };
+
+}}}
+
+#endif
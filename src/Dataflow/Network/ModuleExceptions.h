@@ -42,6 +42,8 @@ namespace Networks {
   struct SCISHARE WrongDatatypeOnPortException : virtual DataPortException {};
   struct SCISHARE PortNotFoundException : virtual DataPortException {};
   struct SCISHARE InvalidInputPortRequestException : virtual DataPortException {};
+  /// Thrown by sendData when a streaming connection was aborted and dropped the chunk.
+  struct SCISHARE StreamAbortedException : virtual DataPortException {};
   struct SCISHARE GeneralModuleError : virtual Core::ExceptionBase {};
 
   #define MODULE_ERROR_WITH_TYPE(type, message) \
@@ -88,6 +88,9 @@ namespace Networks {
     virtual void enqueueExecuteAgain(bool upstream) = 0;
     virtual const MetadataMap& metadata() const = 0;
     virtual bool isStoppable() const = 0;
+    /// True for modules that act beyond their output ports (rendering, file I/O,
+    /// interpreters); their outputs are never replayed from ModuleOutputMemoCache.
+    virtual bool hasSideEffects() const = 0;
     virtual bool executionDisabled() const = 0;
     virtual void setExecutionDisabled(bool disable) = 0;
     virtual bool isImplementationDisabled() const = 0;
@@ -0,0 +1,348 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Network/ModuleOutputMemoCache.h>
+#include <Dataflow/Network/ModuleInterface.h>
+#include <Dataflow/Network/ModuleStateInterface.h>
+#include <Dataflow/Network/PortInterface.h>
+#include <Dataflow/Network/DatatypeContentHash.h>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <sstream>
+
+using namespace SCIRun;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Thread;
+
+CORE_SINGLETON_IMPLEMENTATION( ModuleOutputMemoCache )
+
+ModuleOutputMemoCache::ModuleOutputMemoCache() : budget_(0), inUse_(0), spillSequence_(0), lock_("moduleOutputMemoCache")
+{
+}
+
+ModuleOutputMemoCache::~ModuleOutputMemoCache()
+{
+  clear();
+}
+
+void ModuleOutputMemoCache::setMemoryBudget(size_t bytes)
+{
+  EntryList victims;
+  {
+    Guard g(lock_.get());
+    budget_ = bytes;
+    victims = evictToBudget();
+  }
+  spillEvicted(victims);
+}
+
+size_t ModuleOutputMemoCache::memoryBudget() const
+{
+  Guard g(lock_.get());
+  return budget_;
+}
+
+bool ModuleOutputMemoCache::enabled() const
+{
+  return memoryBudget() > 0;
+}
+
+void ModuleOutputMemoCache::setSpillDirectory(const boost::filesystem::path& dir)
+{
+  if (!dir.empty())
+    boost::filesystem::create_directories(dir);
+  Guard g(lock_.get());
+  spillDirectory_ = dir;
+}
+
+boost::optional<std::string> ModuleOutputMemoCache::keyFor(const ModuleInterface& module) const
+{
+  if (0 == module.numOutputPorts() || module.hasSideEffects())
+    return boost::none;
+
+  std::ostringstream state;
+  auto moduleState = module.cstate();
+  if (moduleState)
+  {
+    for (const auto& name : moduleState->getKeys())
+      state << name.name() << '=' << moduleState->getValue(name).value() << ';';
+  }
+
+  std::ostringstream key;
+  key << module.name() << '|' << std::hex << contentHash(state.str());
+  for (const auto& input : module.inputPorts())
+  {
+    key << '|' << input->id().toString() << ':';
+    DatatypeHandleOption data;
+    if (input->nconnections() > 0)
+      data = input->getData();
+    if (data && *data)
+      key << inputHash(*data);
+    else
+      key << '-';
+  }
+  return key.str();
+}
+
+boost::uint64_t ModuleOutputMemoCache::inputHash(const DatatypeHandle& data) const
+{
+  {
+    Guard g(lock_.get());
+    auto known = inputHashes_.find(data->id());
+    if (known != inputHashes_.end() && known->second.data.lock() == data)
+      return known->second.hash;
+  }
+
+  auto hash = contentHash(data);
+
+  Guard g(lock_.get());
+  for (auto i = inputHashes_.begin(); i != inputHashes_.end();)
+  {
+    if (i->second.data.expired())
+      i = inputHashes_.erase(i);
+    else
+      ++i;
+  }
+  inputHashes_[data->id()] = HashedInput{ data, hash };
+  return hash;
+}
+
+boost::optional<ModuleOutputMemoCache::Outputs> ModuleOutputMemoCache::find(const std::string& key)
+{
+  SpilledOutputs files;
+  {
+    Guard g(lock_.get());
+    auto entry = index_.find(key);
+    if (entry != index_.end())
+    {
+      lru_.splice(lru_.begin(), lru_, entry->second);
+      return entry->second->outputs;
+    }
+    files = takeSpilled(key);
+  }
+  if (files.empty())
+    return boost::none;
+
+  auto outputs = unspill(files);
+  if (!outputs)
+    return boost::none;
+
+  EntryList victims;
+  {
+    Guard g(lock_.get());
+    if (budget_ > 0 && index_.find(key) == index_.end())
+    {
+      insertFront(key, *outputs);
+      victims = evictToBudget();
+    }
+  }
+  spillEvicted(victims);
+  return outputs;
+}
+
+void ModuleOutputMemoCache::store(const std::string& key, const Outputs& outputs)
+{
+  EntryList victims;
+  SpilledOutputs stale;
+  {
+    Guard g(lock_.get());
+    if (0 == budget_)
+      return;
+    auto existing = index_.find(key);
+    if (existing != index_.end())
+    {
+      inUse_ -= existing->second->bytes;
+      lru_.erase(existing->second);
+      index_.erase(existing);
+    }
+    stale = takeSpilled(key);
+    insertFront(key, outputs);
+    victims = evictToBudget();
+  }
+  removeSpillFiles(stale);
+  spillEvicted(victims);
+}
+
+void ModuleOutputMemoCache::insertFront(const std::string& key, const Outputs& outputs)
+{
+  size_t bytes = sizeof(Entry);
+  for (const auto& output : outputs)
+    bytes += approximateElementCount(output.second) * sizeof(double);
+  lru_.push_front(Entry{ key, outputs, bytes });
+  index_[key] = lru_.begin();
+  inUse_ += bytes;
+}
+
+ModuleOutputMemoCache::EntryList ModuleOutputMemoCache::evictToBudget()
+{
+  EntryList victims;
+  while (inUse_ > budget_ && !lru_.empty())
+  {
+    auto victim = std::prev(lru_.end());
+    inUse_ -= victim->bytes;
+    index_.erase(victim->key);
+    victims.splice(victims.end(), lru_, victim);
+  }
+  return victims;
+}
+
+ModuleOutputMemoCache::SpilledOutputs ModuleOutputMemoCache::takeSpilled(const std::string& key)
+{
+  SpilledOutputs files;
+  auto spilled = spilled_.find(key);
+  if (spilled != spilled_.end())
+  {
+    files.swap(spilled->second);
+    spilled_.erase(spilled);
+  }
+  return files;
+}
+
+boost::filesystem::path ModuleOutputMemoCache::activeSpillDirectory() const
+{
+  return budget_ > 0 ? spillDirectory_ : boost::filesystem::path();
+}
+
+void ModuleOutputMemoCache::spillEvicted(const EntryList& victims)
+{
+  if (victims.empty())
+    return;
+  boost::filesystem::path dir;
+  {
+    Guard g(lock_.get());
+    dir = activeSpillDirectory();
+  }
+  if (dir.empty())
+    return;
+
+  for (const auto& victim : victims)
+  {
+    auto files = spill(victim, dir);
+    if (!files)
+      continue;
+
+    SpilledOutputs discarded;
+    {
+      Guard g(lock_.get());
+      // stored again or disabled while the files were written: the spill is stale
+      if (activeSpillDirectory().empty() || index_.find(victim.key) != index_.end())
+      {
+        discarded.swap(*files);
+      }
+      else
+      {
+        discarded = takeSpilled(victim.key);
+        spilled_[victim.key].swap(*files);
+      }
+    }
+    removeSpillFiles(discarded);
+  }
+}
+
+boost::optional<ModuleOutputMemoCache::SpilledOutputs> ModuleOutputMemoCache::spill(const Entry& entry,
+  const boost::filesystem::path& dir)
+{
+  for (const auto& output : entry.outputs)
+  {
+    if (!canSpill(output.second))
+      return boost::none;
+  }
+
+  SpilledOutputs files;
+  for (const auto& output : entry.outputs)
+  {
+    auto file = dir / ("memo_" + boost::lexical_cast<std::string>(spillSequence_++) + ".bin");
+    auto spilled = spillToFile(output.second, file);
+    if (!spilled)
+    {
+      removeSpillFiles(files);
+      return boost::none;
+    }
+    files.push_back(SpilledOutput{ output.first, *spilled });
+  }
+  return files;
+}
+
+boost::optional<ModuleOutputMemoCache::Outputs> ModuleOutputMemoCache::unspill(const SpilledOutputs& files)
+{
+  Outputs outputs;
+  for (const auto& output : files)
+  {
+    auto data = restoreFromFile(output.data);
+    if (!data)
+    {
+      removeSpillFiles(files);
+      return boost::none;
+    }
+    outputs.push_back(std::make_pair(output.port, data));
+  }
+  removeSpillFiles(files);
+  return outputs;
+}
+
+void ModuleOutputMemoCache::removeSpillFiles(const SpilledOutputs& files)
+{
+  for (const auto& output : files)
+    removeSpillFile(output.data);
+}
+
+size_t ModuleOutputMemoCache::size() const
+{
+  Guard g(lock_.get());
+  return lru_.size();
+}
+
+size_t ModuleOutputMemoCache::spilledCount() const
+{
+  Guard g(lock_.get());
+  return spilled_.size();
+}
+
+size_t ModuleOutputMemoCache::memoryInUse() const
+{
+  Guard g(lock_.get());
+  return inUse_;
+}
+
+void ModuleOutputMemoCache::clear()
+{
+  EntryList entries;
+  std::map<std::string, SpilledOutputs> spilled;
+  {
+    Guard g(lock_.get());
+    entries.swap(lru_);
+    index_.clear();
+    inUse_ = 0;
+    spilled.swap(spilled_);
+    inputHashes_.clear();
+  }
+  for (const auto& files : spilled)
+    removeSpillFiles(files.second);
+}
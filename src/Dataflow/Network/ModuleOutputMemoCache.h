@@ -0,0 +1,131 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef DATAFLOW_NETWORK_MODULE_OUTPUT_MEMO_CACHE_H
+#define DATAFLOW_NETWORK_MODULE_OUTPUT_MEMO_CACHE_H
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/optional.hpp>
+#include <boost/filesystem/path.hpp>
+#include <Core/Utils/Singleton.h>
+#include <Core/Thread/Mutex.h>
+#include <Core/Datatypes/Datatype.h>
+#include <Dataflow/Network/NetworkFwd.h>
+#include <Dataflow/Network/ModuleDescription.h>
+#include <Dataflow/Network/DatatypeSpill.h>
+#include <Dataflow/Network/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Networks {
+
+  /// Optional memoization of module outputs across executions. Entries are keyed on
+  /// module type, a canonical hash of the module state and content hashes of the
+  /// inputs, so a module fed identical data, or switched back to earlier parameters,
+  /// replays its previous outputs instead of executing. Entries live in a
+  /// least-recently-used memory cache bounded by an approximate byte budget; with a
+  /// spill directory set, evicted matrix and field outputs are written to disk and
+  /// read back on the next hit. Disabled while the budget is zero.
+  ///
+  /// Port data is treated as immutable once sent, so each input object is hashed once
+  /// and later executions reuse that hash while the object is alive. Spill files are
+  /// written and read outside the cache lock.
+  class SCISHARE ModuleOutputMemoCache : boost::noncopyable
+  {
+    CORE_SINGLETON(ModuleOutputMemoCache)
+  public:
+    typedef std::vector<std::pair<PortId, Core::Datatypes::DatatypeHandle>> Outputs;
+    ~ModuleOutputMemoCache();
+
+    void setMemoryBudget(size_t bytes);
+    size_t memoryBudget() const;
+    bool enabled() const;
+    void setSpillDirectory(const boost::filesystem::path& dir);
+
+    /// Memoization key for the module's next execution; none if it must always run
+    /// because it has no outputs or reports side effects (ModuleInterface::hasSideEffects).
+    boost::optional<std::string> keyFor(const ModuleInterface& module) const;
+    boost::optional<Outputs> find(const std::string& key);
+    void store(const std::string& key, const Outputs& outputs);
+
+    size_t size() const;
+    size_t spilledCount() const;
+    size_t memoryInUse() const;
+    void clear();
+  private:
+    ModuleOutputMemoCache();
+    struct Entry
+    {
+      std::string key;
+      Outputs outputs;
+      size_t bytes;
+    };
+    struct SpilledOutput
+    {
+      PortId port;
+      SpilledDatatype data;
+    };
+    struct HashedInput
+    {
+      boost::weak_ptr<Core::Datatypes::Datatype> data;
+      boost::uint64_t hash;
+    };
+    typedef std::list<Entry> EntryList;
+    typedef std::vector<SpilledOutput> SpilledOutputs;
+    boost::uint64_t inputHash(const Core::Datatypes::DatatypeHandle& data) const;
+    // the following four expect lock_ to be held
+    void insertFront(const std::string& key, const Outputs& outputs);
+    EntryList evictToBudget();
+    SpilledOutputs takeSpilled(const std::string& key);
+    boost::filesystem::path activeSpillDirectory() const;
+    // the following three must be called without lock_
+    void spillEvicted(const EntryList& victims);
+    boost::optional<SpilledOutputs> spill(const Entry& entry, const boost::filesystem::path& dir);
+    static boost::optional<Outputs> unspill(const SpilledOutputs& files);
+    static void removeSpillFiles(const SpilledOutputs& files);
+
+    EntryList lru_;
+    std::map<std::string, EntryList::iterator> index_;
+    std::map<std::string, SpilledOutputs> spilled_;
+    mutable std::map<Core::Datatypes::Datatype::id_type, HashedInput> inputHashes_;
+    size_t budget_;
+    size_t inUse_;
+    std::atomic<size_t> spillSequence_;
+    boost::filesystem::path spillDirectory_;
+    mutable Core::Thread::Mutex lock_;
+  };
+
+}}}
+
+#endif
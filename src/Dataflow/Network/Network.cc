@@ -147,6 +147,21 @@ void Network::disable_connection(const ConnectionId&)
   /// @todo
 }
 
+bool Network::setLoopCarried(const ConnectionId& id, bool loopCarried)
+{
+  auto loc = connections_.find(id);
+  if (loc == connections_.end())
+    return false;
+  loc->second->setLoopCarried(loopCarried);
+  return true;
+}
+
+bool Network::isLoopCarried(const ConnectionId& id) const
+{
+  auto loc = connections_.find(id);
+  return loc != connections_.end() && loc->second->isLoopCarried();
+}
+
 size_t Network::nmodules() const
 {
   return modules_.size();
@@ -200,7 +215,7 @@ NetworkInterface::ConnectionDescriptionList Network::connections(bool includeVir
 {
   Connections toDescribe;
   std::copy_if(connections_.begin(), connections_.end(), std::inserter(toDescribe, toDescribe.begin()),
-    [includeVirtual](const Connections::value_type& c) { return includeVirtual || !c.second->isVirtual(); });
+    [includeVirtual](const Connections::value_type& c) { return includeVirtual || (!c.second->isVirtual() && !c.second->isLoopCarried()); });
   ConnectionDescriptionList conns;
   std::transform(toDescribe.begin(), toDescribe.end(), std::back_inserter(conns),
     [](const Connections::value_type& c) { return c.first.describe(); });
@@ -62,6 +62,8 @@ namespace Networks {
     bool disconnect(const ConnectionId&) override;
     size_t nconnections() const override;
     void disable_connection(const ConnectionId&) override;
+    bool setLoopCarried(const ConnectionId& id, bool loopCarried) override;
+    bool isLoopCarried(const ConnectionId& id) const override;
     ConnectionDescriptionList connections(bool includeVirtual) const override;
     int errorCode() const override;
     void incrementErrorCode(const ModuleId& moduleId) override;
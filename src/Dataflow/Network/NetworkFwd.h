@@ -51,6 +51,7 @@ class PortInterface;
 struct PortId;
 class PortDescriptionInterface;
 class Connection;
+class ConnectionStream;
 class InputPortInterface;
 class OutputPortInterface;
 struct ConnectionId;
@@ -89,6 +90,7 @@ typedef SharedPointer<ModuleStateInterfaceFactory> ModuleStateFactoryHandle;
 typedef SharedPointer<ReexecuteStrategyFactory> ReexecuteStrategyFactoryHandle;
 typedef SharedPointer<PortInterface> PortHandle;
 typedef SharedPointer<Connection> ConnectionHandle;
+typedef SharedPointer<ConnectionStream> ConnectionStreamHandle;
 typedef SharedPointer<InputPortInterface> InputPortHandle;
 typedef SharedPointer<OutputPortInterface> OutputPortHandle;
 typedef SharedPointer<ModuleFactory> ModuleFactoryHandle;
@@ -88,6 +88,10 @@ namespace Networks {
     virtual bool disconnect(const ConnectionId&) = 0;
     virtual size_t nconnections() const = 0;
     virtual void disable_connection(const ConnectionId&) = 0;
+    /// Returns false if the connection does not exist.
+    virtual bool setLoopCarried(const ConnectionId& id, bool loopCarried) = 0;
+    virtual bool isLoopCarried(const ConnectionId& id) const = 0;
+    /// Without includeVirtual, lists the connections that order execution: virtual and loop-carried ones are left out.
     virtual ConnectionDescriptionList connections(bool includeVirtual) const = 0;
     virtual void incrementErrorCode(const ModuleId& moduleId) = 0;
     virtual NetworkGlobalSettings& settings() = 0;
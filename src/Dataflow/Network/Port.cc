@@ -32,7 +32,9 @@
 #include <Core/Datatypes/Datatype.h>
 #include <Core/Utils/Exception.h>
 #include <Dataflow/Network/Connection.h>
+#include <Dataflow/Network/ConnectionStream.h>
 #include <Dataflow/Network/ModuleInterface.h>
+#include <Dataflow/Network/ModuleExceptions.h>
 #include <Dataflow/Network/ModuleDescription.h>
 #include <Dataflow/Network/DataflowInterfaces.h>
 #include <Core/Logging/Log.h>
@@ -224,7 +226,13 @@ void OutputPort::sendData(DatatypeHandle data)
   {
     if (c && c->iport_)
     {
-      source_->send(c->iport_->sink());
+      if (auto stream = c->stream())
+      {
+        if (!stream->push(data))
+          BOOST_THROW_EXCEPTION(StreamAbortedException() << SCIRun::Core::ErrorMessage("Stream aborted on connection " + c->id()));
+      }
+      else
+        source_->send(c->iport_->sink());
     }
   }
   connectionCountIncreasedFlag_ = false;
@@ -0,0 +1,276 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Network/PortDataCache.h>
+#include <Dataflow/Network/SimpleSourceSink.h>
+#include <Dataflow/Network/DatatypeContentHash.h>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+
+using namespace SCIRun;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Thread;
+
+CORE_SINGLETON_IMPLEMENTATION( PortDataCache )
+
+PortDataCache::PortDataCache() : budget_(0), inUse_(0), spillSequence_(0), lock_("portDataCache")
+{
+}
+
+PortDataCache::~PortDataCache()
+{
+  clear();
+}
+
+void PortDataCache::setMemoryBudget(size_t bytes)
+{
+  Guard g(lock_.get());
+  budget_ = bytes;
+  if (0 == budget_)
+  {
+    // stop tracking; whatever is resident stays with its source
+    lru_.clear();
+    index_.clear();
+    inUse_ = 0;
+  }
+  else
+    evictToBudget();
+}
+
+size_t PortDataCache::memoryBudget() const
+{
+  Guard g(lock_.get());
+  return budget_;
+}
+
+bool PortDataCache::enabled() const
+{
+  Guard g(lock_.get());
+  return budget_ > 0;
+}
+
+void PortDataCache::setSpillDirectory(const boost::filesystem::path& dir)
+{
+  Guard g(lock_.get());
+  spillDirectory_ = dir;
+  if (!dir.empty())
+    boost::filesystem::create_directories(dir);
+}
+
+void PortDataCache::cached(SimpleSource* source, const DatatypeHandle& data)
+{
+  Guard g(lock_.get());
+  source->data_ = data;
+  erase(source);
+  removeSpilled(source);
+  dropped_.erase(source);
+  if (0 == budget_ || !data)
+    return;
+
+  insertFront(source, data, false);
+  evictToBudget();
+}
+
+DatatypeHandle PortDataCache::sent(const SimpleSource* source, const SimpleSink* sink)
+{
+  Guard g(lock_.get());
+  providers_[sink] = source;
+  auto entry = index_.find(source);
+  if (entry != index_.end())
+  {
+    entry->second->sent = true;
+    entry->second->pending.insert(sink);
+  }
+  return source->data_;
+}
+
+DatatypeHandle PortDataCache::resident(const SimpleSource* source) const
+{
+  Guard g(lock_.get());
+  return source->data_;
+}
+
+void PortDataCache::received(const SimpleSink* sink)
+{
+  Guard g(lock_.get());
+  auto provider = providers_.find(sink);
+  if (provider == providers_.end())
+    return;
+  auto entry = index_.find(provider->second);
+  if (entry == index_.end())
+    return;
+
+  auto consumed = entry->second->pending.erase(sink) > 0;
+  lru_.splice(lru_.begin(), lru_, entry->second);
+  if (consumed)
+    evictToBudget();
+}
+
+DatatypeHandle PortDataCache::reload(const SimpleSink* sink)
+{
+  Guard g(lock_.get());
+  auto provider = providers_.find(sink);
+  if (provider == providers_.end())
+    return nullptr;
+  auto spilled = spilled_.find(provider->second);
+  if (spilled == spilled_.end())
+    return nullptr;
+
+  auto data = restoreFromFile(spilled->second.data);
+  if (!data)
+  {
+    removeSpilled(provider->second);
+    return nullptr;
+  }
+  // the spill file is kept, so evicting this output again costs no write
+  auto source = spilled->second.source;
+  source->data_ = data;
+  insertFront(source, data, true);
+  evictToBudget();
+  return data;
+}
+
+void PortDataCache::remove(const SimpleSource* source)
+{
+  Guard g(lock_.get());
+  erase(source);
+  removeSpilled(source);
+  dropped_.erase(source);
+  for (auto provider = providers_.begin(); provider != providers_.end();)
+  {
+    if (provider->second == source)
+      provider = providers_.erase(provider);
+    else
+      ++provider;
+  }
+}
+
+void PortDataCache::remove(const SimpleSink* sink)
+{
+  Guard g(lock_.get());
+  providers_.erase(sink);
+  for (auto& entry : lru_)
+    entry.pending.erase(sink);
+}
+
+bool PortDataCache::evicted(const DatatypeSourceInterface* source) const
+{
+  Guard g(lock_.get());
+  return dropped_.find(source) != dropped_.end();
+}
+
+void PortDataCache::insertFront(SimpleSource* source, const DatatypeHandle& data, bool sent)
+{
+  auto bytes = sizeof(Entry) + approximateElementCount(data) * sizeof(double);
+  lru_.push_front(Entry{ source, bytes, sent, {} });
+  index_[source] = lru_.begin();
+  inUse_ += bytes;
+}
+
+void PortDataCache::erase(const SimpleSource* source)
+{
+  auto entry = index_.find(source);
+  if (entry == index_.end())
+    return;
+  inUse_ -= entry->second->bytes;
+  lru_.erase(entry->second);
+  index_.erase(entry);
+}
+
+void PortDataCache::evictToBudget()
+{
+  // outputs not yet sent, or still waiting on a receiver, are pinned
+  auto victim = lru_.end();
+  while (inUse_ > budget_ && victim != lru_.begin())
+  {
+    --victim;
+    if (!victim->sent || !victim->pending.empty())
+      continue;
+    evict(*victim);
+    inUse_ -= victim->bytes;
+    index_.erase(victim->source);
+    victim = lru_.erase(victim);
+  }
+}
+
+void PortDataCache::evict(const Entry& entry)
+{
+  auto source = entry.source;
+  if (spilled_.find(source) == spilled_.end())
+  {
+    boost::optional<SpilledDatatype> spilled;
+    if (!spillDirectory_.empty() && canSpill(source->data_))
+      spilled = spillToFile(source->data_, spillDirectory_ / ("port_" + boost::lexical_cast<std::string>(spillSequence_++) + ".bin"));
+    if (spilled)
+      spilled_[source] = SpilledOutput{ source, *spilled };
+    else
+      dropped_.insert(source);
+  }
+  source->data_.reset();
+}
+
+void PortDataCache::removeSpilled(const SimpleSource* source)
+{
+  auto spilled = spilled_.find(source);
+  if (spilled == spilled_.end())
+    return;
+  removeSpillFile(spilled->second.data);
+  spilled_.erase(spilled);
+}
+
+size_t PortDataCache::residentCount() const
+{
+  Guard g(lock_.get());
+  return lru_.size();
+}
+
+size_t PortDataCache::spilledCount() const
+{
+  Guard g(lock_.get());
+  return spilled_.size();
+}
+
+size_t PortDataCache::memoryInUse() const
+{
+  Guard g(lock_.get());
+  return inUse_;
+}
+
+void PortDataCache::clear()
+{
+  Guard g(lock_.get());
+  lru_.clear();
+  index_.clear();
+  providers_.clear();
+  dropped_.clear();
+  inUse_ = 0;
+  while (!spilled_.empty())
+    removeSpilled(spilled_.begin()->first);
+}
@@ -0,0 +1,124 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef DATAFLOW_NETWORK_PORT_DATA_CACHE_H
+#define DATAFLOW_NETWORK_PORT_DATA_CACHE_H
+
+#include <list>
+#include <map>
+#include <set>
+#include <boost/filesystem/path.hpp>
+#include <Core/Utils/Singleton.h>
+#include <Core/Thread/Mutex.h>
+#include <Core/Datatypes/DatatypeFwd.h>
+#include <Dataflow/Network/NetworkFwd.h>
+#include <Dataflow/Network/DatatypeSpill.h>
+#include <Dataflow/Network/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Networks {
+
+  class SimpleSource;
+  class SimpleSink;
+
+  /// Memory budget for data cached on output ports. SimpleSource holds the only strong
+  /// reference to each output (sinks keep weak ones), so once every connected sink has
+  /// received an output, the source's reference can be dropped. When the cached bytes
+  /// exceed the budget, such fully consumed outputs are evicted least recently used
+  /// first. With a spill directory set, evicted matrices and fields are written there
+  /// and reloaded on the next receive; other evicted outputs make their module
+  /// re-execute (see OutputPortsCachedCheckerImpl). Disabled while the budget is zero.
+  /// Eviction may run on any module's thread, so every read or write of a SimpleSource's
+  /// data goes through the hooks below, under this cache's lock.
+  class SCISHARE PortDataCache : boost::noncopyable
+  {
+    CORE_SINGLETON(PortDataCache)
+  public:
+    ~PortDataCache();
+
+    void setMemoryBudget(size_t bytes);
+    size_t memoryBudget() const;
+    bool enabled() const;
+    void setSpillDirectory(const boost::filesystem::path& dir);
+
+    /// Hooks called by SimpleSource and SimpleSink.
+    void cached(SimpleSource* source, const Core::Datatypes::DatatypeHandle& data);
+    /// Registers the sink as a pending receiver and returns the data to hand it.
+    Core::Datatypes::DatatypeHandle sent(const SimpleSource* source, const SimpleSink* sink);
+    Core::Datatypes::DatatypeHandle resident(const SimpleSource* source) const;
+    void received(const SimpleSink* sink);
+    Core::Datatypes::DatatypeHandle reload(const SimpleSink* sink);
+    void remove(const SimpleSource* source);
+    void remove(const SimpleSink* sink);
+
+    /// True when the source's output was evicted without a spill file, so it has to
+    /// be recomputed.
+    bool evicted(const DatatypeSourceInterface* source) const;
+
+    size_t residentCount() const;
+    size_t spilledCount() const;
+    size_t memoryInUse() const;
+    void clear();
+  private:
+    PortDataCache();
+    struct Entry
+    {
+      SimpleSource* source;
+      size_t bytes;
+      bool sent;
+      std::set<const SimpleSink*> pending;
+    };
+    struct SpilledOutput
+    {
+      SimpleSource* source;
+      SpilledDatatype data;
+    };
+    typedef std::list<Entry> EntryList;
+    void insertFront(SimpleSource* source, const Core::Datatypes::DatatypeHandle& data, bool sent);
+    void evict(const Entry& entry);
+    void erase(const SimpleSource* source);
+    void evictToBudget();
+    void removeSpilled(const SimpleSource* source);
+
+    EntryList lru_;
+    std::map<const SimpleSource*, EntryList::iterator> index_;
+    std::map<const SimpleSink*, const SimpleSource*> providers_;
+    std::map<const SimpleSource*, SpilledOutput> spilled_;
+    std::set<const DatatypeSourceInterface*> dropped_;
+    size_t budget_;
+    size_t inUse_;
+    size_t spillSequence_;
+    boost::filesystem::path spillDirectory_;
+    mutable Core::Thread::Mutex lock_;
+  };
+
+}}}
+
+#endif
@@ -30,6 +30,8 @@
 
 #include <iostream>
 #include <Dataflow/Network/SimpleSourceSink.h>
+#include <Dataflow/Network/PortDataCache.h>
+#include <Dataflow/Network/DatatypeContentHash.h>
 #include <Core/Logging/Log.h>
 // don't really like this dependency
 #include <Core/Algorithms/Describe/DescribeDatatype.h>
@@ -48,6 +50,7 @@ SimpleSink::SimpleSink() :
 SimpleSink::~SimpleSink()
 {
   instances_.erase(this);
+  PortDataCache::Instance().remove(this);
 }
 
 void SimpleSink::waitForData()
@@ -81,8 +84,14 @@ DatatypeHandleOption SimpleSink::receive()
 {
   if (auto strong = weakData_.lock())
   {
+    PortDataCache::Instance().received(this);
     return strong;
   }
+  if (auto reloaded = PortDataCache::Instance().reload(this))
+  {
+    weakData_ = reloaded;
+    return reloaded;
+  }
   return DatatypeHandleOption();
 }
 
@@ -131,7 +140,8 @@ boost::signals2::connection SimpleSink::connectDataHasChanged(const DataHasChang
 
 void SimpleSource::cacheData(DatatypeHandle data)
 {
-  data_ = data;
+  dataSize_ = data ? approximateElementCount(data) : 0;
+  PortDataCache::Instance().cached(this, data);
 }
 
 void SimpleSource::send(DatatypeSinkInterfaceHandle receiver) const
@@ -140,12 +150,13 @@ void SimpleSource::send(DatatypeSinkInterfaceHandle receiver) const
   if (!sink)
     THROW_INVALID_ARGUMENT("SimpleSource can only send to SimpleSinks");
 
-  sink->setData(data_);
+  // registering first keeps the output pinned until the sink receives it
+  sink->setData(PortDataCache::Instance().sent(this, sink));
 }
 
 bool SimpleSource::hasData() const
 {
-  return data_ != nullptr;
+  return PortDataCache::Instance().resident(this) != nullptr;
 }
 
 SimpleSource::SimpleSource()
@@ -156,6 +167,7 @@ SimpleSource::SimpleSource()
 SimpleSource::~SimpleSource()
 {
   instances_.erase(this);
+  PortDataCache::Instance().remove(this);
 }
 
 std::set<SimpleSource*> SimpleSource::instances_;
@@ -163,11 +175,15 @@ std::set<SimpleSource*> SimpleSource::instances_;
 void SimpleSource::clearAllSources()
 {
   for (auto source : instances_)
-    source->data_.reset();
+  {
+    PortDataCache::Instance().cached(source, nullptr);
+    source->dataSize_ = 0;
+  }
+  PortDataCache::Instance().clear();
 }
 
 std::string SimpleSource::describeData() const
 {
   DescribeDatatype dd;
-  return dd.describe(data_);
+  return dd.describe(PortDataCache::Instance().resident(this));
 }
@@ -34,6 +34,7 @@
 #include <Dataflow/Network/DataflowInterfaces.h>
 #include <boost/function.hpp>
 #include <set>
+#include <atomic>
 #include <Dataflow/Network/share.h>
 
 namespace SCIRun
@@ -94,11 +95,16 @@ namespace SCIRun
         virtual void send(DatatypeSinkInterfaceHandle receiver) const override;
         virtual bool hasData() const override;
         virtual std::string describeData() const override;
+        virtual size_t dataSize() const override { return dataSize_; }
 
         static void clearAllSources();
       protected:
+        // only accessed under the PortDataCache lock, which may evict it from another thread
         SCIRun::Core::Datatypes::DatatypeHandle data_;
+        // kept when the cache spills data_, so cost estimates never have to reload it
+        std::atomic<size_t> dataSize_ {0};
         static std::set<SimpleSource*> instances_;
+        friend class PortDataCache;
       };
     }
   }
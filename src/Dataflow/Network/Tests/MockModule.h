@@ -84,6 +84,7 @@ namespace SCIRun {
           MOCK_METHOD1(connectErrorListener, boost::signals2::connection(const ErrorSignalType::slot_type&));
           MOCK_CONST_METHOD0(needToExecute, bool());
           MOCK_CONST_METHOD0(isStoppable, bool());
+          MOCK_CONST_METHOD0(hasSideEffects, bool());
           MOCK_METHOD0(setStateDefaults, void());
           MOCK_CONST_METHOD0(getAlgorithm, SCIRun::Core::Algorithms::AlgorithmHandle());
           MOCK_METHOD0(executionState, SCIRun::Dataflow::Networks::ModuleExecutionState&());
@@ -53,6 +53,8 @@ namespace SCIRun {
           MOCK_METHOD1(disconnect, bool(const ConnectionId&));
           MOCK_CONST_METHOD0(nconnections, size_t());
           MOCK_METHOD1(disable_connection, void(const ConnectionId&));
+          MOCK_METHOD2(setLoopCarried, bool(const ConnectionId&, bool));
+          MOCK_CONST_METHOD1(isLoopCarried, bool(const ConnectionId&));
           MOCK_CONST_METHOD0(toString, std::string());
           MOCK_CONST_METHOD1(connections, ConnectionDescriptionList(bool));
           MOCK_CONST_METHOD0(errorCode, int());
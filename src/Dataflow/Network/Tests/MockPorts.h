@@ -137,6 +137,7 @@ namespace SCIRun {
           MOCK_CONST_METHOD1(send, void(DatatypeSinkInterfaceHandle));
           MOCK_CONST_METHOD0(hasData, bool());
           MOCK_CONST_METHOD0(describeData, std::string());
+          MOCK_CONST_METHOD0(dataSize, size_t());
         };
 
         typedef boost::shared_ptr<MockDatatypeSource> MockDatatypeSourcePtr;
@@ -0,0 +1,120 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Network/ModuleCostHistory.h>
+#include <Dataflow/Network/Module.h>
+#include <Dataflow/Network/ModuleBuilder.h>
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+
+using namespace SCIRun::Dataflow::Networks;
+
+class ModuleCostHistoryTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ModuleCostHistory::Instance().clear();
+  }
+  void TearDown() override
+  {
+    ModuleCostHistory::Instance().clear();
+  }
+};
+
+TEST_F(ModuleCostHistoryTests, EstimatesFromMeanOfRecordedRuns)
+{
+  auto& history = ModuleCostHistory::Instance();
+  EXPECT_FALSE(history.estimate("BuildFEMatrix", 10));
+
+  history.record("BuildFEMatrix", 10, 20.0);
+  history.record("BuildFEMatrix", 10, 40.0);
+
+  ASSERT_TRUE(history.estimate("BuildFEMatrix", 10));
+  EXPECT_DOUBLE_EQ(30.0, *history.estimate("BuildFEMatrix", 10));
+  EXPECT_FALSE(history.estimate("CreateString", 10));
+}
+
+TEST_F(ModuleCostHistoryTests, EstimateUsesNearestInputSizeClass)
+{
+  auto& history = ModuleCostHistory::Instance();
+  history.record("BuildFEMatrix", 4, 0.5);
+  history.record("BuildFEMatrix", 20, 30.0);
+
+  EXPECT_DOUBLE_EQ(0.5, *history.estimate("BuildFEMatrix", 0));
+  EXPECT_DOUBLE_EQ(0.5, *history.estimate("BuildFEMatrix", 11));
+  EXPECT_DOUBLE_EQ(30.0, *history.estimate("BuildFEMatrix", 13));
+  EXPECT_DOUBLE_EQ(30.0, *history.estimate("BuildFEMatrix", 25));
+}
+
+TEST_F(ModuleCostHistoryTests, OldRunsFadeOutAfterAveragingWindow)
+{
+  auto& history = ModuleCostHistory::Instance();
+  for (size_t i = 0; i < ModuleCostHistory::AveragingWindow; ++i)
+    history.record("SolveLinearSystem", 8, 1.0);
+  for (int i = 0; i < 100; ++i)
+    history.record("SolveLinearSystem", 8, 3.0);
+
+  EXPECT_NEAR(3.0, *history.estimate("SolveLinearSystem", 8), 1e-3);
+  ASSERT_EQ(1, history.entries().size());
+  EXPECT_EQ(ModuleCostHistory::AveragingWindow, history.entries()[0].runs);
+}
+
+TEST_F(ModuleCostHistoryTests, CanSaveAndReload)
+{
+  auto file = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  auto& history = ModuleCostHistory::Instance();
+  history.setStorageFile(file);
+  history.record("BuildFEMatrix", 12, 31.5);
+  history.record("CreateString", 0, 0.001);
+  ASSERT_TRUE(history.save());
+
+  history.clear();
+  EXPECT_TRUE(history.entries().empty());
+  history.setStorageFile(file);
+
+  auto entries = history.entries();
+  ASSERT_EQ(2, entries.size());
+  EXPECT_EQ("BuildFEMatrix", entries[0].moduleName);
+  EXPECT_EQ(12, entries[0].inputSizeClass);
+  EXPECT_EQ(1, entries[0].runs);
+  EXPECT_DOUBLE_EQ(31.5, entries[0].meanSeconds);
+  EXPECT_DOUBLE_EQ(0.001, *history.estimate("CreateString", 0));
+  boost::filesystem::remove(file);
+}
+
+TEST_F(ModuleCostHistoryTests, UnconnectedInputsHaveSmallestSizeClass)
+{
+  Module::resetIdGenerator();
+  ModuleHandle module = ModuleBuilder().with_name("SolveLinearSystem")
+    .add_input_port(Port::ConstructionParams(PortId(0, "ForwardMatrix"), "Matrix", false))
+    .add_input_port(Port::ConstructionParams(PortId(0, "RHS"), "Matrix", false))
+    .build();
+  EXPECT_EQ(0, ModuleCostHistory::inputSizeClass(*module));
+}
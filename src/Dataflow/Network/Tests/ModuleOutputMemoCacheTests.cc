@@ -0,0 +1,257 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Network/ModuleOutputMemoCache.h>
+#include <Dataflow/Network/DatatypeContentHash.h>
+#include <Dataflow/Network/Module.h>
+#include <Dataflow/Network/ModuleBuilder.h>
+#include <Dataflow/Network/SimpleSourceSink.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/String.h>
+#include <boost/filesystem.hpp>
+#include <boost/functional/factory.hpp>
+#include <gtest/gtest.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+
+namespace
+{
+  DenseMatrixHandle matrixOfSize(int n, double value)
+  {
+    return boost::make_shared<DenseMatrix>(DenseMatrix::Constant(n, n, value));
+  }
+
+  /// Transient values only, enough for a module that reports its result to the GUI
+  class TransientOnlyState : public ModuleStateInterface
+  {
+  public:
+    const Value getValue(const Name& name) const override { return Value(name, 0); }
+    void setValue(const Name&, const Value::Value&) override {}
+    bool containsKey(const Name&) const override { return false; }
+    Keys getKeys() const override { return Keys(); }
+    ModuleStateHandle clone() const override { return boost::make_shared<TransientOnlyState>(); }
+    TransientValueOption getTransientValue(const Name& name) const override
+    {
+      auto i = transients_.find(name.name());
+      return i != transients_.end() ? TransientValueOption(i->second) : TransientValueOption();
+    }
+    void setTransientValue(const Name& name, const TransientValue& value, bool fireSignal) override
+    {
+      transients_[name.name()] = value;
+      if (fireSignal)
+        fireTransientStateChangeSignal();
+    }
+    void fireTransientStateChangeSignal() override { changed_(); }
+    boost::signals2::connection connectStateChanged(state_changed_sig_t::slot_function_type subscriber) override
+    {
+      return changed_.connect(subscriber);
+    }
+    boost::signals2::connection connectSpecificStateChanged(const Name&, state_changed_sig_t::slot_function_type subscriber) override
+    {
+      return changed_.connect(subscriber);
+    }
+  private:
+    std::map<std::string, TransientValue> transients_;
+    state_changed_sig_t changed_;
+  };
+
+  class TransientOnlyStateFactory : public ModuleStateInterfaceFactory
+  {
+  public:
+    ModuleStateInterface* make_state(const std::string&) const override { return new TransientOnlyState; }
+  };
+
+  class CountingModule : public Module
+  {
+  public:
+    explicit CountingModule(bool sideEffects = false,
+      ModuleStateFactoryHandle stateFactory = DefaultModuleFactories::defaultStateFactory_) :
+      Module(ModuleLookupInfo(), false, DefaultModuleFactories::defaultAlgoFactory_, stateFactory),
+      executions(0), sideEffects_(sideEffects) {}
+    void execute() override
+    {
+      ++executions;
+      send_output_handle(PortId(0, "Output"), matrixOfSize(2, executions));
+    }
+    void setStateDefaults() override {}
+    bool hasSideEffects() const override { return sideEffects_; }
+    int executions;
+  private:
+    bool sideEffects_;
+  };
+
+  class ReportingModule : public CountingModule
+  {
+  public:
+    ReportingModule() : CountingModule(false, boost::make_shared<TransientOnlyStateFactory>()) {}
+    void execute() override
+    {
+      CountingModule::execute();
+      get_state()->setTransientValue("ReportedInfo", executions);
+    }
+  };
+
+  ModuleHandle makeModule(const boost::function<Module*()>& maker)
+  {
+    ModuleBuilder::use_source_type(boost::factory<SimpleSource*>());
+    ModuleBuilder::use_sink_type(boost::factory<SimpleSink*>());
+    Module::resetIdGenerator();
+    return ModuleBuilder().using_func(maker)
+      .add_input_port(Port::ConstructionParams(ProgrammablePortId(), "MetadataObject", false))
+      .add_output_port(Port::ConstructionParams(PortId(0, "Output"), "Matrix", false))
+      .build();
+  }
+
+  ModuleHandle makeCountingModule(bool sideEffects)
+  {
+    return makeModule([sideEffects]() { return new CountingModule(sideEffects); });
+  }
+}
+
+class ModuleOutputMemoCacheTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ModuleOutputMemoCache::Instance().clear();
+    ModuleOutputMemoCache::Instance().setSpillDirectory({});
+    ModuleOutputMemoCache::Instance().setMemoryBudget(1 << 20);
+  }
+  void TearDown() override
+  {
+    ModuleOutputMemoCache::Instance().setMemoryBudget(0);
+    ModuleOutputMemoCache::Instance().setSpillDirectory({});
+    ModuleOutputMemoCache::Instance().clear();
+  }
+  static ModuleOutputMemoCache::Outputs outputsOf(DatatypeHandle data)
+  {
+    return { std::make_pair(PortId(0, "Output"), data) };
+  }
+};
+
+TEST(DatatypeContentHashTests, EqualContentsHashEqual)
+{
+  EXPECT_EQ(contentHash(matrixOfSize(3, 1.5)), contentHash(matrixOfSize(3, 1.5)));
+  EXPECT_NE(contentHash(matrixOfSize(3, 1.5)), contentHash(matrixOfSize(3, 2.5)));
+  EXPECT_NE(contentHash(matrixOfSize(3, 1.5)), contentHash(matrixOfSize(2, 1.5)));
+  EXPECT_EQ(contentHash(boost::make_shared<String>("abc")), contentHash(boost::make_shared<String>("abc")));
+  EXPECT_NE(contentHash(boost::make_shared<String>("abc")), contentHash(boost::make_shared<String>("abd")));
+}
+
+TEST_F(ModuleOutputMemoCacheTests, DisabledWithoutBudget)
+{
+  auto& memo = ModuleOutputMemoCache::Instance();
+  EXPECT_TRUE(memo.enabled());
+  memo.setMemoryBudget(0);
+  EXPECT_FALSE(memo.enabled());
+  memo.store("key", outputsOf(matrixOfSize(2, 1)));
+  EXPECT_FALSE(memo.find("key"));
+}
+
+TEST_F(ModuleOutputMemoCacheTests, EvictsLeastRecentlyUsedBeyondBudget)
+{
+  auto& memo = ModuleOutputMemoCache::Instance();
+  // each 100x100 matrix is roughly 80 kB
+  memo.setMemoryBudget(200 * 1000);
+  memo.store("a", outputsOf(matrixOfSize(100, 1)));
+  memo.store("b", outputsOf(matrixOfSize(100, 2)));
+  ASSERT_TRUE(memo.find("a"));
+  memo.store("c", outputsOf(matrixOfSize(100, 3)));
+
+  EXPECT_EQ(2, memo.size());
+  EXPECT_TRUE(memo.find("a"));
+  EXPECT_FALSE(memo.find("b"));
+  EXPECT_TRUE(memo.find("c"));
+  EXPECT_LE(memo.memoryInUse(), memo.memoryBudget());
+}
+
+TEST_F(ModuleOutputMemoCacheTests, SpillsEvictedMatricesToDisk)
+{
+  auto dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  auto& memo = ModuleOutputMemoCache::Instance();
+  memo.setSpillDirectory(dir);
+  memo.setMemoryBudget(100 * 1000);
+  memo.store("a", outputsOf(matrixOfSize(100, 1)));
+  memo.store("b", outputsOf(matrixOfSize(100, 2)));
+  EXPECT_EQ(1, memo.size());
+  EXPECT_EQ(1, memo.spilledCount());
+
+  auto restored = memo.find("a");
+  ASSERT_TRUE(restored);
+  ASSERT_EQ(1, restored->size());
+  EXPECT_EQ(contentHash(matrixOfSize(100, 1)), contentHash((*restored)[0].second));
+  EXPECT_EQ("Output", (*restored)[0].first.name);
+
+  memo.clear();
+  EXPECT_EQ(0, memo.spilledCount());
+  boost::filesystem::remove_all(dir);
+}
+
+TEST_F(ModuleOutputMemoCacheTests, ModuleReplaysOutputsForUnchangedInputs)
+{
+  auto module = makeCountingModule(false);
+  auto counter = boost::dynamic_pointer_cast<CountingModule>(module);
+
+  EXPECT_TRUE(module->executeWithSignals());
+  EXPECT_EQ(1, counter->executions);
+  EXPECT_EQ(1, ModuleOutputMemoCache::Instance().size());
+
+  EXPECT_TRUE(module->executeWithSignals());
+  EXPECT_EQ(1, counter->executions);
+
+  ModuleOutputMemoCache::Instance().setMemoryBudget(0);
+  EXPECT_TRUE(module->executeWithSignals());
+  EXPECT_EQ(2, counter->executions);
+}
+
+TEST_F(ModuleOutputMemoCacheTests, ModulesWithSideEffectsAlwaysExecute)
+{
+  auto module = makeCountingModule(true);
+  auto counter = boost::dynamic_pointer_cast<CountingModule>(module);
+
+  EXPECT_FALSE(ModuleOutputMemoCache::Instance().keyFor(*module));
+  EXPECT_TRUE(module->executeWithSignals());
+  EXPECT_TRUE(module->executeWithSignals());
+  EXPECT_EQ(2, counter->executions);
+  EXPECT_EQ(0, ModuleOutputMemoCache::Instance().size());
+}
+
+TEST_F(ModuleOutputMemoCacheTests, ModulesPublishingThroughStateAlwaysExecute)
+{
+  auto module = makeModule([]() { return new ReportingModule; });
+  auto reporter = boost::dynamic_pointer_cast<ReportingModule>(module);
+
+  EXPECT_TRUE(module->executeWithSignals());
+  EXPECT_TRUE(module->executeWithSignals());
+  EXPECT_EQ(2, reporter->executions);
+  EXPECT_EQ(0, ModuleOutputMemoCache::Instance().size());
+  EXPECT_EQ(2, boost::any_cast<int>(*module->get_state()->getTransientValue("ReportedInfo")));
+}
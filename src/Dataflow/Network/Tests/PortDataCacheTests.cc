@@ -0,0 +1,207 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Network/PortDataCache.h>
+#include <Dataflow/Network/Port.h>
+#include <Dataflow/Network/Connection.h>
+#include <Dataflow/Network/SimpleSourceSink.h>
+#include <Dataflow/Network/Tests/MockModule.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Dataflow::Networks::Mocks;
+using namespace SCIRun::Core::Datatypes;
+using ::testing::NiceMock;
+using ::testing::DefaultValue;
+
+namespace
+{
+  // roughly 80 kB each
+  DenseMatrixHandle bigMatrix(double value)
+  {
+    return boost::make_shared<DenseMatrix>(DenseMatrix::Constant(100, 100, value));
+  }
+
+  struct Link
+  {
+    explicit Link(ModuleInterface* module) :
+      source(new SimpleSource),
+      sink(new SimpleSink),
+      outputPort(new OutputPort(module, Port::ConstructionParams(PortId(0, "Output"), "Matrix", false), source)),
+      inputPort(new InputPort(module, Port::ConstructionParams(PortId(0, "Input"), "Matrix", false), sink)),
+      connection(outputPort, inputPort, "link", false)
+    {}
+    boost::shared_ptr<SimpleSource> source;
+    boost::shared_ptr<SimpleSink> sink;
+    OutputPortHandle outputPort;
+    InputPortHandle inputPort;
+    Connection connection;
+  };
+}
+
+class PortDataCacheTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    DefaultValue<InputPortHandle>::Set(InputPortHandle());
+    DefaultValue<OutputPortHandle>::Set(OutputPortHandle());
+    module_.reset(new NiceMock<MockModule>);
+    PortDataCache::Instance().clear();
+    PortDataCache::Instance().setSpillDirectory({});
+    PortDataCache::Instance().setMemoryBudget(100 * 1000);
+  }
+  void TearDown() override
+  {
+    PortDataCache::Instance().setMemoryBudget(0);
+    PortDataCache::Instance().setSpillDirectory({});
+    PortDataCache::Instance().clear();
+  }
+  static bool receives(Link& link)
+  {
+    auto data = link.inputPort->getData();
+    return data && *data;
+  }
+  MockModulePtr module_;
+};
+
+TEST_F(PortDataCacheTests, EvictsConsumedOutputsBeyondBudget)
+{
+  auto& cache = PortDataCache::Instance();
+  Link first(module_.get()), second(module_.get());
+
+  first.outputPort->sendData(bigMatrix(1));
+  EXPECT_TRUE(receives(first));
+  EXPECT_EQ(1, cache.residentCount());
+
+  second.outputPort->sendData(bigMatrix(2));
+  EXPECT_EQ(1, cache.residentCount());
+  EXPECT_FALSE(first.outputPort->hasData());
+  EXPECT_TRUE(cache.evicted(first.source.get()));
+  EXPECT_TRUE(second.outputPort->hasData());
+  EXPECT_FALSE(cache.evicted(second.source.get()));
+  EXPECT_FALSE(receives(first));
+  EXPECT_LE(cache.memoryInUse(), cache.memoryBudget());
+}
+
+TEST_F(PortDataCacheTests, OutputsAwaitingReceiversArePinned)
+{
+  auto& cache = PortDataCache::Instance();
+  Link first(module_.get()), second(module_.get());
+
+  first.outputPort->sendData(bigMatrix(1));
+  second.outputPort->sendData(bigMatrix(2));
+  EXPECT_EQ(2, cache.residentCount());
+  EXPECT_GT(cache.memoryInUse(), cache.memoryBudget());
+
+  EXPECT_TRUE(receives(second));
+  EXPECT_EQ(1, cache.residentCount());
+  EXPECT_TRUE(first.outputPort->hasData());
+  EXPECT_TRUE(cache.evicted(second.source.get()));
+}
+
+TEST_F(PortDataCacheTests, NewDataClearsEvictedState)
+{
+  auto& cache = PortDataCache::Instance();
+  Link first(module_.get()), second(module_.get());
+
+  first.outputPort->sendData(bigMatrix(1));
+  EXPECT_TRUE(receives(first));
+  second.outputPort->sendData(bigMatrix(2));
+  ASSERT_TRUE(cache.evicted(first.source.get()));
+
+  EXPECT_TRUE(receives(second));
+  first.outputPort->sendData(bigMatrix(3));
+  EXPECT_FALSE(cache.evicted(first.source.get()));
+  EXPECT_TRUE(receives(first));
+}
+
+TEST_F(PortDataCacheTests, SpilledOutputsReloadOnReceive)
+{
+  auto dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  auto& cache = PortDataCache::Instance();
+  cache.setSpillDirectory(dir);
+  Link first(module_.get()), second(module_.get());
+
+  first.outputPort->sendData(bigMatrix(1));
+  EXPECT_TRUE(receives(first));
+  second.outputPort->sendData(bigMatrix(2));
+  EXPECT_FALSE(first.outputPort->hasData());
+  EXPECT_FALSE(cache.evicted(first.source.get()));
+  EXPECT_EQ(1, cache.spilledCount());
+
+  auto reloaded = first.inputPort->getData();
+  ASSERT_TRUE(reloaded && *reloaded);
+  auto matrix = boost::dynamic_pointer_cast<DenseMatrix>(*reloaded);
+  ASSERT_TRUE(matrix != nullptr);
+  EXPECT_EQ(100, matrix->rows());
+  EXPECT_EQ(1.0, (*matrix)(99, 99));
+
+  cache.clear();
+  EXPECT_EQ(0, cache.spilledCount());
+  boost::filesystem::remove_all(dir);
+}
+
+TEST_F(PortDataCacheTests, DisabledWithoutBudget)
+{
+  auto& cache = PortDataCache::Instance();
+  cache.setMemoryBudget(0);
+  Link first(module_.get()), second(module_.get());
+
+  first.outputPort->sendData(bigMatrix(1));
+  EXPECT_TRUE(receives(first));
+  second.outputPort->sendData(bigMatrix(2));
+  EXPECT_EQ(0, cache.residentCount());
+  EXPECT_TRUE(first.outputPort->hasData());
+  EXPECT_TRUE(receives(first));
+}
+
+TEST_F(PortDataCacheTests, SpilledOutputsKeepTheirSizeWithoutReloading)
+{
+  auto dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  auto& cache = PortDataCache::Instance();
+  cache.setSpillDirectory(dir);
+  Link first(module_.get()), second(module_.get());
+
+  first.outputPort->sendData(bigMatrix(1));
+  EXPECT_TRUE(receives(first));
+  second.outputPort->sendData(bigMatrix(2));
+  ASSERT_EQ(1, cache.spilledCount());
+
+  EXPECT_EQ(100 * 100, first.source->dataSize());
+  EXPECT_FALSE(first.outputPort->hasData());
+  EXPECT_EQ(1, cache.spilledCount());
+
+  cache.clear();
+  boost::filesystem::remove_all(dir);
+}
@@ -38,11 +38,11 @@ ModuleLookupInfoXML::ModuleLookupInfoXML(const ModuleLookupInfoXML& rhs) : Modul
 
 ModuleLookupInfoXML::ModuleLookupInfoXML(const ModuleLookupInfo& rhs) : ModuleLookupInfo(rhs) {}
 
-ConnectionDescriptionXML::ConnectionDescriptionXML() {}
+ConnectionDescriptionXML::ConnectionDescriptionXML() : loopCarried_(false) {}
 
-ConnectionDescriptionXML::ConnectionDescriptionXML(const ConnectionDescriptionXML& rhs) : ConnectionDescription(rhs) {}
+ConnectionDescriptionXML::ConnectionDescriptionXML(const ConnectionDescriptionXML& rhs) : ConnectionDescription(rhs), loopCarried_(rhs.loopCarried_) {}
 
-ConnectionDescriptionXML::ConnectionDescriptionXML(const ConnectionDescription& rhs) : ConnectionDescription(rhs) {}
+ConnectionDescriptionXML::ConnectionDescriptionXML(const ConnectionDescription& rhs, bool loopCarried) : ConnectionDescription(rhs), loopCarried_(loopCarried) {}
 
 bool SCIRun::Dataflow::Networks::operator<(const ConnectionDescriptionXML& lhs, const ConnectionDescriptionXML& rhs)
 {
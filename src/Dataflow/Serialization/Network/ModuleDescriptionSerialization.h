@@ -36,6 +36,7 @@
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/string.hpp>
 #include <boost/serialization/nvp.hpp>
+#include <boost/serialization/version.hpp>
 #include <Dataflow/Serialization/Network/share.h>
 
 namespace SCIRun {
@@ -69,11 +70,16 @@ namespace Networks {
       ar & boost::serialization::make_nvp("port1_", out_.portId_);
       ar & boost::serialization::make_nvp("moduleId2_", in_.moduleId_.id_);
       ar & boost::serialization::make_nvp("port2_", in_.portId_);
+      if (version > 0)
+        ar & boost::serialization::make_nvp("loopCarried_", loopCarried_);
     }
   public:
     ConnectionDescriptionXML();
     ConnectionDescriptionXML(const ConnectionDescriptionXML& rhs);
-    ConnectionDescriptionXML(const ConnectionDescription& rhs);
+    ConnectionDescriptionXML(const ConnectionDescription& rhs, bool loopCarried = false);
+
+    /// Files written before version 1 have no loop-carried connections.
+    bool loopCarried_;
   };
 
   //to order connections by port index.
@@ -92,4 +98,6 @@ namespace boost {
     }
   }}
 
+BOOST_CLASS_VERSION(SCIRun::Dataflow::Networks::ConnectionDescriptionXML, 1)
+
 #endif
@@ -107,7 +107,11 @@ NetworkHandle NetworkXMLConverter::from_xml_data(const NetworkXML& data)
     auto to = network->lookupModule(conn.in_.moduleId_);
 
     if (from && to)
-      controller_->requestConnection(from->getOutputPort(conn.out_.portId_).get(), to->getInputPort(conn.in_.portId_).get());
+    {
+      auto id = controller_->requestConnection(from->getOutputPort(conn.out_.portId_).get(), to->getInputPort(conn.in_.portId_).get());
+      if (id && conn.loopCarried_)
+        network->setLoopCarried(*id, true);
+    }
     else
     {
       logError(
@@ -157,7 +161,11 @@ NetworkXMLConverter::NetworkAppendInfo NetworkXMLConverter::appendXmlData(const
       auto from = network->lookupModule(ModuleId(modOut->second));
       auto to = network->lookupModule(ModuleId(modIn->second));
       if (from && to)
-        controller_->requestConnection(from->getOutputPort(conn.out_.portId_).get(), to->getInputPort(conn.in_.portId_).get());
+      {
+        auto id = controller_->requestConnection(from->getOutputPort(conn.out_.portId_).get(), to->getInputPort(conn.in_.portId_).get());
+        if (id && conn.loopCarried_)
+          network->setLoopCarried(*id, true);
+      }
     }
   }
   return info;
@@ -184,7 +192,7 @@ NetworkFileHandle NetworkToXML::to_xml_data(const NetworkHandle& network, Module
   for (const auto& desc : conns)
   {
     if (connFilter(desc))
-      networkXML.connections.push_back(ConnectionDescriptionXML(desc));
+      networkXML.connections.push_back(ConnectionDescriptionXML(desc, network->isLoopCarried(ConnectionId::create(desc))));
   }
   for (size_t i = 0; i < network->nmodules(); ++i)
   {
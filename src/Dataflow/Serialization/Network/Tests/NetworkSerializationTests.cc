@@ -161,6 +161,32 @@ TEST(SerializeNetworkTest, RoundTripObject)
 }
 
 
+TEST(SerializeNetworkTest, LoopCarriedFlagRoundTrips)
+{
+  auto networkXML = exampleNet();
+  networkXML.connections[0].loopCarried_ = true;
+
+  ModuleFactoryHandle mf(new HardCodedModuleFactory);
+  NetworkEditorController controller(mf, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+  NetworkXMLConverter converter(mf, nullptr, nullptr, nullptr, &controller);
+  auto network = converter.from_xml_data(networkXML);
+  ASSERT_TRUE(network.get() != nullptr);
+  EXPECT_TRUE(network->isLoopCarried(ConnectionId::create(networkXML.connections[0])));
+  EXPECT_FALSE(network->isLoopCarried(ConnectionId::create(networkXML.connections[1])));
+
+  auto xml = converter.to_xml_data(network);
+  ASSERT_TRUE(xml.get() != nullptr);
+  NetworkXMLSerializer serializer;
+  std::ostringstream ostr;
+  serializer.save_xml(xml->network, ostr);
+  std::istringstream istr(ostr.str());
+  auto readIn = serializer.load_xml(istr);
+  ASSERT_TRUE(readIn.get() != nullptr);
+  ASSERT_EQ(2, readIn->connections.size());
+  for (const auto& conn : readIn->connections)
+    EXPECT_EQ(ConnectionDescription(conn) == networkXML.connections[0], conn.loopCarried_);
+}
+
 TEST(SerializeNetworkTest, FullTestWithModuleState)
 {
   ModuleFactoryHandle mf(new HardCodedModuleFactory);
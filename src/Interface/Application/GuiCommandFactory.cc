@@ -68,6 +68,8 @@ CommandHandle GuiGlobalCommandFactory::create(GlobalCommands type) const
     return boost::make_shared<InteractiveModeCommandConsole>();
   case GlobalCommands::SetupQuitAfterExecute:
     return boost::make_shared<QuitAfterExecuteCommandGui>();
+  case GlobalCommands::RunParameterSweep:
+    return boost::make_shared<RunParameterSweepCommandConsole>();
   case GlobalCommands::QuitCommand:
     return boost::make_shared<QuitCommandGui>();
   default:
@@ -50,4 +50,5 @@ SolveComplexLinearSystemDialog::SolveComplexLinearSystemDialog(const std::string
   solverNameLookup.insert(StringPair("BiConjugate Gradient (Eigen)", "bicg"));
   solverNameLookup.insert(StringPair("Least Squares Conjugate Gradient (Eigen)", "lscg"));
   addComboBoxManager(methodComboBox_, Variables::Method, solverNameLookup);
+  addComboBoxManager(preconditionerComboBox_, Variables::Preconditioner);
 }
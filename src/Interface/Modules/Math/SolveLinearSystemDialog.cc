@@ -28,6 +28,7 @@
 
 #include <Interface/Modules/Math/SolveLinearSystemDialog.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
 #include <Core/Logging/Log.h>
 #include <Dataflow/Network/ModuleStateInterface.h>  //TODO: extract into intermediate
 
@@ -40,6 +41,7 @@
 using namespace SCIRun::Gui;
 using namespace SCIRun::Dataflow::Networks;
 using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Math;
 
 
 namespace SCIRun {
@@ -104,4 +106,7 @@ SolveLinearSystemDialog::SolveLinearSystemDialog(const std::string& name, Module
 
   addComboBoxManager(preconditionerComboBox_, Variables::Preconditioner);
   addComboBoxManager(methodComboBox_, Variables::Method, impl_->solverNameLookup_);
+  addCheckBoxManager(warmStartCheckBox_, Parameters::WarmStart);
+  addCheckBoxManager(mixedPrecisionCheckBox_, Parameters::MixedPrecision);
+  addCheckBoxManager(reorderCheckBox_, Parameters::ReorderMatrix);
 }
@@ -53,6 +53,7 @@ void SolveComplexLinearSystem::setStateDefaults()
   state->setValue(Variables::TargetError, 1e-5);
   state->setValue(Variables::MaxIterations, 500);
   state->setValue(Variables::Method, std::string("cg"));
+  state->setValue(Variables::Preconditioner, std::string("Jacobi"));
 }
 
 void SolveComplexLinearSystem::execute()
@@ -63,6 +64,7 @@ void SolveComplexLinearSystem::execute()
   if (needToExecute())
   {
     SolveLinearSystemAlgorithm algo;
+    algo.setOption(Variables::Preconditioner, get_state()->getValue(Variables::Preconditioner).toString());
     auto col = convertMatrix::toColumn(rhs);
     auto input = std::make_tuple(lhs, col);
     auto tolerance = get_state()->getValue(Variables::TargetError).toDouble();
@@ -32,6 +32,7 @@
 #include <Modules/Math/SolveLinearSystem.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
@@ -41,6 +42,7 @@ using namespace SCIRun::Modules::Math;
 using namespace SCIRun::Core;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Math;
 using namespace SCIRun::Dataflow::Networks;
 using namespace SCIRun::Core::Logging;
 
@@ -57,6 +59,9 @@ void SolveLinearSystem::setStateDefaults()
   setStateIntFromAlgo(Variables::MaxIterations);
   setStateStringFromAlgoOption(Variables::Method);
   setStateStringFromAlgoOption(Variables::Preconditioner);
+  setStateBoolFromAlgo(Parameters::WarmStart);
+  setStateBoolFromAlgo(Parameters::MixedPrecision);
+  setStateBoolFromAlgo(Parameters::ReorderMatrix);
 }
 
 void SolveLinearSystem::execute()
@@ -67,14 +72,23 @@ void SolveLinearSystem::execute()
   if (needToExecute())
   {
     /// @todo: why aren't these checks in the algo class?
-    if (rhs->ncols() != 1)
-      THROW_ALGORITHM_INPUT_ERROR("Right-hand side matrix must contain only one column.");
+    if (rhs->ncols() < 1)
+      THROW_ALGORITHM_INPUT_ERROR("Right-hand side matrix must contain at least one column.");
     if (!matrixIs::sparse(A))
       THROW_ALGORITHM_INPUT_ERROR("Left-hand side matrix to solve must be sparse.");
 
-    auto rhsCol = castMatrix::toColumn(rhs);
-    if (!rhsCol)
-      rhsCol = convertMatrix::toColumn(rhs);
+    // Several right-hand side columns (e.g. one per lead field electrode) are solved together
+    MatrixHandle rhsInput;
+    if (rhs->ncols() == 1)
+    {
+      auto rhsCol = castMatrix::toColumn(rhs);
+      rhsInput = rhsCol ? rhsCol : convertMatrix::toColumn(rhs);
+    }
+    else
+    {
+      auto rhsDense = castMatrix::toDense(rhs);
+      rhsInput = rhsDense ? rhsDense : convertMatrix::toDense(rhs);
+    }
 
     auto tolerance = get_state()->getValue(Variables::TargetError).toDouble();
     auto maxIterations = get_state()->getValue(Variables::MaxIterations).toInt();
@@ -91,6 +105,9 @@ void SolveLinearSystem::execute()
       algo().setOption(Variables::Method, method);
     if (!precond.empty())
       algo().setOption(Variables::Preconditioner, precond);
+    algo().set(Parameters::WarmStart, get_state()->getValue(Parameters::WarmStart).toBool());
+    algo().set(Parameters::MixedPrecision, get_state()->getValue(Parameters::MixedPrecision).toBool());
+    algo().set(Parameters::ReorderMatrix, get_state()->getValue(Parameters::ReorderMatrix).toBool());
 
     std::ostringstream ostr;
     ostr << "Running algorithm Parallel " << method << " Solver with tolerance " << tolerance << " and maximum iterations " << maxIterations;
@@ -100,7 +117,7 @@ void SolveLinearSystem::execute()
       ScopedTimeRemarker perf(this, "Linear solver");
       remark("Using preconditioner: " + precond);
 
-      auto output = algo().run(withInputData((LHS, A)(RHS, rhsCol)));
+      auto output = algo().run(withInputData((LHS, A)(RHS, rhsInput)));
 
       sendOutputFromAlgorithm(Solution, output);
     }
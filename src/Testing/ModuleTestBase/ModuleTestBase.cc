@@ -44,6 +44,7 @@
 #include <Core/GeometryPrimitives/Point.h>
 #include <Core/Logging/Log.h>
 #include <Dataflow/Network/SimpleSourceSink.h>
+#include <Dataflow/Network/PortDataCache.h>
 #include <Dataflow/Network/ModuleBuilder.h>
 
 using namespace SCIRun;
@@ -84,7 +85,7 @@ private:
 class TestSimpleSource : public SimpleSource
 {
 public:
-  DatatypeHandle getDataForTesting() const { return data_; }
+  DatatypeHandle getDataForTesting() const { return PortDataCache::Instance().resident(this); }
 };
 
 class MockAlgorithmFactory : public AlgorithmFactory